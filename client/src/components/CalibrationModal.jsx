@@ -155,9 +155,20 @@ export default function CalibrationModal({
                 const cal = calConfig[p.id];
                 const rawBpm = p.heartbeat?.rawBpm ?? p.heartbeat?.bpm ?? 0;
                 const hasActive = p.heartbeat?.active;
+                const detector = calibrationState?.detector?.[p.id];
                 return (
                   <tr key={p.id}>
-                    <td>{p.name}</td>
+                    <td>
+                      {p.name}
+                      {detector && (
+                        <small title={detector.failed
+                          ? getStr('host', 'calibration.detectorFailed')
+                          : `${detector.thresholdPct}% · ${detector.minRange} · ${detector.refractoryMs} ms`}
+                        >
+                          {detector.failed ? ' ✗' : ' ✓'}
+                        </small>
+                      )}
+                    </td>
                     <td>
                       <input
                         type="number"
@@ -180,8 +191,9 @@ export default function CalibrationModal({
                         onChange={e => handleManualEdit(p.id, 'elevatedBpm', e.target.value)}
                       />
                     </td>
-                    <td className={styles.liveValue}>
+                    <td className={styles.liveValue} title={getStr('host', 'calibration.qualityHint')}>
                       {hasActive ? rawBpm : '—'}
+                      {p.heartbeat?.quality != null && <small> · {p.heartbeat.quality}%</small>}
                     </td>
                     <td>
                       <input
@@ -230,6 +242,16 @@ export default function CalibrationModal({
               <span>{getStr('host', 'calibration.addNoise')}</span>
             </label>
           </div>
+          <div className={styles.optionToggle}>
+            <label>
+              <input
+                type="checkbox"
+                checked={hostSettings?.heartbeatAutoSimulate ?? false}
+                onChange={e => send(ClientMsg.SAVE_HOST_SETTINGS, { heartbeatAutoSimulate: e.target.checked })}
+              />
+              <span>{getStr('host', 'calibration.autoSimulate')}</span>
+            </label>
+          </div>
           {hasSimulated && (
             <div className={styles.simToggle}>
               <label>
@@ -4,6 +4,7 @@ import styles from './HeartbeatModal.module.css';
 
 export default function HeartbeatModal({ isOpen, onClose, players, onPushHeartbeatSlide }) {
   const activePlayers = (players || []).filter(p => p.heartbeat?.active);
+  const leadsOffPlayers = (players || []).filter(p => p.heartbeat?.leadsOff);
 
   return (
     <Modal isOpen={isOpen} onClose={onClose} title="HEARTBEAT">
@@ -14,10 +15,17 @@ export default function HeartbeatModal({ isOpen, onClose, players, onPushHeartbe
             onClick={() => { onPushHeartbeatSlide(p.id); onClose(); }}
           >
             ❤️ {p.name}
+            {p.heartbeat.stress != null && <span className={styles.stress}>stress {p.heartbeat.stress}</span>}
             <span className={styles.bpm}>{p.heartbeat.bpm} BPM</span>
             {p.heartbeat.fake && <span className={styles.debugBadge}>DEBUG</span>}
           </button>
         ))}
+        {leadsOffPlayers.map(p => (
+          <button key={p.id} disabled>
+            {p.name}
+            <span className={styles.bpm}>LEADS OFF</span>
+          </button>
+        ))}
       </div>
     </Modal>
   );
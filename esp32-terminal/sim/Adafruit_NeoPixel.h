@@ -0,0 +1,39 @@
+// Adafruit_NeoPixel shim: pixel colours as the last show() latched them
+#ifndef SIM_ADAFRUIT_NEOPIXEL_H
+#define SIM_ADAFRUIT_NEOPIXEL_H
+
+#include <Arduino.h>
+
+#define NEO_RGB     ((0 << 6) | (0 << 4) | (1 << 2) | (2))
+#define NEO_GRB     ((1 << 6) | (1 << 4) | (0 << 2) | (2))
+#define NEO_KHZ800  0x0000
+#define NEO_KHZ400  0x0100
+
+class Adafruit_NeoPixel {
+public:
+    static const int MAX_PIXELS = 8;
+
+    Adafruit_NeoPixel(uint16_t n, int16_t pin = 6, uint16_t type = NEO_GRB + NEO_KHZ800);
+    void begin() {}
+    void show();
+    bool canShow() { return true; }
+    void clear() { memset(pixels, 0, sizeof(pixels)); }
+    void setBrightness(uint8_t b) { brightness = b; }
+    void setPixelColor(uint16_t n, uint32_t c) { if (n < count) pixels[n] = c; }
+    uint32_t getPixelColor(uint16_t n) const { return n < count ? pixels[n] : 0; }
+    uint16_t numPixels() const { return count; }
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+        return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    }
+
+    // Colours shown last, as 0xRRGGBB
+    uint32_t shown[MAX_PIXELS] = {};
+    uint32_t shows = 0;
+
+private:
+    uint16_t count;
+    uint8_t brightness = 0;
+    uint32_t pixels[MAX_PIXELS] = {};
+};
+
+#endif // SIM_ADAFRUIT_NEOPIXEL_H
@@ -0,0 +1,137 @@
+// Arduino core shim (arduino-esp32 2.x surface the firmware uses) for the host simulator
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#include "WString.h"
+#include "freertos/FreeRTOS.h"
+#include "esp_heap_caps.h"     // Arduino-ESP32 pulls this in through esp32-hal.h
+
+using std::min;
+using std::max;
+
+#define PI          3.1415926535897932384626433832795
+#define HIGH        0x1
+#define LOW         0x0
+#define INPUT       0x01
+#define OUTPUT      0x03
+#define PULLUP      0x04
+#define INPUT_PULLUP 0x05
+#define RISING      0x01
+#define FALLING     0x02
+#define CHANGE      0x03
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_NOINIT_ATTR
+#define PROGMEM
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+// ============================================================================
+// TIME, GPIO, ADC, PWM
+// ============================================================================
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+
+#define digitalPinToInterrupt(p) (p)
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t pin);
+
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t resolution);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcWrite(uint8_t channel, uint32_t duty);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+bool setCpuFrequencyMhz(uint32_t mhz);
+uint32_t getCpuFrequencyMhz();
+float temperatureRead();
+
+// ============================================================================
+// IPADDRESS, SERIAL, ESP
+// ============================================================================
+
+class IPAddress {
+public:
+    IPAddress() : bytes{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : bytes{a, b, c, d} {}
+    uint8_t operator[](int i) const { return bytes[i]; }
+    uint8_t& operator[](int i) { return bytes[i]; }
+    bool operator==(const IPAddress& o) const { return memcmp(bytes, o.bytes, 4) == 0; }
+    String toString() const;
+
+private:
+    uint8_t bytes[4];
+};
+
+// stdout / stdin. Lines typed into the simulator that start with '!' are simulator
+// controls (sim.cpp); everything else arrives here as serial input.
+class HardwareSerial {
+public:
+    void begin(unsigned long baud) {}
+    int available();
+    int read();
+    int availableForWrite() { return 4096; }
+    size_t write(uint8_t c) { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t len);
+    size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t print(const String& s) { return print(s.c_str()); }
+    size_t println(const char* s = "") { return print(s) + print("\n"); }
+    size_t println(const String& s) { return println(s.c_str()); }
+    size_t printf(const char* fmt, ...) __attribute__((format(__printf__, 2, 3)));
+    void flush();
+};
+
+extern HardwareSerial Serial;
+
+// Heap figures are fixed (the host heap says nothing about the ESP32's); the cycle
+// counter runs at the simulated CPU clock
+class EspClass {
+public:
+    [[noreturn]] void restart();
+    uint32_t getHeapSize();
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap();
+    uint32_t getMaxAllocHeap();
+    uint32_t getCycleCount();
+    uint32_t getCpuFreqMHz() { return getCpuFrequencyMhz(); }
+};
+
+extern EspClass ESP;
+
+uint32_t xthal_get_ccount();
+
+typedef enum {
+    ESP_RST_UNKNOWN, ESP_RST_POWERON, ESP_RST_EXT, ESP_RST_SW, ESP_RST_PANIC,
+    ESP_RST_INT_WDT, ESP_RST_TASK_WDT, ESP_RST_WDT, ESP_RST_DEEPSLEEP, ESP_RST_BROWNOUT,
+    ESP_RST_SDIO
+} esp_reset_reason_t;
+
+esp_reset_reason_t esp_reset_reason();
+
+typedef int esp_err_t;
+#define ESP_OK                  0
+#define ESP_FAIL                -1
+#define ESP_ERR_NOT_SUPPORTED   0x106
+
+#endif // SIM_ARDUINO_H
@@ -0,0 +1,31 @@
+// ESP32Encoder shim: the count the PCNT unit would keep. The "u"/"d" controls turn the
+// knob — the count moves and the A/B pins toggle, so edge interrupts fire as on the chip.
+#ifndef SIM_ESP32ENCODER_H
+#define SIM_ESP32ENCODER_H
+
+#include <Arduino.h>
+
+enum class puType { up, down, none };
+
+class ESP32Encoder {
+public:
+    static puType useInternalWeakPullResistors;
+
+    ESP32Encoder();
+    void attachFullQuad(int aPin, int bPin);
+    void attachHalfQuad(int aPin, int bPin) { attachFullQuad(aPin, bPin); }
+    int64_t getCount() { return count; }
+    int64_t clearCount() { count = 0; return 0; }
+    void setCount(int64_t value) { count = value; }
+
+    // Every attached encoder, pulses > 0 clockwise (loop task)
+    static void simTurn(int pulses);
+
+private:
+    int pinA = -1;
+    int pinB = -1;
+    int64_t count = 0;
+    ESP32Encoder* next = nullptr;
+};
+
+#endif // SIM_ESP32ENCODER_H
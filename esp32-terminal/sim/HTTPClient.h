@@ -0,0 +1,19 @@
+// HTTPClient shim: every request fails to connect (firmware update checks only)
+#ifndef SIM_HTTPCLIENT_H
+#define SIM_HTTPCLIENT_H
+
+#include <Arduino.h>
+
+#define HTTPC_ERROR_CONNECTION_REFUSED  (-1)
+#define HTTP_CODE_OK                    200
+
+class HTTPClient {
+public:
+    bool begin(const String& url) { return true; }
+    void setTimeout(uint16_t timeoutMs) {}
+    int GET() { return HTTPC_ERROR_CONNECTION_REFUSED; }
+    String getString() { return String(); }
+    void end() {}
+};
+
+#endif // SIM_HTTPCLIENT_H
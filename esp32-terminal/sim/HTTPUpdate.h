@@ -0,0 +1,22 @@
+// HTTPUpdate shim: there is no flash to write, so an update always fails cleanly
+#ifndef SIM_HTTPUPDATE_H
+#define SIM_HTTPUPDATE_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+enum HTTPUpdateResult { HTTP_UPDATE_FAILED, HTTP_UPDATE_NO_UPDATES, HTTP_UPDATE_OK };
+typedef HTTPUpdateResult t_httpUpdate_return;
+
+class HTTPUpdate {
+public:
+    void setLedPin(int ledPin = -1, uint8_t ledOn = HIGH) {}
+    void rebootOnUpdate(bool reboot) {}
+    t_httpUpdate_return update(WiFiClient& client, const String& url) { return HTTP_UPDATE_FAILED; }
+    int getLastError() { return -1; }
+    String getLastErrorString() { return "not supported in the simulator"; }
+};
+
+extern HTTPUpdate httpUpdate;
+
+#endif // SIM_HTTPUPDATE_H
@@ -0,0 +1,47 @@
+// Preferences (NVS) shim: every namespace lives in one text file (--nvs, default
+// sim-nvs.txt), read at the first begin() and rewritten by end() after a change
+#ifndef SIM_PREFERENCES_H
+#define SIM_PREFERENCES_H
+
+#include <Arduino.h>
+#include <string>
+
+class Preferences {
+public:
+    // Read-only opening of a namespace that was never written fails, as on NVS
+    bool begin(const char* name, bool readOnly = false, const char* partition = nullptr);
+    void end();
+
+    bool isKey(const char* key);
+    bool remove(const char* key);
+    bool clear();
+
+    size_t putUChar(const char* key, uint8_t value) { return put(key, &value, sizeof(value)); }
+    size_t putUShort(const char* key, uint16_t value) { return put(key, &value, sizeof(value)); }
+    size_t putInt(const char* key, int32_t value) { return put(key, &value, sizeof(value)); }
+    size_t putUInt(const char* key, uint32_t value) { return put(key, &value, sizeof(value)); }
+    size_t putFloat(const char* key, float value) { return put(key, &value, sizeof(value)); }
+    size_t putBool(const char* key, bool value) { return putUChar(key, value ? 1 : 0); }
+    size_t putBytes(const char* key, const void* value, size_t len) { return put(key, value, len); }
+
+    uint8_t getUChar(const char* key, uint8_t def = 0) { get(key, &def, sizeof(def)); return def; }
+    uint16_t getUShort(const char* key, uint16_t def = 0) { get(key, &def, sizeof(def)); return def; }
+    int32_t getInt(const char* key, int32_t def = 0) { get(key, &def, sizeof(def)); return def; }
+    uint32_t getUInt(const char* key, uint32_t def = 0) { get(key, &def, sizeof(def)); return def; }
+    float getFloat(const char* key, float def = NAN) { get(key, &def, sizeof(def)); return def; }
+    bool getBool(const char* key, bool def = false) { return getUChar(key, def ? 1 : 0) != 0; }
+    size_t getBytesLength(const char* key);
+    // 0 if the stored value does not fit in maxLen
+    size_t getBytes(const char* key, void* buf, size_t maxLen);
+
+private:
+    std::string ns;
+    bool open = false;
+    bool readOnly = true;
+    bool dirty = false;
+
+    size_t put(const char* key, const void* value, size_t len);
+    bool get(const char* key, void* out, size_t len);   // Only a value of exactly len bytes
+};
+
+#endif // SIM_PREFERENCES_H
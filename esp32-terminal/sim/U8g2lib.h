@@ -0,0 +1,94 @@
+// U8g2 shim: a 1-bit framebuffer in memory and a "panel" that sendBuffer() and
+// updateDisplayArea() copy it to, counting the bytes an SSD1322 (4 bits per pixel)
+// would have been sent. Glyphs are drawn as solid cells of the font's size — the text
+// itself is kept per panel position for the "screen" control.
+#ifndef SIM_U8G2LIB_H
+#define SIM_U8G2LIB_H
+
+#include <Arduino.h>
+#include <string>
+#include <vector>
+
+typedef uint16_t u8g2_uint_t;
+
+struct u8g2_cb_t {
+    uint8_t quarterTurns;
+};
+
+extern const u8g2_cb_t u8g2_cb_r0;
+extern const u8g2_cb_t u8g2_cb_r2;
+#define U8G2_R0 (&u8g2_cb_r0)
+#define U8G2_R2 (&u8g2_cb_r2)
+#define U8X8_PIN_NONE 255
+
+// Fonts are their metrics here: cell width, cell height, ascent
+extern const uint8_t u8g2_font_6x10_tf[];
+extern const uint8_t u8g2_font_10x20_tf[];
+
+class U8G2 {
+public:
+    static constexpr int WIDTH = 256;
+    static constexpr int HEIGHT = 64;
+
+    struct Text {
+        int x, y, w, h;             // Cell box, logical coordinates
+        std::string str;
+    };
+
+    U8G2(const u8g2_cb_t* rotation);
+
+    bool begin() { return true; }
+    void setDisplayRotation(const u8g2_cb_t* r) { rotation = r; }
+    void setFlipMode(uint8_t mode) {}
+    void setContrast(uint8_t value) {}
+    void setPowerSave(uint8_t on) {}
+
+    void clearBuffer();
+    void sendBuffer();
+    // Tile (8x8) area in buffer orientation — mirrored back here under U8G2_R2
+    void updateDisplayArea(uint8_t tx, uint8_t ty, uint8_t tw, uint8_t th);
+    uint8_t getBufferTileWidth() const { return WIDTH / 8; }
+    uint8_t getBufferTileHeight() const { return HEIGHT / 8; }
+    u8g2_uint_t getDisplayWidth() const { return WIDTH; }
+    u8g2_uint_t getDisplayHeight() const { return HEIGHT; }
+
+    void setFont(const uint8_t* f) { font = f; }
+    void setDrawColor(uint8_t c) { color = c; }
+    int8_t getAscent() const { return (int8_t)font[2]; }
+    u8g2_uint_t getStrWidth(const char* s) const { return (u8g2_uint_t)(strlen(s) * font[0]); }
+    u8g2_uint_t drawStr(u8g2_uint_t x, u8g2_uint_t y, const char* s);
+
+    void drawPixel(u8g2_uint_t x, u8g2_uint_t y) { plot(x, y); }
+    void drawHLine(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w) { fill(x, y, w, 1); }
+    void drawVLine(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t h) { fill(x, y, 1, h); }
+    void drawBox(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h);
+    void drawFrame(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h);
+    void drawXBMP(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h, const uint8_t* bitmap);
+
+    // Panel as last sent, and the text on it
+    uint8_t panel[HEIGHT][WIDTH] = {};
+    std::vector<Text> panelText;
+    uint32_t sends = 0;
+    uint64_t bytesSent = 0;
+
+private:
+    const u8g2_cb_t* rotation;
+    const uint8_t* font = u8g2_font_6x10_tf;
+    uint8_t color = 1;
+    uint8_t buffer[HEIGHT][WIDTH] = {};
+    std::vector<Text> text;             // Text in the buffer
+
+    void plot(int x, int y);
+    void fill(int x, int y, int w, int h);
+    void eraseText(int x, int y, int w, int h);
+    void copyToPanel(int x, int y, int w, int h);
+};
+
+class U8G2_SSD1322_NHD_256X64_F_4W_HW_SPI : public U8G2 {
+public:
+    U8G2_SSD1322_NHD_256X64_F_4W_HW_SPI(const u8g2_cb_t* rotation, uint8_t cs, uint8_t dc,
+                                        uint8_t reset = U8X8_PIN_NONE)
+        : U8G2(rotation) {}
+};
+
+#endif // SIM_U8G2LIB_H
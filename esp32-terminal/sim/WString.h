@@ -0,0 +1,124 @@
+// Arduino String shim — the Arduino API over std::string (it allocates the same way:
+// on growth, and never while a reserve() still covers the contents)
+#ifndef SIM_WSTRING_H
+#define SIM_WSTRING_H
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+
+class String {
+public:
+    String(const char* s = "") : s_(s ? s : "") {}
+    String(const char* s, unsigned int len) : s_(s ? s : "", s ? len : 0) {}
+    explicit String(char c) : s_(1, c) {}
+    explicit String(int v, unsigned char base = 10) : s_(fmt(base == 16 ? "%x" : "%d", v)) {}
+    explicit String(unsigned int v, unsigned char base = 10) : s_(fmt(base == 16 ? "%x" : "%u", v)) {}
+    explicit String(long v) : s_(fmt("%ld", v)) {}
+    explicit String(unsigned long v) : s_(fmt("%lu", v)) {}
+    explicit String(double v, unsigned int decimals = 2) : s_(fmtf(v, decimals)) {}
+    String(const String&) = default;
+    String(String&&) = default;
+    String& operator=(const String&) = default;
+    String& operator=(String&&) = default;
+    String& operator=(const char* s) { s_ = s ? s : ""; return *this; }
+
+    const char* c_str() const { return s_.c_str(); }
+    unsigned int length() const { return (unsigned int)s_.size(); }
+    bool isEmpty() const { return s_.empty(); }
+    bool reserve(unsigned int size) { s_.reserve(size); return true; }
+
+    bool concat(const String& s) { s_ += s.s_; return true; }
+    bool concat(const char* s) { if (s) s_ += s; return s != nullptr; }
+    bool concat(const char* s, unsigned int len) { if (s) s_.append(s, len); return s != nullptr; }
+    bool concat(char c) { s_ += c; return true; }
+    bool concat(int v) { return concat(String(v)); }
+    bool concat(unsigned int v) { return concat(String(v)); }
+    bool concat(long v) { return concat(String(v)); }
+    bool concat(unsigned long v) { return concat(String(v)); }
+    bool concat(double v) { return concat(String(v)); }
+    template <typename T> String& operator+=(const T& v) { concat(v); return *this; }
+
+    bool equals(const String& s) const { return s_ == s.s_; }
+    bool equals(const char* s) const { return s_ == (s ? s : ""); }
+    bool operator==(const String& s) const { return equals(s); }
+    bool operator==(const char* s) const { return equals(s); }
+    bool operator!=(const String& s) const { return !equals(s); }
+    bool operator!=(const char* s) const { return !equals(s); }
+    bool operator<(const String& s) const { return s_ < s.s_; }
+
+    char charAt(unsigned int i) const { return i < s_.size() ? s_[i] : '\0'; }
+    char operator[](unsigned int i) const { return charAt(i); }
+    char& operator[](unsigned int i) { return s_[i]; }
+    void setCharAt(unsigned int i, char c) { if (i < s_.size()) s_[i] = c; }
+
+    int indexOf(char c, unsigned int from = 0) const { return pos(s_.find(c, from)); }
+    int indexOf(const String& s, unsigned int from = 0) const { return pos(s_.find(s.s_, from)); }
+    int lastIndexOf(char c) const { return pos(s_.rfind(c)); }
+    bool startsWith(const String& s) const { return s_.compare(0, s.s_.size(), s.s_) == 0; }
+    bool endsWith(const String& s) const {
+        return s_.size() >= s.s_.size() && s_.compare(s_.size() - s.s_.size(), s.s_.size(), s.s_) == 0;
+    }
+    String substring(unsigned int from) const { return substring(from, length()); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) std::swap(from, to);
+        if (from >= s_.size()) return String();
+        return String(s_.substr(from, std::min<size_t>(to, s_.size()) - from).c_str());
+    }
+
+    void remove(unsigned int index) { if (index < s_.size()) s_.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < s_.size()) s_.erase(index, count); }
+    void replace(const String& find, const String& with) {
+        if (find.s_.empty()) return;
+        for (size_t p = s_.find(find.s_); p != std::string::npos; p = s_.find(find.s_, p + with.s_.size())) {
+            s_.replace(p, find.s_.size(), with.s_);
+        }
+    }
+    void trim() {
+        size_t b = s_.find_first_not_of(" \t\r\n");
+        size_t e = s_.find_last_not_of(" \t\r\n");
+        s_ = b == std::string::npos ? std::string() : s_.substr(b, e - b + 1);
+    }
+    void toUpperCase() { for (char& c : s_) c = (char)toupper((unsigned char)c); }
+    void toLowerCase() { for (char& c : s_) c = (char)tolower((unsigned char)c); }
+    long toInt() const { return strtol(s_.c_str(), nullptr, 10); }
+    float toFloat() const { return strtof(s_.c_str(), nullptr); }
+
+private:
+    std::string s_;
+
+    static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+    template <typename T> static std::string fmt(const char* f, T v) {
+        char buf[24];
+        snprintf(buf, sizeof(buf), f, v);
+        return buf;
+    }
+    static std::string fmtf(double v, unsigned int decimals) {
+        char buf[40];
+        snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+        return buf;
+    }
+};
+
+// What String + String yields in the Arduino core (ArduinoJson adapts it as a string)
+class StringSumHelper : public String {
+public:
+    StringSumHelper(const String& s) : String(s) {}
+    StringSumHelper(const char* s) : String(s) {}
+};
+
+inline StringSumHelper operator+(const StringSumHelper& a, const String& b) {
+    StringSumHelper r(a);
+    r.concat(b);
+    return r;
+}
+inline StringSumHelper operator+(const StringSumHelper& a, const char* b) {
+    StringSumHelper r(a);
+    r.concat(b);
+    return r;
+}
+
+#endif // SIM_WSTRING_H
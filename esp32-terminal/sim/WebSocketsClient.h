@@ -0,0 +1,90 @@
+// WebSocketsClient shim (links2004/WebSockets API): a plain-socket RFC 6455 client.
+// Like the library, loop() connects (blocking, then every reconnect interval while
+// down), runs the handshake, sends pings when a heartbeat is set and delivers frames
+// as events; sending with headerToPayload writes the header into the space reserved in
+// front of the payload and masks it in place. Fragmented messages are delivered whole.
+#ifndef SIM_WEBSOCKETSCLIENT_H
+#define SIM_WEBSOCKETSCLIENT_H
+
+#include <Arduino.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#define WEBSOCKETS_MAX_HEADER_SIZE (14)
+
+typedef enum {
+    WStype_ERROR,
+    WStype_DISCONNECTED,
+    WStype_CONNECTED,
+    WStype_TEXT,
+    WStype_BIN,
+    WStype_FRAGMENT_TEXT_START,
+    WStype_FRAGMENT_BIN_START,
+    WStype_FRAGMENT,
+    WStype_FRAGMENT_FIN,
+    WStype_PING,
+    WStype_PONG,
+} WStype_t;
+
+class WebSocketsClient {
+public:
+    typedef std::function<void(WStype_t type, uint8_t* payload, size_t length)> WebSocketClientEvent;
+
+    ~WebSocketsClient();
+
+    void begin(const char* host, uint16_t port, const char* url = "/", const char* protocol = "arduino");
+    void onEvent(WebSocketClientEvent cb) { onEventCb = cb; }
+    void loop();
+    void disconnect();
+    bool isConnected() const { return state == State::CONNECTED; }
+
+    void setReconnectInterval(unsigned long ms) { reconnectIntervalMs = ms; }
+    void enableHeartbeat(uint32_t pingIntervalMs, uint32_t pongTimeoutMs, uint8_t disconnectTimeoutCount);
+    void disableHeartbeat() { pingIntervalMs = 0; }
+
+    bool sendTXT(uint8_t* payload, size_t length = 0, bool headerToPayload = false);
+    bool sendTXT(const char* payload, size_t length = 0);
+    bool sendTXT(String& payload) { return sendTXT(payload.c_str(), payload.length()); }
+    bool sendBIN(uint8_t* payload, size_t length, bool headerToPayload = false);
+    bool sendBIN(const uint8_t* payload, size_t length);
+    bool sendPing(uint8_t* payload = nullptr, size_t length = 0);
+
+private:
+    enum class State { DISCONNECTED, HANDSHAKE, CONNECTED };
+
+    std::string host;
+    uint16_t port = 0;
+    std::string url;
+    std::string protocol;
+    WebSocketClientEvent onEventCb;
+
+    State state = State::DISCONNECTED;
+    int fd = -1;
+    bool started = false;
+    bool connectNow = false;            // begin() was called: no reconnect wait
+    unsigned long reconnectIntervalMs = 500;
+    unsigned long lastAttemptMs = 0;
+    std::vector<uint8_t> rx;
+    std::vector<uint8_t> message;       // Fragments so far
+    uint8_t messageOpcode = 0;
+
+    uint32_t pingIntervalMs = 0;
+    uint32_t pongTimeoutMs = 0;
+    uint8_t disconnectTimeoutCount = 0;
+    uint8_t pongTimeouts = 0;
+    unsigned long lastPingMs = 0;
+    bool pongPending = false;
+
+    bool connectSocket();
+    void close(bool notify);
+    bool readHandshake();
+    bool readFrames();
+    void dispatch(uint8_t opcode, uint8_t* payload, size_t length);
+    void heartbeat();
+    bool sendFrame(uint8_t opcode, uint8_t* payload, size_t length, bool headerToPayload);
+    bool writeAll(const uint8_t* data, size_t len);
+    void event(WStype_t type, uint8_t* payload, size_t length);
+};
+
+#endif // SIM_WEBSOCKETSCLIENT_H
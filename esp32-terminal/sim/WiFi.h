@@ -0,0 +1,31 @@
+// WiFi shim: the host's network is already up, so the station connects at once on
+// 127.0.0.1 with a steady signal
+#ifndef SIM_WIFI_H
+#define SIM_WIFI_H
+
+#include <Arduino.h>
+
+typedef enum {
+    WL_IDLE_STATUS = 0, WL_NO_SSID_AVAIL = 1, WL_CONNECTED = 3, WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5, WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } wifi_mode_t;
+
+class WiFiClass {
+public:
+    bool mode(wifi_mode_t m) { return true; }
+    wl_status_t begin(const char* ssid, const char* passphrase = nullptr) { return status(); }
+    bool disconnect(bool wifiOff = false) { return true; }
+    wl_status_t status() { return WL_CONNECTED; }
+    IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+    int8_t RSSI() { return -55; }
+    bool setSleep(bool enabled) { return true; }
+};
+
+extern WiFiClass WiFi;
+
+// Only handed to httpUpdate, which never gets far enough to use it
+class WiFiClient {};
+
+#endif // SIM_WIFI_H
@@ -0,0 +1,42 @@
+// WiFiUDP shim over a host socket. begin() takes an ephemeral port rather than the one
+// asked for (the server on this host owns the discovery port; replies go to the sender),
+// and broadcasts are sent to --discover (default 127.0.0.1) instead.
+#ifndef SIM_WIFIUDP_H
+#define SIM_WIFIUDP_H
+
+#include <Arduino.h>
+
+class WiFiUDP {
+public:
+    ~WiFiUDP() { stop(); }
+    uint8_t begin(uint16_t port);
+    void stop();
+
+    int beginPacket(IPAddress ip, uint16_t port);
+    size_t write(const uint8_t* buf, size_t len);
+    size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    int endPacket();
+
+    int parsePacket();          // Size of the next datagram, 0 if none waiting
+    int available() { return rxLen - rxPos; }
+    int read(char* buf, size_t len) { return read((uint8_t*)buf, len); }
+    int read(uint8_t* buf, size_t len);
+    IPAddress remoteIP() { return remote; }
+    uint16_t remotePort() { return remotePortNum; }
+
+private:
+    static const int MAX_DATAGRAM = 512;
+
+    int fd = -1;
+    uint8_t tx[MAX_DATAGRAM];
+    int txLen = 0;
+    IPAddress dest;
+    uint16_t destPort = 0;
+    uint8_t rx[MAX_DATAGRAM];
+    int rxLen = 0;
+    int rxPos = 0;
+    IPAddress remote;
+    uint16_t remotePortNum = 0;
+};
+
+#endif // SIM_WIFIUDP_H
@@ -0,0 +1,10 @@
+// ESP-IDF MAC shim: 02:00:00:00:00:<--mac>
+#ifndef SIM_ESP_MAC_H
+#define SIM_ESP_MAC_H
+
+#include <stdint.h>
+#include <Arduino.h>
+
+esp_err_t esp_efuse_mac_get_default(uint8_t* mac);
+
+#endif // SIM_ESP_MAC_H
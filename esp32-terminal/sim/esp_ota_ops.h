@@ -0,0 +1,16 @@
+// ESP-IDF OTA shim: the two app slots of default_8MB.csv; nothing is ever written
+#ifndef SIM_ESP_OTA_OPS_H
+#define SIM_ESP_OTA_OPS_H
+
+#include <stdint.h>
+
+typedef struct {
+    const char* label;
+    uint32_t address;
+    uint32_t size;
+} esp_partition_t;
+
+const esp_partition_t* esp_ota_get_running_partition();
+const esp_partition_t* esp_ota_get_next_update_partition(const esp_partition_t* start_from);
+
+#endif // SIM_ESP_OTA_OPS_H
@@ -0,0 +1,7 @@
+// ESP-IDF ROM printf shim: straight to stderr, no allocation
+#ifndef SIM_ESP_ROM_SYS_H
+#define SIM_ESP_ROM_SYS_H
+
+int esp_rom_printf(const char* fmt, ...) __attribute__((format(__printf__, 1, 2)));
+
+#endif // SIM_ESP_ROM_SYS_H
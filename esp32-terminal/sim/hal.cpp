@@ -0,0 +1,342 @@
+// Arduino / ESP-IDF shims: clock, pins and their interrupts, LEDC, the synthetic ECG on
+// the AD8232 input, and the ESP system calls. Pin state is only touched by the loop task
+// (interrupts and controls run there too), so none of it needs locking.
+
+#include "sim.h"
+#include <Arduino.h>
+#include <Adafruit_NeoPixel.h>
+#include <ESP32Encoder.h>
+#include <HTTPUpdate.h>
+#include <SPI.h>
+#include <WiFi.h>
+#include <driver/ledc.h>
+#include <esp_heap_caps.h>
+#include <esp_mac.h>
+#include <esp_ota_ops.h>
+#include <esp_rom_sys.h>
+#include <stdarg.h>
+#include <chrono>
+#include <thread>
+#include "config.h"
+
+EspClass ESP;
+SPIClass SPI;
+WiFiClass WiFi;
+HTTPUpdate httpUpdate;
+
+// ============================================================================
+// CLOCK
+// ============================================================================
+
+static uint32_t cpuMhz = 240;
+
+unsigned long millis() {
+    return (unsigned long)(simMicros() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)simMicros();
+}
+
+void delay(uint32_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+    uint64_t until = simMicros() + us;
+    while (simMicros() < until) {}
+}
+
+bool setCpuFrequencyMhz(uint32_t mhz) {
+    cpuMhz = mhz;
+    return true;
+}
+
+uint32_t getCpuFrequencyMhz() {
+    return cpuMhz;
+}
+
+uint32_t EspClass::getCycleCount() {
+    return (uint32_t)(simMicros() * cpuMhz);
+}
+
+uint32_t xthal_get_ccount() {
+    return ESP.getCycleCount();
+}
+
+float temperatureRead() {
+    return 41.5f;
+}
+
+// ============================================================================
+// GPIO
+// ============================================================================
+
+static const int PIN_COUNT = 49;
+
+struct PinIsr {
+    void (*handler)(void*);
+    void (*plainHandler)();
+    void* arg;
+    int mode;
+};
+
+static uint8_t pinLevels[PIN_COUNT];
+static PinIsr pinIsrs[PIN_COUNT];
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < PIN_COUNT && (mode & PULLUP)) pinLevels[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin < PIN_COUNT) pinLevels[pin] = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < PIN_COUNT ? pinLevels[pin] : LOW;
+}
+
+int simPinLevel(int pin) {
+    return digitalRead((uint8_t)pin);
+}
+
+void simSetPin(int pin, int level) {
+    if (pin < 0 || pin >= PIN_COUNT || pinLevels[pin] == level) return;
+    pinLevels[pin] = (uint8_t)level;
+    const PinIsr& isr = pinIsrs[pin];
+    bool fire = isr.mode == CHANGE || (isr.mode == RISING && level == HIGH) ||
+                (isr.mode == FALLING && level == LOW);
+    if (!fire) return;
+    if (isr.handler) isr.handler(isr.arg);
+    if (isr.plainHandler) isr.plainHandler();
+}
+
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode) {
+    if (pin < PIN_COUNT) pinIsrs[pin] = { handler, nullptr, arg, mode };
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode) {
+    if (pin < PIN_COUNT) pinIsrs[pin] = { nullptr, handler, nullptr, mode };
+}
+
+void detachInterrupt(uint8_t pin) {
+    if (pin < PIN_COUNT) pinIsrs[pin] = {};
+}
+
+// ============================================================================
+// ADC — synthetic ECG
+// ============================================================================
+
+// One beat as Gaussian P, Q, R, S and T waves (seconds from the R peak, width, height in
+// ADC counts) on a slowly wandering baseline, plus a little noise
+static int ecgSample(uint64_t us) {
+    struct Wave { float at, width, height; };
+    static const Wave waves[] = {
+        { -0.20f, 0.025f, 120 }, { -0.03f, 0.010f, -150 }, { 0.0f, 0.012f, 1400 },
+        { 0.03f, 0.010f, -350 }, { 0.25f, 0.040f, 300 },
+    };
+    static uint32_t noise = 1;
+    float t = us / 1e6f;
+    float period = 60.0f / simOptions.bpm;
+    float phase = fmodf(t, period) - 0.35f;     // R peak 350 ms into each beat
+    float v = 1900.0f + 60.0f * sinf(t * 0.6f);
+    for (const Wave& w : waves) {
+        float d = (phase - w.at) / w.width;
+        v += w.height * expf(-0.5f * d * d);
+    }
+    noise = noise * 1664525u + 1013904223u;
+    v += (float)((int)(noise >> 27) - 16);
+    return std::max(0, std::min(4095, (int)v));
+}
+
+uint16_t analogRead(uint8_t pin) {
+    if (pin != PIN_AD8232_OUT) return 0;
+    // Leads off: the amplifier output sits at a rail
+    if (digitalRead(PIN_AD8232_LOP) == HIGH || digitalRead(PIN_AD8232_LOM) == HIGH) return 4095;
+    return (uint16_t)ecgSample(simMicros());
+}
+
+int simAnalogRead(int pin) {
+    return analogRead((uint8_t)pin);
+}
+
+// ============================================================================
+// LEDC
+// ============================================================================
+
+static const int LEDC_CHANNELS = 16;
+
+struct LedcChannel {
+    uint32_t duty;
+    ledc_cb_t fadeCb;
+    void* fadeArg;
+};
+
+static LedcChannel ledc[LEDC_CHANNELS];
+
+uint32_t ledcSetup(uint8_t channel, uint32_t freq, uint8_t resolution) {
+    return freq;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {}
+
+void ledcWrite(uint8_t channel, uint32_t duty) {
+    if (channel >= LEDC_CHANNELS) return;
+    ledc[channel].duty = duty;
+}
+
+uint32_t simLedcDuty(int channel) {
+    return channel >= 0 && channel < LEDC_CHANNELS ? ledc[channel].duty : 0;
+}
+
+esp_err_t ledc_fade_func_install(int intr_alloc_flags) {
+    return ESP_OK;
+}
+
+esp_err_t ledc_cb_register(ledc_mode_t speed_mode, ledc_channel_t channel, ledc_cbs_t* cbs,
+                           void* user_arg) {
+    if (channel < 0 || channel >= LEDC_CHANNELS) return ESP_FAIL;
+    ledc[channel].fadeCb = cbs->fade_cb;
+    ledc[channel].fadeArg = user_arg;
+    return ESP_OK;
+}
+
+// The duty jumps to the target at once; the end event arrives after the fade time
+esp_err_t ledc_set_fade_time_and_start(ledc_mode_t speed_mode, ledc_channel_t channel,
+                                       uint32_t target_duty, uint32_t max_fade_time_ms,
+                                       ledc_fade_mode_t fade_mode) {
+    if (channel < 0 || channel >= LEDC_CHANNELS) return ESP_FAIL;
+    ledc[channel].duty = target_duty;
+    simPost(max_fade_time_ms, [speed_mode, channel, target_duty] {
+        LedcChannel& c = ledc[channel];
+        if (!c.fadeCb) return;
+        ledc_cb_param_t param = { LEDC_FADE_END_EVT, (uint32_t)speed_mode, (uint32_t)channel, target_duty };
+        c.fadeCb(&param, c.fadeArg);
+    });
+    return ESP_OK;
+}
+
+// ============================================================================
+// NEOPIXEL, ENCODER
+// ============================================================================
+
+static Adafruit_NeoPixel* neoPixels = nullptr;
+
+Adafruit_NeoPixel::Adafruit_NeoPixel(uint16_t n, int16_t pin, uint16_t type)
+    : count(std::min<uint16_t>(n, MAX_PIXELS)) {
+    neoPixels = this;
+}
+
+void Adafruit_NeoPixel::show() {
+    memcpy(shown, pixels, sizeof(shown));
+    shows++;
+}
+
+void simNeoPixelDump() {
+    if (!neoPixels) return;
+    for (int i = 0; i < neoPixels->numPixels(); i++) {
+        simLog("Pixel %d #%06lX (%lu shows)", i, (unsigned long)neoPixels->shown[i],
+               (unsigned long)neoPixels->shows);
+    }
+}
+
+puType ESP32Encoder::useInternalWeakPullResistors = puType::up;
+static ESP32Encoder* encoders = nullptr;
+
+ESP32Encoder::ESP32Encoder() {
+    next = encoders;
+    encoders = this;
+}
+
+void ESP32Encoder::attachFullQuad(int aPin, int bPin) {
+    pinA = aPin;
+    pinB = bPin;
+    pinMode(aPin, INPUT_PULLUP);
+    pinMode(bPin, INPUT_PULLUP);
+}
+
+// Quadrature: A leads B clockwise, B leads A counter-clockwise; one edge per pulse
+void ESP32Encoder::simTurn(int pulses) {
+    for (ESP32Encoder* e = encoders; e; e = e->next) {
+        if (e->pinA < 0) continue;
+        int step = pulses > 0 ? 1 : -1;
+        for (int i = 0; i != pulses; i += step) {
+            e->count += step;
+            bool first = (i % 2 == 0) == (step > 0);
+            int pin = first ? e->pinA : e->pinB;
+            simSetPin(pin, digitalRead((uint8_t)pin) == HIGH ? LOW : HIGH);
+        }
+    }
+}
+
+// ============================================================================
+// ESP SYSTEM
+// ============================================================================
+
+static const uint32_t HEAP_SIZE = 327680;
+static const uint32_t HEAP_FREE = 245760;
+static const uint32_t HEAP_LARGEST = 110592;
+static const uint32_t HEAP_MIN_FREE = 237568;
+
+void EspClass::restart() {
+    simLog("Restart requested, exiting");
+    simExit(0);
+}
+
+uint32_t EspClass::getHeapSize() { return HEAP_SIZE; }
+uint32_t EspClass::getFreeHeap() { return HEAP_FREE; }
+uint32_t EspClass::getMinFreeHeap() { return HEAP_MIN_FREE; }
+uint32_t EspClass::getMaxAllocHeap() { return HEAP_LARGEST; }
+
+size_t heap_caps_get_free_size(uint32_t caps) { return HEAP_FREE; }
+size_t heap_caps_get_minimum_free_size(uint32_t caps) { return HEAP_MIN_FREE; }
+size_t heap_caps_get_largest_free_block(uint32_t caps) { return HEAP_LARGEST; }
+
+esp_reset_reason_t esp_reset_reason() {
+    return ESP_RST_POWERON;
+}
+
+esp_err_t esp_efuse_mac_get_default(uint8_t* mac) {
+    const uint8_t addr[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, simOptions.mac };
+    memcpy(mac, addr, sizeof(addr));
+    return ESP_OK;
+}
+
+static const esp_partition_t appSlots[2] = {
+    { "app0", 0x10000, 0x330000 },
+    { "app1", 0x340000, 0x330000 },
+};
+
+const esp_partition_t* esp_ota_get_running_partition() {
+    return &appSlots[0];
+}
+
+const esp_partition_t* esp_ota_get_next_update_partition(const esp_partition_t* start_from) {
+    return &appSlots[1];
+}
+
+int esp_rom_printf(const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int n = vfprintf(stderr, fmt, args);
+    va_end(args);
+    return n;
+}
+
+long random(long howbig) {
+    return howbig > 0 ? (long)(((uint64_t)rand() << 16 ^ (uint64_t)rand()) % (uint64_t)howbig) : 0;
+}
+
+long random(long howsmall, long howbig) {
+    return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed) {
+    srand((unsigned)seed);
+}
+
+String IPAddress::toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", bytes[0], bytes[1], bytes[2], bytes[3]);
+    return String(buf);
+}
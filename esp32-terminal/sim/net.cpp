@@ -0,0 +1,443 @@
+// Network shims over host sockets: WiFiUDP (discovery) and WebSocketsClient (RFC 6455,
+// client side: masked frames out, ping/pong, close, continuation frames in)
+
+#include "sim.h"
+#include <WebSocketsClient.h>
+#include <WiFiUdp.h>
+#include <algorithm>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "config.h"
+
+// ============================================================================
+// UDP
+// ============================================================================
+
+uint8_t WiFiUDP::begin(uint16_t port) {
+    stop();
+    fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+    if (fd < 0) return 0;
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        stop();
+        return 0;
+    }
+    return 1;
+}
+
+void WiFiUDP::stop() {
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+    rxLen = rxPos = 0;
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port) {
+    dest = ip;
+    destPort = port;
+    txLen = 0;
+    return fd >= 0;
+}
+
+size_t WiFiUDP::write(const uint8_t* buf, size_t len) {
+    len = std::min(len, (size_t)(MAX_DATAGRAM - txLen));
+    memcpy(tx + txLen, buf, len);
+    txLen += (int)len;
+    return len;
+}
+
+int WiFiUDP::endPacket() {
+    if (fd < 0) return 0;
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(destPort);
+    if (dest == IPAddress(255, 255, 255, 255)) {
+        if (inet_pton(AF_INET, simOptions.discoverHost, &addr.sin_addr) != 1) return 0;
+    } else {
+        uint8_t b[4] = { dest[0], dest[1], dest[2], dest[3] };
+        memcpy(&addr.sin_addr, b, 4);
+    }
+    return sendto(fd, tx, txLen, 0, (sockaddr*)&addr, sizeof(addr)) == txLen;
+}
+
+int WiFiUDP::parsePacket() {
+    rxLen = rxPos = 0;
+    if (fd < 0) return 0;
+    sockaddr_in from = {};
+    socklen_t fromLen = sizeof(from);
+    ssize_t n = recvfrom(fd, rx, sizeof(rx), 0, (sockaddr*)&from, &fromLen);
+    if (n <= 0) return 0;
+    const uint8_t* b = (const uint8_t*)&from.sin_addr.s_addr;
+    remote = IPAddress(b[0], b[1], b[2], b[3]);
+    remotePortNum = ntohs(from.sin_port);
+    rxLen = (int)n;
+    return rxLen;
+}
+
+int WiFiUDP::read(uint8_t* buf, size_t len) {
+    int n = std::min((int)len, rxLen - rxPos);
+    memcpy(buf, rx + rxPos, n);
+    rxPos += n;
+    return n;
+}
+
+// ============================================================================
+// WEBSOCKET
+// ============================================================================
+
+enum Opcode : uint8_t {
+    OP_CONTINUATION = 0x0, OP_TEXT = 0x1, OP_BINARY = 0x2,
+    OP_CLOSE = 0x8, OP_PING = 0x9, OP_PONG = 0xA,
+};
+
+static const uint32_t CONNECT_TIMEOUT_MS = 2000;
+
+static std::string base64(const uint8_t* data, size_t len) {
+    static const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = data[i] << 16 | (i + 1 < len ? data[i + 1] << 8 : 0) | (i + 2 < len ? data[i + 2] : 0);
+        out += digits[v >> 18 & 63];
+        out += digits[v >> 12 & 63];
+        out += i + 1 < len ? digits[v >> 6 & 63] : '=';
+        out += i + 2 < len ? digits[v & 63] : '=';
+    }
+    return out;
+}
+
+WebSocketsClient::~WebSocketsClient() {
+    if (fd >= 0) ::close(fd);
+}
+
+void WebSocketsClient::begin(const char* h, uint16_t p, const char* u, const char* proto) {
+    host = h;
+    port = p;
+    url = u;
+    protocol = proto;
+    started = true;
+    connectNow = true;
+}
+
+void WebSocketsClient::enableHeartbeat(uint32_t interval, uint32_t timeout, uint8_t count) {
+    pingIntervalMs = interval;
+    pongTimeoutMs = timeout;
+    disconnectTimeoutCount = count;
+    pongTimeouts = 0;
+    pongPending = false;
+    lastPingMs = millis();
+}
+
+void WebSocketsClient::event(WStype_t type, uint8_t* payload, size_t length) {
+    if (onEventCb) onEventCb(type, payload, length);
+}
+
+// Blocking connect (bounded), then the socket goes non-blocking for reads
+bool WebSocketsClient::connectSocket() {
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* res = nullptr;
+    char portStr[8];
+    snprintf(portStr, sizeof(portStr), "%u", port);
+    if (getaddrinfo(host.c_str(), portStr, &hints, &res) != 0 || !res) return false;
+
+    fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    bool ok = fd >= 0;
+    if (ok && connect(fd, res->ai_addr, res->ai_addrlen) < 0) {
+        pollfd pfd = { fd, POLLOUT, 0 };
+        int err = 0;
+        socklen_t errLen = sizeof(err);
+        ok = errno == EINPROGRESS && poll(&pfd, 1, CONNECT_TIMEOUT_MS) == 1 &&
+             getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &errLen) == 0 && err == 0;
+    }
+    freeaddrinfo(res);
+    if (!ok) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+        return false;
+    }
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    return true;
+}
+
+void WebSocketsClient::close(bool notify) {
+    bool wasConnected = state == State::CONNECTED;
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+    state = State::DISCONNECTED;
+    rx.clear();
+    message.clear();
+    pongPending = false;
+    lastAttemptMs = millis();
+    if (notify && wasConnected) event(WStype_DISCONNECTED, nullptr, 0);
+}
+
+void WebSocketsClient::disconnect() {
+    if (state == State::CONNECTED) {
+        uint8_t frame[WEBSOCKETS_MAX_HEADER_SIZE + 2];
+        frame[WEBSOCKETS_MAX_HEADER_SIZE] = 1000 >> 8;      // Normal closure
+        frame[WEBSOCKETS_MAX_HEADER_SIZE + 1] = 1000 & 0xFF;
+        sendFrame(OP_CLOSE, frame, 2, true);
+    }
+    close(true);
+}
+
+void WebSocketsClient::loop() {
+    if (!started) return;
+
+    if (state == State::DISCONNECTED) {
+        unsigned long now = millis();
+        if (!connectNow && now - lastAttemptMs < reconnectIntervalMs) return;
+        connectNow = false;
+        lastAttemptMs = now;
+        if (!connectSocket()) return;
+
+        uint8_t key[16];
+        for (uint8_t& b : key) b = (uint8_t)random(256);
+        char request[512];
+        int n = snprintf(request, sizeof(request),
+                         "GET %s HTTP/1.1\r\nHost: %s:%u\r\nConnection: Upgrade\r\nUpgrade: websocket\r\n"
+                         "Sec-WebSocket-Version: 13\r\nSec-WebSocket-Key: %s\r\n"
+                         "Sec-WebSocket-Protocol: %s\r\nUser-Agent: arduino-WebSocket-Client\r\n\r\n",
+                         url.c_str(), host.c_str(), port, base64(key, sizeof(key)).c_str(), protocol.c_str());
+        if (!writeAll((const uint8_t*)request, n)) {
+            close(false);
+            return;
+        }
+        state = State::HANDSHAKE;
+    }
+
+    uint8_t buf[4096];
+    for (;;) {
+        ssize_t n = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+        if (n > 0) {
+            rx.insert(rx.end(), buf, buf + n);
+            continue;
+        }
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            close(true);
+            return;
+        }
+        break;
+    }
+
+    if (state == State::HANDSHAKE && !readHandshake()) return;
+    if (state == State::CONNECTED && readFrames()) heartbeat();
+}
+
+// True once the 101 response is in; a refused upgrade closes the socket
+bool WebSocketsClient::readHandshake() {
+    static const char END[] = "\r\n\r\n";
+    auto end = std::search(rx.begin(), rx.end(), END, END + 4);
+    if (end == rx.end()) return false;
+    std::string response(rx.begin(), end);
+    rx.erase(rx.begin(), end + 4);
+    if (response.compare(0, 12, "HTTP/1.1 101") != 0) {
+        simLog("WebSocket upgrade refused: %.40s", response.c_str());
+        close(false);
+        return false;
+    }
+    state = State::CONNECTED;
+    pongTimeouts = 0;
+    lastPingMs = millis();
+    std::string path = url;
+    event(WStype_CONNECTED, (uint8_t*)&path[0], path.size());
+    return state == State::CONNECTED;
+}
+
+// Deliver every complete frame in rx; false if the connection went away meanwhile
+bool WebSocketsClient::readFrames() {
+    size_t pos = 0;
+    while (state == State::CONNECTED) {
+        size_t avail = rx.size() - pos;
+        if (avail < 2) break;
+        const uint8_t* h = rx.data() + pos;
+        bool fin = h[0] & 0x80;
+        uint8_t opcode = h[0] & 0x0F;
+        bool masked = h[1] & 0x80;
+        uint64_t len = h[1] & 0x7F;
+        size_t headerLen = 2;
+        if (len == 126) {
+            if (avail < 4) break;
+            len = (uint64_t)h[2] << 8 | h[3];
+            headerLen = 4;
+        } else if (len == 127) {
+            if (avail < 10) break;
+            len = 0;
+            for (int i = 0; i < 8; i++) len = len << 8 | h[2 + i];
+            headerLen = 10;
+        }
+        uint8_t mask[4] = {};
+        if (masked) {
+            if (avail < headerLen + 4) break;
+            memcpy(mask, h + headerLen, 4);
+            headerLen += 4;
+        }
+        if (avail < headerLen + len) break;
+
+        // Payload plus a terminator, as the library hands text over
+        std::vector<uint8_t> payload(h + headerLen, h + headerLen + len);
+        for (size_t i = 0; masked && i < payload.size(); i++) payload[i] ^= mask[i % 4];
+        pos += headerLen + len;
+
+        if (opcode == OP_CONTINUATION || (!fin && (opcode == OP_TEXT || opcode == OP_BINARY))) {
+            if (opcode != OP_CONTINUATION) {
+                message.clear();
+                messageOpcode = opcode;
+            }
+            message.insert(message.end(), payload.begin(), payload.end());
+            if (!fin) continue;
+            payload.swap(message);
+            message.clear();
+            opcode = messageOpcode;
+        }
+        payload.push_back(0);
+        dispatch(opcode, payload.data(), payload.size() - 1);
+    }
+    if (state != State::CONNECTED) return false;
+    rx.erase(rx.begin(), rx.begin() + pos);
+    return true;
+}
+
+void WebSocketsClient::dispatch(uint8_t opcode, uint8_t* payload, size_t length) {
+    switch (opcode) {
+        case OP_TEXT:
+            event(WStype_TEXT, payload, length);
+            break;
+        case OP_BINARY:
+            event(WStype_BIN, payload, length);
+            break;
+        case OP_PING: {
+            std::vector<uint8_t> pong(WEBSOCKETS_MAX_HEADER_SIZE + length);
+            memcpy(pong.data() + WEBSOCKETS_MAX_HEADER_SIZE, payload, length);
+            sendFrame(OP_PONG, pong.data(), length, true);
+            event(WStype_PING, payload, length);
+            break;
+        }
+        case OP_PONG:
+            pongPending = false;
+            pongTimeouts = 0;
+            event(WStype_PONG, payload, length);
+            break;
+        case OP_CLOSE: {
+            uint8_t frame[WEBSOCKETS_MAX_HEADER_SIZE + 2];
+            size_t n = std::min(length, (size_t)2);
+            memcpy(frame + WEBSOCKETS_MAX_HEADER_SIZE, payload, n);
+            sendFrame(OP_CLOSE, frame, n, true);
+            close(true);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void WebSocketsClient::heartbeat() {
+    if (pingIntervalMs == 0) return;
+    unsigned long now = millis();
+    if (pongPending && pongTimeoutMs > 0 && now - lastPingMs > pongTimeoutMs) {
+        pongPending = false;
+        if (++pongTimeouts >= disconnectTimeoutCount && disconnectTimeoutCount > 0) {
+            simLog("WebSocket heartbeat: %u pongs missed, disconnecting", pongTimeouts);
+            disconnect();
+            return;
+        }
+    }
+    if (!pongPending && now - lastPingMs >= pingIntervalMs) {
+        sendPing();
+        pongPending = true;
+        lastPingMs = now;
+    }
+}
+
+bool WebSocketsClient::writeAll(const uint8_t* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            pollfd pfd = { fd, POLLOUT, 0 };
+            if (poll(&pfd, 1, CONNECT_TIMEOUT_MS) == 1) continue;
+        }
+        if (n <= 0) return false;
+        data += n;
+        len -= n;
+    }
+    return true;
+}
+
+// headerToPayload: payload starts WEBSOCKETS_MAX_HEADER_SIZE bytes before the data and
+// the header is built in that space, so the frame goes out in one write without a copy.
+// Nothing the firmware sends exceeds WS_TX_MAX; refusing more also keeps the copy size
+// below from wrapping.
+bool WebSocketsClient::sendFrame(uint8_t opcode, uint8_t* payload, size_t length, bool headerToPayload) {
+    if (fd < 0 || (state != State::CONNECTED && opcode != OP_CLOSE)) return false;
+    if (length > WS_TX_MAX) return false;
+    std::vector<uint8_t> copy;
+    if (!headerToPayload) {
+        copy.resize(WEBSOCKETS_MAX_HEADER_SIZE + length);
+        memcpy(copy.data() + WEBSOCKETS_MAX_HEADER_SIZE, payload, length);
+        payload = copy.data();
+    }
+    uint8_t* data = payload + WEBSOCKETS_MAX_HEADER_SIZE;
+
+    uint8_t header[WEBSOCKETS_MAX_HEADER_SIZE];
+    size_t headerLen = 2;
+    header[0] = 0x80 | opcode;
+    if (length < 126) {
+        header[1] = 0x80 | (uint8_t)length;
+    } else if (length <= 0xFFFF) {
+        header[1] = 0x80 | 126;
+        header[2] = (uint8_t)(length >> 8);
+        header[3] = (uint8_t)length;
+        headerLen = 4;
+    } else {
+        header[1] = 0x80 | 127;
+        for (int i = 0; i < 8; i++) header[2 + i] = (uint8_t)((uint64_t)length >> (56 - 8 * i));
+        headerLen = 10;
+    }
+    uint8_t* mask = header + headerLen;
+    for (int i = 0; i < 4; i++) mask[i] = (uint8_t)random(256);
+    headerLen += 4;
+    for (size_t i = 0; i < length; i++) data[i] ^= mask[i % 4];
+
+    uint8_t* frame = data - headerLen;
+    memcpy(frame, header, headerLen);
+    if (!writeAll(frame, headerLen + length)) {
+        close(true);
+        return false;
+    }
+    return true;
+}
+
+bool WebSocketsClient::sendTXT(uint8_t* payload, size_t length, bool headerToPayload) {
+    if (length == 0) length = strlen((const char*)payload + (headerToPayload ? WEBSOCKETS_MAX_HEADER_SIZE : 0));
+    return sendFrame(OP_TEXT, payload, length, headerToPayload);
+}
+
+bool WebSocketsClient::sendTXT(const char* payload, size_t length) {
+    return sendTXT((uint8_t*)payload, length ? length : strlen(payload), false);
+}
+
+bool WebSocketsClient::sendBIN(uint8_t* payload, size_t length, bool headerToPayload) {
+    return sendFrame(OP_BINARY, payload, length, headerToPayload);
+}
+
+bool WebSocketsClient::sendBIN(const uint8_t* payload, size_t length) {
+    return sendFrame(OP_BINARY, (uint8_t*)payload, length, false);
+}
+
+bool WebSocketsClient::sendPing(uint8_t* payload, size_t length) {
+    std::vector<uint8_t> frame(WEBSOCKETS_MAX_HEADER_SIZE + length);
+    if (length > 0) memcpy(frame.data() + WEBSOCKETS_MAX_HEADER_SIZE, payload, length);
+    return sendFrame(OP_PING, frame.data(), length, true);
+}
@@ -0,0 +1,116 @@
+// Preferences shim — a line per key in the store file: namespace, key, value bytes in hex
+
+#include "sim.h"
+#include <Preferences.h>
+#include <map>
+#include <string>
+#include <vector>
+
+typedef std::vector<uint8_t> Value;
+typedef std::map<std::string, std::map<std::string, Value>> Store;
+
+// Loaded at the first begin(); Preferences is only used by the loop task
+static Store& store() {
+    static Store s;
+    static bool loaded = false;
+    if (loaded) return s;
+    loaded = true;
+    FILE* f = fopen(simOptions.nvsPath, "r");
+    if (!f) return s;
+    char ns[32], key[32], hex[1024];
+    while (fscanf(f, "%31s %31s %1023s", ns, key, hex) == 3) {
+        Value v;
+        for (const char* p = hex; p[0] && p[1]; p += 2) {
+            unsigned byte;
+            if (sscanf(p, "%2x", &byte) != 1) break;
+            v.push_back((uint8_t)byte);
+        }
+        s[ns][key] = v;
+    }
+    fclose(f);
+    return s;
+}
+
+static void save() {
+    FILE* f = fopen(simOptions.nvsPath, "w");
+    if (!f) {
+        simLog("Cannot write %s", simOptions.nvsPath);
+        return;
+    }
+    for (const auto& ns : store()) {
+        for (const auto& kv : ns.second) {
+            fprintf(f, "%s %s ", ns.first.c_str(), kv.first.c_str());
+            for (uint8_t b : kv.second) fprintf(f, "%02x", b);
+            fputc('\n', f);
+        }
+    }
+    fclose(f);
+}
+
+bool Preferences::begin(const char* name, bool ro, const char* partition) {
+    if (open) end();
+    Store& s = store();
+    if (ro && s.find(name) == s.end()) return false;
+    ns = name;
+    readOnly = ro;
+    dirty = false;
+    open = true;
+    return true;
+}
+
+void Preferences::end() {
+    if (open && dirty) save();
+    open = false;
+    dirty = false;
+}
+
+bool Preferences::isKey(const char* key) {
+    if (!open) return false;
+    const auto& keys = store()[ns];
+    return keys.find(key) != keys.end();
+}
+
+bool Preferences::remove(const char* key) {
+    if (!open || readOnly) return false;
+    dirty = store()[ns].erase(key) > 0 || dirty;
+    return true;
+}
+
+bool Preferences::clear() {
+    if (!open || readOnly) return false;
+    store()[ns].clear();
+    dirty = true;
+    return true;
+}
+
+size_t Preferences::put(const char* key, const void* value, size_t len) {
+    // Keys are at most 15 characters on NVS; the store file needs them without spaces
+    if (!open || readOnly || strlen(key) > 15 || strchr(key, ' ')) return 0;
+    const uint8_t* bytes = (const uint8_t*)value;
+    store()[ns][key] = Value(bytes, bytes + len);
+    dirty = true;
+    return len;
+}
+
+bool Preferences::get(const char* key, void* out, size_t len) {
+    if (!open) return false;
+    const auto& keys = store()[ns];
+    auto it = keys.find(key);
+    if (it == keys.end() || it->second.size() != len) return false;
+    memcpy(out, it->second.data(), len);
+    return true;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!open) return 0;
+    const auto& keys = store()[ns];
+    auto it = keys.find(key);
+    return it == keys.end() ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+    size_t len = getBytesLength(key);
+    if (len == 0 || len > maxLen) return 0;
+    get(key, buf, len);
+    return len;
+}
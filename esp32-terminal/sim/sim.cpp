@@ -0,0 +1,381 @@
+// Host simulator entry point: options, the hardware event queue, FreeRTOS tasks as
+// threads, and stdin — serial input for the firmware's console, or a '!' control that
+// works the buttons, the dial and the leads, or shows the screen and LEDs.
+
+#include "sim.h"
+#include <Arduino.h>
+#include <ESP32Encoder.h>
+#include <stdarg.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "config.h"
+
+void setup();
+void loop();
+
+SimOptions simOptions;
+
+// ============================================================================
+// CLOCK AND EVENTS
+// ============================================================================
+
+uint64_t simMicros() {
+    static const auto start = std::chrono::steady_clock::now();
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+static std::mutex eventMutex;
+static std::condition_variable eventCv;
+static uint64_t wakeSeq = 0;            // Bumped by every post and notification
+// Never freed: the stdin thread may still post while the process exits
+static auto* events = new std::multimap<uint64_t, std::function<void()>>();
+
+void simPost(uint32_t delayMs, std::function<void()> fn) {
+    std::lock_guard<std::mutex> lock(eventMutex);
+    events->emplace(simMicros() + delayMs * 1000ULL, std::move(fn));
+    wakeSeq++;
+    eventCv.notify_all();
+}
+
+void simWake() {
+    std::lock_guard<std::mutex> lock(eventMutex);
+    wakeSeq++;
+    eventCv.notify_all();
+}
+
+static void runDueEvents() {
+    for (;;) {
+        std::function<void()> fn;
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            if (events->empty() || events->begin()->first > simMicros()) return;
+            fn = std::move(events->begin()->second);
+            events->erase(events->begin());
+        }
+        fn();
+    }
+}
+
+bool simWait(uint64_t timeoutUs, const std::function<bool()>& done) {
+    const bool onLoop = simOnLoopTask();
+    const uint64_t deadline = simMicros() + timeoutUs;
+    for (;;) {
+        uint64_t seen;
+        {
+            std::lock_guard<std::mutex> lock(eventMutex);
+            seen = wakeSeq;
+        }
+        if (onLoop) runDueEvents();
+        if (done()) return true;
+
+        uint64_t now = simMicros();
+        if (now >= deadline) return false;
+        std::unique_lock<std::mutex> lock(eventMutex);
+        uint64_t until = deadline;
+        if (onLoop && !events->empty()) until = std::min(until, events->begin()->first);
+        if (until > now) {
+            eventCv.wait_for(lock, std::chrono::microseconds(until - now),
+                             [&] { return wakeSeq != seen; });
+        }
+    }
+}
+
+// ============================================================================
+// TASKS
+// ============================================================================
+
+struct SimTask {
+    const char* name;
+    uint32_t stackDepth;
+    std::atomic<uint32_t> notifications{0};
+};
+
+static SimTask loopTask{ "loopTask", 8192 };
+static thread_local SimTask* currentTask = nullptr;
+
+// Shutdown: tasks park at their next vTaskDelay so nothing runs during exit()
+static std::atomic<bool> parking{false};
+static std::atomic<int> taskThreads{0};
+static std::atomic<int> parkedThreads{0};
+
+bool simOnLoopTask() {
+    return currentTask == &loopTask;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth,
+                                   void* arg, UBaseType_t priority, TaskHandle_t* created,
+                                   BaseType_t core) {
+    SimTask* task = new SimTask{ name, stackDepth };
+    if (created) *created = task;
+    taskThreads++;
+    std::thread([fn, arg, task] {
+        currentTask = task;
+        fn(arg);
+    }).detach();
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* arg,
+                       UBaseType_t priority, TaskHandle_t* created) {
+    return xTaskCreatePinnedToCore(fn, name, stackDepth, arg, priority, created, tskNO_AFFINITY);
+}
+
+void vTaskDelay(TickType_t ticks) {
+    if (simOnLoopTask()) {
+        simWait(ticks * 1000ULL, [] { return false; });
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+    if (parking) {
+        parkedThreads++;
+        for (;;) std::this_thread::sleep_for(std::chrono::hours(1));
+    }
+}
+
+TickType_t xTaskGetTickCount() {
+    return (TickType_t)(simMicros() / 1000);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    return currentTask;
+}
+
+const char* pcTaskGetName(TaskHandle_t task) {
+    task = task ? task : currentTask;
+    return task ? task->name : "?";
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    task = task ? task : currentTask;
+    return task ? task->stackDepth : 0;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    SimTask* task = currentTask;
+    uint64_t timeoutUs = ticks == portMAX_DELAY ? UINT64_MAX / 2 : ticks * 1000ULL;
+    simWait(timeoutUs, [task] { return task->notifications.load() > 0; });
+    if (clearOnExit) return task->notifications.exchange(0);
+    uint32_t n = task->notifications.load();
+    while (n > 0 && !task->notifications.compare_exchange_weak(n, n - 1)) {}
+    return n;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    if (task) {
+        task->notifications++;
+        simWake();
+    }
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken) {
+    xTaskNotifyGive(task);
+    if (higherPriorityTaskWoken) *higherPriorityTaskWoken = pdTRUE;
+}
+
+// ============================================================================
+// SERIAL
+// ============================================================================
+
+HardwareSerial Serial;
+
+static std::mutex serialMutex;
+static std::deque<char> serialRx;
+
+int HardwareSerial::available() {
+    std::lock_guard<std::mutex> lock(serialMutex);
+    return (int)serialRx.size();
+}
+
+int HardwareSerial::read() {
+    std::lock_guard<std::mutex> lock(serialMutex);
+    if (serialRx.empty()) return -1;
+    char c = serialRx.front();
+    serialRx.pop_front();
+    return (uint8_t)c;
+}
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t len) {
+    size_t n = fwrite(buf, 1, len, stdout);
+    fflush(stdout);
+    return n;
+}
+
+size_t HardwareSerial::printf(const char* fmt, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    return n > 0 ? write((const uint8_t*)buf, std::min<size_t>(n, sizeof(buf) - 1)) : 0;
+}
+
+void HardwareSerial::flush() {
+    fflush(stdout);
+}
+
+void simLog(const char* fmt, ...) {
+    char buf[256];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    fprintf(stdout, "[Sim] %s\n", buf);
+    fflush(stdout);
+}
+
+// ============================================================================
+// CONTROLS
+// ============================================================================
+
+static std::atomic<bool> quitRequested{false};
+
+static void pressButton(int pin, uint32_t holdMs) {
+    simSetPin(pin, LOW);
+    simPost(holdMs, [pin] { simSetPin(pin, HIGH); });
+}
+
+static const char* const CONTROL_HELP =
+    "Controls (a line starting with '!'; anything else goes to the serial console):\n"
+    "  !y !n !s    tap YES / NO / the encoder switch\n"
+    "  !Y !N       hold YES / NO for a long press\n"
+    "  !S          hold the encoder switch until the terminal restarts\n"
+    "  !u !d       turn the dial one detent up / down\n"
+    "  !l          leads off / on\n"
+    "  !screen     text on the panel        !pbm FILE  panel as a PBM image\n"
+    "  !leds       LED and pixel state      !quit      exit\n";
+
+// Loop task
+static void runControl(const std::string& control) {
+    const char* c = control.c_str();
+    if (control == "y") pressButton(PIN_BTN_YES, 150);
+    else if (control == "n") pressButton(PIN_BTN_NO, 150);
+    else if (control == "s") pressButton(PIN_ENCODER_SW, 150);
+    else if (control == "Y") pressButton(PIN_BTN_YES, 1000);
+    else if (control == "N") pressButton(PIN_BTN_NO, 1000);
+    else if (control == "S") pressButton(PIN_ENCODER_SW, 5500);
+    else if (control == "u") ESP32Encoder::simTurn(-ENCODER_PULSES_PER_DETENT);
+    else if (control == "d") ESP32Encoder::simTurn(ENCODER_PULSES_PER_DETENT);
+    else if (control == "l") {
+        int off = simPinLevel(PIN_AD8232_LOP) == HIGH ? LOW : HIGH;
+        simSetPin(PIN_AD8232_LOP, off);
+        simLog("Leads %s", off == HIGH ? "off" : "on");
+    }
+    else if (control == "screen") simDisplayDump();
+    else if (strncmp(c, "pbm ", 4) == 0) {
+        if (simDisplayWritePbm(c + 4)) simLog("Panel written to %s", c + 4);
+        else simLog("Cannot write %s", c + 4);
+    }
+    else if (control == "leds") {
+        simLog("YES %lu, NO %lu, power %lu (of %d), heartbeat LED %s",
+               (unsigned long)simLedcDuty(PWM_CHANNEL_YES), (unsigned long)simLedcDuty(PWM_CHANNEL_NO),
+               (unsigned long)simLedcDuty(PWM_CHANNEL_POWER), (1 << PWM_RESOLUTION) - 1,
+               simPinLevel(PIN_LED_HEARTBEAT) == HIGH ? "on" : "off");
+        simNeoPixelDump();
+    }
+    else if (control == "quit") quitRequested = true;
+    else fputs(CONTROL_HELP, stdout);
+}
+
+static void stdinReader() {
+    char line[256];
+    while (fgets(line, sizeof(line), stdin)) {
+        if (line[0] == '!') {
+            std::string control(line + 1);
+            while (!control.empty() && (control.back() == '\n' || control.back() == '\r')) control.pop_back();
+            simPost(0, [control] { runControl(control); });
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(serialMutex);
+            serialRx.insert(serialRx.end(), line, line + strlen(line));
+        }
+        simWake();
+    }
+}
+
+// --keys: comma-separated controls, played once setup() is through
+static void scheduleKeys(const char* keys) {
+    uint32_t at = 1500;
+    while (keys && *keys) {
+        const char* end = strchr(keys, ',');
+        std::string control(keys, end ? end - keys : strlen(keys));
+        simPost(at, [control] { runControl(control); });
+        at += 400;
+        keys = end ? end + 1 : nullptr;
+    }
+}
+
+// ============================================================================
+// EXIT
+// ============================================================================
+
+void simExit(int code) {
+    // Let the log drain task empty the ring, then park every task
+    std::this_thread::sleep_for(std::chrono::milliseconds(LOG_DRAIN_MS * 3));
+    parking = true;
+    for (int i = 0; i < 200 && parkedThreads < taskThreads; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    fflush(stdout);
+    exit(code);
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  --run-ms N        exit after N ms (default: run until !quit)\n"
+            "  --keys LIST       controls to play after boot, e.g. d,d,y (player 3)\n"
+            "  --nvs FILE        Preferences store (default sim-nvs.txt)\n"
+            "  --discover HOST   where discovery broadcasts go (default 127.0.0.1)\n"
+            "  --bpm N           synthetic heart rate (default 72)\n"
+            "  --mac N           last MAC byte, 0-255 (default 94)\n"
+            "%s", prog, CONTROL_HELP);
+}
+
+static bool parseArgs(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        const char* opt = argv[i];
+        const char* val = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (strcmp(opt, "--help") == 0 || strcmp(opt, "-h") == 0 || !val) return false;
+        if (strcmp(opt, "--run-ms") == 0) simOptions.runMs = strtoul(val, nullptr, 10);
+        else if (strcmp(opt, "--keys") == 0) simOptions.keys = val;
+        else if (strcmp(opt, "--nvs") == 0) simOptions.nvsPath = val;
+        else if (strcmp(opt, "--discover") == 0) simOptions.discoverHost = val;
+        else if (strcmp(opt, "--bpm") == 0) simOptions.bpm = std::max(20UL, strtoul(val, nullptr, 10));
+        else if (strcmp(opt, "--mac") == 0) simOptions.mac = (uint8_t)strtoul(val, nullptr, 0);
+        else return false;
+        i++;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (!parseArgs(argc, argv)) {
+        usage(argv[0]);
+        return 2;
+    }
+    currentTask = &loopTask;
+    simMicros();
+    std::thread(stdinReader).detach();
+    scheduleKeys(simOptions.keys);
+
+    setup();
+    for (;;) {
+        if (quitRequested || (simOptions.runMs > 0 && simMicros() >= simOptions.runMs * 1000ULL)) {
+            simExit(0);
+        }
+        loop();
+    }
+}
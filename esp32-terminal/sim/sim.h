@@ -0,0 +1,58 @@
+// Simulator core — what the Arduino/ESP-IDF shims share. The firmware runs unchanged:
+// setup() and loop() on the main thread (the loop task), xTaskCreate tasks on their own
+// threads. Interrupt handlers and timer callbacks are queued as events and run on the
+// loop task at its next wait (delay, vTaskDelay, ulTaskNotifyTake), as they would on the
+// loop's core; the log drain and stall watchdog tasks really run beside it.
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <functional>
+
+struct SimOptions {
+    const char* nvsPath = "sim-nvs.txt";        // Preferences store
+    const char* discoverHost = "127.0.0.1";     // Where discovery broadcasts are sent
+    const char* keys = nullptr;                 // Controls to play after boot ("d,d,y")
+    uint32_t runMs = 0;                         // Exit after this long (0 = until quit)
+    uint32_t bpm = 72;                          // Synthetic ECG rate
+    uint8_t mac = 0x5E;                         // Last MAC byte (select screen title)
+};
+
+extern SimOptions simOptions;
+
+// Since the simulator started
+uint64_t simMicros();
+
+// Hardware event: fn runs on the loop task delayMs from now, at its next wait.
+// Safe to call from any thread.
+void simPost(uint32_t delayMs, std::function<void()> fn);
+
+// Wake the loop task if it is waiting (a task notification arrived)
+void simWake();
+
+// Loop task: run due events until done() or timeoutUs passes; true if done() ended it.
+// Other tasks just sleep (their waits never run events).
+bool simWait(uint64_t timeoutUs, const std::function<bool()>& done);
+bool simOnLoopTask();
+
+// Pins driven from outside (buttons, encoder, leads-off). Loop task only: a level change
+// runs the handler attached with attachInterruptArg.
+void simSetPin(int pin, int level);
+int simPinLevel(int pin);
+
+// Peripheral state for the "leds" control
+uint32_t simLedcDuty(int channel);
+int simAnalogRead(int pin);
+
+// Display (U8g2 shim): text drawn on the panel, and the panel as a PBM image
+void simDisplayDump();
+bool simDisplayWritePbm(const char* path);
+void simNeoPixelDump();
+
+// Flush output and exit; tasks are parked first so nothing runs during teardown
+[[noreturn]] void simExit(int code);
+
+// Sim's own messages (prefixed "[Sim] "), kept out of the firmware's log ring
+void simLog(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+#endif // SIM_H
@@ -0,0 +1,127 @@
+// U8g2 shim — drawing into the framebuffer, and the panel it is sent to
+
+#include "sim.h"
+#include <U8g2lib.h>
+#include <algorithm>
+
+const u8g2_cb_t u8g2_cb_r0 = { 0 };
+const u8g2_cb_t u8g2_cb_r2 = { 2 };
+
+const uint8_t u8g2_font_6x10_tf[] = { 6, 10, 7 };
+const uint8_t u8g2_font_10x20_tf[] = { 10, 20, 14 };
+
+static U8G2* display = nullptr;
+
+U8G2::U8G2(const u8g2_cb_t* r) : rotation(r) {
+    display = this;
+}
+
+void U8G2::plot(int x, int y) {
+    if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT) return;
+    uint8_t& px = buffer[y][x];
+    px = color == 2 ? px ^ 1 : color;
+}
+
+void U8G2::fill(int x, int y, int w, int h) {
+    int x1 = std::min(x + w, WIDTH), y1 = std::min(y + h, HEIGHT);
+    for (int py = std::max(y, 0); py < y1; py++) {
+        for (int px = std::max(x, 0); px < x1; px++) plot(px, py);
+    }
+}
+
+// Text under an area drawn over is gone (or no longer readable)
+void U8G2::eraseText(int x, int y, int w, int h) {
+    text.erase(std::remove_if(text.begin(), text.end(), [&](const Text& t) {
+        return t.x < x + w && x < t.x + t.w && t.y < y + h && y < t.y + t.h;
+    }), text.end());
+}
+
+void U8G2::clearBuffer() {
+    memset(buffer, 0, sizeof(buffer));
+    text.clear();
+}
+
+u8g2_uint_t U8G2::drawStr(u8g2_uint_t x, u8g2_uint_t y, const char* s) {
+    int cw = font[0], ch = font[1], ascent = font[2];
+    int top = (int)y - ascent;
+    int w = (int)strlen(s) * cw;
+    eraseText(x, top, w, ch);
+    if (*s) text.push_back({ (int)x, top, w, ch, s });
+    for (int i = 0; s[i]; i++) {
+        if (s[i] != ' ') fill(x + i * cw, top + 1, cw - 1, ascent - 1);
+    }
+    return (u8g2_uint_t)w;
+}
+
+void U8G2::drawBox(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h) {
+    eraseText(x, y, w, h);
+    fill(x, y, w, h);
+}
+
+void U8G2::drawFrame(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h) {
+    if (w == 0 || h == 0) return;
+    fill(x, y, w, 1);
+    fill(x, y + h - 1, w, 1);
+    fill(x, y, 1, h);
+    fill(x + w - 1, y, 1, h);
+}
+
+// XBM: rows of LSB-first bits, each row padded to a byte
+void U8G2::drawXBMP(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h, const uint8_t* bitmap) {
+    int stride = (w + 7) / 8;
+    for (int row = 0; row < h; row++) {
+        for (int col = 0; col < w; col++) {
+            if (bitmap[row * stride + col / 8] & (1 << (col % 8))) plot(x + col, y + row);
+        }
+    }
+}
+
+void U8G2::copyToPanel(int x, int y, int w, int h) {
+    for (int py = y; py < y + h; py++) memcpy(&panel[py][x], &buffer[py][x], w);
+    panelText.erase(std::remove_if(panelText.begin(), panelText.end(), [&](const Text& t) {
+        return t.x < x + w && x < t.x + t.w && t.y < y + h && y < t.y + t.h;
+    }), panelText.end());
+    for (const Text& t : text) {
+        if (t.x >= x && t.x < x + w && t.y >= y && t.y < y + h) panelText.push_back(t);
+    }
+    sends++;
+    bytesSent += (uint64_t)w * h / 2;
+}
+
+void U8G2::sendBuffer() {
+    copyToPanel(0, 0, WIDTH, HEIGHT);
+}
+
+void U8G2::updateDisplayArea(uint8_t tx, uint8_t ty, uint8_t tw, uint8_t th) {
+    int tilesW = getBufferTileWidth(), tilesH = getBufferTileHeight();
+    if (rotation->quarterTurns == 2) {
+        tx = tilesW - tx - tw;
+        ty = tilesH - ty - th;
+    }
+    if (tx + tw > tilesW || ty + th > tilesH) return;
+    copyToPanel(tx * 8, ty * 8, tw * 8, th * 8);
+}
+
+void simDisplayDump() {
+    if (!display) return;
+    std::vector<U8G2::Text> lines = display->panelText;
+    std::sort(lines.begin(), lines.end(), [](const U8G2::Text& a, const U8G2::Text& b) {
+        return a.y != b.y ? a.y < b.y : a.x < b.x;
+    });
+    simLog("Panel: %lu sends, %llu bytes", (unsigned long)display->sends,
+           (unsigned long long)display->bytesSent);
+    for (const U8G2::Text& t : lines) simLog("  %3d,%2d  %s", t.x, t.y, t.str.c_str());
+}
+
+bool simDisplayWritePbm(const char* path) {
+    if (!display) return false;
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "P1\n%d %d\n", U8G2::WIDTH, U8G2::HEIGHT);
+    for (int y = 0; y < U8G2::HEIGHT; y++) {
+        for (int x = 0; x < U8G2::WIDTH; x++) fputc(display->panel[y][x] ? '1' : '0', f);
+        fputc('\n', f);
+    }
+    fclose(f);
+    return true;
+}
@@ -0,0 +1,142 @@
+// Allocation-site counters
+//
+// With -Wl,--wrap=malloc (and calloc, realloc) every call to those in the image — Arduino
+// core, libraries and the prebuilt IDF archives alike — lands here first. The site is
+// the wrapper's return address, i.e. the instruction after the call: String churn shows
+// up as String::changeBuffer, JSON documents as ArduinoJson's allocator, and so on.
+// Xtensa's windowed ABI gives no reliable deeper frames, so one level is all there is.
+// heap_caps_malloc() callers bypass malloc and are not seen.
+//
+// The zero-heap trap (HEAP_ALLOC_TRAP) rides on the same wrappers: once armed, any
+// allocation from the loop task is recorded with the profiler scope it happened in.
+
+#include "allochook.h"
+#include "config.h"
+#include "prof.h"
+#include <Arduino.h>
+#include <esp_rom_sys.h>
+
+#if HEAP_ALLOC_SITES
+
+static portMUX_TYPE siteMux = portMUX_INITIALIZER_UNLOCKED;
+
+#if HEAP_ALLOC_TRAP
+static TaskHandle_t trapTask = nullptr;
+static uint32_t trapCount = 0;
+static AllocTrap traps[HEAP_TRAP_SITES];
+static int trapSites = 0;
+static int trapTaken = 0;
+
+// Under siteMux. The profiler stack belongs to the trapped task, so reading it here is safe.
+static void trap(uintptr_t caller, size_t bytes) {
+    trapCount++;
+    for (int i = 0; i < trapSites; i++) {
+        if (traps[i].site == caller) return;
+    }
+    if (trapSites == HEAP_TRAP_SITES) return;
+
+    ProfScope scope = ProfScope::OTHER;
+    uintptr_t scopeSite = 0;
+    profActiveScopes(&scope, &scopeSite, 1);
+    traps[trapSites++] = { caller, (uint32_t)bytes, (uint8_t)scope, scopeSite };
+}
+#endif
+
+static void count(void* caller, size_t bytes) {
+    portENTER_CRITICAL_SAFE(&siteMux);
+    heapmonCountAlloc((uintptr_t)caller, bytes);
+#if HEAP_ALLOC_TRAP
+    bool trapped = trapTask != nullptr && xTaskGetCurrentTaskHandle() == trapTask;
+    if (trapped) trap((uintptr_t)caller, bytes);
+#endif
+    portEXIT_CRITICAL_SAFE(&siteMux);
+
+#if HEAP_ALLOC_TRAP >= 2
+    if (trapped) {
+        // ROM printf: Serial would allocate. The backtrace below runs through the caller.
+        esp_rom_printf("[Heap] Allocation of %u bytes after setup from %p\n", (unsigned)bytes, caller);
+        abort();
+    }
+#endif
+}
+
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t n, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    count(__builtin_return_address(0), size);
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t n, size_t size) {
+    count(__builtin_return_address(0), n * size);
+    return __real_calloc(n, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    count(__builtin_return_address(0), size);
+    return __real_realloc(ptr, size);
+}
+}
+
+int allocHookTakeSites(HeapSite* out, int max, uint32_t* missed) {
+    portENTER_CRITICAL(&siteMux);
+    int n = heapmonTopSites(out, max);
+    *missed = heapmonSitesMissed();
+    heapmonResetSites();
+    portEXIT_CRITICAL(&siteMux);
+    return n;
+}
+
+#else
+
+int allocHookTakeSites(HeapSite* out, int max, uint32_t* missed) {
+    *missed = 0;
+    return 0;
+}
+
+#endif
+
+#if HEAP_ALLOC_SITES && HEAP_ALLOC_TRAP
+
+void allocHookArm() {
+    portENTER_CRITICAL(&siteMux);
+    trapTask = xTaskGetCurrentTaskHandle();
+    portEXIT_CRITICAL(&siteMux);
+}
+
+bool allocHookArmed() {
+    return trapTask != nullptr;
+}
+
+uint32_t allocHookTrapped() {
+    return trapCount;
+}
+
+int allocHookTakeTraps(AllocTrap* out, int max) {
+    int n = 0;
+    portENTER_CRITICAL(&siteMux);
+    while (trapTaken < trapSites && n < max) out[n++] = traps[trapTaken++];
+    portEXIT_CRITICAL(&siteMux);
+    return n;
+}
+
+#else
+
+void allocHookArm() {}
+
+bool allocHookArmed() {
+    return false;
+}
+
+uint32_t allocHookTrapped() {
+    return 0;
+}
+
+int allocHookTakeTraps(AllocTrap* out, int max) {
+    return 0;
+}
+
+#endif
@@ -0,0 +1,31 @@
+// Allocation-site counters — malloc, calloc and realloc wrapped at link time when
+// HEAP_ALLOC_SITES is built in (see platformio.ini); counted into heapmon's site table
+#ifndef ALLOCHOOK_H
+#define ALLOCHOOK_H
+
+#include "heapmon.h"
+
+// Busiest sites since the last call (the table is cleared), and how many allocations came
+// from sites the full table could not take. Returns 0 sites when the hook is not built in.
+int allocHookTakeSites(HeapSite* out, int max, uint32_t* missed);
+
+// Zero-heap trap (HEAP_ALLOC_TRAP): an allocation made by the armed task after
+// allocHookArm(), with the profiler scope open at the time and where it was entered
+struct AllocTrap {
+    uintptr_t site;         // Caller of malloc (resolve with addr2line)
+    uint32_t bytes;         // Size of the first allocation from this site
+    uint8_t scope;          // ProfScope, innermost
+    uintptr_t scopeSite;    // Where that scope was entered
+};
+
+// Start trapping the calling task's allocations. No-op unless built with HEAP_ALLOC_TRAP.
+void allocHookArm();
+bool allocHookArmed();
+
+// Allocations trapped since allocHookArm()
+uint32_t allocHookTrapped();
+
+// Callers trapped since the last call (each one is reported once); returns how many
+int allocHookTakeTraps(AllocTrap* out, int max);
+
+#endif // ALLOCHOOK_H
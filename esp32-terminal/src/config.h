@@ -91,31 +91,194 @@
 
 #define AD8232_SAMPLE_MS     4     // ~250 Hz sample rate
 #define AD8232_BEAT_FLASH_MS 80    // LED on-time per beat
+#define AD8232_FILTER_BLOCK  8     // Samples per low-pass block on the detection path (32 ms)
+#define AD8232_BPM_SEND_MS   2000  // Heartbeat report interval in bpm mode (tunable)
+
+// Detector defaults for a player slot without a stored calibration (tunable)
+#define AD8232_THRESHOLD_PCT 60    // Beat threshold, % of the rolling range above its min
+#define AD8232_MIN_RANGE     400   // Minimum ADC range, rejects T-wave false triggers
+#define AD8232_REFRACTORY_MS 400   // Dead time after a beat, ~150 BPM cap
+
+// Per-player detector calibration (learned on request, stored in NVS per player slot)
+#define AD8232_CAL_MAX_BEATS   48   // Inter-beat peaks kept for threshold estimation
+#define AD8232_CAL_MIN_BEATS   8    // Fewer beats than this and the run is discarded
+
+// Leads-off (LO+/LO- high when an electrode is disconnected)
+#define AD8232_LEADS_POLL_MS     50   // Pin poll rate while leads are off (ADC idle)
+#define AD8232_LEADS_DEBOUNCE_MS 150  // State must hold this long before it is reported
+
+// Raw waveform stream (opt-in, server requests it via heartrateMonitor.waveform)
+#define AD8232_WAVE_DECIMATE   2    // 250 Hz -> 125 Hz on the wire
+#define AD8232_WAVE_FRAME_MS   100  // Batch window per binary frame
+#define AD8232_WAVE_MAX_SAMPLES 24  // Frame capacity (headroom for loop stalls)
+
+// Local OLED trace (DisplayStyle::ECG) — 125 Hz into a ring the display drains each frame
+#define AD8232_SCOPE_DECIMATE  2
+#define AD8232_SCOPE_RING      64   // ~0.5 s of slack if the display stalls
+
+// Per-beat events (report mode "beats") — a frame goes out when either limit is hit
+#define AD8232_BEAT_BATCH_MAX  4    // Beats per frame
+#define AD8232_BEAT_BATCH_MS   1000 // Max age of the oldest queued beat
+
+// Beat-interval statistics (hrv.cpp)
+#define HRV_WINDOW          16    // Accepted R-R intervals kept (~12 s at 80 BPM)
+#define HRV_MIN_INTERVALS   3     // Below this, BPM reads 0
+#define HRV_RR_MIN_MS       300   // 200 BPM
+#define HRV_RR_MAX_MS       2000  // 30 BPM
+#define HRV_ECTOPIC_PCT     20    // Reject intervals further than this from the median
+#define HRV_REJECT_RESET    4     // Consecutive rejections that mean the rhythm really changed
+
+// Signal quality index (sqi.cpp) — each component scores 0..1 between its bad and good bounds
+#define SQI_RANGE_BAD       400   // ADC peak-to-peak (same as the detector's minimum range)
+#define SQI_RANGE_GOOD      1000
+#define SQI_NOISE_GOOD_PCT  1     // Mean |2nd difference| as % of range
+#define SQI_NOISE_BAD_PCT   5
+#define SQI_WANDER_GOOD_PCT 30    // Baseline (slow EMA) excursion as % of the drift-free range
+#define SQI_WANDER_BAD_PCT  100
+#define SQI_BEAT_HISTORY    8     // Recent beats scored for R-R regularity
 
 // ============================================================================
 // TIMING CONFIGURATION
 // ============================================================================
 
-// Button debounce time in milliseconds
+// Cooperative scheduler (sched.cpp) — task table size and loop cadences
+#define SCHED_MAX_TASKS  12
+#define APP_TICK_MS      2     // Game loop: network pump, input, frame commit
+#define SCHED_LOG_MS     60000 // [Sched] per-task runtime report
+
+// Logging (logbuf.cpp) — the loop queues records, a low-priority task writes them out.
+// Levels: 1 error, 2 warn, 3 info, 4 debug (WebSocket frame echo, per-beat lines); the
+// ones above LOG_LEVEL compile out.
+#ifndef LOG_LEVEL
+#define LOG_LEVEL        3
+#endif
+#define LOG_RING_BYTES   4096
+#define LOG_STR_MAX      200   // String argument bytes kept (a record is 255 at most)
+#define LOG_DRAIN_MS     20    // Drain task period
+// 1: raw records on the UART instead of text, decoded on the host with the firmware ELF
+// (node tools/log-decode.mjs .pio/build/esp32/firmware.elf)
+#ifndef LOG_BINARY
+#define LOG_BINARY       0
+#endif
+
+// Serial console (console.cpp) — polled by the scheduler; a poll reads at most
+// CONSOLE_BYTES_PER_POLL bytes, so a pasted block cannot hold up the loop
+#define CONSOLE_POLL_MS        20
+#define CONSOLE_BYTES_PER_POLL 64
+#define CONSOLE_LINE_MAX       80
+#define CONSOLE_MAX_ARGS       6
+
+// Runtime tunables (tunables.cpp) — the #defines marked "tunable" are only defaults;
+// saved values live in this NVS namespace and are loaded at boot
+#define TUNABLES_NVS_NAMESPACE "tunables"
+
+// Loop profiler (prof.cpp) — cycle-counter scopes; 0 compiles the scopes out
+#define PROFILE_ENABLE    1
+#define PROF_MAX_DEPTH    4
+#define PROF_SLOW_LOOP_US 4000  // Iterations longer than one heart rate sample period are blamed
+
+// Loop-stall watchdog (stall.cpp) — records survive soft resets in RTC memory
+#define STALL_THRESHOLD_MS 100   // Past the loop's planned wake-up
+#define STALL_CHECK_MS     20    // Watchdog task period
+#define STALL_RING         8     // Records kept until uploaded
+#define STALL_DEPTH        PROF_MAX_DEPTH
+
+// Heap health (heapmon.cpp) — sampled locally, pushed to the server as heapReport
+#define HEAP_SAMPLE_MS     1000
+#define HEAP_REPORT_MS     60000
+#define HEAP_SITE_SLOTS    64    // Allocation call sites tracked
+#define HEAP_REPORT_SITES  8     // Busiest sites per report
+
+// Allocation-site counters need the linker to route malloc through allochook.cpp — enable
+// them with build_flags (see platformio.ini), not here
+#ifndef HEAP_ALLOC_SITES
+#define HEAP_ALLOC_SITES   0
+#endif
+
+// Zero-heap check (needs HEAP_ALLOC_SITES): once the terminal is first connected, every
+// allocation the loop task makes is trapped. 1 counts and logs each new caller, 2 also
+// aborts on the first one so the panic backtrace names the file and line.
+#ifndef HEAP_ALLOC_TRAP
+#define HEAP_ALLOC_TRAP    0
+#endif
+#if HEAP_ALLOC_TRAP && !HEAP_ALLOC_SITES
+#error "HEAP_ALLOC_TRAP needs HEAP_ALLOC_SITES and the malloc wrappers"
+#endif
+#define HEAP_TRAP_SITES    16    // Distinct trapped callers logged
+
+// Input-to-photon latency (latency.cpp) — samples kept per game phase
+#define LATENCY_SAMPLES    32
+#define LATENCY_TIMEOUT_MS 1000  // Input with no frame / server state within this is dropped
+
+// Power manager (power.cpp) — IDLE slows the game loop; modem sleep covers the latency
+#define APP_IDLE_TICK_MS 20
+#define POWER_PROFILE    1     // Log time and sleep share per power level
+#define POWER_LOG_MS     60000
+
+// Button debounce time in milliseconds (tunable)
 #define DEBOUNCE_MS     50
 
-// Rotary encoder poll interval
+// Button hold that counts as a long press (tunable)
+#define LONG_PRESS_MS   600
+
+// Rotary encoder poll interval (tunable)
 #define ENCODER_POLL_MS  10
 
+// Target selection: selectTo goes out once the dial has rested this long (tunable)
+#define SCROLL_SETTLE_MS 150
+
 // LED pulse period in milliseconds
 #define LED_PULSE_MS    1000
 
+// Hardware fade ramps per PWM LED breath (state changes apply at the next ramp end)
+#define LED_PULSE_STEPS 10
+
+// Server-defined keyframe animations (ledanim.cpp)
+#define LED_ANIM_SLOTS      8     // Cached animations
+#define LED_ANIM_MAX_STOPS  12    // Keyframes per animation
+#define LED_ANIM_ID_LEN     16    // Including the terminator
+
 // Neopixel fade duration in milliseconds
 #define LED_FADE_MS     150
 
+// Neopixel frame interval (~60 fps)
+#define LED_FRAME_MS    16
+
 // WiFi connection timeout
 #define WIFI_TIMEOUT_MS 30000
 
 // WebSocket reconnect delay
 #define WS_RECONNECT_MS 3000
 
-// WebSocket keepalive interval during target selection fast path
-#define WS_KEEPALIVE_MS 1000
+// WebSocket ping interval, 0 = off (tunable). Two pings unanswered for WS_PONG_TIMEOUT_MS
+// drop the connection, so a dead link is noticed before TCP gives up.
+#define WS_PING_MS         0
+#define WS_PONG_TIMEOUT_MS 3000
+
+// Server clock sync exchange interval (1 s until the sample window is full)
+#define TIME_SYNC_INTERVAL_MS 10000
+
+// PLAYER_STATE "at" (server time) further ahead than this is applied immediately —
+// it means the clock offset is stale, and holding the screen that long would look hung
+#define SCHEDULE_MAX_AHEAD_MS 2000
+
+// Low-priority binary uplink (waveform etc.) — token bucket per terminal.
+// 9 terminals x 1 KB/s stays far below what the AP needs for game messages.
+#define STREAM_BUDGET_BPS   1024  // Sustained bytes/s
+#define STREAM_BURST_BYTES  256   // Bucket depth
+
+// Remote diagnostics (diag.cpp) — log lines and counters the host turns on per terminal.
+// Own budget, below the waveform's; a frame only goes out once game traffic has been
+// quiet for DIAG_QUIET_MS, and DIAG_FRAME_MAX bounds how long it can hold the socket.
+#define DIAG_RING_BYTES     2048  // Lines waiting for the uplink (kept while disconnected)
+#define DIAG_FLUSH_MS       500   // Log batching window
+#define DIAG_METRICS_MS     5000
+#define DIAG_FRAME_MAX      512
+#define DIAG_BUDGET_BPS     512   // Sustained bytes/s
+#define DIAG_QUIET_MS       150   // After a game message in either direction
+
+// Largest outgoing WebSocket frame (the profile report); frames are built in one static buffer
+#define WS_TX_MAX           4096
 
 // ============================================================================
 // ROTARY ENCODER CONFIGURATION
@@ -144,6 +307,7 @@
 #define LED_BRIGHT       255   // 100%
 #define LED_BRIGHT_NO    40    // ~16% - red LED perceived much brighter than yellow, needs heavy cap
 #define LED_POWER_BRIGHT 8    // ~3% - just a visible glow for power indicator
+#define LED_POWER_HIGH   40    // ~16% - power LED BRIGHT and PULSE peak (server-requested)
 
 // ============================================================================
 // DISPLAY CONFIGURATION
@@ -160,4 +324,12 @@
 #define FONT_SMALL_HEIGHT  12
 #define FONT_LARGE_HEIGHT  24
 
+// ECG scope (DisplayStyle::ECG) — incremental sweep, only touched tiles are sent
+#define DISPLAY_SCOPE_FRAME_MS   16    // displayUpdate() interval (~60 fps)
+#define DISPLAY_SCOPE_GAP        6     // Blank columns kept ahead of the sweep
+#define DISPLAY_SCOPE_MIN_RANGE  200   // ADC counts; smaller swings are not magnified further
+
+// New CRITICAL text blinks twice (blank / redraw steps), without blocking the loop
+#define DISPLAY_BLINK_MS         150
+
 #endif // CONFIG_H
@@ -0,0 +1,91 @@
+// Serial console
+
+#include "console.h"
+#include "logbuf.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const ConsoleCommand* commands = nullptr;
+static int commandCount = 0;
+
+static char line[CONSOLE_LINE_MAX];
+static int lineLen = 0;
+static bool overflow = false;    // Rest of an over-long line is discarded
+
+void consoleInit(const ConsoleCommand* table, int count) {
+    commands = table;
+    commandCount = count;
+    lineLen = 0;
+    overflow = false;
+}
+
+static void printHelp() {
+    LOG_OUT("Commands:");
+    for (int i = 0; i < commandCount; i++) {
+        LOG_OUT("  %-10s %-16s %s", commands[i].name, commands[i].usage, commands[i].help);
+    }
+}
+
+static bool runLine() {
+    char* argv[CONSOLE_MAX_ARGS];
+    int argc = 0;
+    char* p = line;
+    while (*p && argc < CONSOLE_MAX_ARGS) {
+        while (*p == ' ') *p++ = '\0';
+        if (!*p) break;
+        argv[argc++] = p;
+        while (*p && *p != ' ') p++;
+    }
+    if (argc == 0) return false;
+
+    if (strcmp(argv[0], "help") == 0 || strcmp(argv[0], "?") == 0) {
+        printHelp();
+        return true;
+    }
+    for (int i = 0; i < commandCount; i++) {
+        if (strcmp(argv[0], commands[i].name) == 0) {
+            commands[i].run(argc, argv);
+            return true;
+        }
+    }
+    LOG_OUT("Unknown command '%s' (help lists them)", argv[0]);
+    return false;
+}
+
+bool consoleFeed(char c) {
+    if (c == '\r' || c == '\n') {
+        bool ran = false;
+        if (overflow) {
+            LOG_OUT("Line too long (max %d characters)", CONSOLE_LINE_MAX - 1);
+        } else {
+            line[lineLen] = '\0';
+            ran = runLine();
+        }
+        lineLen = 0;
+        overflow = false;
+        return ran;
+    }
+    if (c == '\b' || c == 0x7F) {
+        if (lineLen > 0) lineLen--;
+        return false;
+    }
+    if (c == '\t') c = ' ';
+    if (c < ' ' || overflow) return false;
+    if (lineLen >= CONSOLE_LINE_MAX - 1) {
+        overflow = true;
+        return false;
+    }
+    line[lineLen++] = c;
+    return false;
+}
+
+bool consoleParseUint(const char* text, uint32_t min, uint32_t max, uint32_t* out) {
+    char* end = nullptr;
+    unsigned long v = text ? strtoul(text, &end, 10) : 0;
+    if (text == nullptr || end == text || *end != '\0' || v < min || v > max) {
+        LOG_OUT("Expected a number from %lu to %lu", (unsigned long)min, (unsigned long)max);
+        return false;
+    }
+    *out = (uint32_t)v;
+    return true;
+}
@@ -0,0 +1,31 @@
+// Serial console — line-oriented commands typed into the serial monitor. Bytes are fed
+// in as they arrive (whatever Serial.available() holds, never waiting for more); a
+// finished line is split into words and run by the matching command. Replies go
+// through the log ring (LOG_OUT), so a long report never blocks the loop on the UART.
+// consoleFeed() takes characters, not the UART, so test_console types lines at it directly.
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <stdint.h>
+#include "config.h"
+
+typedef void (*ConsoleHandler)(int argc, char** argv);   // argv[0] is the command name
+
+struct ConsoleCommand {
+    const char* name;
+    const char* usage;      // Arguments, for help ("<0-4>"; "" if none)
+    const char* help;
+    ConsoleHandler run;
+};
+
+// The table must outlive the console (a static array); "help" is built in
+void consoleInit(const ConsoleCommand* commands, int count);
+
+// One received byte. Returns true when it completed a line that ran a command.
+bool consoleFeed(char c);
+
+// Parse an unsigned argument within [min, max]; replies with the accepted range and
+// returns false when it is not one
+bool consoleParseUint(const char* text, uint32_t min, uint32_t max, uint32_t* out);
+
+#endif // CONSOLE_H
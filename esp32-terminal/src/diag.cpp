@@ -0,0 +1,99 @@
+// Remote diagnostics
+//
+// Same scheme as the log ring (logbuf.cpp): whole lines back to back, wrapping
+// byte-wise, with head published by the producer only after the bytes are in and tail
+// by the consumer only after it copied them out.
+
+#include "diag.h"
+#include <atomic>
+#include <string.h>
+
+static uint8_t ring[DIAG_RING_BYTES];
+static std::atomic<uint32_t> head(0);     // Bytes ever written (drain task)
+static std::atomic<uint32_t> tail(0);     // Bytes ever consumed (loop task)
+static std::atomic<uint32_t> dropped(0);
+static std::atomic<uint32_t> droppedTotal(0);
+static std::atomic<uint8_t> level(0);
+
+void diagSetLevel(uint8_t lvl) {
+    level.store(lvl, std::memory_order_relaxed);
+}
+
+uint8_t diagLevel() {
+    return level.load(std::memory_order_relaxed);
+}
+
+void diagReset() {
+    head.store(0);
+    tail.store(0);
+    dropped.store(0);
+    droppedTotal.store(0);
+    level.store(0);
+}
+
+static void ringWrite(uint32_t pos, const void* data, int n) {
+    uint32_t at = pos % DIAG_RING_BYTES;
+    uint32_t first = DIAG_RING_BYTES - at;
+    if (first >= (uint32_t)n) {
+        memcpy(ring + at, data, n);
+    } else {
+        memcpy(ring + at, data, first);
+        memcpy(ring, (const uint8_t*)data + first, n - first);
+    }
+}
+
+static void ringRead(uint32_t pos, void* out, int n) {
+    uint32_t at = pos % DIAG_RING_BYTES;
+    uint32_t first = DIAG_RING_BYTES - at;
+    if (first >= (uint32_t)n) {
+        memcpy(out, ring + at, n);
+    } else {
+        memcpy(out, ring + at, first);
+        memcpy((uint8_t*)out + first, ring, n - first);
+    }
+}
+
+bool diagPushLine(uint8_t lvl, uint32_t ms, const char* text, int len) {
+    if (len > DIAG_TEXT_MAX) len = DIAG_TEXT_MAX;
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t t = tail.load(std::memory_order_acquire);
+    if (DIAG_RING_BYTES - (h - t) < (uint32_t)(DIAG_LINE_HEADER + len)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        droppedTotal.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint8_t header[DIAG_LINE_HEADER];
+    header[0] = lvl;
+    for (int i = 0; i < 4; i++) header[1 + i] = (uint8_t)(ms >> (8 * i));   // Little-endian
+    header[5] = (uint8_t)len;
+    ringWrite(h, header, DIAG_LINE_HEADER);
+    ringWrite(h + DIAG_LINE_HEADER, text, len);
+    head.store(h + DIAG_LINE_HEADER + len, std::memory_order_release);
+    return true;
+}
+
+int diagPackLines(uint8_t* out, int max) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t h = head.load(std::memory_order_acquire);
+    int n = 0;
+    while (t != h) {
+        uint8_t header[DIAG_LINE_HEADER];
+        ringRead(t, header, DIAG_LINE_HEADER);
+        int size = DIAG_LINE_HEADER + header[5];
+        if (n + size > max) break;
+        ringRead(t, out + n, size);
+        n += size;
+        t += size;
+    }
+    tail.store(t, std::memory_order_release);
+    return n;
+}
+
+uint32_t diagTakeDropped() {
+    return dropped.exchange(0, std::memory_order_relaxed);
+}
+
+uint32_t diagDroppedTotal() {
+    return droppedTotal.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,49 @@
+// Remote diagnostics — log lines bound for the server. The log drain task hands over
+// each formatted line at or below the level the host asked for; the loop packs them
+// into DIAG_LOG frames (see BinFrame in protocol.h) when the uplink is quiet.
+// Lines and timestamps come in as arguments and frames go out as bytes, so the ring and
+// the packing run on the host too. Single-producer (drain task), single-consumer (loop task).
+#ifndef DIAG_H
+#define DIAG_H
+
+#include <stdint.h>
+#include "config.h"
+
+// Lines are queued in their wire layout: [level][ms, uint32][length][text]
+static const int DIAG_LINE_HEADER = 6;
+static const int DIAG_TEXT_MAX = 255;
+
+// Counters in a DIAG_METRICS frame, by id. Mirrors DiagMetric in shared/constants.js.
+enum class DiagMetric : uint8_t {
+    HEAP_FREE,          // Bytes
+    HEAP_LARGEST,       // Largest free block, bytes
+    HEAP_MIN_EVER,      // Lowest free heap since boot, bytes
+    WIFI_RSSI,          // dBm (int32)
+    STREAM_DROPPED,     // Low-priority frames refused by the budget since boot
+    DIAG_DROPPED,       // Log lines lost to a full diagnostics ring since boot
+    LATENCY_TIMEOUTS,   // Inputs nothing answered (latency.h)
+    STALLS,             // Loop stalls waiting for upload
+    COUNT
+};
+
+static const int DIAG_METRICS = (int)DiagMetric::COUNT;
+
+// Highest LogLevel forwarded (0: remote logging off). Set by the loop, read by the drain task.
+void diagSetLevel(uint8_t level);
+uint8_t diagLevel();
+
+// Producer side: queue one line (truncated to DIAG_TEXT_MAX). False, and counted, when
+// the ring is full.
+bool diagPushLine(uint8_t level, uint32_t ms, const char* text, int len);
+
+// Consumer side: move whole queued lines into `out`, oldest first, up to `max` bytes.
+// Returns the bytes written (0: nothing queued, or the oldest line does not fit).
+int diagPackLines(uint8_t* out, int max);
+
+// Lines dropped since the last call / since boot
+uint32_t diagTakeDropped();
+uint32_t diagDroppedTotal();
+
+void diagReset();
+
+#endif // DIAG_H
@@ -2,6 +2,9 @@
 #include "display.h"
 #include "config.h"
 #include "icons.h"
+#include "heartrate.h"
+#include "prof.h"
+#include "logbuf.h"
 #include <U8g2lib.h>
 #include <SPI.h>
 #include <esp_mac.h>
@@ -55,6 +58,21 @@ static void applyScreenMode() {
     }
 }
 
+// ECG scope state (see the ECG SCOPE section below)
+static bool scopeActive = false;
+
+// Frame composed by displayCompose() and not yet sent by displayPresent()
+enum class Push : uint8_t { NONE, FULL, SCOPE_TEXT };
+static Push pendingPush = Push::NONE;
+
+// New CRITICAL text blinks: blank / redraw every DISPLAY_BLINK_MS, driven by displayUpdate()
+static DisplayState blinkState;
+static uint8_t blinkStep = 0;       // 0 = idle, odd = blank next, even = redraw next
+static unsigned long blinkNext = 0;
+
+// Text of the last CRITICAL frame shown (see displayCompose)
+static String lastCriticalText;
+
 void displayInit() {
     // Initialize SPI with ESP32-S3 pins
     SPI.begin(PIN_OLED_CLK, -1, PIN_OLED_MOSI, PIN_OLED_CS);
@@ -63,7 +81,7 @@ void displayInit() {
     prefs.begin("display", true);  // read-only
     screenMode = prefs.getUChar("screenMode", 0);
     prefs.end();
-    Serial.printf("[Display] Screen mode: %s\n", screenMode == 0 ? "NHD" : "SSD1322U");
+    LOG_I("[Display] Screen mode: %s", screenMode == 0 ? "NHD" : "SSD1322U");
 
     // Initialize U8g2
     u8g2.begin();
@@ -71,9 +89,16 @@ void displayInit() {
     u8g2.setContrast(255);  // Max contrast for amber OLED
     u8g2.clearBuffer();
     u8g2.sendBuffer();
+
+    // Frames are copied into these; reserved now so copying is allocation-free
+    blinkState.reserve();
+    lastCriticalText.reserve(DisplayState::TEXT_RESERVE);
 }
 
 void displayClear() {
+    scopeActive = false;
+    blinkStep = 0;
+    pendingPush = Push::NONE;
     u8g2.clearBuffer();
     u8g2.sendBuffer();
 }
@@ -116,42 +141,47 @@ static void _renderOperator(const DisplayState& state) {
     static const int MAX_CHARS = 37;              // max chars per line at 6px each
 
     // Build combined text
-    String sentence = state.line1.left;
-    String preview  = state.line2.text;
-    String combined;
-    if (sentence.length() > 0 && preview.length() > 0)
-        combined = sentence + " " + preview;
-    else if (sentence.length() > 0)
-        combined = sentence;
-    else
-        combined = preview;
-
-    // Word-wrap into 3 rows
-    String rows[3] = {"", "", ""};
+    const char* sentence = state.line1.left.c_str();
+    const char* preview  = state.line2.text.c_str();
+    char combined[3 * (MAX_CHARS + 1)];
+    snprintf(combined, sizeof(combined), "%s%s%s", sentence, (*sentence && *preview) ? " " : "", preview);
+
+    // Word-wrap into 3 rows (fixed buffers: this redraws on every dial step)
+    char rows[3][MAX_CHARS + 1] = {"", "", ""};
+    int rowLen[3] = {0, 0, 0};
+    auto append = [&](int r, const char* word, int len) {
+        if (rowLen[r] > 0) rows[r][rowLen[r]++] = ' ';
+        if (len > MAX_CHARS - rowLen[r]) len = MAX_CHARS - rowLen[r];
+        memcpy(rows[r] + rowLen[r], word, len);
+        rowLen[r] += len;
+        rows[r][rowLen[r]] = '\0';
+    };
     int rowIdx = 0;
-    int pos = 0;
-    while (pos < (int)combined.length() && rowIdx < 3) {
-        int sp = combined.indexOf(' ', pos);
-        String word = (sp == -1) ? combined.substring(pos) : combined.substring(pos, sp);
-        pos = (sp == -1) ? combined.length() : sp + 1;
-        if (word.length() == 0) continue;
-        String candidate = rows[rowIdx].length() > 0 ? rows[rowIdx] + " " + word : word;
-        if ((int)candidate.length() <= MAX_CHARS) {
-            rows[rowIdx] = candidate;
+    const char* pos = combined;
+    while (*pos && rowIdx < 3) {
+        const char* sp = strchr(pos, ' ');
+        const char* word = pos;
+        int wordLen = sp ? (int)(sp - pos) : (int)strlen(pos);
+        pos = sp ? sp + 1 : pos + wordLen;
+        if (wordLen == 0) continue;
+        int candidateLen = rowLen[rowIdx] > 0 ? rowLen[rowIdx] + 1 + wordLen : wordLen;
+        if (candidateLen <= MAX_CHARS) {
+            append(rowIdx, word, wordLen);
         } else if (rowIdx < 2) {
             rowIdx++;
-            rows[rowIdx] = word;
+            append(rowIdx, word, wordLen);
         }
     }
 
     // Find which row contains the preview word (it's the last word = end of last non-empty row)
+    int previewLen = strlen(preview);
     int previewRow = -1;
     int previewCharX = MARGIN_X;
-    if (preview.length() > 0) {
+    if (previewLen > 0) {
         for (int r = 2; r >= 0; r--) {
-            if (rows[r].length() >= preview.length() && rows[r].endsWith(preview)) {
+            if (rowLen[r] >= previewLen && strcmp(rows[r] + rowLen[r] - previewLen, preview) == 0) {
                 previewRow = r;
-                int prefixLen = rows[r].length() - preview.length();
+                int prefixLen = rowLen[r] - previewLen;
                 previewCharX = MARGIN_X + prefixLen * 6; // FONT_SMALL = 6px/char
                 break;
             }
@@ -162,27 +192,27 @@ static void _renderOperator(const DisplayState& state) {
 
     // Render rows
     for (int r = 0; r < 3; r++) {
-        if (rows[r].length() == 0) continue;
+        if (rowLen[r] == 0) continue;
 
-        if (r == previewRow && preview.length() > 0) {
-            // Draw committed prefix
-            int prefixLen = rows[r].length() - preview.length();
-            String prefix = rows[r].substring(0, prefixLen);
+        if (r == previewRow && previewLen > 0) {
+            // Draw committed prefix (the row cut short in place)
+            int prefixLen = rowLen[r] - previewLen;
+            rows[r][prefixLen] = '\0';
             u8g2.setDrawColor(1);
-            if (prefix.length() > 0) u8g2.drawStr(MARGIN_X, OP_Y[r], prefix.c_str());
+            if (prefixLen > 0) u8g2.drawStr(MARGIN_X, OP_Y[r], rows[r]);
 
             // Draw inverted box behind preview word
-            int previewW = u8g2.getStrWidth(preview.c_str());
+            int previewW = u8g2.getStrWidth(preview);
             u8g2.setDrawColor(1);
             u8g2.drawBox(previewCharX - 1, OP_Y[r] - 9, previewW + 2, 11);
 
             // Draw preview text dark-on-bright
             u8g2.setDrawColor(0);
-            u8g2.drawStr(previewCharX, OP_Y[r], preview.c_str());
+            u8g2.drawStr(previewCharX, OP_Y[r], preview);
             u8g2.setDrawColor(1);
         } else {
             u8g2.setDrawColor(1);
-            u8g2.drawStr(MARGIN_X, OP_Y[r], rows[r].c_str());
+            u8g2.drawStr(MARGIN_X, OP_Y[r], rows[r]);
         }
     }
 
@@ -202,14 +232,196 @@ static void _renderOperator(const DisplayState& state) {
     }
 }
 
-// Internal: draw the full display state into u8g2 buffer and send it
-static void _renderBuffer(const DisplayState& state) {
+// ============================================================================
+// ECG SCOPE (DisplayStyle::ECG)
+// ============================================================================
+// The trace fills tile rows 2-5 (y 16..47) across the full width, sweeping left to
+// right like a bedside monitor. Each sample draws one column at the sweep position and
+// blanks the column DISPLAY_SCOPE_GAP ahead; only the 8-px tile columns touched since
+// the last frame are sent, so a frame is a few hundred bytes of SPI instead of the
+// whole 8 KB buffer. Line 1 and line 3 keep their own tile rows and are redrawn only
+// when the server sends new text.
+
+#define SCOPE_TILE_Y    2
+#define SCOPE_TILE_H    4
+#define SCOPE_TOP       (SCOPE_TILE_Y * 8)
+#define SCOPE_H         (SCOPE_TILE_H * 8)
+#define SCOPE_MAX_COLS  16    // Samples drawn per frame at most (catch-up after a stall)
+
+static int scopeX = 0;
+static int scopePrevY = -1;
+static int scopeMin = 0;            // Vertical scale for the current sweep
+static int scopeMax = 0;
+static int sweepMin = 4095;         // Extremes seen this sweep (next sweep's scale)
+static int sweepMax = 0;
+static uint32_t scopeDirty = 0;     // One bit per tile column
+static bool scopeLeadsOff = false;
+
+// Full-buffer rotation (U8G2_R2 for NHD panels) is applied while drawing, so the buffer
+// is in panel orientation and a logical tile area has to be mirrored to match
+static void sendTiles(int tx, int ty, int tw, int th) {
+    if (screenMode == 0) {
+        tx = u8g2.getBufferTileWidth() - tx - tw;
+        ty = u8g2.getBufferTileHeight() - ty - th;
+    }
+    u8g2.updateDisplayArea(tx, ty, tw, th);
+}
+
+// Send each run of dirty tile columns as one area
+static void scopeFlush() {
+    int tx = 0;
+    while (scopeDirty != 0 && tx < DISPLAY_WIDTH / 8) {
+        if (!(scopeDirty & (1UL << tx))) { tx++; continue; }
+        int start = tx;
+        while (tx < DISPLAY_WIDTH / 8 && (scopeDirty & (1UL << tx))) tx++;
+        sendTiles(start, SCOPE_TILE_Y, tx - start, SCOPE_TILE_H);
+    }
+    scopeDirty = 0;
+}
+
+// Blank the trace area and restart the sweep (scale is relearned from the first sample)
+static void scopeClear() {
+    u8g2.setDrawColor(0);
+    u8g2.drawBox(0, SCOPE_TOP, DISPLAY_WIDTH, SCOPE_H);
+    u8g2.setDrawColor(1);
+    if (scopeLeadsOff) {
+        u8g2.setFont(FONT_SMALL);
+        const char* msg = "NO CONTACT";
+        u8g2.drawStr((DISPLAY_WIDTH - u8g2.getStrWidth(msg)) / 2, SCOPE_TOP + SCOPE_H / 2 + 4, msg);
+    }
+    scopeX = 0;
+    scopePrevY = -1;
+    scopeMin = scopeMax = 0;
+    sweepMin = 4095;
+    sweepMax = 0;
+    scopeDirty = 0xFFFFFFFFUL;
+}
+
+static void scopeColumn(int value) {
+    if (scopeMax == 0) {
+        scopeMin = value - DISPLAY_SCOPE_MIN_RANGE / 2;
+        scopeMax = value + DISPLAY_SCOPE_MIN_RANGE / 2;
+    }
+    if (value < sweepMin) sweepMin = value;
+    if (value > sweepMax) sweepMax = value;
+
+    int ahead = (scopeX + DISPLAY_SCOPE_GAP) % DISPLAY_WIDTH;
+    u8g2.setDrawColor(0);
+    u8g2.drawVLine(ahead, SCOPE_TOP, SCOPE_H);
+    scopeDirty |= 1UL << (ahead / 8);
+
+    int y = SCOPE_TOP + SCOPE_H - 1 - (value - scopeMin) * (SCOPE_H - 1) / (scopeMax - scopeMin);
+    if (y < SCOPE_TOP) y = SCOPE_TOP;
+    if (y > SCOPE_TOP + SCOPE_H - 1) y = SCOPE_TOP + SCOPE_H - 1;
+
+    // Join to the previous sample within this column only (column x-1 may already be sent)
+    u8g2.setDrawColor(1);
+    if (scopePrevY < 0 || scopeX == 0) {
+        u8g2.drawPixel(scopeX, y);
+    } else {
+        int top = y < scopePrevY ? y : scopePrevY;
+        int len = (y < scopePrevY ? scopePrevY - y : y - scopePrevY) + 1;
+        u8g2.drawVLine(scopeX, top, len);
+    }
+    scopeDirty |= 1UL << (scopeX / 8);
+    scopePrevY = y;
+
+    if (++scopeX == DISPLAY_WIDTH) {
+        // Rescale once per sweep from what the last sweep actually spanned (+1/8 margin)
+        int range = sweepMax - sweepMin;
+        if (range < DISPLAY_SCOPE_MIN_RANGE) range = DISPLAY_SCOPE_MIN_RANGE;
+        int mid = (sweepMin + sweepMax) / 2;
+        scopeMin = mid - range * 9 / 16;
+        scopeMax = mid + range * 9 / 16;
+        sweepMin = 4095;
+        sweepMax = 0;
+        scopeX = 0;
+    }
+}
+
+// Text rows around the trace. On entry the whole buffer is sent; afterwards only the
+// text tile rows are, so a line 1/3 update does not restart the sweep. Nothing is sent
+// until displayPresent().
+static void _renderScope(const DisplayState& state) {
+    bool entering = !scopeActive;
+    if (entering) {
+        u8g2.clearBuffer();
+        scopeLeadsOff = heartrateLeadsOff();
+        scopeClear();
+        scopeDirty = 0;
+    } else {
+        u8g2.setDrawColor(0);
+        u8g2.drawBox(0, 0, DISPLAY_WIDTH, SCOPE_TOP);
+        u8g2.drawBox(0, SCOPE_TOP + SCOPE_H, DISPLAY_WIDTH, DISPLAY_HEIGHT - SCOPE_TOP - SCOPE_H);
+    }
+
+    u8g2.setFont(FONT_SMALL);
+    u8g2.setDrawColor(1);
+    u8g2.drawStr(MARGIN_X, LINE1_Y, state.line1.left.c_str());
+    if (state.line1.right.length() > 0) {
+        int rightWidth = u8g2.getStrWidth(state.line1.right.c_str());
+        u8g2.drawStr(DISPLAY_WIDTH - rightWidth - MARGIN_X, LINE1_Y, state.line1.right.c_str());
+    }
+    if (state.line3.left.length() > 0 || state.line3.right.length() > 0) {
+        u8g2.drawStr(MARGIN_X, LINE3_Y, state.line3.left.c_str());
+        int rightWidth = u8g2.getStrWidth(state.line3.right.c_str());
+        u8g2.drawStr(DISPLAY_WIDTH - rightWidth - MARGIN_X, LINE3_Y, state.line3.right.c_str());
+    } else {
+        const String& text = state.line3.center.length() > 0 ? state.line3.center : state.line3.text;
+        u8g2.drawStr((DISPLAY_WIDTH - u8g2.getStrWidth(text.c_str())) / 2, LINE3_Y, text.c_str());
+    }
+
+    if (entering) scopeActive = true;
+    pendingPush = entering ? Push::FULL : Push::SCOPE_TEXT;
+}
+
+// Internal: draw the full display state into the u8g2 buffer (sent by displayPresent)
+static void _composeBuffer(const DisplayState& state);
+
+void displayUpdate() {
+    PROF_SCOPE(ProfScope::DISPLAY);
+    unsigned long now = millis();
+
+    if (blinkStep > 0 && (long)(now - blinkNext) >= 0) {
+        if (blinkStep % 2 == 1) {
+            u8g2.clearBuffer();
+        } else {
+            _composeBuffer(blinkState);
+        }
+        u8g2.sendBuffer();
+        pendingPush = Push::NONE;
+        blinkStep = blinkStep < 4 ? blinkStep + 1 : 0;
+        blinkNext += DISPLAY_BLINK_MS;
+    }
+
+    if (!scopeActive) return;
+
+    bool off = heartrateLeadsOff();
+    if (off != scopeLeadsOff) {
+        scopeLeadsOff = off;
+        scopeClear();
+    }
+
+    uint16_t samples[SCOPE_MAX_COLS];
+    size_t n = heartrateScopeRead(samples, SCOPE_MAX_COLS);
+    if (!scopeLeadsOff) {
+        for (size_t i = 0; i < n; i++) scopeColumn(samples[i]);
+    }
+    if (scopeDirty) scopeFlush();
+}
+
+bool displayAnimating() {
+    return blinkStep > 0 || scopeActive;
+}
+
+static void _composeBuffer(const DisplayState& state) {
+    scopeActive = false;
+    pendingPush = Push::FULL;
     u8g2.clearBuffer();
 
     // Operator sentence mode uses completely different layout
     if (state.line2.style == DisplayStyle::OPERATOR) {
         _renderOperator(state);
-        u8g2.sendBuffer();
         return;
     }
 
@@ -279,37 +491,57 @@ static void _renderBuffer(const DisplayState& state) {
         int line3X = (TEXT_AREA_W - line3Width) / 2;
         u8g2.drawStr(line3X, LINE3_Y, state.line3.text.c_str());
     }
-
-    // Send buffer to display
-    u8g2.sendBuffer();
 }
 
-void displayRender(const DisplayState& state) {
+void displayCompose(const DisplayState& state) {
+    PROF_SCOPE(ProfScope::DISPLAY);
+    blinkStep = 0;  // A newer frame replaces any blink in progress
+
+    if (state.line2.style == DisplayStyle::ECG) {
+        _renderScope(state);
+        return;
+    }
+
     // Operator mode renders once (no blink animation)
     if (state.line2.style == DisplayStyle::OPERATOR) {
-        _renderBuffer(state);
+        _composeBuffer(state);
         return;
     }
 
     // Critical content only flashes on first display — track seen text so
     // scrolling away and back does not re-trigger the blink animation.
-    static String lastCriticalText = "";
     bool isCritical = state.line2.style == DisplayStyle::CRITICAL;
     bool isNewCritical = isCritical && state.line2.text != lastCriticalText;
     if (isCritical) lastCriticalText = state.line2.text;
 
-    int blinkCycles = isNewCritical ? 3 : 1;
+    if (isNewCritical) {
+        blinkState = state;
+        blinkStep = 1;
+        blinkNext = millis() + DISPLAY_BLINK_MS;
+    }
+    _composeBuffer(state);
+}
 
-    for (int blink = 0; blink < blinkCycles; blink++) {
-        if (blink > 0) {
-            // Blank frame between blinks
-            delay(150);
-            u8g2.clearBuffer();
+void displayPresent() {
+    PROF_SCOPE(ProfScope::DISPLAY);
+    switch (pendingPush) {
+        case Push::FULL:
             u8g2.sendBuffer();
-            delay(150);
-        }
-        _renderBuffer(state);
+            break;
+        case Push::SCOPE_TEXT:
+            sendTiles(0, 0, DISPLAY_WIDTH / 8, SCOPE_TILE_Y);
+            sendTiles(0, SCOPE_TILE_Y + SCOPE_TILE_H, DISPLAY_WIDTH / 8, 8 - SCOPE_TILE_Y - SCOPE_TILE_H);
+            break;
+        case Push::NONE:
+            break;
     }
+    if (blinkStep > 0) blinkNext = millis() + DISPLAY_BLINK_MS;  // Time the blink from the frame actually shown
+    pendingPush = Push::NONE;
+}
+
+void displayRender(const DisplayState& state) {
+    displayCompose(state);
+    displayPresent();
 }
 
 void displayMessage(const char* line1, const char* line2, const char* line3) {
@@ -323,6 +555,9 @@ void displayMessage(const char* line1, const char* line2, const char* line3) {
 }
 
 void displayPlayerSelect(uint8_t selectedPlayer) {
+    scopeActive = false;
+    blinkStep = 0;
+    pendingPush = Push::NONE;
     u8g2.clearBuffer();
 
     // === LINE 1: Title ===
@@ -371,7 +606,7 @@ void displayToggleScreenMode() {
     prefs.putUChar("screenMode", screenMode);
     prefs.end();
 
-    Serial.printf("[Display] Screen mode changed to: %s\n", screenMode == 0 ? "NHD" : "SSD1322U");
+    LOG_I("[Display] Screen mode changed to: %s", screenMode == 0 ? "NHD" : "SSD1322U");
 }
 
 const char* displayGetScreenModeName() {
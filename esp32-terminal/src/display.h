@@ -8,9 +8,23 @@
 // Initialize the display
 void displayInit();
 
-// Render the current display state
+// Render the current display state (displayCompose + displayPresent)
 void displayRender(const DisplayState& state);
 
+// Two-phase render for frame commits: draw the state into the framebuffer, then push
+// it to the panel. Composing is the slow part, so it can happen before the LEDs are
+// latched and the push right after them.
+void displayCompose(const DisplayState& state);
+void displayPresent();
+
+// Advance timed display effects (call every DISPLAY_SCOPE_FRAME_MS): the blink of new
+// CRITICAL text, and the ECG trace while DisplayStyle::ECG is showing (new samples,
+// only the changed tiles pushed)
+void displayUpdate();
+
+// Whether displayUpdate() has anything to do (a blink or the ECG trace is running)
+bool displayAnimating();
+
 // Show a simple message (for boot/connection states)
 void displayMessage(const char* line1, const char* line2, const char* line3);
 
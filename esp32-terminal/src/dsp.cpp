@@ -0,0 +1,72 @@
+// Block-based fixed-point DSP kernels
+//
+// The optimized kernels are written for the Xtensa LX7 pipeline: contiguous reads (the
+// FIR delay line is mirrored so the tap loop never wraps), 4-way unrolled MACs into
+// independent accumulators, and filter state held in locals for the whole block. All
+// arithmetic is integer, so reordering the sums cannot change a single bit — the *Ref
+// version is the readable specification.
+
+#include "dsp.h"
+
+static inline int16_t sat16(int32_t v) {
+    return v > 32767 ? 32767 : (v < -32768 ? -32768 : (int16_t)v);
+}
+
+// ============================================================================
+// FIR
+// ============================================================================
+
+void dspFirInit(DspFirQ15* f, const int16_t* coeffs, uint16_t taps, int16_t* delay) {
+    f->coeffs = coeffs;
+    f->taps = taps;
+    f->delay = delay;
+    f->pos = 0;
+    dspFirPrime(f, 0);
+}
+
+void dspFirPrime(DspFirQ15* f, int16_t value) {
+    for (uint16_t i = 0; i < 2 * f->taps; i++) f->delay[i] = value;
+}
+
+// New samples are written at a decreasing position into both halves of the ring, so
+// delay[pos + k] == x[n - k] for k = 0..taps-1 without any wrap inside the MAC loop.
+void dspFirQ15(DspFirQ15* f, const int16_t* in, int16_t* out, size_t n) {
+    const int16_t* h = f->coeffs;
+    const uint16_t taps = f->taps;
+    int16_t* delay = f->delay;
+    uint16_t pos = f->pos;
+
+    for (size_t i = 0; i < n; i++) {
+        pos = pos == 0 ? taps - 1 : pos - 1;
+        delay[pos] = in[i];
+        delay[pos + taps] = in[i];
+
+        const int16_t* x = delay + pos;
+        int32_t acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+        uint16_t k = 0;
+        for (; k + 4 <= taps; k += 4) {
+            acc0 += (int32_t)h[k] * x[k];
+            acc1 += (int32_t)h[k + 1] * x[k + 1];
+            acc2 += (int32_t)h[k + 2] * x[k + 2];
+            acc3 += (int32_t)h[k + 3] * x[k + 3];
+        }
+        for (; k < taps; k++) acc0 += (int32_t)h[k] * x[k];
+
+        out[i] = sat16((acc0 + acc1 + acc2 + acc3 + (1 << 14)) >> 15);
+    }
+    f->pos = pos;
+}
+
+void dspFirQ15Ref(DspFirQ15* f, const int16_t* in, int16_t* out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        f->pos = (f->pos + f->taps - 1) % f->taps;
+        f->delay[f->pos] = in[i];
+        f->delay[f->pos + f->taps] = in[i];
+
+        int32_t acc = 0;
+        for (uint16_t k = 0; k < f->taps; k++) {
+            acc += (int32_t)f->coeffs[k] * f->delay[(f->pos + k) % f->taps];
+        }
+        out[i] = sat16((acc + (1 << 14)) >> 15);
+    }
+}
@@ -0,0 +1,29 @@
+// Block-based fixed-point DSP kernels for the 250 Hz ECG path (the beat detector's FIR).
+// The kernel has a straightforward *Ref twin; the two are bit-exact (integer arithmetic,
+// same rounding) and test/test_dsp checks that on the host.
+#ifndef DSP_H
+#define DSP_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ============================================================================
+// FIR — Q15 coefficients, int32 accumulator, round-half-up, saturate to int16
+// ============================================================================
+// Headroom: sum(|h|) * max(|x|) must stay below 2^31. Unity-gain Q15 filters
+// (sum(|h|) <= 2^16) therefore take inputs up to +/-2^14 — ADC samples are 12-bit.
+
+struct DspFirQ15 {
+    const int16_t* coeffs;   // h[0..taps-1]
+    uint16_t taps;
+    int16_t* delay;          // 2 * taps entries (mirrored ring, see dspFirInit)
+    uint16_t pos;
+};
+
+void dspFirInit(DspFirQ15* f, const int16_t* coeffs, uint16_t taps, int16_t* delay);
+// Fill the delay line with a constant so the output starts settled at that level
+void dspFirPrime(DspFirQ15* f, int16_t value);
+void dspFirQ15(DspFirQ15* f, const int16_t* in, int16_t* out, size_t n);
+void dspFirQ15Ref(DspFirQ15* f, const int16_t* in, int16_t* out, size_t n);
+
+#endif // DSP_H
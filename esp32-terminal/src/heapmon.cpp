@@ -0,0 +1,73 @@
+// Heap health
+
+#include "heapmon.h"
+
+static HeapSummary summary;
+static HeapSite sites[HEAP_SITE_SLOTS];
+static uint32_t sitesMissed = 0;
+
+uint8_t heapmonFragPct(uint32_t freeBytes, uint32_t largestBlock) {
+    if (freeBytes == 0 || largestBlock >= freeBytes) return 0;
+    return (uint8_t)(100 - (uint64_t)largestBlock * 100 / freeBytes);
+}
+
+void heapmonReset() {
+    summary = {};
+}
+
+void heapmonSample(const HeapSample& sample) {
+    summary.last = sample;
+    summary.fragPct = heapmonFragPct(sample.freeBytes, sample.largestBlock);
+    if (summary.samples == 0 || sample.freeBytes < summary.minFree) summary.minFree = sample.freeBytes;
+    if (summary.samples == 0 || sample.largestBlock < summary.minLargest) {
+        summary.minLargest = sample.largestBlock;
+    }
+    if (summary.fragPct > summary.maxFragPct) summary.maxFragPct = summary.fragPct;
+    summary.samples++;
+}
+
+HeapSummary heapmonSummary() {
+    return summary;
+}
+
+void heapmonCountAlloc(uintptr_t site, uint32_t bytes) {
+    if (site == 0) return;
+    uint32_t h = (uint32_t)(site ^ (site >> 13)) * 2654435761u;
+    for (int probe = 0; probe < HEAP_SITE_SLOTS; probe++) {
+        HeapSite& s = sites[(h + probe) % HEAP_SITE_SLOTS];
+        if (s.site == site || s.site == 0) {
+            s.site = site;
+            s.count++;
+            s.bytes += bytes;
+            return;
+        }
+    }
+    sitesMissed++;
+}
+
+int heapmonTopSites(HeapSite* out, int max) {
+    int n = 0;
+    for (const HeapSite& s : sites) {
+        if (s.site == 0) continue;
+        // Insertion into the descending top-`max` list
+        int pos = n < max ? n : max;
+        while (pos > 0 && out[pos - 1].count < s.count) {
+            if (pos < max) out[pos] = out[pos - 1];
+            pos--;
+        }
+        if (pos < max) {
+            out[pos] = s;
+            if (n < max) n++;
+        }
+    }
+    return n;
+}
+
+uint32_t heapmonSitesMissed() {
+    return sitesMissed;
+}
+
+void heapmonResetSites() {
+    for (HeapSite& s : sites) s = {};
+    sitesMissed = 0;
+}
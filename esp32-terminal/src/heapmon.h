@@ -0,0 +1,50 @@
+// Heap health — free heap, largest free block and fragmentation over a session, and
+// optional allocation counters per call site (fed by the malloc wrappers in allochook.cpp).
+// The caller samples heap_caps and passes the figures in; nothing here queries the allocator.
+#ifndef HEAPMON_H
+#define HEAPMON_H
+
+#include <stdint.h>
+#include "config.h"
+
+struct HeapSample {
+    uint32_t freeBytes;
+    uint32_t largestBlock;
+    uint32_t minEverFree;       // Allocator's own low-water mark since boot
+};
+
+struct HeapSummary {
+    HeapSample last;
+    uint32_t samples;
+    uint32_t minFree;           // Lowest sampled free heap since boot
+    uint32_t minLargest;        // Smallest sampled largest block since boot
+    uint8_t fragPct;            // 100 - largest/free, last sample
+    uint8_t maxFragPct;         // Worst since boot
+};
+
+struct TaskStack {
+    const char* name;
+    uint32_t freeBytes;         // Stack high-water mark: least ever left free
+};
+
+struct HeapSite {
+    uintptr_t site;             // Caller of malloc/calloc/realloc
+    uint32_t count;             // Allocations since the last heapmonResetSites()
+    uint32_t bytes;
+};
+
+void heapmonReset();
+void heapmonSample(const HeapSample& sample);
+HeapSummary heapmonSummary();
+
+// 0 when free is 0; a single free block is 0 %
+uint8_t heapmonFragPct(uint32_t freeBytes, uint32_t largestBlock);
+
+// Allocation-site table (HEAP_SITE_SLOTS open-addressed entries). Once full, allocations
+// from new sites are only counted in heapmonSitesMissed(). Not locked — the caller is.
+void heapmonCountAlloc(uintptr_t site, uint32_t bytes);
+int heapmonTopSites(HeapSite* out, int max);    // By count, descending
+uint32_t heapmonSitesMissed();
+void heapmonResetSites();
+
+#endif // HEAPMON_H
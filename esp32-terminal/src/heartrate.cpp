@@ -2,13 +2,28 @@
 
 #include "heartrate.h"
 #include "config.h"
+#include "protocol.h"
+#include "timesync.h"
+#include "hrv.h"
+#include "sqi.h"
+#include "dsp.h"
+#include "prof.h"
+#include "logbuf.h"
+#include "tunables.h"
+#include <Preferences.h>
 
 // BPM send callback — set by caller to avoid heartrate.cpp depending on network.cpp
-typedef void (*BpmSendCallback)(uint8_t bpm);
+typedef void (*BpmSendCallback)(const HeartbeatReport& report);
 static BpmSendCallback bpmSendCallback = nullptr;
 static unsigned long lastBpmSend = 0;
 static bool lastBpmActive = false;
-static const unsigned long BPM_SEND_INTERVAL_MS = 2000;
+
+// Waveform send callback — binary frames, same decoupling as the BPM callback
+typedef bool (*WaveSendCallback)(const uint8_t* frame, size_t len);
+static WaveSendCallback waveSendCallback = nullptr;
+static WaveSendCallback beatSendCallback = nullptr;
+
+static HrReportMode reportMode = HrReportMode::BPM;
 
 // AD8232 power state — powered on once connected to keep analog circuit warm
 static bool hrPowered = false;
@@ -17,25 +32,21 @@ static bool hrPowered = false;
 static bool hrEnabled = false;
 
 // Beat detection state
-static unsigned long lastSampleTime = 0;
 static unsigned long lastBeatTime = 0;
 static unsigned long beatLedOnTime = 0;
 static bool beatLedOn = false;
 
-// BPM calculation — circular buffer of last 4 beat intervals
-static const int BPM_BUFFER_SIZE = 6;
-static unsigned long beatIntervals[6] = {0};
-static int beatIntervalIndex = 0;
-static int beatIntervalCount = 0;
+// Previous beat, for R-R intervals (statistics live in hrv.cpp)
 static unsigned long prevBeatTime = 0;
 
 static const unsigned long ACTIVE_TIMEOUT_MS = 3000; // Consider inactive after 3s without a beat
 
 // Adaptive threshold — sliding window min/max
 static const unsigned long WINDOW_MS = 2000;     // 2-second rolling window
-static const unsigned long REFRACTORY_MS = 400;   // ~150 BPM cap
-static const float THRESHOLD_RATIO = 0.60f;       // 60% of range above min
-static const int MIN_RANGE = 400;                  // Minimum ADC range to reject T-wave false triggers
+
+// Detector tuning — the tunable defaults until a calibration is loaded for the player slot
+static DetectorParams params;
+static uint8_t playerSlot = 0;
 
 static int rollingMin = 4095;
 static int rollingMax = 0;
@@ -44,6 +55,328 @@ static unsigned long windowStart = 0;
 // Track whether signal was below threshold (for rising-edge detection)
 static bool wasBelowThreshold = true;
 
+// Detection-path low-pass — 15-tap Hamming FIR, 35 Hz cutoff at 250 Hz, Q15 with unity
+// DC gain (-18 dB at 50 Hz, -35 dB at 60 Hz). Mains hum and EMG spikes otherwise cross the
+// threshold. Samples are filtered in blocks; the waveform stream and SQI stay raw.
+static const int LOWPASS_TAPS = 15;
+static const int16_t LOWPASS_Q15[LOWPASS_TAPS] = {
+    -15, -184, -500, -418, 1072, 4219, 7641, 9138, 7641, 4219, 1072, -418, -500, -184, -15
+};
+static const unsigned long LOWPASS_DELAY_MS = (LOWPASS_TAPS - 1) / 2 * AD8232_SAMPLE_MS;
+static int16_t lowpassDelay[2 * LOWPASS_TAPS];
+static DspFirQ15 lowpass;
+static bool lowpassPrimed = false;
+static int16_t blockIn[AD8232_FILTER_BLOCK];
+static int16_t blockOut[AD8232_FILTER_BLOCK];
+static unsigned long blockTime[AD8232_FILTER_BLOCK];
+static uint8_t blockCount = 0;
+
+// Leads-off gating — detection and the 250 Hz ADC loop are suspended while off.
+// The last good min/max window is kept so detection resumes without a 2 s re-learn.
+static bool leadsOff = false;
+static bool leadsPinState = false;       // Raw (undebounced) LO+ || LO-
+static unsigned long leadsPinChange = 0;
+static bool leadsReportPending = false;
+static int goodMin = 4095;
+static int goodMax = 0;
+
+// Detector calibration run — per-window ranges/minimums and, per beat, the highest
+// non-R excursion (T wave, noise) as % of range. Stored in NVS namespace "hrcal".
+struct StoredParams {
+    uint8_t version;
+    uint8_t thresholdPct;
+    uint16_t minRange;
+    uint16_t refractoryMs;
+    uint16_t baseline;
+    uint16_t typicalRange;
+};
+static const uint8_t CAL_VERSION = 1;
+static const int CAL_MAX_WINDOWS = 16;
+static Preferences calPrefs;
+static bool calActive = false;
+static unsigned long calEnd = 0;
+static uint16_t calRanges[CAL_MAX_WINDOWS];
+static uint16_t calMins[CAL_MAX_WINDOWS];
+static uint8_t calWindowCount = 0;
+static uint8_t calInterPeaks[AD8232_CAL_MAX_BEATS];
+static uint8_t calBeatCount = 0;
+static int calInterPeak = -1;
+typedef void (*CalibrationCallback)(bool success, const DetectorParams& params, uint8_t beats);
+static CalibrationCallback calCallback = nullptr;
+
+// Waveform stream — decimated samples delta-encoded into the open frame
+static const size_t WAVE_FRAME_BYTES = BinFrame::ECG_WAVE_HEADER + (AD8232_WAVE_MAX_SAMPLES - 1) * 3;
+static bool waveStreaming = false;
+static uint8_t waveFrame[WAVE_FRAME_BYTES];
+static size_t waveLen = 0;
+static uint8_t waveCount = 0;
+static int wavePrev = 0;
+static unsigned long waveFrameStart = 0;
+static uint16_t waveSeq = 0;
+static int waveDecimSum = 0;
+static uint8_t waveDecimCount = 0;
+
+// OLED scope ring — written here, drained by display.cpp via heartrateScopeRead()
+static uint16_t scopeRing[AD8232_SCOPE_RING];
+static uint32_t scopeHead = 0;   // Total samples written (index = head % ring)
+static uint32_t scopeTail = 0;   // Total samples read
+static int scopeDecimSum = 0;
+static uint8_t scopeDecimCount = 0;
+
+// Per-beat events — beat times (local millis) and raw R-R intervals awaiting a BEATS frame
+static unsigned long beatQueueTime[AD8232_BEAT_BATCH_MAX];
+static uint16_t beatQueueRR[AD8232_BEAT_BATCH_MAX];
+static uint8_t beatQueueCount = 0;
+
+static void putU16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static void putU32(uint8_t* p, uint32_t v) {
+    putU16(p, v & 0xFFFF);
+    putU16(p + 2, v >> 16);
+}
+
+static void beatsFlush(unsigned long now) {
+    if (beatQueueCount == 0) return;
+
+    uint8_t frame[BinFrame::BEATS_HEADER + AD8232_BEAT_BATCH_MAX * 4];
+    bool synced = timesyncIsSynced();
+    unsigned long first = beatQueueTime[0];
+    unsigned long age = now - first;
+
+    frame[0] = BinFrame::BEATS;
+    frame[1] = synced ? BinFrame::BEATS_FLAG_SYNCED : 0;
+    frame[2] = beatQueueCount;
+    putU32(frame + 3, synced ? (uint32_t)timesyncToServer(first) : 0);
+    putU16(frame + 7, age > 0xFFFF ? 0xFFFF : age);
+    frame[9] = leadsOff ? 0 : sqiGet();
+    size_t len = BinFrame::BEATS_HEADER;
+    for (int i = 0; i < beatQueueCount; i++) {
+        putU16(frame + len, beatQueueTime[i] - first);
+        putU16(frame + len + 2, beatQueueRR[i]);
+        len += 4;
+    }
+
+    if (beatSendCallback) beatSendCallback(frame, len);
+    beatQueueCount = 0;
+}
+
+static void beatsQueue(unsigned long beatTime, unsigned long rr) {
+    if (beatQueueCount >= AD8232_BEAT_BATCH_MAX) beatsFlush(beatTime);
+    beatQueueTime[beatQueueCount] = beatTime;
+    beatQueueRR[beatQueueCount] = rr > 0xFFFF ? 0 : rr;
+    beatQueueCount++;
+}
+
+static void waveformReset() {
+    waveLen = 0;
+    waveCount = 0;
+    waveDecimSum = 0;
+    waveDecimCount = 0;
+}
+
+// Hand the open frame to the network layer. The sequence number advances even if the
+// send is refused (budget exhausted), so the server sees dropped frames as gaps.
+static void waveformFlush() {
+    if (waveCount == 0) return;
+    if (waveSendCallback) waveSendCallback(waveFrame, waveLen);
+    waveSeq++;
+    waveLen = 0;
+    waveCount = 0;
+}
+
+static void waveformPush(int sample, unsigned long now) {
+    // Box-filter decimation: average AD8232_WAVE_DECIMATE raw samples per output sample
+    waveDecimSum += sample;
+    if (++waveDecimCount < AD8232_WAVE_DECIMATE) return;
+    int value = waveDecimSum / AD8232_WAVE_DECIMATE;
+    waveDecimSum = 0;
+    waveDecimCount = 0;
+
+    if (waveCount == 0) {
+        waveFrame[0] = BinFrame::ECG_WAVE;
+        putU16(waveFrame + 1, waveSeq);
+        putU32(waveFrame + 3, now);
+        waveFrame[7] = AD8232_SAMPLE_MS * AD8232_WAVE_DECIMATE;
+        putU16(waveFrame + 9, value);
+        waveLen = BinFrame::ECG_WAVE_HEADER;
+        waveFrameStart = now;
+    } else {
+        int delta = value - wavePrev;
+        if (delta > -128 && delta <= 127) {
+            waveFrame[waveLen++] = (uint8_t)(int8_t)delta;
+        } else {
+            waveFrame[waveLen++] = BinFrame::DELTA_ESCAPE;
+            putU16(waveFrame + waveLen, value);
+            waveLen += 2;
+        }
+    }
+    wavePrev = value;
+    waveFrame[8] = ++waveCount;
+
+    if (waveCount >= AD8232_WAVE_MAX_SAMPLES) waveformFlush();
+}
+
+static void scopePush(int sample) {
+    scopeDecimSum += sample;
+    if (++scopeDecimCount < AD8232_SCOPE_DECIMATE) return;
+    scopeRing[scopeHead % AD8232_SCOPE_RING] = scopeDecimSum / AD8232_SCOPE_DECIMATE;
+    scopeHead++;
+    scopeDecimSum = 0;
+    scopeDecimCount = 0;
+}
+
+size_t heartrateScopeRead(uint16_t* out, size_t max) {
+    if (scopeHead - scopeTail > AD8232_SCOPE_RING) scopeTail = scopeHead - AD8232_SCOPE_RING;
+    size_t n = 0;
+    while (n < max && scopeTail != scopeHead) {
+        out[n++] = scopeRing[scopeTail % AD8232_SCOPE_RING];
+        scopeTail++;
+    }
+    return n;
+}
+
+static void calKey(char* key, size_t len) {
+    snprintf(key, len, "p%u", playerSlot);
+}
+
+// Load the slot's stored params and pre-warm the rolling window with its typical
+// baseline/range, so the first beat after power-on is detected instead of the first window
+static void loadDetectorParams() {
+    params = hrParamsDefaults();
+    if (playerSlot == 0) return;
+
+    char key[8];
+    calKey(key, sizeof(key));
+    StoredParams stored;
+    size_t n = 0;
+    calPrefs.begin("hrcal", true);  // read-only
+    if (calPrefs.isKey(key)) n = calPrefs.getBytes(key, &stored, sizeof(stored));
+    calPrefs.end();
+    if (n != sizeof(stored) || stored.version != CAL_VERSION) return;
+
+    params.thresholdPct = stored.thresholdPct;
+    params.minRange = stored.minRange;
+    params.refractoryMs = stored.refractoryMs;
+    params.baseline = stored.baseline;
+    params.typicalRange = stored.typicalRange;
+    params.learned = true;
+
+    goodMin = params.baseline;
+    goodMax = params.baseline + params.typicalRange;
+    rollingMin = goodMin;
+    rollingMax = goodMax;
+    windowStart = millis();
+    LOG_I("[HR] Slot %u calibration: threshold=%u%% minRange=%u refractory=%ums",
+          playerSlot, params.thresholdPct, params.minRange, params.refractoryMs);
+}
+
+static void saveDetectorParams() {
+    if (playerSlot == 0) return;
+    StoredParams stored = {
+        CAL_VERSION, params.thresholdPct, params.minRange, params.refractoryMs,
+        params.baseline, params.typicalRange
+    };
+    char key[8];
+    calKey(key, sizeof(key));
+    calPrefs.begin("hrcal", false);  // read-write
+    calPrefs.putBytes(key, &stored, sizeof(stored));
+    calPrefs.end();
+}
+
+static uint16_t calMedian(const uint16_t* values, int count) {
+    uint16_t sorted[CAL_MAX_WINDOWS];
+    for (int i = 0; i < count; i++) {
+        int j = i;
+        while (j > 0 && sorted[j - 1] > values[i]) { sorted[j] = sorted[j - 1]; j--; }
+        sorted[j] = values[i];
+    }
+    return sorted[count / 2];
+}
+
+static uint8_t calUpperQuartile(const uint8_t* values, int count) {
+    uint8_t sorted[AD8232_CAL_MAX_BEATS];
+    for (int i = 0; i < count; i++) {
+        int j = i;
+        while (j > 0 && sorted[j - 1] > values[i]) { sorted[j] = sorted[j - 1]; j--; }
+        sorted[j] = values[i];
+    }
+    return sorted[count * 3 / 4];
+}
+
+static int clampInt(int v, int lo, int hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static void calFinish() {
+    calActive = false;
+    uint8_t beats = calBeatCount;
+    if (beats < AD8232_CAL_MIN_BEATS || calWindowCount < 2) {
+        LOG_W("[HR] Calibration failed: %u beats in %u windows", beats, calWindowCount);
+        if (calCallback) calCallback(false, params, beats);
+        return;
+    }
+
+    uint16_t range = calMedian(calRanges, calWindowCount);
+    // Threshold sits a margin above the tallest non-R peaks (T waves) seen in most beats
+    params.thresholdPct = clampInt(calUpperQuartile(calInterPeaks, beats) + 15, 45, 85);
+    params.minRange = clampInt(range * 40 / 100, 150, 1000);
+    uint32_t rr = hrvMedianInterval();
+    params.refractoryMs = rr ? clampInt(rr * 45 / 100, 250, 400) : tunableGet(Tunable::HR_REFRACTORY);
+    params.baseline = calMedian(calMins, calWindowCount);
+    params.typicalRange = range;
+    params.learned = true;
+    saveDetectorParams();
+
+    LOG_I("[HR] Calibrated slot %u: threshold=%u%% minRange=%u refractory=%ums (%u beats)",
+          playerSlot, params.thresholdPct, params.minRange, params.refractoryMs, beats);
+    if (calCallback) calCallback(true, params, beats);
+}
+
+void heartrateSetPlayerSlot(uint8_t slot) {
+    if (slot == playerSlot) return;
+    playerSlot = slot;
+    if (hrPowered) loadDetectorParams();
+}
+
+void heartrateStartCalibration(unsigned long durationMs) {
+    if (durationMs == 0) {
+        if (calActive) LOG_I("[HR] Calibration cancelled");
+        calActive = false;
+        return;
+    }
+    heartratePowerOn();
+    calActive = true;
+    calEnd = millis() + durationMs;
+    calWindowCount = 0;
+    calBeatCount = 0;
+    calInterPeak = -1;
+    LOG_I("[HR] Calibrating detector for %lu ms", durationMs);
+}
+
+bool heartrateIsCalibrating() {
+    return calActive;
+}
+
+void heartrateDetectorDefaultsChanged() {
+    if (hrParamsDefaultsChanged(&params)) {
+        LOG_I("[HR] Detector defaults: threshold=%u%% minRange=%u refractory=%ums",
+              params.thresholdPct, params.minRange, params.refractoryMs);
+    }
+}
+
+bool heartrateSaveDetectorParams() {
+    if (playerSlot == 0 || !hrParamsStorable(params)) return false;
+    saveDetectorParams();
+    return true;
+}
+
+void heartrateSetCalibrationCallback(void (*cb)(bool, const DetectorParams&, uint8_t)) {
+    calCallback = cb;
+}
+
 void heartrateInit() {
     // AD8232 shutdown control — start in shutdown (HIGH = off)
     pinMode(PIN_AD8232_SDN, OUTPUT);
@@ -51,18 +384,26 @@ void heartrateInit() {
     hrPowered = false;
     hrEnabled = false;
 
+    // Leads-off comparator outputs (driven by the AD8232, no pull needed)
+    pinMode(PIN_AD8232_LOP, INPUT);
+    pinMode(PIN_AD8232_LOM, INPUT);
+
     // Red heartbeat LED
     pinMode(PIN_LED_HEARTBEAT, OUTPUT);
     digitalWrite(PIN_LED_HEARTBEAT, LOW);
 
-    Serial.println("[HR] AD8232 initialized, SDN HIGH (shutdown)");
+    dspFirInit(&lowpass, LOWPASS_Q15, LOWPASS_TAPS, lowpassDelay);
+    params = hrParamsDefaults();   // Tunables are loaded by now; the slot's come at power-on
+
+    LOG_I("[HR] AD8232 initialized, SDN HIGH (shutdown)");
 }
 
 void heartratePowerOn() {
     if (!hrPowered) {
         digitalWrite(PIN_AD8232_SDN, LOW);
         hrPowered = true;
-        Serial.println("[HR] AD8232 powered on (warm-up)");
+        loadDetectorParams();
+        LOG_I("[HR] AD8232 powered on (warm-up)");
     }
 }
 
@@ -73,7 +414,17 @@ void heartratePowerOff() {
         beatLedOn = false;
         hrPowered = false;
         hrEnabled = false;
-        Serial.println("[HR] AD8232 powered off");
+        waveformReset();
+        beatQueueCount = 0;
+        hrvReset();
+        sqiReset();
+        lowpassPrimed = false;
+        blockCount = 0;
+        prevBeatTime = 0;
+        leadsOff = false;
+        leadsPinState = false;
+        calActive = false;
+        LOG_I("[HR] AD8232 powered off");
     }
 }
 
@@ -81,7 +432,8 @@ void heartrateEnable() {
     if (!hrEnabled) {
         heartratePowerOn(); // Ensure powered on
         hrEnabled = true;
-        Serial.println("[HR] Reporting enabled");
+        leadsReportPending = true;  // Announce current contact state to the server
+        LOG_I("[HR] Reporting enabled");
     }
 }
 
@@ -90,30 +442,65 @@ void heartrateDisable() {
         digitalWrite(PIN_LED_HEARTBEAT, LOW);
         beatLedOn = false;
         hrEnabled = false;
-        Serial.println("[HR] Reporting disabled");
+        waveformReset();
+        beatQueueCount = 0;
+        LOG_I("[HR] Reporting disabled");
     }
 }
 
-void heartrateUpdate() {
-    if (!hrPowered) return;
-
-    unsigned long now = millis();
-
-    // Turn off beat LED after flash duration
-    if (beatLedOn && (now - beatLedOnTime >= AD8232_BEAT_FLASH_MS)) {
+static void setLeadsOff(bool off, unsigned long now) {
+    leadsOff = off;
+    leadsReportPending = true;
+    if (off) {
+        // Freeze the last window that actually held a signal
+        if (rollingMax - rollingMin >= params.minRange) {
+            goodMin = rollingMin;
+            goodMax = rollingMax;
+        }
+        waveformFlush();
+        waveformReset();
+        sqiReset();
+        lowpassPrimed = false;
+        blockCount = 0;
         digitalWrite(PIN_LED_HEARTBEAT, LOW);
         beatLedOn = false;
+    } else {
+        // Pre-warm from the frozen window; the first beat after contact has no valid R-R
+        rollingMin = goodMin;
+        rollingMax = goodMax;
+        windowStart = now;
+        wasBelowThreshold = true;
+        prevBeatTime = 0;
     }
+    if (hrEnabled) LOG_I("[HR] Leads %s", off ? "off" : "on");
+}
 
-    // Sample at ~250 Hz
-    if (now - lastSampleTime < AD8232_SAMPLE_MS) return;
-    lastSampleTime = now;
-
-    // Read analog signal
-    int sample = analogRead(PIN_AD8232_OUT);
+// Returns true if sampling should continue this iteration. While the leads are off the
+// task runs at AD8232_LEADS_POLL_MS and only the pins are read.
+static bool leadsUpdate(unsigned long now) {
+    bool pin = digitalRead(PIN_AD8232_LOP) == HIGH || digitalRead(PIN_AD8232_LOM) == HIGH;
+    if (pin != leadsPinState) {
+        leadsPinState = pin;
+        leadsPinChange = now;
+    }
+    if (leadsPinState != leadsOff && now - leadsPinChange >= AD8232_LEADS_DEBOUNCE_MS) {
+        setLeadsOff(leadsPinState, now);
+    }
+    return !leadsOff;
+}
 
+// One low-passed sample through the adaptive-threshold detector. `now` is the arrival
+// time of the newest raw sample in the filter; R-R intervals are unaffected by the
+// filter delay, absolute beat times are corrected by LOWPASS_DELAY_MS.
+static void detectSample(int sample, unsigned long now) {
     // Update rolling min/max window
     if (now - windowStart > WINDOW_MS) {
+        sqiCloseWindow();
+        if (calActive && calWindowCount < CAL_MAX_WINDOWS && rollingMax > rollingMin) {
+            calRanges[calWindowCount] = rollingMax - rollingMin;
+            calMins[calWindowCount] = rollingMin;
+            calWindowCount++;
+        }
         // Decay toward current sample to avoid stale extremes
         rollingMin = sample;
         rollingMax = sample;
@@ -125,30 +512,43 @@ void heartrateUpdate() {
 
     int range = rollingMax - rollingMin;
 
-    if (range < MIN_RANGE) return;  // Signal too weak or just noise, skip detection
+    // Highest excursion between beats (outside the R complex) for threshold learning
+    if (calActive && lastBeatTime > 0 && now - lastBeatTime >= params.refractoryMs && sample > calInterPeak) {
+        calInterPeak = sample;
+    }
+
+    if (range < (int)params.minRange) return;  // Signal too weak or just noise, skip detection
 
     // Dynamic threshold
-    int threshold = rollingMin + (int)(range * THRESHOLD_RATIO);
+    int threshold = rollingMin + range * params.thresholdPct / 100;
 
     if (sample >= threshold) {
-        if (wasBelowThreshold && (now - lastBeatTime >= REFRACTORY_MS)) {
+        if (wasBelowThreshold && (now - lastBeatTime >= params.refractoryMs)) {
+            // Only score cycles that lie within one rolling window (consistent min/range)
+            if (calActive && calInterPeak >= 0 && lastBeatTime >= windowStart && calBeatCount < AD8232_CAL_MAX_BEATS) {
+                calInterPeaks[calBeatCount++] = clampInt((calInterPeak - rollingMin) * 100 / range, 0, 100);
+            }
+            calInterPeak = -1;
+
             // Beat detected — record interval for BPM
+            unsigned long rawInterval = (prevBeatTime > 0) ? now - prevBeatTime : 0;
+            bool accepted = false;
             if (prevBeatTime > 0) {
-                unsigned long interval = now - prevBeatTime;
-                if (interval > 300 && interval < 4000) {
-                    while (interval > 1500) interval /= 2;
-                    beatIntervals[beatIntervalIndex] = interval;
-                    beatIntervalIndex = (beatIntervalIndex + 1) % BPM_BUFFER_SIZE;
-                    if (beatIntervalCount < BPM_BUFFER_SIZE) beatIntervalCount++;
+                accepted = hrvAddInterval(rawInterval) == HrvVerdict::ACCEPTED;
+                sqiAddBeat(accepted);
+                if (!accepted && hrEnabled) {
+                    LOG_D("[HR] Rejected R-R %lu ms (median %lu)", rawInterval, (unsigned long)hrvMedianInterval());
                 }
             }
+            // Rejected intervals go out as unknown, so the server's statistics skip them too
+            if (hrEnabled && reportMode == HrReportMode::BEATS) beatsQueue(now - LOWPASS_DELAY_MS, accepted ? rawInterval : 0);
             prevBeatTime = now;
 
             lastBeatTime = now;
 
             // Only flash LED when reporting is enabled
             if (hrEnabled) {
-                Serial.printf("[HR] Beat detected  sample=%d  threshold=%d  range=%d\n", sample, threshold, range);
+                LOG_D("[HR] Beat detected  sample=%d  threshold=%d  range=%d", sample, threshold, range);
                 digitalWrite(PIN_LED_HEARTBEAT, HIGH);
                 beatLedOn = true;
                 beatLedOnTime = now;
@@ -160,41 +560,137 @@ void heartrateUpdate() {
     }
 }
 
-uint8_t heartrateGetBPM() {
-    if (beatIntervalCount == 0) return 0;
+void heartrateUpdate() {
+    PROF_SCOPE(ProfScope::HEARTRATE);
+    if (!hrPowered) return;
 
-    unsigned long sum = 0;
-    int count = min(beatIntervalCount, BPM_BUFFER_SIZE);
-    for (int i = 0; i < count; i++) {
-        sum += beatIntervals[i];
+    unsigned long now = millis();
+
+    // Turn off beat LED after flash duration
+    if (beatLedOn && (now - beatLedOnTime >= AD8232_BEAT_FLASH_MS)) {
+        digitalWrite(PIN_LED_HEARTBEAT, LOW);
+        beatLedOn = false;
     }
-    unsigned long avgInterval = sum / count;
-    if (avgInterval == 0) return 0;
 
-    unsigned long bpm = 60000 / avgInterval;
-    if (bpm > 220) bpm = 220;
-    return (uint8_t)bpm;
+    if (calActive && (long)(now - calEnd) >= 0) calFinish();
+
+    // One sample per call — every AD8232_SAMPLE_MS (~250 Hz) while the leads are on
+    if (!leadsUpdate(now)) return;
+
+    // Read analog signal
+    int sample = analogRead(PIN_AD8232_OUT);
+
+    if (hrEnabled && waveStreaming) waveformPush(sample, now);
+    scopePush(sample);
+    sqiAddSample(sample);
+
+    // Start the filter settled at the current level instead of ramping up from zero
+    if (!lowpassPrimed) {
+        dspFirPrime(&lowpass, sample);
+        lowpassPrimed = true;
+    }
+    blockIn[blockCount] = sample;
+    blockTime[blockCount] = now;
+    if (++blockCount < AD8232_FILTER_BLOCK) return;
+
+    dspFirQ15(&lowpass, blockIn, blockOut, AD8232_FILTER_BLOCK);
+    blockCount = 0;
+    for (int i = 0; i < AD8232_FILTER_BLOCK; i++) detectSample(blockOut[i], blockTime[i]);
+}
+
+uint8_t heartrateGetBPM() {
+    uint8_t bpm = hrvGetStats().bpm;
+    return bpm > 220 ? 220 : bpm;
+}
+
+HrvStats heartrateGetStats() {
+    return hrvGetStats();
+}
+
+uint8_t heartrateGetQuality() {
+    return (hrPowered && !leadsOff) ? sqiGet() : 0;
+}
+
+bool heartrateLeadsOff() {
+    return hrPowered && leadsOff;
+}
+
+uint32_t heartrateTaskPeriodMs() {
+    return hrPowered && !leadsOff ? AD8232_SAMPLE_MS : AD8232_LEADS_POLL_MS;
 }
 
 bool heartrateIsActive() {
     return (lastBeatTime > 0) && (millis() - lastBeatTime < ACTIVE_TIMEOUT_MS);
 }
 
-void heartrateSetSendCallback(void (*cb)(uint8_t)) {
+void heartrateSetSendCallback(void (*cb)(const HeartbeatReport&)) {
     bpmSendCallback = cb;
 }
 
-// Call each loop iteration when connected. Sends BPM every 2 s; sends 0 once when signal lost.
+void heartrateSetWaveSendCallback(bool (*cb)(const uint8_t*, size_t)) {
+    waveSendCallback = cb;
+}
+
+void heartrateSetBeatSendCallback(bool (*cb)(const uint8_t*, size_t)) {
+    beatSendCallback = cb;
+}
+
+void heartrateSetReportMode(HrReportMode mode) {
+    if (mode == reportMode) return;
+    reportMode = mode;
+    beatQueueCount = 0;
+    LOG_I("[HR] Report mode: %s", mode == HrReportMode::BEATS ? "beats" : "bpm");
+}
+
+void heartrateSetWaveformStreaming(bool enabled) {
+    if (enabled == waveStreaming) return;
+    waveStreaming = enabled;
+    waveformReset();
+    LOG_I("[HR] Waveform stream %s", enabled ? "on" : "off");
+}
+
+// Call each loop iteration when connected. Flushes stream/beat frames; in bpm mode sends stats
+// every 2 s. Either mode sends zeros once when the signal is lost.
 void heartrateCheckAndSend() {
-    if (!bpmSendCallback) return;
     unsigned long now = millis();
-    bool active = heartrateIsActive();
-    if (active && (now - lastBpmSend >= BPM_SEND_INTERVAL_MS)) {
-        bpmSendCallback(heartrateGetBPM());
+
+    if (waveCount > 0 && now - waveFrameStart >= AD8232_WAVE_FRAME_MS) {
+        waveformFlush();
+    }
+
+    if (beatQueueCount > 0 &&
+        (beatQueueCount >= AD8232_BEAT_BATCH_MAX || now - beatQueueTime[0] >= AD8232_BEAT_BATCH_MS)) {
+        beatsFlush(now);
+    }
+
+    if (!bpmSendCallback) return;
+    HeartbeatReport report = {};
+    report.leadsOff = leadsOff;
+    report.quality = leadsOff ? 0 : sqiGet();
+
+    if (leadsReportPending) {
+        // Contact change is reported at once; stats follow on the normal schedule
+        leadsReportPending = false;
+        bpmSendCallback(report);
+        lastBpmActive = false;
+        return;
+    }
+
+    // Beats mode has no periodic report: the server derives BPM and HRV from the BEATS
+    // frames. Those are only sent while the monitor is enabled, so until then the BPM
+    // report keeps going. Contact changes and the final clear still come through here.
+    bool active = !leadsOff && heartrateIsActive();
+    bool periodic = reportMode == HrReportMode::BPM || !hrEnabled;
+    if (active && periodic && now - lastBpmSend >= tunableGet(Tunable::BPM_SEND)) {
+        report.hrv = hrvGetStats();
+        if (report.hrv.bpm > 220) report.hrv.bpm = 220;
+        bpmSendCallback(report);
         lastBpmSend = now;
         lastBpmActive = true;
+    } else if (active && !periodic) {
+        lastBpmActive = true;
     } else if (!active && lastBpmActive) {
-        bpmSendCallback(0);  // One final send to clear server-side BPM
+        bpmSendCallback(report);  // One final send to clear server-side BPM
         lastBpmActive = false;
     }
 }
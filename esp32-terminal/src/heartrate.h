@@ -3,19 +3,42 @@
 #define HEARTRATE_H
 
 #include <Arduino.h>
+#include "protocol.h"
+#include "hrv.h"
+#include "hrparams.h"
 
 // Initialize AD8232 pins and panel LEDs
 void heartrateInit();
 
-// Sample ADC, detect beats, drive LEDs (call every loop iteration)
+// Sample ADC, detect beats, drive LEDs (call every heartrateTaskPeriodMs() — one sample per call)
 void heartrateUpdate();
 
-// Get current BPM (average of recent beat intervals, 0 if insufficient data)
+// Periodic report handed to the send callback
+struct HeartbeatReport {
+    HrvStats hrv;
+    bool leadsOff;      // Electrodes disconnected (bpm is 0, not a flat-lined player)
+    uint8_t quality;    // Signal quality index of the last 2 s window, 0-100 (see sqi.cpp)
+};
+
+// Get current BPM (trimmed mean of recent beat intervals, 0 if insufficient data)
 uint8_t heartrateGetBPM();
 
+// BPM plus HRV (RMSSD/SDNN) over the rolling window; ectopic intervals are excluded
+HrvStats heartrateGetStats();
+
 // Returns true if a beat was detected within the last 3 seconds
 bool heartrateIsActive();
 
+// Signal quality of the last detection window, 0-100 (0 while powered down or leads off)
+uint8_t heartrateGetQuality();
+
+// Returns true while LO+ or LO- reports a disconnected electrode (debounced)
+bool heartrateLeadsOff();
+
+// How often heartrateUpdate() wants to run: AD8232_SAMPLE_MS while sampling,
+// AD8232_LEADS_POLL_MS while the leads are off or the AD8232 is powered down
+uint32_t heartrateTaskPeriodMs();
+
 // Power the AD8232 on/off (controls shutdown pin)
 void heartratePowerOn();
 void heartratePowerOff();
@@ -24,11 +47,52 @@ void heartratePowerOff();
 void heartrateEnable();
 void heartrateDisable();
 
-// Register callback for sending BPM to the server (avoids circular dependency on network.cpp).
+// Player slot whose stored calibration is loaded on power-on (0 = none / operator)
+void heartrateSetPlayerSlot(uint8_t slot);
+
+// Learn DetectorParams from the live signal for durationMs (0 cancels), then store them
+// for the current slot. The result is handed to the calibration callback.
+void heartrateStartCalibration(unsigned long durationMs);
+bool heartrateIsCalibrating();
+
+// An hr* tunable changed: the live detector follows unless the slot is calibrated
+void heartrateDetectorDefaultsChanged();
+
+// Store the live params for the slot again (false: no player slot, or not calibrated)
+bool heartrateSaveDetectorParams();
+
+// Register callback for reporting a finished calibration (success=false: not enough beats)
+void heartrateSetCalibrationCallback(void (*cb)(bool success, const DetectorParams& params, uint8_t beats));
+
+// Register callback for sending BPM/HRV to the server (avoids circular dependency on network.cpp).
 // Call once during setup: heartrateSetSendCallback(networkSendHeartbeat)
-void heartrateSetSendCallback(void (*cb)(uint8_t bpm));
+void heartrateSetSendCallback(void (*cb)(const HeartbeatReport& report));
 
-// Call each connected loop iteration. Sends BPM on schedule; sends 0 once when signal lost.
+// Call each connected loop iteration. Sends stats on schedule; sends zeros once when signal lost,
+// and immediately on each leads-off/on transition.
+// Also flushes the pending waveform frame once AD8232_WAVE_FRAME_MS has elapsed.
 void heartrateCheckAndSend();
 
+// Opt-in raw waveform stream (only produces frames while reporting is enabled).
+void heartrateSetWaveformStreaming(bool enabled);
+
+// Local trace for the OLED scope (DisplayStyle::ECG) — samples averaged down to
+// AD8232_SCOPE_DECIMATE, independent of the network stream. Copies up to max samples
+// that arrived since the last call, oldest first; returns the count. If the reader
+// falls more than AD8232_SCOPE_RING behind, the oldest samples are skipped.
+size_t heartrateScopeRead(uint16_t* out, size_t max);
+
+// Register callback for sending binary waveform frames (see BinFrame::ECG_WAVE).
+// Returns false if the frame was dropped; the sequence number still advances so the
+// server can count the gap. Call once during setup: heartrateSetWaveSendCallback(networkSendStream)
+void heartrateSetWaveSendCallback(bool (*cb)(const uint8_t* frame, size_t len));
+
+// BPM: periodic stats only (default). BEATS: additionally sends per-beat BinFrame::BEATS
+// frames for beat-accurate display; the periodic stats send continues in both modes.
+void heartrateSetReportMode(HrReportMode mode);
+
+// Register callback for sending BEATS frames. Unlike the waveform these are not
+// budget-capped (a few bytes per beat). Call once during setup.
+void heartrateSetBeatSendCallback(bool (*cb)(const uint8_t* frame, size_t len));
+
 #endif // HEARTRATE_H
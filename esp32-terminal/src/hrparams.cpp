@@ -0,0 +1,27 @@
+// Beat detector parameters
+
+#include "hrparams.h"
+#include "tunables.h"
+
+DetectorParams hrParamsDefaults() {
+    DetectorParams p = {
+        (uint8_t)tunableGet(Tunable::HR_THRESHOLD),
+        (uint16_t)tunableGet(Tunable::HR_MIN_RANGE),
+        (uint16_t)tunableGet(Tunable::HR_REFRACTORY),
+        0, 0, false
+    };
+    return p;
+}
+
+bool hrParamsDefaultsChanged(DetectorParams* p) {
+    if (p->learned) return false;
+    DetectorParams d = hrParamsDefaults();
+    if (d.thresholdPct == p->thresholdPct && d.minRange == p->minRange &&
+        d.refractoryMs == p->refractoryMs) return false;
+    *p = d;
+    return true;
+}
+
+bool hrParamsStorable(const DetectorParams& p) {
+    return p.learned && p.typicalRange > 0;
+}
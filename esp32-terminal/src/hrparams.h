@@ -0,0 +1,29 @@
+// Beat detector parameters — the tunable defaults, and what a default change does to the
+// set a player slot is running with.
+#ifndef HRPARAMS_H
+#define HRPARAMS_H
+
+#include <stdint.h>
+
+// Beat detector tuning — defaults until a calibration run has been stored for the slot
+struct DetectorParams {
+    uint8_t thresholdPct;    // Beat threshold as % of the rolling range above its min
+    uint16_t minRange;       // Windows with less peak-to-peak than this are ignored
+    uint16_t refractoryMs;   // Dead time after a beat
+    uint16_t baseline;       // Typical window minimum (pre-warms the rolling window)
+    uint16_t typicalRange;   // Typical peak-to-peak
+    bool learned;            // false = firmware defaults
+};
+
+// The hrThresholdPct / hrMinRange / hrRefractoryMs tunables
+DetectorParams hrParamsDefaults();
+
+// An hr* tunable changed: params still on the defaults follow it, a calibrated slot keeps
+// what it learned. Returns whether p changed.
+bool hrParamsDefaultsChanged(DetectorParams* p);
+
+// Whether p may be stored for a slot: loading pre-warms the rolling window with baseline
+// and typicalRange, which only a calibration run measures
+bool hrParamsStorable(const DetectorParams& p);
+
+#endif // HRPARAMS_H
@@ -0,0 +1,145 @@
+// Beat-interval statistics
+//
+// Accepted intervals live in a ring (arrival order) and a sorted copy (for median and
+// trimmed mean). Running sums give SDNN; a second ring of squared successive differences
+// gives RMSSD. A rejection breaks the successive-difference chain so a dropped beat
+// never shows up as a huge RMSSD spike.
+
+#include "hrv.h"
+#include "config.h"
+#include <math.h>
+
+static uint16_t ring[HRV_WINDOW];
+static uint16_t sorted[HRV_WINDOW];
+static int count = 0;
+static int next = 0;
+static uint32_t sum = 0;
+static uint64_t sumSq = 0;
+
+static uint32_t diffSq[HRV_WINDOW];
+static int diffCount = 0;
+static int diffNext = 0;
+static uint64_t diffSum = 0;
+
+static uint16_t lastAccepted = 0;   // 0 = chain broken
+static int consecutiveRejects = 0;
+static uint16_t rejectedTotal = 0;
+
+static void sortedRemove(uint16_t value) {
+    int i = 0;
+    while (i < count && sorted[i] != value) i++;
+    for (; i < count - 1; i++) sorted[i] = sorted[i + 1];
+}
+
+static void sortedInsert(uint16_t value) {
+    int i = count;
+    while (i > 0 && sorted[i - 1] > value) {
+        sorted[i] = sorted[i - 1];
+        i--;
+    }
+    sorted[i] = value;
+}
+
+static void clearWindow() {
+    count = 0;
+    next = 0;
+    sum = 0;
+    sumSq = 0;
+    diffCount = 0;
+    diffNext = 0;
+    diffSum = 0;
+    lastAccepted = 0;
+    consecutiveRejects = 0;
+}
+
+static void pushDiff(uint32_t sq) {
+    if (diffCount == HRV_WINDOW) {
+        diffSum -= diffSq[diffNext];
+    } else {
+        diffCount++;
+    }
+    diffSq[diffNext] = sq;
+    diffSum += sq;
+    diffNext = (diffNext + 1) % HRV_WINDOW;
+}
+
+static HrvVerdict reject(HrvVerdict verdict) {
+    lastAccepted = 0;
+    consecutiveRejects++;
+    if (rejectedTotal < 0xFFFF) rejectedTotal++;
+    return verdict;
+}
+
+HrvVerdict hrvAddInterval(uint32_t rrMs) {
+    if (rrMs < HRV_RR_MIN_MS || rrMs > HRV_RR_MAX_MS) return reject(HrvVerdict::OUT_OF_RANGE);
+
+    if (count >= HRV_MIN_INTERVALS) {
+        uint32_t median = hrvMedianInterval();
+        uint32_t dev = rrMs > median ? rrMs - median : median - rrMs;
+        if (dev * 100 > median * HRV_ECTOPIC_PCT) {
+            // A run of "outliers" that agree with each other is a real rate change
+            if (consecutiveRejects + 1 < HRV_REJECT_RESET) return reject(HrvVerdict::ECTOPIC);
+            clearWindow();
+        }
+    }
+    consecutiveRejects = 0;
+
+    uint16_t rr = (uint16_t)rrMs;
+    if (count == HRV_WINDOW) {
+        uint16_t old = ring[next];
+        sortedRemove(old);
+        count--;
+        sum -= old;
+        sumSq -= (uint32_t)old * old;
+    }
+    sortedInsert(rr);
+    ring[next] = rr;
+    next = (next + 1) % HRV_WINDOW;
+    count++;
+    sum += rr;
+    sumSq += (uint32_t)rr * rr;
+
+    if (lastAccepted > 0) {
+        int32_t d = (int32_t)rr - lastAccepted;
+        pushDiff((uint32_t)(d * d));
+    }
+    lastAccepted = rr;
+    return HrvVerdict::ACCEPTED;
+}
+
+uint32_t hrvMedianInterval() {
+    if (count == 0) return 0;
+    if (count & 1) return sorted[count / 2];
+    return (sorted[count / 2 - 1] + sorted[count / 2]) / 2;
+}
+
+static uint8_t toBpm(uint32_t intervalMs) {
+    if (intervalMs == 0) return 0;
+    uint32_t bpm = (60000 + intervalMs / 2) / intervalMs;
+    return bpm > 255 ? 255 : (uint8_t)bpm;
+}
+
+HrvStats hrvGetStats() {
+    HrvStats s = {};
+    s.count = count;
+    s.rejected = rejectedTotal;
+    if (count < HRV_MIN_INTERVALS) return s;
+
+    // Trimmed mean: drop the lowest and highest quarter
+    int trim = count / 4;
+    uint32_t trimmedSum = 0;
+    for (int i = trim; i < count - trim; i++) trimmedSum += sorted[i];
+    s.bpm = toBpm(trimmedSum / (count - 2 * trim));
+    s.medianBpm = toBpm(hrvMedianInterval());
+
+    uint64_t n = count;
+    uint64_t var = (n * sumSq - (uint64_t)sum * sum) / (n * n);
+    s.sdnn = (uint16_t)(sqrtf((float)var) + 0.5f);
+    if (diffCount > 0) s.rmssd = (uint16_t)(sqrtf((float)diffSum / diffCount) + 0.5f);
+    return s;
+}
+
+void hrvReset() {
+    clearWindow();
+    rejectedTotal = 0;
+}
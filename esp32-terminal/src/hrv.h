@@ -0,0 +1,33 @@
+// Beat-interval statistics — robust BPM, RMSSD and SDNN over a rolling window.
+#ifndef HRV_H
+#define HRV_H
+
+#include <stdint.h>
+
+struct HrvStats {
+    uint8_t bpm;          // From the trimmed mean of the window (0 if < HRV_MIN_INTERVALS)
+    uint8_t medianBpm;    // From the median interval
+    uint16_t rmssd;       // Root mean square of successive differences, ms (0 if no pairs)
+    uint16_t sdnn;        // Standard deviation of intervals, ms
+    uint8_t count;        // Intervals currently in the window
+    uint16_t rejected;    // Intervals rejected since the last reset
+};
+
+enum class HrvVerdict {
+    ACCEPTED,
+    OUT_OF_RANGE,   // Outside HRV_RR_MIN_MS..HRV_RR_MAX_MS
+    ECTOPIC         // Too far from the running median (missed, doubled or premature beat)
+};
+
+// Feed one R-R interval in ms. Constant work per beat (bounded by HRV_WINDOW).
+HrvVerdict hrvAddInterval(uint32_t rrMs);
+
+HrvStats hrvGetStats();
+
+// Median of accepted intervals, ms (0 if empty)
+uint32_t hrvMedianInterval();
+
+// Clear the window (e.g. electrodes removed or monitor powered down)
+void hrvReset();
+
+#endif // HRV_H
@@ -1,15 +1,16 @@
 // Input Handler Implementation
 #include "input.h"
 #include "config.h"
+#include "prof.h"
+#include "tunables.h"
 #include <ESP32Encoder.h>
 
-#define LONG_PRESS_MS 600
-
 // Button debounce state
 static bool lastYesState = true;  // HIGH when not pressed (pullup)
 static bool lastNoState = true;
 static unsigned long lastYesChange = 0;
 static unsigned long lastNoChange = 0;
+static uint32_t debounceMs = DEBOUNCE_MS;   // Copy of the tunable the edge ISR can read
 
 // Long press tracking: start timing on press, fire normal on release if not long
 static bool yesPressing = false;
@@ -25,6 +26,47 @@ static ESP32Encoder encoder;
 static int32_t lastEncoderCount = 0;
 static unsigned long lastEncoderPoll = 0;
 
+// Task woken on button edges (see inputSetWakeTask)
+static TaskHandle_t wakeTask = nullptr;
+
+// Edge capture times (micros) stamped by the ISR, so an event is timed from the physical
+// edge rather than from the poll that noticed it. A button keeps the first edge of a
+// bounce burst; the encoder keeps its latest step.
+enum EdgeSource { EDGE_YES, EDGE_NO, EDGE_SW, EDGE_ENCODER, EDGE_SOURCES };
+static volatile uint32_t edgeUs[EDGE_SOURCES];
+static volatile uint32_t lastEdgeUs[EDGE_SOURCES];
+static uint32_t eventCapturedUs = 0;
+
+static void IRAM_ATTR onInputEdge(void* arg) {
+    int src = (int)(intptr_t)arg;
+    uint32_t now = micros();
+    if (src == EDGE_ENCODER || now - lastEdgeUs[src] > debounceMs * 1000UL) edgeUs[src] = now;
+    lastEdgeUs[src] = now;
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(wakeTask, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+// Remember when `event` was captured and return it
+static InputEvent captured(InputEvent event, int src) {
+    eventCapturedUs = (wakeTask != nullptr && src < EDGE_SOURCES) ? edgeUs[src] : micros();
+    return event;
+}
+
+void inputSetWakeTask(TaskHandle_t task) {
+    wakeTask = task;
+    attachInterruptArg(digitalPinToInterrupt(PIN_BTN_YES), onInputEdge, (void*)EDGE_YES, CHANGE);
+    attachInterruptArg(digitalPinToInterrupt(PIN_BTN_NO), onInputEdge, (void*)EDGE_NO, CHANGE);
+    attachInterruptArg(digitalPinToInterrupt(PIN_ENCODER_SW), onInputEdge, (void*)EDGE_SW, CHANGE);
+    attachInterruptArg(digitalPinToInterrupt(PIN_ENCODER_A), onInputEdge, (void*)EDGE_ENCODER, CHANGE);
+    attachInterruptArg(digitalPinToInterrupt(PIN_ENCODER_B), onInputEdge, (void*)EDGE_ENCODER, CHANGE);
+}
+
+uint32_t inputEventCapturedUs() {
+    return eventCapturedUs;
+}
+
 void inputInit() {
     // Configure button pins with internal pullup
     pinMode(PIN_BTN_YES, INPUT_PULLUP);
@@ -36,6 +78,7 @@ void inputInit() {
     encoder.attachFullQuad(PIN_ENCODER_A, PIN_ENCODER_B);
     encoder.clearCount();
     lastEncoderCount = 0;
+    debounceMs = tunableGet(Tunable::DEBOUNCE);
 
     // Initialize button states
     lastYesState = digitalRead(PIN_BTN_YES);
@@ -43,12 +86,13 @@ void inputInit() {
 }
 
 InputEvent inputPoll() {
+    PROF_SCOPE(ProfScope::INPUTS);
     unsigned long now = millis();
 
     // === Check YES button ===
     bool yesState = digitalRead(PIN_BTN_YES);
     if (yesState != lastYesState) {
-        if (now - lastYesChange > DEBOUNCE_MS) {
+        if (now - lastYesChange > debounceMs) {
             lastYesChange = now;
             lastYesState = yesState;
 
@@ -61,7 +105,7 @@ InputEvent inputPoll() {
                 // Button released — fire normal press if long press didn't already fire
                 if (yesPressing && !yesLongFired) {
                     yesPressing = false;
-                    return InputEvent::YES;
+                    return captured(InputEvent::YES, EDGE_YES);
                 }
                 yesPressing = false;
             }
@@ -69,15 +113,15 @@ InputEvent inputPoll() {
     }
 
     // Check YES long press threshold while button is held
-    if (yesPressing && !yesLongFired && (now - yesPressStart >= LONG_PRESS_MS)) {
+    if (yesPressing && !yesLongFired && (now - yesPressStart >= tunableGet(Tunable::LONG_PRESS))) {
         yesLongFired = true;
-        return InputEvent::LONG_YES;
+        return captured(InputEvent::LONG_YES, EDGE_SOURCES);  // Timed from the hold threshold
     }
 
     // === Check NO button ===
     bool noState = digitalRead(PIN_BTN_NO);
     if (noState != lastNoState) {
-        if (now - lastNoChange > DEBOUNCE_MS) {
+        if (now - lastNoChange > debounceMs) {
             lastNoChange = now;
             lastNoState = noState;
 
@@ -90,7 +134,7 @@ InputEvent inputPoll() {
                 // Button released — fire normal press if long press didn't already fire
                 if (noPressing && !noLongFired) {
                     noPressing = false;
-                    return InputEvent::NO;
+                    return captured(InputEvent::NO, EDGE_NO);
                 }
                 noPressing = false;
             }
@@ -98,13 +142,13 @@ InputEvent inputPoll() {
     }
 
     // Check NO long press threshold while button is held
-    if (noPressing && !noLongFired && (now - noPressStart >= LONG_PRESS_MS)) {
+    if (noPressing && !noLongFired && (now - noPressStart >= tunableGet(Tunable::LONG_PRESS))) {
         noLongFired = true;
-        return InputEvent::LONG_NO;
+        return captured(InputEvent::LONG_NO, EDGE_SOURCES);
     }
 
     // === Check rotary encoder ===
-    if (now - lastEncoderPoll > ENCODER_POLL_MS) {
+    if (now - lastEncoderPoll > tunableGet(Tunable::ENCODER_POLL)) {
         lastEncoderPoll = now;
 
         int32_t currentCount = encoder.getCount();
@@ -112,10 +156,10 @@ InputEvent inputPoll() {
 
         if (diff >= ENCODER_PULSES_PER_DETENT) {
             lastEncoderCount += ENCODER_PULSES_PER_DETENT;
-            return InputEvent::DOWN;
+            return captured(InputEvent::DOWN, EDGE_ENCODER);
         } else if (diff <= -ENCODER_PULSES_PER_DETENT) {
             lastEncoderCount -= ENCODER_PULSES_PER_DETENT;
-            return InputEvent::UP;
+            return captured(InputEvent::UP, EDGE_ENCODER);
         }
     }
 
@@ -134,7 +178,7 @@ static unsigned long lastEncoderBtnChange = 0;
 
 bool inputCheckEncoderTap() {
     bool state = digitalRead(PIN_ENCODER_SW);
-    if (state != lastEncoderBtnState && (millis() - lastEncoderBtnChange > DEBOUNCE_MS)) {
+    if (state != lastEncoderBtnState && (millis() - lastEncoderBtnChange > debounceMs)) {
         unsigned long now = millis();
         lastEncoderBtnChange = now;
         lastEncoderBtnState = state;
@@ -144,3 +188,7 @@ bool inputCheckEncoderTap() {
     }
     return false;
 }
+
+void inputSetDebounceMs(uint32_t ms) {
+    debounceMs = ms;
+}
@@ -16,7 +16,18 @@ InputEvent inputPoll();
 // Get the current encoder position (1-8 range, wrapping)
 uint8_t inputGetRotaryPosition();
 
+// micros() when the event last returned by inputPoll() physically happened (the edge
+// stamped by the wake ISR; the poll time before inputSetWakeTask() or for long presses)
+uint32_t inputEventCapturedUs();
+
 // Returns true once on a short encoder button press (< 500 ms hold)
 bool inputCheckEncoderTap();
 
+// Give `task` a notification on every button edge (YES, NO, encoder switch) and encoder
+// step, so a loop sleeping in ulTaskNotifyTake() wakes at once instead of at its next tick
+void inputSetWakeTask(TaskHandle_t task);
+
+// Button debounce window — the DEBOUNCE_MS tunable, copied here for the edge ISR
+void inputSetDebounceMs(uint32_t ms);
+
 #endif // INPUT_H
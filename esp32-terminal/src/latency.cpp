@@ -0,0 +1,110 @@
+// Input-to-photon latency
+//
+// One pending measurement per metric: inputs arriving while one is open are folded into
+// it. Samples go into a small ring per metric and phase; percentiles sort a copy.
+
+#include "latency.h"
+
+struct LatencyRing {
+    uint32_t samples[LATENCY_SAMPLES];
+    uint16_t count;
+    uint16_t next;
+};
+
+struct Pending {
+    bool open;
+    uint32_t capturedUs;
+};
+
+static LatencyRing rings[LATENCY_METRICS][LATENCY_PHASES];
+static Pending pending[LATENCY_METRICS];
+static uint32_t timeouts = 0;
+
+static void push(LatencyMetric metric, uint8_t phase, uint32_t us) {
+    if (phase >= LATENCY_PHASES) return;
+    LatencyRing& r = rings[(int)metric][phase];
+    r.samples[r.next] = us;
+    r.next = (r.next + 1) % LATENCY_SAMPLES;
+    if (r.count < LATENCY_SAMPLES) r.count++;
+}
+
+// Close the pending measurement at `atUs`, recording it unless it timed out
+static void close(LatencyMetric metric, uint32_t atUs, uint8_t phase) {
+    Pending& p = pending[(int)metric];
+    if (!p.open) return;
+    int32_t us = (int32_t)(atUs - p.capturedUs);
+    if (us < 0) return;     // Arrived before the input (already in flight)
+    p.open = false;
+    if ((uint32_t)us > LATENCY_TIMEOUT_MS * 1000UL) {
+        timeouts++;
+        return;
+    }
+    push(metric, phase, (uint32_t)us);
+}
+
+void latencyReset() {
+    for (auto& metric : rings) {
+        for (LatencyRing& r : metric) r = {};
+    }
+    for (Pending& p : pending) p = {};
+    timeouts = 0;
+}
+
+// Start a measurement, replacing one that was never answered
+static void open(LatencyMetric metric, uint32_t capturedUs) {
+    Pending& p = pending[(int)metric];
+    if (p.open && capturedUs - p.capturedUs > LATENCY_TIMEOUT_MS * 1000UL) {
+        p.open = false;
+        timeouts++;
+    }
+    if (!p.open) p = { true, capturedUs };
+}
+
+void latencyInput(uint32_t capturedUs, bool awaitsAck) {
+    open(LatencyMetric::PHOTON, capturedUs);
+    if (awaitsAck) open(LatencyMetric::ACK, capturedUs);
+}
+
+void latencyPresented(uint32_t nowUs, uint8_t phase) {
+    close(LatencyMetric::PHOTON, nowUs, phase);
+}
+
+void latencyStateArrived(uint32_t arrivedUs, uint8_t phase) {
+    close(LatencyMetric::ACK, arrivedUs, phase);
+}
+
+static uint32_t rank(const uint32_t* sorted, int n, int pct) {
+    int idx = (pct * n + 99) / 100 - 1;     // Nearest rank
+    if (idx < 0) idx = 0;
+    return sorted[idx];
+}
+
+LatencyPercentiles latencyGet(LatencyMetric metric, uint8_t phase) {
+    LatencyPercentiles out = {};
+    if ((int)metric >= LATENCY_METRICS || phase >= LATENCY_PHASES) return out;
+    const LatencyRing& r = rings[(int)metric][phase];
+    if (r.count == 0) return out;
+
+    uint32_t sorted[LATENCY_SAMPLES];
+    int n = r.count;
+    for (int i = 0; i < n; i++) {
+        uint32_t v = r.samples[i];
+        int j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+
+    out.count = n;
+    out.p50Us = rank(sorted, n, 50);
+    out.p90Us = rank(sorted, n, 90);
+    out.p99Us = rank(sorted, n, 99);
+    out.maxUs = sorted[n - 1];
+    return out;
+}
+
+uint32_t latencyTimeouts() {
+    return timeouts;
+}
@@ -0,0 +1,45 @@
+// Input-to-photon latency — from the capture of an input event to the OLED push that
+// follows it, and to the server's next player state. Kept per game phase.
+// Every event carries its own microsecond timestamp; the module never reads a clock.
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+#include "config.h"
+
+enum class LatencyMetric : uint8_t {
+    PHOTON,     // Input captured -> displayPresent() finished the SPI push
+    ACK,        // Input captured -> next playerState arrived from the server
+    COUNT
+};
+
+static const int LATENCY_METRICS = (int)LatencyMetric::COUNT;
+static const int LATENCY_PHASES = 11;   // GameLedState values
+
+struct LatencyPercentiles {
+    uint16_t count;     // Samples in the window (at most LATENCY_SAMPLES)
+    uint32_t p50Us;
+    uint32_t p90Us;
+    uint32_t p99Us;
+    uint32_t maxUs;
+};
+
+void latencyReset();
+
+// An input event was acted on. Starts the photon measurement unless one is already
+// waiting for a frame (the earliest unanswered input is what the player waits on);
+// awaitsAck also starts the server acknowledgement measurement.
+void latencyInput(uint32_t capturedUs, bool awaitsAck);
+
+// A frame was pushed to the OLED / a player state arrived, while in `phase`.
+// Measurements older than LATENCY_TIMEOUT_MS are dropped instead (nothing answered them).
+void latencyPresented(uint32_t nowUs, uint8_t phase);
+void latencyStateArrived(uint32_t arrivedUs, uint8_t phase);
+
+// Over the last LATENCY_SAMPLES per metric and phase (nearest-rank percentiles)
+LatencyPercentiles latencyGet(LatencyMetric metric, uint8_t phase);
+
+// Measurements dropped on timeout since the last reset
+uint32_t latencyTimeouts();
+
+#endif // LATENCY_H
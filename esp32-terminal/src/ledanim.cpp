@@ -0,0 +1,97 @@
+// Keyframe LED animations
+//
+// A small fixed table (LED_ANIM_SLOTS) of server-defined animations. Sampling is integer
+// only: segment progress is Q8 (0..256), eased, then used to interpolate each channel.
+
+#include "ledanim.h"
+#include <string.h>
+
+static LedAnimation table[LED_ANIM_SLOTS];
+static uint8_t used = 0;
+static uint8_t nextEvict = 0;
+
+void ledAnimStore(const LedAnimation& anim) {
+    for (uint8_t i = 0; i < used; i++) {
+        if (strncmp(table[i].id, anim.id, LED_ANIM_ID_LEN) == 0) {
+            table[i] = anim;
+            return;
+        }
+    }
+    if (used < LED_ANIM_SLOTS) {
+        table[used++] = anim;
+        return;
+    }
+    table[nextEvict] = anim;
+    nextEvict = (nextEvict + 1) % LED_ANIM_SLOTS;
+}
+
+const LedAnimation* ledAnimFind(const char* id) {
+    for (uint8_t i = 0; i < used; i++) {
+        if (strncmp(table[i].id, id, LED_ANIM_ID_LEN) == 0) return &table[i];
+    }
+    return nullptr;
+}
+
+void ledAnimClear() {
+    used = 0;
+    nextEvict = 0;
+}
+
+static uint32_t ease(LedEase curve, uint32_t t) {
+    switch (curve) {
+        case LedEase::IN:     return (t * t) >> 8;
+        case LedEase::OUT:    return 256 - (((256 - t) * (256 - t)) >> 8);
+        case LedEase::IN_OUT: return (t * t * (768 - 2 * t)) >> 16;
+        case LedEase::STEP:   return t >= 256 ? 256 : 0;
+        case LedEase::LINEAR:
+        default:              return t;
+    }
+}
+
+static uint8_t lerp(uint8_t a, uint8_t b, uint32_t t) {
+    return (uint8_t)(a + (((int32_t)b - a) * (int32_t)t) / 256);
+}
+
+static void frameOf(const LedKeyframe& k, LedAnimFrame* out) {
+    out->r = k.r;
+    out->g = k.g;
+    out->b = k.b;
+    out->level = k.level;
+}
+
+bool ledAnimSample(const LedAnimation& anim, uint32_t elapsedMs, LedAnimFrame* out) {
+    if (anim.count == 0) {
+        *out = {};
+        return false;
+    }
+
+    uint32_t cycle = 0;
+    for (uint8_t i = 1; i < anim.count; i++) cycle += anim.stops[i].ms;
+    if (cycle == 0) {
+        frameOf(anim.stops[anim.count - 1], out);
+        return false;
+    }
+
+    uint32_t loop = elapsedMs / cycle;
+    if (anim.loops > 0 && loop >= anim.loops) {
+        frameOf(anim.stops[anim.count - 1], out);
+        return false;
+    }
+
+    uint32_t t = elapsedMs % cycle;
+    for (uint8_t i = 1; i < anim.count; i++) {
+        const LedKeyframe& to = anim.stops[i];
+        if (t < to.ms) {
+            const LedKeyframe& from = anim.stops[i - 1];
+            uint32_t e = ease(to.ease, (t << 8) / to.ms);
+            out->r = lerp(from.r, to.r, e);
+            out->g = lerp(from.g, to.g, e);
+            out->b = lerp(from.b, to.b, e);
+            out->level = lerp(from.level, to.level, e);
+            return true;
+        }
+        t -= to.ms;
+    }
+    frameOf(anim.stops[anim.count - 1], out);  // Not reached: t < cycle
+    return true;
+}
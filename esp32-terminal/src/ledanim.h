@@ -0,0 +1,56 @@
+// Keyframe LED animations — defined by the server, cached by id, played on the LED tick.
+// Sampling maps elapsed time to a colour; leds.cpp owns the clock and the pixels.
+#ifndef LEDANIM_H
+#define LEDANIM_H
+
+#include <stdint.h>
+#include "config.h"
+
+enum class LedEase : uint8_t {
+    LINEAR,
+    IN,        // Quadratic ease-in
+    OUT,       // Quadratic ease-out
+    IN_OUT,    // Smoothstep
+    STEP       // Hold the previous stop, jump at the end of the segment
+};
+
+// Which LEDs an animation drives (the others keep their normal state)
+static const uint8_t LED_ANIM_NEOPIXEL = 0x01;
+static const uint8_t LED_ANIM_YES = 0x02;
+static const uint8_t LED_ANIM_NO = 0x04;
+
+// One stop. The first stop is the starting value; each later stop is reached `ms`
+// after the previous one.
+struct LedKeyframe {
+    uint16_t ms;
+    uint8_t r, g, b;     // Neopixel colour
+    uint8_t level;       // Button LED level, 0-255 of the channel's bright duty
+    LedEase ease;        // Curve of the segment that ends at this stop
+};
+
+struct LedAnimation {
+    char id[LED_ANIM_ID_LEN];
+    uint8_t targets;     // LED_ANIM_* bits
+    uint8_t loops;       // Times to play, 0 = until stopped
+    uint8_t count;       // Stops in use
+    LedKeyframe stops[LED_ANIM_MAX_STOPS];
+};
+
+struct LedAnimFrame {
+    uint8_t r, g, b, level;
+};
+
+// Cache an animation, replacing one with the same id (or the oldest entry when full)
+void ledAnimStore(const LedAnimation& anim);
+
+// Cached animation by id, nullptr if unknown
+const LedAnimation* ledAnimFind(const char* id);
+
+// Value at elapsedMs after the start. Returns false once every loop has played,
+// with out set to the last stop.
+bool ledAnimSample(const LedAnimation& anim, uint32_t elapsedMs, LedAnimFrame* out);
+
+// Drop every cached animation (server change)
+void ledAnimClear();
+
+#endif // LEDANIM_H
@@ -1,55 +1,202 @@
 // LED Controller Implementation
 #include "leds.h"
 #include "config.h"
+#include "ledanim.h"
+#include "prof.h"
+#include "logbuf.h"
 #include <Adafruit_NeoPixel.h>
+#include <driver/ledc.h>
 
 // Neopixel instance (1 pixel)
 static Adafruit_NeoPixel neopixel(1, PIN_NEOPIXEL, NEOPIXEL_ORDER + NEO_KHZ800);
 
-// Current LED states
-static LedState yesLedState = LedState::OFF;
-static LedState noLedState = LedState::OFF;
-
-// Neopixel fade: current (display) and target colors
-static float curR = 0, curG = 0, curB = 0;
-static float tgtR = 0, tgtG = 0, tgtB = 0;
+// PWM LEDs (YES/NO buttons, power). PULSE breathes on the LEDC hardware fade engine:
+// each breath is LED_PULSE_STEPS linear ramps along the sine table, and the fade-end
+// interrupt only flags the channel — ledsUpdate() arms the next ramp. Nothing runs per frame.
+struct PwmLed {
+    uint8_t channel;
+    uint8_t dim;             // Duty for LedState::DIM
+    uint8_t bright;          // Duty for BRIGHT and the top of a PULSE breath
+    LedState state;
+    bool fading;             // A hardware ramp is in flight (LEDC calls would block until it ends)
+    volatile bool fadeDone;  // Set from the fade-end ISR
+    uint8_t step;            // Position within the breath
+    bool animated;           // A keyframe animation owns the channel
+    int16_t animDuty;        // Last duty written by the animation (-1 = none yet)
+};
+static PwmLed pwmYes = { PWM_CHANNEL_YES, LED_DIM, LED_BRIGHT, LedState::OFF, false, false, 0, false, -1 };
+static PwmLed pwmNo = { PWM_CHANNEL_NO, LED_DIM, LED_BRIGHT_NO, LedState::OFF, false, false, 0, false, -1 };
+static PwmLed pwmPower = { PWM_CHANNEL_POWER, LED_POWER_BRIGHT, LED_POWER_HIGH, LedState::DIM, false, false, 0, false, -1 };
+static PwmLed* const pwmLeds[] = { &pwmYes, &pwmNo, &pwmPower };
+
+// Neopixel fade: current (display) and target colors, 8.8 fixed point
+static uint16_t curR = 0, curG = 0, curB = 0;
+static uint16_t tgtR = 0, tgtG = 0, tgtB = 0;
 static bool statusPulse = false;
+static bool neopixelSettled = false;   // Last frame changed nothing and the next won't either
+
+// Keyframe animation playing over the normal state (a copy, so a redefinition by the
+// server doesn't change it mid-play)
+static LedAnimation anim;
+static bool animPlaying = false;
+static unsigned long animStart = 0;
 
-// Pulse animation state
+// Pulse animation state — 16-bit phase, one full turn per LED_PULSE_MS
 static unsigned long lastPulseUpdate = 0;
-static float pulsePhase = 0;
+static uint16_t pulsePhase = 0;
+static uint8_t sineLut[256];         // 0.5 + 0.5 * sin, scaled to 0..255 (filled in ledsInit)
+
+// Global neopixel brightness 25/255, applied here rather than with setBrightness() so
+// the colour compared below is exactly what goes on the wire
+static const uint16_t NEOPIXEL_SCALE = 26;
+
+// Last colour handed to show(); the pixel is only rewritten when this changes
+static uint32_t shownColor = 0xFFFFFFFF;
+
+// Counters — show() calls and time spent in ledsUpdate(), rolled over each second
+static LedStats stats = {};
+static uint16_t windowShows = 0;
+static uint32_t windowUpdateUs = 0;
+static uint16_t windowUpdates = 0;
+static uint32_t windowMaxUs = 0;
+static unsigned long windowStart = 0;
+static unsigned long lastStatsLog = 0;
+static const unsigned long STATS_LOG_MS = 60000;
+
+// Pulse brightness from 0.2 to 1.0, out of 256
+static uint16_t getPulseBrightness() {
+    return 51 + ((205 * sineLut[pulsePhase >> 8]) >> 8);
+}
 
-// Calculate pulse brightness (0.0 to 1.0)
-static float getPulseBrightness() {
-    // Sine wave from 0.2 to 1.0
-    return 0.2f + 0.8f * (0.5f + 0.5f * sin(pulsePhase));
+// Move one 8.8 channel a fixed fraction toward its target; the last step is at least one
+// LSB so the fade settles exactly and the colour stops changing
+static uint16_t fadeChannel(uint16_t cur, uint16_t tgt, uint32_t stepQ16) {
+    int32_t diff = (int32_t)tgt - cur;
+    if (diff == 0) return cur;
+    int32_t delta = (int32_t)(((int64_t)diff * stepQ16) >> 16);
+    if (delta == 0) delta = diff > 0 ? 1 : -1;
+    return cur + delta;
 }
 
-// Apply LED state to PWM output
-static void applyLedState(uint8_t channel, LedState state) {
-    uint8_t bright = (channel == PWM_CHANNEL_NO) ? LED_BRIGHT_NO : LED_BRIGHT;
-    uint8_t brightness = LED_OFF;
+static void setTarget(uint8_t r, uint8_t g, uint8_t b) {
+    tgtR = r << 8; tgtG = g << 8; tgtB = b << 8;
+    neopixelSettled = false;
+}
 
-    switch (state) {
+static bool IRAM_ATTR onFadeEnd(const ledc_cb_param_t* param, void* arg) {
+    if (param->event == LEDC_FADE_END_EVT) ((PwmLed*)arg)->fadeDone = true;
+    return false;  // No higher-priority task woken
+}
+
+// Arm the ramp to the next point of the breath (20%..100% of the bright level)
+static void pulseStep(PwmLed* led) {
+    led->step = (led->step + 1) % LED_PULSE_STEPS;
+    uint8_t low = led->bright / 5;
+    uint8_t s = sineLut[(uint8_t)(led->step * 256 / LED_PULSE_STEPS + 192)];  // Starts at the trough
+    uint32_t duty = low + ((led->bright - low) * s) / 255;
+    led->fading = true;
+    ledc_set_fade_time_and_start(LEDC_LOW_SPEED_MODE, (ledc_channel_t)led->channel, duty,
+                                 LED_PULSE_MS / LED_PULSE_STEPS, LEDC_FADE_NO_WAIT);
+}
+
+// Write the channel's current state. Only called while no ramp is in flight.
+static void pwmApply(PwmLed* led) {
+    switch (led->state) {
         case LedState::OFF:
-            brightness = LED_OFF;
+            ledcWrite(led->channel, LED_OFF);
             break;
         case LedState::DIM:
-            brightness = LED_DIM;
+            ledcWrite(led->channel, led->dim);
             break;
         case LedState::BRIGHT:
-            brightness = bright;
+            ledcWrite(led->channel, led->bright);
             break;
         case LedState::PULSE:
-            // Treat pulse same as bright for button LEDs
-            brightness = bright;
+            led->step = 0;
+            pulseStep(led);
             break;
     }
+}
+
+// Apply LED state to PWM output. While a ramp is in flight or an animation owns the
+// channel the new state is only recorded; it is applied when either ends.
+static void applyLedState(PwmLed* led, LedState state) {
+    if (state == led->state) return;
+    led->state = state;
+    if (led->fading || led->animated) return;
+    pwmApply(led);
+}
+
+static void pwmFadeUpdate(PwmLed* led) {
+    if (!led->fadeDone) return;
+    led->fadeDone = false;
+    led->fading = false;
+    if (led->animated) return;  // Animation takes over from its next frame
+    if (led->state == LedState::PULSE) {
+        pulseStep(led);
+    } else {
+        pwmApply(led);  // Left PULSE mid-breath — settle now that LEDC is free
+    }
+}
+
+// Animation frame for one PWM LED: level is a fraction of the channel's bright duty
+static void pwmAnimate(PwmLed* led, uint8_t level) {
+    led->animated = true;
+    if (led->fading) return;
+    int16_t duty = level * led->bright / 255;
+    if (duty == led->animDuty) return;
+    led->animDuty = duty;
+    ledcWrite(led->channel, duty);
+}
+
+static void pwmAnimateEnd(PwmLed* led) {
+    if (!led->animated) return;
+    led->animated = false;
+    led->animDuty = -1;
+    if (!led->fading) pwmApply(led);
+}
+
+// One animation frame. The neopixel jumps to the keyframe colour (no fade) and, when the
+// animation ends, fades from its last colour back to the normal target.
+static bool animFrame(unsigned long now) {
+    LedAnimFrame frame;
+    bool running = ledAnimSample(anim, now - animStart, &frame);
+    if (anim.targets & LED_ANIM_YES) pwmAnimate(&pwmYes, frame.level);
+    if (anim.targets & LED_ANIM_NO) pwmAnimate(&pwmNo, frame.level);
+    if (anim.targets & LED_ANIM_NEOPIXEL) {
+        curR = frame.r << 8;
+        curG = frame.g << 8;
+        curB = frame.b << 8;
+    }
+    if (!running) ledsStopAnimation();
+    return running && (anim.targets & LED_ANIM_NEOPIXEL);
+}
+
+bool ledsPlayAnimation(const char* id) {
+    const LedAnimation* found = ledAnimFind(id);
+    if (!found) {
+        LOG_W("[LED] Unknown animation '%s'", id);
+        return false;
+    }
+    if (animPlaying) ledsStopAnimation();
+    anim = *found;
+    animPlaying = true;
+    animStart = millis();
+    return true;
+}
 
-    ledcWrite(channel, brightness);
+void ledsStopAnimation() {
+    if (!animPlaying) return;
+    animPlaying = false;
+    pwmAnimateEnd(&pwmYes);
+    pwmAnimateEnd(&pwmNo);
 }
 
 void ledsInit() {
+    for (int i = 0; i < 256; i++) {
+        sineLut[i] = (uint8_t)(127.5f + 127.5f * sinf(i * 2.0f * PI / 256.0f));
+    }
+
     // Initialize PWM for button LEDs
     ledcSetup(PWM_CHANNEL_YES, PWM_FREQ, PWM_RESOLUTION);
     ledcSetup(PWM_CHANNEL_NO, PWM_FREQ, PWM_RESOLUTION);
@@ -64,61 +211,126 @@ void ledsInit() {
     ledcWrite(PWM_CHANNEL_NO, 0);
     ledcWrite(PWM_CHANNEL_POWER, LED_POWER_BRIGHT);
 
+    // Hardware fades for PULSE
+    ledc_fade_func_install(0);
+    for (PwmLed* led : pwmLeds) {
+        ledc_cbs_t callbacks = { onFadeEnd };
+        ledc_cb_register(LEDC_LOW_SPEED_MODE, (ledc_channel_t)led->channel, &callbacks, led);
+    }
+
     // Initialize Neopixel
     neopixel.begin();
-    neopixel.setBrightness(25);  // 25/255 brightness
     neopixel.clear();
     neopixel.show();
 }
 
-void ledsUpdate() {
-    unsigned long now = millis();
-
-    // Update at ~60 fps
-    if (now - lastPulseUpdate > 16) {
-        lastPulseUpdate = now;
-
-        // Advance pulse phase (complete cycle in LED_PULSE_MS)
-        pulsePhase += (2.0f * PI * 16.0f) / LED_PULSE_MS;
-        if (pulsePhase > 2.0f * PI) {
-            pulsePhase -= 2.0f * PI;
-        }
-
-        // Fade current color toward target (~500ms transition)
-        float step = 16.0f / LED_FADE_MS;  // fraction per frame at ~60fps
-        if (step > 1.0f) step = 1.0f;
-        curR += (tgtR - curR) * step;
-        curG += (tgtG - curG) * step;
-        curB += (tgtB - curB) * step;
-
-        // Apply pulse modulation or solid color
-        float brightness = statusPulse ? getPulseBrightness() : 1.0f;
-        neopixel.setPixelColor(0, neopixel.Color(
-            (uint8_t)(curR * brightness),
-            (uint8_t)(curG * brightness),
-            (uint8_t)(curB * brightness)
-        ));
+static void statsUpdate(unsigned long now, uint32_t us) {
+    windowUpdates++;
+    windowUpdateUs += us;
+    if (us > windowMaxUs) windowMaxUs = us;
+    if (now - windowStart < 1000) return;
+
+    stats.showsPerSec = windowShows;
+    stats.updateUsAvg = windowUpdates ? windowUpdateUs / windowUpdates : 0;
+    stats.updateUsMax = windowMaxUs;
+    windowShows = 0;
+    windowUpdateUs = 0;
+    windowUpdates = 0;
+    windowMaxUs = 0;
+    windowStart = now;
+
+    if (now - lastStatsLog >= STATS_LOG_MS) {
+        lastStatsLog = now;
+        LOG_I("[LED] %u show/s, update avg %lu us, max %lu us (%lu shows total)",
+              stats.showsPerSec, (unsigned long)stats.updateUsAvg,
+              (unsigned long)stats.updateUsMax, (unsigned long)stats.showsTotal);
+    }
+}
+
+// One neopixel frame: advance pulse, fade and animation, show() if the colour changed
+static void neopixelFrame(unsigned long now) {
+    uint32_t t0 = micros();
+    unsigned long elapsed = now - lastPulseUpdate;
+    lastPulseUpdate = now;
+
+    // Advance pulse phase by the real elapsed time (complete cycle in LED_PULSE_MS)
+    pulsePhase += (uint16_t)(((elapsed % LED_PULSE_MS) << 16) / LED_PULSE_MS);
+
+    // Fade current color toward target (~LED_FADE_MS transition)
+    uint32_t step = ((uint32_t)LED_FRAME_MS << 16) / LED_FADE_MS;  // Q16 fraction per frame
+    if (step > 0x10000) step = 0x10000;
+    curR = fadeChannel(curR, tgtR, step);
+    curG = fadeChannel(curG, tgtG, step);
+    curB = fadeChannel(curB, tgtB, step);
+
+    bool animNeopixel = animPlaying && animFrame(now);
+
+    // Apply pulse modulation or solid color, then the global brightness
+    uint32_t scale = (statusPulse && !animNeopixel ? getPulseBrightness() : 256) * NEOPIXEL_SCALE;
+    uint32_t color = neopixel.Color(
+        (uint8_t)(((curR >> 8) * scale) >> 16),
+        (uint8_t)(((curG >> 8) * scale) >> 16),
+        (uint8_t)(((curB >> 8) * scale) >> 16)
+    );
+    neopixelSettled = color == shownColor && !statusPulse && !animPlaying &&
+                      curR == tgtR && curG == tgtG && curB == tgtB;
+    if (color != shownColor) {
+        shownColor = color;
+        neopixel.setPixelColor(0, color);
         neopixel.show();
+        windowShows++;
+        stats.showsTotal++;
     }
+
+    statsUpdate(now, micros() - t0);
+}
+
+void ledsUpdate() {
+    PROF_SCOPE(ProfScope::LEDS);
+    for (PwmLed* led : pwmLeds) pwmFadeUpdate(led);
+    neopixelFrame(millis());
+}
+
+void ledsCommit() {
+    PROF_SCOPE(ProfScope::LEDS);
+    neopixelFrame(millis());
+}
+
+bool ledsAnimating() {
+    if (!neopixelSettled || animPlaying) return true;
+    for (PwmLed* led : pwmLeds) {
+        // A PULSE breath needs ledsUpdate() to arm each ramp when the last one ends
+        if (led->fading || led->fadeDone || led->state == LedState::PULSE) return true;
+    }
+    return false;
+}
+
+LedStats ledsGetStats() {
+    // No frames run while the LEDs are settled (IDLE): the last window is stale
+    if (millis() - windowStart > 2000) stats.showsPerSec = 0;
+    return stats;
 }
 
 void ledsSetYes(LedState state) {
-    yesLedState = state;
-    applyLedState(PWM_CHANNEL_YES, state);
+    applyLedState(&pwmYes, state);
 }
 
 void ledsSetNo(LedState state) {
-    noLedState = state;
-    applyLedState(PWM_CHANNEL_NO, state);
+    applyLedState(&pwmNo, state);
+}
+
+void ledsSetPower(LedState state) {
+    applyLedState(&pwmPower, state);
 }
 
 void ledsSetFromDisplay(const DisplayState& state) {
     ledsSetYes(state.leds.yes);
     ledsSetNo(state.leds.no);
+    ledsSetPower(state.leds.power);
 }
 
 void ledsSetStatusColor(uint8_t r, uint8_t g, uint8_t b) {
-    tgtR = r; tgtG = g; tgtB = b;
+    setTarget(r, g, b);
     statusPulse = false;
 }
 
@@ -126,49 +338,49 @@ void ledsSetStatus(ConnectionState state) {
     switch (state) {
         case ConnectionState::BOOT:
             // White - initializing
-            tgtR = 100; tgtG = 100; tgtB = 100;
+            setTarget(100, 100, 100);
             statusPulse = false;
             break;
 
         case ConnectionState::PLAYER_SELECT:
             // Purple - selecting player
-            tgtR = 150; tgtG = 0; tgtB = 255;
+            setTarget(150, 0, 255);
             statusPulse = true;
             break;
 
         case ConnectionState::WIFI_CONNECTING:
             // Blue - connecting to WiFi
-            tgtR = 0; tgtG = 0; tgtB = 255;
+            setTarget(0, 0, 255);
             statusPulse = true;
             break;
 
         case ConnectionState::WS_CONNECTING:
             // Yellow - connecting to WebSocket
-            tgtR = 255; tgtG = 200; tgtB = 0;
+            setTarget(255, 200, 0);
             statusPulse = true;
             break;
 
         case ConnectionState::JOINING:
             // Cyan - joining game
-            tgtR = 0; tgtG = 255; tgtB = 255;
+            setTarget(0, 255, 255);
             statusPulse = false;
             break;
 
         case ConnectionState::CONNECTED:
             // Green - connected
-            tgtR = 0; tgtG = 255; tgtB = 0;
+            setTarget(0, 255, 0);
             statusPulse = false;
             break;
 
         case ConnectionState::RECONNECTING:
             // Orange - reconnecting
-            tgtR = 255; tgtG = 100; tgtB = 0;
+            setTarget(255, 100, 0);
             statusPulse = true;
             break;
 
         case ConnectionState::ERROR:
             // Red - error
-            tgtR = 255; tgtG = 0; tgtB = 0;
+            setTarget(255, 0, 0);
             statusPulse = false;
             break;
     }
@@ -181,52 +393,52 @@ void ledsSetGameState(GameLedState state) {
             return;
 
         case GameLedState::OFF:
-            tgtR = 0; tgtG = 0; tgtB = 0;
+            setTarget(0, 0, 0);
             statusPulse = false;
             break;
 
         case GameLedState::LOBBY:
-            tgtR = 100; tgtG = 100; tgtB = 100;
+            setTarget(100, 100, 100);
             statusPulse = false;
             break;
 
         case GameLedState::DAY:
-            tgtR = 0; tgtG = 255; tgtB = 0;
+            setTarget(0, 255, 0);
             statusPulse = false;
             break;
 
         case GameLedState::NIGHT:
-            tgtR = 0; tgtG = 0; tgtB = 255;
+            setTarget(0, 0, 255);
             statusPulse = false;
             break;
 
         case GameLedState::VOTING:
-            tgtR = 255; tgtG = 200; tgtB = 0;
+            setTarget(255, 200, 0);
             statusPulse = true;
             break;
 
         case GameLedState::LOCKED:
-            tgtR = 0; tgtG = 255; tgtB = 0;
+            setTarget(0, 255, 0);
             statusPulse = false;
             break;
 
         case GameLedState::ABSTAINED:
-            tgtR = 60; tgtG = 60; tgtB = 60;
+            setTarget(60, 60, 60);
             statusPulse = false;
             break;
 
         case GameLedState::DEAD:
-            tgtR = 255; tgtG = 0; tgtB = 0;
+            setTarget(255, 0, 0);
             statusPulse = false;
             break;
 
         case GameLedState::COWARD:
-            tgtR = 230; tgtG = 168; tgtB = 0; // Yellow
+            setTarget(230, 168, 0); // Yellow
             statusPulse = false;
             break;
 
         case GameLedState::GAME_OVER:
-            tgtR = 100; tgtG = 100; tgtB = 100;
+            setTarget(100, 100, 100);
             statusPulse = false;
             break;
     }
@@ -235,9 +447,10 @@ void ledsSetGameState(GameLedState state) {
 void ledsOff() {
     ledsSetYes(LedState::OFF);
     ledsSetNo(LedState::OFF);
-    tgtR = 0; tgtG = 0; tgtB = 0;
+    setTarget(0, 0, 0);
     curR = 0; curG = 0; curB = 0;
     statusPulse = false;
     neopixel.clear();
     neopixel.show();
+    shownColor = 0;
 }
@@ -8,16 +8,41 @@
 // Initialize LEDs
 void ledsInit();
 
-// Update LEDs (call in main loop for pulse animations)
+// Update LEDs — one neopixel frame per call (call every LED_FRAME_MS)
 void ledsUpdate();
 
-// Set button LED states
+// Run the neopixel frame now rather than on the next LED_FRAME_MS tick, so a new status
+// colour starts in the same loop tick as the button LEDs and the OLED (frame commit)
+void ledsCommit();
+
+// Whether ledsUpdate() still has work: a neopixel fade, pulse or animation, or a button
+// LED breathing or mid-ramp. False once every LED holds a steady level.
+bool ledsAnimating();
+
+// Neopixel engine counters (rates over the last full second)
+struct LedStats {
+    uint16_t showsPerSec;    // show() calls — 0 while the colour is static
+    uint32_t updateUsAvg;    // Time per ledsUpdate() frame
+    uint32_t updateUsMax;
+    uint32_t showsTotal;
+};
+LedStats ledsGetStats();
+
+// Set button LED states (PULSE breathes on the LEDC hardware fader)
 void ledsSetYes(LedState state);
 void ledsSetNo(LedState state);
 
+// Set the power LED (DIM is the normal glow)
+void ledsSetPower(LedState state);
+
 // Set both button LEDs from display state
 void ledsSetFromDisplay(const DisplayState& state);
 
+// Play a cached keyframe animation (see ledanim.h) over the normal LED state.
+// Returns false if the server never defined that id.
+bool ledsPlayAnimation(const char* id);
+void ledsStopAnimation();
+
 // Set neopixel status color
 void ledsSetStatus(ConnectionState state);
 
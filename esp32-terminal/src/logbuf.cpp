@@ -0,0 +1,259 @@
+// Deferred logging
+//
+// The ring holds whole records back to back, each led by its length byte, and wraps
+// byte-wise. Producer (loop task) and consumer (drain task) sit on different cores, so
+// head and tail are atomics: the producer publishes head only after the bytes are in,
+// the consumer frees them by publishing tail only after copying them out.
+
+#include "logbuf.h"
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+
+static uint8_t ring[LOG_RING_BYTES];
+static std::atomic<uint32_t> head(0);     // Bytes ever written (producer)
+static std::atomic<uint32_t> tail(0);     // Bytes ever consumed (consumer)
+static std::atomic<uint32_t> dropped(0);
+static std::atomic<uint8_t> level(LOG_LEVEL);
+static uint32_t (*clockMs)() = nullptr;
+
+void logSetClock(uint32_t (*clock)()) {
+    clockMs = clock;
+}
+
+void logSetLevel(uint8_t lvl) {
+    level.store(lvl > LOG_LEVEL ? LOG_LEVEL : lvl, std::memory_order_relaxed);
+}
+
+uint8_t logLevel() {
+    return level.load(std::memory_order_relaxed);
+}
+
+void logReset() {
+    head.store(0);
+    tail.store(0);
+    dropped.store(0);
+    level.store(LOG_LEVEL);
+}
+
+// ============================================================================
+// ENCODING
+// ============================================================================
+
+static void put(LogEncoder& e, const void* data, int n) {
+    memcpy(e.buf + e.len, data, n);
+    e.len += n;
+}
+
+void logEncodeBegin(LogEncoder& e, LogLevel level, const char* fmt) {
+    uintptr_t addr = (uintptr_t)fmt;
+    uint32_t ms = clockMs ? clockMs() : 0;
+    e.buf[0] = 0;
+    e.buf[1] = (uint8_t)level;
+    e.len = 2;
+    put(e, &addr, sizeof(addr));
+    put(e, &ms, sizeof(ms));
+}
+
+// Arguments that no longer fit are left off; the formatter prints their specifiers raw
+static bool room(LogEncoder& e, int n) {
+    return e.len + 1 + n <= LOG_RECORD_MAX;
+}
+
+void logEncodeI32(LogEncoder& e, int32_t v) {
+    if (!room(e, sizeof(v))) return;
+    e.buf[e.len++] = LOG_ARG_I32;
+    put(e, &v, sizeof(v));
+}
+
+void logEncodeU32(LogEncoder& e, uint32_t v) {
+    if (!room(e, sizeof(v))) return;
+    e.buf[e.len++] = LOG_ARG_U32;
+    put(e, &v, sizeof(v));
+}
+
+void logEncodeI64(LogEncoder& e, int64_t v) {
+    if (!room(e, sizeof(v))) return;
+    e.buf[e.len++] = LOG_ARG_I64;
+    put(e, &v, sizeof(v));
+}
+
+void logEncodeU64(LogEncoder& e, uint64_t v) {
+    if (!room(e, sizeof(v))) return;
+    e.buf[e.len++] = LOG_ARG_U64;
+    put(e, &v, sizeof(v));
+}
+
+void logEncodeFloat(LogEncoder& e, float v) {
+    if (!room(e, sizeof(v))) return;
+    e.buf[e.len++] = LOG_ARG_FLOAT;
+    put(e, &v, sizeof(v));
+}
+
+void logEncodeStr(LogEncoder& e, const char* s) {
+    if (s == nullptr) s = "(null)";
+    if (!room(e, 1)) return;
+    int n = strnlen(s, LOG_STR_MAX);
+    if (n > LOG_RECORD_MAX - e.len - 2) n = LOG_RECORD_MAX - e.len - 2;
+    e.buf[e.len++] = LOG_ARG_STR;
+    e.buf[e.len++] = (uint8_t)n;
+    put(e, s, n);
+}
+
+// ============================================================================
+// RING
+// ============================================================================
+
+void logCommit(LogEncoder& e) {
+    e.buf[0] = (uint8_t)e.len;
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t t = tail.load(std::memory_order_acquire);
+    if (LOG_RING_BYTES - (h - t) < (uint32_t)e.len) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    uint32_t at = h % LOG_RING_BYTES;
+    uint32_t first = LOG_RING_BYTES - at;
+    if (first >= (uint32_t)e.len) {
+        memcpy(ring + at, e.buf, e.len);
+    } else {
+        memcpy(ring + at, e.buf, first);
+        memcpy(ring, e.buf + first, e.len - first);
+    }
+    head.store(h + e.len, std::memory_order_release);
+}
+
+int logPop(uint8_t* out) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t h = head.load(std::memory_order_acquire);
+    if (h == t) return 0;
+
+    uint32_t at = t % LOG_RING_BYTES;
+    int len = ring[at];
+    uint32_t first = LOG_RING_BYTES - at;
+    if (first >= (uint32_t)len) {
+        memcpy(out, ring + at, len);
+    } else {
+        memcpy(out, ring + at, first);
+        memcpy(out + first, ring, len - first);
+    }
+    tail.store(t + len, std::memory_order_release);
+    return len;
+}
+
+uint32_t logTakeDropped() {
+    return dropped.exchange(0, std::memory_order_relaxed);
+}
+
+// ============================================================================
+// FORMATTING
+// ============================================================================
+
+LogLevel logRecordLevel(const uint8_t* rec) {
+    return (LogLevel)rec[1];
+}
+
+uint32_t logRecordMs(const uint8_t* rec) {
+    uint32_t ms;
+    memcpy(&ms, rec + 2 + sizeof(uintptr_t), sizeof(ms));
+    return ms;
+}
+
+// One conversion of the record's format string with the next argument. `spec` holds
+// the flags, width and precision ("%-8.2"); length modifiers were dropped, the value's
+// own type decides them.
+static int formatArg(char* out, int max, char* spec, int specLen, char conv,
+                     const uint8_t*& arg, const uint8_t* end) {
+    uint8_t tag = arg < end ? *arg++ : 0;
+    int64_t i = 0;
+    uint64_t u = 0;
+    float f = 0;
+    int strLen = 0;
+    const char* str = nullptr;
+    switch (tag) {
+        case LOG_ARG_I32: { int32_t v; memcpy(&v, arg, 4); arg += 4; i = v; u = (uint32_t)v; break; }
+        case LOG_ARG_U32: { uint32_t v; memcpy(&v, arg, 4); arg += 4; i = v; u = v; break; }
+        case LOG_ARG_I64: memcpy(&i, arg, 8); arg += 8; u = (uint64_t)i; break;
+        case LOG_ARG_U64: memcpy(&u, arg, 8); arg += 8; i = (int64_t)u; break;
+        case LOG_ARG_FLOAT: memcpy(&f, arg, 4); arg += 4; break;
+        case LOG_ARG_STR: strLen = *arg++; str = (const char*)arg; arg += strLen; break;
+        default:
+            arg = end;
+            spec[specLen] = conv;
+            spec[specLen + 1] = '\0';
+            return snprintf(out, max, "%s", spec);   // Missing argument: show the specifier
+    }
+
+    switch (conv) {
+        case 'd': case 'i':
+            memcpy(spec + specLen, "lld", 4);
+            if (tag == LOG_ARG_FLOAT) i = (int64_t)f;
+            return snprintf(out, max, spec, (long long)i);
+        case 'u': case 'x': case 'X': case 'o':
+            spec[specLen] = 'l';
+            spec[specLen + 1] = 'l';
+            spec[specLen + 2] = conv;
+            spec[specLen + 3] = '\0';
+            // A 32-bit negative printed as hex stays 32 bits wide, as printf would have it
+            if (tag == LOG_ARG_I32) u = (uint32_t)i;
+            return snprintf(out, max, spec, (unsigned long long)u);
+        case 'c':
+            memcpy(spec + specLen, "c", 2);
+            return snprintf(out, max, spec, (int)i);
+        case 'p':
+            return snprintf(out, max, "0x%08llx", (unsigned long long)u);
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+            spec[specLen] = conv;
+            spec[specLen + 1] = '\0';
+            if (tag != LOG_ARG_FLOAT) f = (tag == LOG_ARG_U32 || tag == LOG_ARG_U64) ? (float)u : (float)i;
+            return snprintf(out, max, spec, (double)f);
+        case 's':
+        default: {
+            if (str == nullptr) return snprintf(out, max, "%lld", (long long)i);
+            // The copy is not terminated: its length becomes the precision (keeping the width)
+            char* dot = (char*)memchr(spec, '.', specLen);
+            if (dot != nullptr) specLen = dot - spec;
+            memcpy(spec + specLen, ".*s", 4);
+            return snprintf(out, max, spec, strLen, str);
+        }
+    }
+}
+
+int logFormat(const uint8_t* rec, int len, char* out, int max) {
+    const char* fmt;
+    uintptr_t addr;
+    memcpy(&addr, rec + 2, sizeof(addr));
+    fmt = (const char*)addr;
+    const uint8_t* arg = rec + LOG_HEADER;
+    const uint8_t* end = rec + len;
+
+    int n = 0;
+    out[0] = '\0';
+    while (*fmt && n < max - 1) {
+        if (*fmt != '%') {
+            out[n++] = *fmt++;
+            continue;
+        }
+        if (fmt[1] == '%') {
+            out[n++] = '%';
+            fmt += 2;
+            continue;
+        }
+
+        char spec[24];
+        int specLen = 0;
+        spec[specLen++] = *fmt++;
+        while (*fmt && strchr("-+ #0123456789.", *fmt) && specLen < (int)sizeof(spec) - 5) {
+            spec[specLen++] = *fmt++;
+        }
+        while (*fmt && strchr("hlLqjzt", *fmt)) fmt++;
+        if (!*fmt) break;
+        char conv = *fmt++;
+
+        int w = formatArg(out + n, max - n, spec, specLen, conv, arg, end);
+        if (w > 0) n += w < max - n ? w : max - n - 1;
+    }
+    out[n] = '\0';
+    return n;
+}
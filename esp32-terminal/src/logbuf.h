@@ -0,0 +1,133 @@
+// Deferred logging — LOG_x() copies the format string's address and the raw arguments
+// into a ring; formatting happens later, in the drain task (text) or on the host
+// (LOG_BINARY, tools/log-decode.mjs). A call costs a few memcpys, never a UART wait.
+// Levels above LOG_LEVEL compile out, arguments included.
+// Records are popped and formatted into caller buffers (the clock is set by logSetClock),
+// so the drain task owns the UART. The ring is single-producer: only the loop task logs.
+#ifndef LOGBUF_H
+#define LOGBUF_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#ifdef ARDUINO
+#include <WString.h>
+#endif
+
+// CONSOLE is what the operator asked for on the serial console: never filtered or compiled out
+enum class LogLevel : uint8_t { CONSOLE = 0, ERROR, WARN, INFO, DEBUG };
+
+// Record: [length][level][format address][ms][tagged args...]. String arguments are
+// copied (truncated to what fits); numbers keep their type so the decoder can format
+// them as the format string asks.
+static const int LOG_RECORD_MAX = 255;
+static const int LOG_HEADER = 2 + sizeof(uintptr_t) + 4;
+
+enum LogArgTag : uint8_t {
+    LOG_ARG_I32 = 'i',
+    LOG_ARG_U32 = 'u',
+    LOG_ARG_I64 = 'I',
+    LOG_ARG_U64 = 'U',
+    LOG_ARG_FLOAT = 'f',
+    LOG_ARG_STR = 's'      // Length byte, then the bytes (no terminator)
+};
+
+struct LogEncoder {
+    uint8_t buf[LOG_RECORD_MAX];
+    int len;
+};
+
+// Millisecond clock stamped on each record (none: 0)
+void logSetClock(uint32_t (*clock)());
+
+void logEncodeBegin(LogEncoder& e, LogLevel level, const char* fmt);
+void logEncodeI32(LogEncoder& e, int32_t v);
+void logEncodeU32(LogEncoder& e, uint32_t v);
+void logEncodeI64(LogEncoder& e, int64_t v);
+void logEncodeU64(LogEncoder& e, uint64_t v);
+void logEncodeFloat(LogEncoder& e, float v);
+void logEncodeStr(LogEncoder& e, const char* s);
+
+// Queue the record; dropped (and counted) when the ring is full
+void logCommit(LogEncoder& e);
+
+inline void logArg(LogEncoder& e, bool v)               { logEncodeI32(e, v); }
+inline void logArg(LogEncoder& e, char v)               { logEncodeI32(e, v); }
+inline void logArg(LogEncoder& e, int v)                { logEncodeI32(e, v); }
+inline void logArg(LogEncoder& e, unsigned v)           { logEncodeU32(e, v); }
+inline void logArg(LogEncoder& e, long v) {
+    if (sizeof(long) == 4) logEncodeI32(e, (int32_t)v); else logEncodeI64(e, v);
+}
+inline void logArg(LogEncoder& e, unsigned long v) {
+    if (sizeof(long) == 4) logEncodeU32(e, (uint32_t)v); else logEncodeU64(e, v);
+}
+inline void logArg(LogEncoder& e, long long v)          { logEncodeI64(e, v); }
+inline void logArg(LogEncoder& e, unsigned long long v) { logEncodeU64(e, v); }
+inline void logArg(LogEncoder& e, double v)             { logEncodeFloat(e, (float)v); }
+inline void logArg(LogEncoder& e, const char* s)        { logEncodeStr(e, s); }
+inline void logArg(LogEncoder& e, const void* p)        { logEncodeU32(e, (uint32_t)(uintptr_t)p); }
+#ifdef ARDUINO
+inline void logArg(LogEncoder& e, const String& s)      { logEncodeStr(e, s.c_str()); }
+#endif
+
+inline void logArgs(LogEncoder&) {}
+
+template <typename T, typename... Rest>
+inline void logArgs(LogEncoder& e, const T& first, const Rest&... rest) {
+    logArg(e, first);
+    logArgs(e, rest...);
+}
+
+// Runtime threshold below the compile-time one (LOG_LEVEL): records above it are skipped
+// before anything is copied
+void logSetLevel(uint8_t level);
+uint8_t logLevel();
+
+// `fmt` must be a string literal: only its address is kept
+template <typename... Args>
+void logWrite(LogLevel level, const char* fmt, const Args&... args) {
+    if ((uint8_t)level > logLevel()) return;
+    LogEncoder e;
+    logEncodeBegin(e, level, fmt);
+    logArgs(e, args...);
+    logCommit(e);
+}
+
+#define LOG_OUT(...) logWrite(LogLevel::CONSOLE, __VA_ARGS__)
+#if LOG_LEVEL >= 1
+#define LOG_E(...) logWrite(LogLevel::ERROR, __VA_ARGS__)
+#else
+#define LOG_E(...) ((void)0)
+#endif
+#if LOG_LEVEL >= 2
+#define LOG_W(...) logWrite(LogLevel::WARN, __VA_ARGS__)
+#else
+#define LOG_W(...) ((void)0)
+#endif
+#if LOG_LEVEL >= 3
+#define LOG_I(...) logWrite(LogLevel::INFO, __VA_ARGS__)
+#else
+#define LOG_I(...) ((void)0)
+#endif
+#if LOG_LEVEL >= 4
+#define LOG_D(...) logWrite(LogLevel::DEBUG, __VA_ARGS__)
+#else
+#define LOG_D(...) ((void)0)
+#endif
+
+// Consumer side (drain task): the oldest record, copied into `out`. Returns its length,
+// 0 when the ring is empty.
+int logPop(uint8_t* out);
+
+// Records dropped because the ring was full, since the last call
+uint32_t logTakeDropped();
+
+// Record as text (no newline). Returns the length written, always terminated.
+int logFormat(const uint8_t* rec, int len, char* out, int max);
+
+LogLevel logRecordLevel(const uint8_t* rec);
+uint32_t logRecordMs(const uint8_t* rec);
+
+void logReset();
+
+#endif // LOGBUF_H
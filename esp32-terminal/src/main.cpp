@@ -2,6 +2,7 @@
 // Main Application Entry Point
 
 #include <Arduino.h>
+#include <esp_heap_caps.h>
 #include "config.h"
 #include "protocol.h"
 #include "display.h"
@@ -10,6 +11,17 @@
 #include "heartrate.h"
 #include "network.h"
 #include "player_select.h"
+#include "sched.h"
+#include "power.h"
+#include "prof.h"
+#include "latency.h"
+#include "stall.h"
+#include "heapmon.h"
+#include "allochook.h"
+#include "logbuf.h"
+#include "diag.h"
+#include "console.h"
+#include "tunables.h"
 
 // Core game-loop state
 static DisplayState currentDisplay;
@@ -17,10 +29,88 @@ static bool displayDirty = true;
 static bool terminalOwnsDisplay = false;
 static ConnectionState lastConnState = ConnectionState::BOOT;
 
+// Frame commit: a server state is staged by onDisplayUpdate and latched by commitFrame()
+// in one loop tick — framebuffer composed first, then button LEDs, neopixel and the
+// OLED push back to back. displayDirty alone is a local, display-only change.
+static bool framePending = false;
+static uint32_t frameArrivedUs = 0;
+
+// Arrival-to-commit latency, logged every 60 s
+static uint32_t frameCommits = 0;
+static uint32_t frameLatencySumUs = 0;
+static uint32_t frameLatencyMaxUs = 0;
+static unsigned long lastFrameLog = 0;
+static const unsigned long FRAME_LOG_MS = 60000;
+
 // Settle timer: sends selectTo after dial stops moving during target selection
-static unsigned long lastScrollMs = 0;
-static bool settlePending = false;
-static const unsigned long SCROLL_SETTLE_MS = 150;
+// (SCROLL_SETTLE_MS tunable)
+
+// Scheduler task ids (registered at the end of setup)
+static int appTask = -1;
+static int settleTask = -1;
+static int heartrateTask = -1;
+static int ledsTask = -1;
+static int displayTask = -1;
+static void appRun();
+static void appTick();
+static void heartrateTick();
+static void ledsTick();
+static void displayTick();
+static void updateFrameTasks();
+static void settleTick();
+static void schedLogTick();
+static uint32_t clockUs();
+static void updatePower(ConnectionState connState);
+
+// Loop profiler: slow iterations are logged at most once per PROF_SLOW_LOG_MS;
+// "prof" on the serial console prints the full report (the server can request it too)
+static unsigned long lastSlowLog = 0;
+static const unsigned long PROF_SLOW_LOG_MS = 1000;
+static uint32_t cycleClock();
+static void profUpdateThreshold();
+static void profLogReport();
+static void latencyLogReport();
+
+static_assert((int)GameLedState::GAME_OVER < LATENCY_PHASES, "latency.h phase table too small");
+
+// Loop-stall watchdog: records live in RTC memory (kept across soft resets) and are
+// checked by a task on the other core; stallMux guards them between the two
+static RTC_NOINIT_ATTR StallRing stallRing;
+static portMUX_TYPE stallMux = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t stallLoggedSeq = 0;
+static bool stallUploadDue = false;
+static void stallWatchdogTask(void* arg);
+static void stallTick(uint32_t idleUs);
+static void stallUpload();
+static void stallLog(const StallRecord& r);
+static const char* resetReasonName();
+
+// Heap health: sampled every HEAP_SAMPLE_MS, pushed to the server every HEAP_REPORT_MS
+static TaskHandle_t loopTaskHandle = nullptr;
+static TaskHandle_t stallTaskHandle = nullptr;
+static unsigned long lastHeapReport = 0;
+static void heapTick();
+
+// Deferred logging: LOG_x() only queues a record; this task, pinned to the other core,
+// formats and writes them out so the loop never waits on the UART
+static TaskHandle_t logTaskHandle = nullptr;
+static void logDrainTask(void* arg);
+static uint32_t logClockMs();
+
+// Remote diagnostics: log lines are batched every DIAG_FLUSH_MS, metrics every
+// DIAG_METRICS_MS, both only while the host has them turned on
+static unsigned long lastDiagMetrics = 0;
+static void diagTick();
+
+// Serial console (console.h): commands are read a few bytes per poll, replies go through
+// the log ring
+static void consoleTick();
+static void consoleInitCommands();
+
+// Runtime tunables (tunables.h): loaded from NVS at boot; a change is pushed to the
+// modules that keep their own copy
+static void onTunableChanged(Tunable t);
+static void logTunables(bool changedOnly);
 
 // Reset detection (hold encoder button 3 s to prompt, 5 s total to restart)
 static unsigned long encoderBtnHeldSince = 0;
@@ -36,13 +126,13 @@ bool checkResetGesture() {
         if (encoderBtnHeldSince == 0) {
             encoderBtnHeldSince = now;
             resetMessageShown = false;
-            Serial.println("Encoder button held - reset timer started");
+            LOG_I("Encoder button held - reset timer started");
         }
 
         unsigned long heldFor = now - encoderBtnHeldSince;
 
         if (heldFor >= RESET_HOLD_MS && !resetMessageShown) {
-            Serial.println("Showing restart message...");
+            LOG_I("Showing restart message...");
             displayMessage("HOLD TO CONFIRM", "RESTARTING", "Release to cancel");
             ledsSetYes(LedState::BRIGHT);
             ledsSetNo(LedState::BRIGHT);
@@ -50,7 +140,7 @@ bool checkResetGesture() {
         }
 
         if (heldFor >= RESET_HOLD_MS + RESET_CONFIRM_MS) {
-            Serial.println("Restarting terminal...");
+            LOG_I("Restarting terminal...");
             displayMessage("", "RESTARTING...", "");
             delay(500);
             ESP.restart();
@@ -60,7 +150,7 @@ bool checkResetGesture() {
     } else {
         if (encoderBtnHeldSince != 0) {
             if (resetMessageShown) {
-                Serial.println("Reset cancelled");
+                LOG_I("Reset cancelled");
                 if (!psIsConfirmed()) {
                     displayPlayerSelect(psGetSelectedPlayer());
                 } else {
@@ -74,75 +164,157 @@ bool checkResetGesture() {
     }
 }
 
-// Callback when display state is received from server
+// Callback when display state is received from server — staged, see commitFrame()
 void onDisplayUpdate(const DisplayState& state) {
+    if (!framePending) frameArrivedUs = networkStateArrivedUs();
+    latencyStateArrived(networkStateArrivedUs(), (uint8_t)state.statusLed);
+    framePending = true;
+
     if (terminalOwnsDisplay) {
         if (state.targetCount == 0) {
             terminalOwnsDisplay = false;
         } else {
-            ledsSetFromDisplay(state);
-            ledsSetGameState(state.statusLed);
+            // Dial selection stays local; take the server's LEDs and footer only
+            currentDisplay.leds = state.leds;
+            currentDisplay.statusLed = state.statusLed;
             currentDisplay.line3 = state.line3;
-            displayDirty = true;
             return;
         }
     }
 
     currentDisplay = state;
-    displayDirty = true;
+}
+
+// Latch the staged frame: the slow compose happens before anything visible changes,
+// so the LEDs and the OLED push land within one SPI transfer of each other
+static void commitFrame() {
+    if (!framePending && !displayDirty) return;
+
+    displayCompose(currentDisplay);
+    if (framePending) {
+        ledsSetFromDisplay(currentDisplay);
+        ledsSetGameState(currentDisplay.statusLed);
+        ledsCommit();
+    }
+    displayPresent();
+    latencyPresented(micros(), (uint8_t)currentDisplay.statusLed);
 
-    ledsSetFromDisplay(state);
-    ledsSetGameState(state.statusLed);
+    if (framePending) {
+        uint32_t us = micros() - frameArrivedUs;
+        frameCommits++;
+        frameLatencySumUs += us;
+        if (us > frameLatencyMaxUs) frameLatencyMaxUs = us;
+    }
+    framePending = false;
+    displayDirty = false;
+
+    unsigned long now = millis();
+    if (now - lastFrameLog >= FRAME_LOG_MS) {
+        lastFrameLog = now;
+        if (frameCommits > 0) {
+            LOG_I("[Frame] %lu commits, arrival->commit avg %lu us, max %lu us",
+                  (unsigned long)frameCommits,
+                  (unsigned long)(frameLatencySumUs / frameCommits),
+                  (unsigned long)frameLatencyMaxUs);
+        }
+        frameCommits = 0;
+        frameLatencySumUs = 0;
+        frameLatencyMaxUs = 0;
+    }
 }
 
 void setup() {
     Serial.begin(115200);
-    Serial.println();
-    Serial.println("=== Murderhouse ESP32 Terminal v" FIRMWARE_VERSION " ===");
+    logSetClock(logClockMs);
+    xTaskCreatePinnedToCore(logDrainTask, "log", 3072, nullptr, 1, &logTaskHandle, 0);
+    LOG_I("=== Murderhouse ESP32 Terminal v" FIRMWARE_VERSION " ===");
 
-    Serial.println("Initializing display...");
+    stallInit(&stallRing);
+    stallLoggedSeq = stallRing.nextSeq - 1;
+    stallUploadDue = stallCount() > 0;
+    LOG_I("[Stall] Boot %lu (%s), %d record(s) to upload",
+          (unsigned long)stallBoot(), resetReasonName(), stallCount());
+    for (int i = 0; i < stallCount(); i++) stallLog(*stallGet(i));
+
+    tunablesInit();
+    tunablesLoad();
+    tunablesSetListener(onTunableChanged);
+    logTunables(true);
+
+    LOG_I("Initializing display...");
+    currentDisplay.reserve();
     displayInit();
     displayConnectionStatus(ConnectionState::BOOT);
 
-    Serial.println("Initializing LEDs...");
+    LOG_I("Initializing LEDs...");
     ledsInit();
     ledsSetStatus(ConnectionState::BOOT);
 
-    Serial.println("Testing button LEDs...");
+    LOG_I("Testing button LEDs...");
     ledsSetYes(LedState::BRIGHT);
     ledsSetNo(LedState::BRIGHT);
     delay(500);
     ledsSetYes(LedState::OFF);
     ledsSetNo(LedState::OFF);
 
-    Serial.println("Initializing heart rate monitor...");
+    LOG_I("Initializing heart rate monitor...");
     heartrateInit();
     heartrateSetSendCallback(networkSendHeartbeat);
+    heartrateSetWaveSendCallback(networkSendStream);
+    heartrateSetBeatSendCallback(networkSendBinary);
+    heartrateSetCalibrationCallback(networkSendDetectorCalibration);
 
-    Serial.println("Testing heartbeat LED (D3)...");
+    LOG_I("Testing heartbeat LED (D3)...");
     digitalWrite(PIN_LED_HEARTBEAT, HIGH);
     delay(500);
     digitalWrite(PIN_LED_HEARTBEAT, LOW);
 
-    Serial.println("Initializing input...");
+    LOG_I("Initializing input...");
     inputInit();
 
-    Serial.println("Entering player selection...");
+    powerInit();
+
+    LOG_I("Entering player selection...");
     psInit();
     lastConnState = ConnectionState::PLAYER_SELECT;
     ledsSetStatus(ConnectionState::PLAYER_SELECT);
     ledsSetYes(LedState::BRIGHT);
     displayPlayerSelect(psGetSelectedPlayer());
 
-    Serial.println("Use dial to select terminal (OPERATOR or PLAYER 1-9), press YES to confirm");
+    LOG_I("Use dial to select terminal (OPERATOR or PLAYER 1-9), press YES to confirm");
+
+    // Priorities: heart rate sampling keeps its cadence first, then the game loop,
+    // then LEDs and the display effects
+    profInit(cycleClock);
+    profUpdateThreshold();
+    schedInit(clockUs);
+    heartrateTask = schedAdd("heartrate", heartrateTick, heartrateTaskPeriodMs() * 1000, 0, 5);
+    appTask = schedAdd("app", appRun, APP_TICK_MS * 1000, 0, 4);
+    settleTask = schedAdd("settle", settleTick, 0, 0, 3);
+    ledsTask = schedAdd("leds", ledsTick, LED_FRAME_MS * 1000, 0, 2);
+    displayTask = schedAdd("display", displayTick, DISPLAY_SCOPE_FRAME_MS * 1000, 0, 1);
+    schedAdd("stats", schedLogTick, SCHED_LOG_MS * 1000UL, 0, 0);
+    schedAdd("heap", heapTick, HEAP_SAMPLE_MS * 1000UL, 0, 0);
+    schedAdd("diag", diagTick, DIAG_FLUSH_MS * 1000UL, 0, 0);
+    schedAdd("console", consoleTick, CONSOLE_POLL_MS * 1000UL, 0, 0);
+    consoleInitCommands();
+    loopTaskHandle = xTaskGetCurrentTaskHandle();
+    inputSetWakeTask(loopTaskHandle);
+
+    // The loop runs on core 1; the watchdog sits on core 0 so a stall can't starve it
+    xTaskCreatePinnedToCore(stallWatchdogTask, "stallwd", 3072, nullptr, 5, &stallTaskHandle, 0);
 }
 
-void loop() {
-    ledsUpdate();
-    heartrateUpdate();
+// App task: the game loop, then the frame tasks follow whatever it changed
+static void appRun() {
+    appTick();
+    updateFrameTasks();
+}
 
+// Game loop: network pump, input, frame commit. Runs every APP_TICK_MS and at once on
+// a button edge; the LEDs, heart rate sampling and display effects are separate tasks.
+static void appTick() {
     if (checkResetGesture()) {
-        delay(10);
         return;
     }
 
@@ -165,7 +337,7 @@ void loop() {
             networkSetDisplayCallback(onDisplayUpdate);
             displayConnectionStatus(ConnectionState::WIFI_CONNECTING);  // flush display after WiFi init power spike
         } else {
-            delay(1);
+            updatePower(ConnectionState::PLAYER_SELECT);
             return;
         }
     }
@@ -180,10 +352,11 @@ void loop() {
     ConnectionState connState = networkUpdate();
 
     if (networkWasKicked()) {
-        Serial.println("Kicked — returning to player select");
+        LOG_I("Kicked — returning to player select");
         psReset();
         terminalOwnsDisplay = false;
-        currentDisplay = DisplayState();
+        framePending = false;
+        currentDisplay.reset();
         displayPlayerSelect(psGetSelectedPlayer());
         ledsSetStatus(ConnectionState::PLAYER_SELECT);
         return;
@@ -196,6 +369,8 @@ void loop() {
 
         if (connState == ConnectionState::CONNECTED) {
             heartratePowerOn();
+            // Network bring-up runs in loop(), so "after setup" starts at the first connect
+            if (!allocHookArmed()) allocHookArm();
         } else if (connState == ConnectionState::RECONNECTING ||
                    connState == ConnectionState::WIFI_CONNECTING ||
                    connState == ConnectionState::PLAYER_SELECT) {
@@ -207,29 +382,23 @@ void loop() {
             displayConnectionStatus(connState, detail);
         }
 
-        Serial.print("Connection state: ");
-        switch (connState) {
-            case ConnectionState::BOOT:            Serial.println("BOOT"); break;
-            case ConnectionState::PLAYER_SELECT:   Serial.println("PLAYER_SELECT"); break;
-            case ConnectionState::WIFI_CONNECTING: Serial.println("WIFI_CONNECTING"); break;
-            case ConnectionState::WS_CONNECTING:   Serial.println("WS_CONNECTING"); break;
-            case ConnectionState::JOINING:         Serial.println("JOINING"); break;
-            case ConnectionState::CONNECTED:       Serial.println("CONNECTED"); break;
-            case ConnectionState::RECONNECTING:    Serial.println("RECONNECTING"); break;
-            case ConnectionState::ERROR:
-                Serial.print("ERROR: ");
-                Serial.println(networkGetLastError());
-                break;
+        if (connState == ConnectionState::ERROR) {
+            LOG_E("Connection state: ERROR: %s", networkGetLastError());
+        } else {
+            LOG_I("Connection state: %s", connectionStateName(connState));
         }
     }
 
+    if (stallUploadDue && connState == ConnectionState::CONNECTED) {
+        stallUpload();
+    }
+
     // ── Connected input handling ─────────────────────────────────────────────────
     if (networkIsConnected()) {
         heartrateCheckAndSend();
 
         // === TARGET SELECTION FAST PATH ===
         if (terminalOwnsDisplay) {
-            static unsigned long lastKeepAlive = 0;
             InputEvent event = inputPoll();
             switch (event) {
                 case InputEvent::UP: {
@@ -240,8 +409,7 @@ void loop() {
                     currentDisplay.line2.text  = currentDisplay.targetNames[newIdx];
                     currentDisplay.line2.style = DisplayStyle::NORMAL;
                     displayDirty = true;
-                    lastScrollMs = millis();
-                    settlePending = true;
+                    schedArm(settleTask, tunableGet(Tunable::SCROLL_SETTLE) * 1000);
                     break;
                 }
                 case InputEvent::DOWN: {
@@ -253,12 +421,12 @@ void loop() {
                     currentDisplay.line2.text  = currentDisplay.targetNames[newIdx];
                     currentDisplay.line2.style = DisplayStyle::NORMAL;
                     displayDirty = true;
-                    lastScrollMs = millis();
-                    settlePending = true;
+                    schedArm(settleTask, tunableGet(Tunable::SCROLL_SETTLE) * 1000);
                     break;
                 }
                 case InputEvent::YES: {
                     terminalOwnsDisplay = false;
+                    schedDisarm(settleTask);
                     int idx = currentDisplay.selectionIndex;
                     int count = currentDisplay.targetCount;
                     currentDisplay.targetCount = 0;
@@ -271,6 +439,7 @@ void loop() {
                 }
                 case InputEvent::NO:
                     terminalOwnsDisplay = false;
+                    schedDisarm(settleTask);
                     currentDisplay.targetCount = 0;
                     networkSendAbstain();
                     break;
@@ -278,37 +447,26 @@ void loop() {
                     break;
             }
 
-            if (settlePending && (millis() - lastScrollMs >= SCROLL_SETTLE_MS)) {
-                settlePending = false;
-                if (currentDisplay.selectionIndex >= 0 &&
-                    currentDisplay.selectionIndex < currentDisplay.targetCount) {
-                    networkSendSelectTo(currentDisplay.targetIds[currentDisplay.selectionIndex].c_str());
-                }
+            // Dial steps redraw locally; YES/NO go to the server and wait for its state
+            if (event != InputEvent::NONE) {
+                latencyInput(inputEventCapturedUs(),
+                             event == InputEvent::YES || event == InputEvent::NO);
             }
 
-            if (displayDirty) {
-                displayRender(currentDisplay);
-                displayDirty = false;
-            }
-
-            if (millis() - lastKeepAlive >= WS_KEEPALIVE_MS) {
-                lastKeepAlive = millis();
-                networkUpdate();
-            }
+            commitFrame();
 
             if (!networkIsConnected()) {
                 terminalOwnsDisplay = false;
                 currentDisplay.targetCount = 0;
             } else {
-                delay(1);
                 return;
             }
         }
 
         if (currentDisplay.targetCount > 0) {
             terminalOwnsDisplay = true;
-            ledsSetYes(LedState::BRIGHT);
-            ledsSetNo(LedState::BRIGHT);
+            currentDisplay.leds.yes = LedState::BRIGHT;
+            currentDisplay.leds.no = LedState::BRIGHT;
         }
 
         InputEvent event = inputPoll();
@@ -325,27 +483,27 @@ void loop() {
                     break;
                 case InputEvent::YES:
                     if (!networkIsOperatorReady()) {
-                        Serial.println("Operator: add word");
+                        LOG_I("Operator: add word");
                         networkSendOperatorAdd();
                     }
                     break;
                 case InputEvent::NO:
                     if (networkIsOperatorReady()) {
-                        Serial.println("Operator: cancel ready");
+                        LOG_I("Operator: cancel ready");
                         networkSendOperatorUnready();
                     } else {
-                        Serial.println("Operator: delete word");
+                        LOG_I("Operator: delete word");
                         networkSendOperatorDelete();
                     }
                     break;
                 case InputEvent::LONG_YES:
                     if (!networkIsOperatorReady()) {
-                        Serial.println("Operator: long YES -> ready");
+                        LOG_I("Operator: long YES -> ready");
                         networkSendOperatorReady();
                     }
                     break;
                 case InputEvent::LONG_NO:
-                    Serial.println("Operator: long NO -> clear");
+                    LOG_I("Operator: long NO -> clear");
                     networkSendOperatorClear();
                     break;
                 case InputEvent::NONE:
@@ -386,31 +544,491 @@ void loop() {
                 default:
                     break;
             }
+            if (event != InputEvent::NONE) latencyInput(inputEventCapturedUs(), true);
         }
 
-        if (displayDirty) {
-            displayRender(currentDisplay);
-            displayDirty = false;
-        }
+        commitFrame();
     }
     else if (connState == ConnectionState::ERROR) {
         static unsigned long lastRetryTime = 0;
         unsigned long now = millis();
         if (now - lastRetryTime >= WS_RECONNECT_MS) {
             lastRetryTime = now;
-            Serial.println("Auto-retrying join...");
+            LOG_I("Auto-retrying join...");
             networkRetryJoin();
         }
         InputEvent event = inputPoll();
         if (event == InputEvent::YES || event == InputEvent::NO) {
-            Serial.println("Manual retry join...");
+            LOG_I("Manual retry join...");
             networkRetryJoin();
         }
     }
 
+    updatePower(connState);
+
     if (networkOtaRequested()) {
         networkExecuteOta();
     }
+}
+
+// Clock and radio follow the game phase; the game loop itself slows down in IDLE
+// (buttons and the dial still run it at once through the wake notification)
+static void updatePower(ConnectionState connState) {
+    PowerLevel before = powerGetLevel();
+    powerUpdate(connState, currentDisplay.statusLed, terminalOwnsDisplay || !psIsConfirmed());
+    PowerLevel after = powerGetLevel();
+    if (after != before) {
+        uint32_t tickMs = after == PowerLevel::IDLE ? APP_IDLE_TICK_MS : APP_TICK_MS;
+        schedSetPeriod(appTask, tickMs * 1000);
+        profUpdateThreshold();   // The slow-loop threshold is in cycles
+    }
+}
+
+// Heart rate task: every AD8232_SAMPLE_MS while there is a signal to sample, the slower
+// leads poll while the electrodes are off or the AD8232 is powered down
+static void heartrateTick() {
+    heartrateUpdate();
+    schedSetPeriod(heartrateTask, heartrateTaskPeriodMs() * 1000);
+}
+
+static void ledsTick() {
+    ledsUpdate();
+    updateFrameTasks();
+}
+
+static void displayTick() {
+    displayUpdate();
+    updateFrameTasks();
+}
+
+// In IDLE the LED and display tasks only run while a fade, pulse, animation, blink or
+// the scope is in progress, so the loop can sleep through to the next app tick. Anything
+// that starts one happens in the game loop, which re-arms them on its way out.
+static void updateFrameTasks() {
+    bool idle = powerGetLevel() == PowerLevel::IDLE;
+    schedSetPeriod(ledsTask, !idle || ledsAnimating() ? LED_FRAME_MS * 1000 : 0);
+    schedSetPeriod(displayTask, !idle || displayAnimating() ? DISPLAY_SCOPE_FRAME_MS * 1000 : 0);
+}
+
+// Dial stopped moving during target selection: tell the server where it landed
+static void settleTick() {
+    if (terminalOwnsDisplay &&
+        currentDisplay.selectionIndex >= 0 &&
+        currentDisplay.selectionIndex < currentDisplay.targetCount) {
+        networkSendSelectTo(currentDisplay.targetIds[currentDisplay.selectionIndex].c_str());
+    }
+}
+
+// Per-task runtime report
+static void schedLogTick() {
+    for (int i = 0; i < schedTaskCount(); i++) {
+        SchedStats s = schedGetStats(i);
+        LOG_I("[Sched] %-9s %6lu runs, avg %4lu us, max %6lu us, %lu overruns",
+              schedGetName(i), (unsigned long)s.runs, (unsigned long)s.avgUs,
+              (unsigned long)s.maxUs, (unsigned long)s.overruns);
+    }
+    schedResetStats();
+}
+
+static uint32_t clockUs() {
+    return micros();
+}
+
+// Input-to-photon and input-to-ack percentiles for each phase that has samples
+static void latencyLogReport() {
+    for (int phase = 0; phase < LATENCY_PHASES; phase++) {
+        for (int m = 0; m < LATENCY_METRICS; m++) {
+            LatencyPercentiles p = latencyGet((LatencyMetric)m, phase);
+            if (p.count == 0) continue;
+            LOG_OUT("[Latency] %-9s %-6s n=%2u p50 %6lu us, p90 %6lu us, p99 %6lu us, max %6lu us",
+                    gameLedStateName((GameLedState)phase),
+                    m == (int)LatencyMetric::PHOTON ? "photon" : "ack", (unsigned)p.count,
+                    (unsigned long)p.p50Us, (unsigned long)p.p90Us,
+                    (unsigned long)p.p99Us, (unsigned long)p.maxUs);
+        }
+    }
+    LOG_OUT("[Latency] %lu inputs unanswered", (unsigned long)latencyTimeouts());
+}
+
+static void heapTick() {
+    HeapSample sample;
+    sample.freeBytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    sample.largestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    sample.minEverFree = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    heapmonSample(sample);
+
+#if HEAP_ALLOC_TRAP
+    AllocTrap traps[HEAP_TRAP_SITES];
+    int trapCount = allocHookTakeTraps(traps, HEAP_TRAP_SITES);
+    for (int i = 0; i < trapCount; i++) {
+        LOG_E("[Heap] Trap: %lu B from 0x%08lx in %s@0x%08lx",
+              (unsigned long)traps[i].bytes, (unsigned long)traps[i].site,
+              profScopeName((ProfScope)traps[i].scope), (unsigned long)traps[i].scopeSite);
+    }
+#endif
+
+    if (millis() - lastHeapReport < HEAP_REPORT_MS || !networkIsConnected()) return;
+    lastHeapReport = millis();
+
+    // ESP-IDF reports stack high-water marks in bytes
+    TaskStack stacks[] = {
+        { "loop", loopTaskHandle ? uxTaskGetStackHighWaterMark(loopTaskHandle) : 0 },
+        { "stallwd", stallTaskHandle ? uxTaskGetStackHighWaterMark(stallTaskHandle) : 0 },
+        { "log", logTaskHandle ? uxTaskGetStackHighWaterMark(logTaskHandle) : 0 },
+    };
+    HeapSite sites[HEAP_REPORT_SITES];
+    uint32_t missed = 0;
+    int siteCount = allocHookTakeSites(sites, HEAP_REPORT_SITES, &missed);
+
+    HeapSummary heap = heapmonSummary();
+    networkSendHeapReport(heap, stacks, sizeof(stacks) / sizeof(stacks[0]), sites, siteCount, missed);
+    LOG_I("[Heap] free %lu, largest %lu (%u%% fragmented), min ever %lu, stack free loop %lu",
+          (unsigned long)heap.last.freeBytes, (unsigned long)heap.last.largestBlock,
+          heap.fragPct, (unsigned long)heap.last.minEverFree,
+          (unsigned long)stacks[0].freeBytes);
+}
+
+static uint32_t logClockMs() {
+    return millis();
+}
+
+// Text mode formats here, off the loop; LOG_BINARY writes each record raw behind a
+// 0x1E marker and leaves formatting to tools/log-decode.mjs
+static void logDrainTask(void* arg) {
+    static uint8_t rec[LOG_RECORD_MAX];
+    static char line[LOG_RECORD_MAX + LOG_STR_MAX];
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_MS));
+
+        int len;
+        while ((len = logPop(rec)) > 0) {
+            // Lines the host asked for are formatted here in binary mode too
+            int n = -1;
+            uint8_t level = (uint8_t)logRecordLevel(rec);
+            if (diagLevel() > 0 && level <= diagLevel()) {
+                n = logFormat(rec, len, line, sizeof(line) - 1);
+                diagPushLine(level, logRecordMs(rec), line, n);
+            }
+#if LOG_BINARY
+            Serial.write((uint8_t)0x1E);
+            Serial.write(rec, len);
+#else
+            if (n < 0) n = logFormat(rec, len, line, sizeof(line) - 1);
+            line[n++] = '\n';
+            Serial.write((const uint8_t*)line, n);
+#endif
+        }
+
+        uint32_t dropped = logTakeDropped();
+        if (dropped > 0) {
+            int n = snprintf(line, sizeof(line), "[Log] %lu records dropped\n", (unsigned long)dropped);
+            Serial.write((const uint8_t*)line, n);
+        }
+    }
+}
 
-    delay(1);
+static void diagTick() {
+    networkDiagFlush();
+    if (!networkDiagMetricsEnabled() || millis() - lastDiagMetrics < DIAG_METRICS_MS) return;
+
+    uint32_t values[DIAG_METRICS] = {};
+    values[(int)DiagMetric::HEAP_FREE] = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    values[(int)DiagMetric::HEAP_LARGEST] = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    values[(int)DiagMetric::HEAP_MIN_EVER] = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    values[(int)DiagMetric::LATENCY_TIMEOUTS] = latencyTimeouts();
+    portENTER_CRITICAL(&stallMux);
+    values[(int)DiagMetric::STALLS] = stallCount();
+    portEXIT_CRITICAL(&stallMux);
+    if (networkSendDiagMetrics(values)) lastDiagMetrics = millis();
+}
+
+// ============================================================================
+// SERIAL CONSOLE
+// ============================================================================
+
+static void consoleTick() {
+    for (int i = 0; i < CONSOLE_BYTES_PER_POLL && Serial.available() > 0; i++) {
+        consoleFeed((char)Serial.read());
+    }
+}
+
+static void cmdProf(int argc, char** argv) {
+    profLogReport();
+    latencyLogReport();
+}
+
+static void cmdHeap(int argc, char** argv) {
+    HeapSummary heap = heapmonSummary();
+    LOG_OUT("[Heap] free %lu, largest %lu (%u%% fragmented), min ever %lu",
+            (unsigned long)heap.last.freeBytes, (unsigned long)heap.last.largestBlock,
+            heap.fragPct, (unsigned long)heap.last.minEverFree);
+    LOG_OUT("[Heap] worst sampled: free %lu, largest %lu, %u%% fragmented",
+            (unsigned long)heap.minFree, (unsigned long)heap.minLargest, heap.maxFragPct);
+    LOG_OUT("[Heap] stack free: loop %lu, stallwd %lu, log %lu",
+            (unsigned long)(loopTaskHandle ? uxTaskGetStackHighWaterMark(loopTaskHandle) : 0),
+            (unsigned long)(stallTaskHandle ? uxTaskGetStackHighWaterMark(stallTaskHandle) : 0),
+            (unsigned long)(logTaskHandle ? uxTaskGetStackHighWaterMark(logTaskHandle) : 0));
+}
+
+static void cmdNet(int argc, char** argv) {
+    networkLogStatus();
+}
+
+static void cmdLog(int argc, char** argv) {
+    uint32_t level;
+    if (argc < 2) {
+        LOG_OUT("Log level %u (built with %d: 1 error, 2 warn, 3 info, 4 debug)", logLevel(), LOG_LEVEL);
+        return;
+    }
+    if (!consoleParseUint(argv[1], 0, LOG_LEVEL, &level)) return;
+    logSetLevel(level);
+    LOG_OUT("Log level %u", logLevel());
+}
+
+static void cmdReconnect(int argc, char** argv) {
+    networkReconnect(false);
+}
+
+static void cmdDiscover(int argc, char** argv) {
+    networkReconnect(true);
+}
+
+static void cmdSet(int argc, char** argv) {
+    if (argc < 3) {
+        logTunables(false);
+        return;
+    }
+    int i = tunableFind(argv[1]);
+    if (i < 0) {
+        LOG_OUT("Unknown setting '%s' (set lists them)", argv[1]);
+        return;
+    }
+    const TunableDef& d = tunableDef((Tunable)i);
+    uint32_t v;
+    if (!consoleParseUint(argv[2], d.min, d.max, &v)) return;
+    tunableSet((Tunable)i, v);
+}
+
+static void cmdSave(int argc, char** argv) {
+    if (tunablesSave()) LOG_OUT("Settings stored, loaded again at boot");
+    else LOG_OUT("Could not open NVS");
+}
+
+static void cmdDefaults(int argc, char** argv) {
+    tunablesResetDefaults();
+    LOG_OUT("Settings back to the defaults (save to keep them)");
+}
+
+static void cmdHrSave(int argc, char** argv) {
+    if (heartrateSaveDetectorParams()) LOG_OUT("Detector params stored for this player slot");
+    else LOG_OUT("Nothing to store: no player slot, or the detector is not calibrated");
+}
+
+static const ConsoleCommand consoleCommands[] = {
+    { "prof",      "",                "Loop profile histograms and input latency percentiles", cmdProf },
+    { "heap",      "",                "Heap free / largest block / fragmentation, task stacks", cmdHeap },
+    { "net",       "",                "Connection state, server, signal", cmdNet },
+    { "log",       "[0-4]",           "Show or set the log level (up to the built-in one)", cmdLog },
+    { "reconnect", "",                "Drop the WebSocket and connect again", cmdReconnect },
+    { "discover",  "",                "Forget the server address and rediscover it", cmdDiscover },
+    { "set",       "[name value]",    "Show or change a tunable (until reboot)", cmdSet },
+    { "save",      "",                "Store the tunables so they survive reboot", cmdSave },
+    { "defaults",  "",                "Put every tunable back to its default", cmdDefaults },
+    { "hrsave",    "",                "Store the calibrated detector params for the slot again", cmdHrSave },
+};
+
+static void consoleInitCommands() {
+    consoleInit(consoleCommands, sizeof(consoleCommands) / sizeof(consoleCommands[0]));
+}
+
+// ============================================================================
+// RUNTIME TUNABLES
+// ============================================================================
+
+static void onTunableChanged(Tunable t) {
+    uint32_t v = tunableGet(t);
+    switch (t) {
+        case Tunable::DEBOUNCE:      inputSetDebounceMs(v); break;
+        case Tunable::WS_PING:       networkApplyWsPing(); break;
+        case Tunable::HR_THRESHOLD:
+        case Tunable::HR_MIN_RANGE:
+        case Tunable::HR_REFRACTORY: heartrateDetectorDefaultsChanged(); break;
+        default: break;    // Read where they are used
+    }
+    const TunableDef& d = tunableDef(t);
+    LOG_I("[Tune] %s = %lu%s", d.name, (unsigned long)v, d.unit);
+}
+
+// Console listing, or at boot the values that differ from the defaults
+static void logTunables(bool changedOnly) {
+    for (int i = 0; i < (int)Tunable::COUNT; i++) {
+        const TunableDef& d = tunableDef((Tunable)i);
+        uint32_t v = tunableGet((Tunable)i);
+        if (changedOnly) {
+            if (v != d.def) LOG_I("[Tune] %s = %lu%s (default %lu)", d.name, (unsigned long)v, d.unit, (unsigned long)d.def);
+        } else {
+            LOG_OUT("  %-15s %5lu%-2s %lu..%lu, default %lu%s", d.name, (unsigned long)v, d.unit,
+                    (unsigned long)d.min, (unsigned long)d.max, (unsigned long)d.def, v != d.def ? " *" : "");
+        }
+    }
+}
+
+static void stallWatchdogTask(void* arg) {
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(STALL_CHECK_MS));
+
+        ProfScope scopes[STALL_DEPTH];
+        uintptr_t sites[STALL_DEPTH];
+        int depth = profActiveScopes(scopes, sites, STALL_DEPTH);
+        uint8_t scopeIds[STALL_DEPTH];
+        uint32_t siteAddrs[STALL_DEPTH];
+        for (int i = 0; i < depth; i++) {
+            scopeIds[i] = (uint8_t)scopes[i];
+            siteAddrs[i] = (uint32_t)sites[i];
+        }
+
+        portENTER_CRITICAL(&stallMux);
+        stallCheck(millis(), scopeIds, siteAddrs, depth);
+        portEXIT_CRITICAL(&stallMux);
+    }
+}
+
+// Loop side: feed the watchdog before sleeping, and log stalls that just finished
+static void stallTick(uint32_t idleUs) {
+    StallRecord finished;
+    bool fresh = false;
+
+    portENTER_CRITICAL(&stallMux);
+    stallFeed(millis(), idleUs / 1000);
+    int n = stallCount();
+    if (n > 0 && stallGet(n - 1)->seq != stallLoggedSeq) {
+        finished = *stallGet(n - 1);
+        stallLoggedSeq = finished.seq;
+        fresh = true;
+    }
+    portEXIT_CRITICAL(&stallMux);
+
+    if (fresh) {
+        stallLog(finished);
+        stallUploadDue = true;
+    }
+}
+
+static void stallUpload() {
+    StallRecord records[STALL_RING];
+    portENTER_CRITICAL(&stallMux);
+    int n = stallCount();
+    for (int i = 0; i < n; i++) records[i] = *stallGet(i);
+    portEXIT_CRITICAL(&stallMux);
+
+    if (n > 0 && !networkSendStallReport(records, n, resetReasonName())) return;
+
+    portENTER_CRITICAL(&stallMux);
+    stallAck(n);
+    portEXIT_CRITICAL(&stallMux);
+    stallUploadDue = false;
+    if (n > 0) LOG_I("[Stall] Uploaded %d record(s)", n);
+}
+
+// "[Stall] #3 boot 2: 640 ms in network < display (0x42001234 0x42005678)"
+static void stallLog(const StallRecord& r) {
+    char where[96];
+    int len = snprintf(where, sizeof(where), "%s", r.depth ? "" : "other");
+    for (int i = 0; i < r.depth && len < (int)sizeof(where); i++) {
+        len += snprintf(where + len, sizeof(where) - len, "%s%s", i ? " < " : "",
+                        profScopeName((ProfScope)r.scopes[i]));
+    }
+    for (int i = 0; i < r.depth && len < (int)sizeof(where); i++) {
+        len += snprintf(where + len, sizeof(where) - len, "%s0x%08lx%s", i ? " " : " (",
+                        (unsigned long)r.sites[i], i == r.depth - 1 ? ")" : "");
+    }
+    LOG_W("[Stall] #%lu boot %lu: %lu ms in %s%s", (unsigned long)r.seq,
+          (unsigned long)r.boot, (unsigned long)r.durationMs, where,
+          (r.flags & STALL_UNFINISHED) ? ", cut short by reset" : "");
+}
+
+static const char* resetReasonName() {
+    switch (esp_reset_reason()) {
+        case ESP_RST_POWERON:   return "power-on";
+        case ESP_RST_EXT:       return "external";
+        case ESP_RST_SW:        return "software";
+        case ESP_RST_PANIC:     return "panic";
+        case ESP_RST_INT_WDT:   return "interrupt watchdog";
+        case ESP_RST_TASK_WDT:  return "task watchdog";
+        case ESP_RST_WDT:       return "watchdog";
+        case ESP_RST_DEEPSLEEP: return "deep sleep";
+        case ESP_RST_BROWNOUT:  return "brownout";
+        default:                return "unknown";
+    }
+}
+
+static uint32_t cycleClock() {
+    return ESP.getCycleCount();
+}
+
+static void profUpdateThreshold() {
+    profSetSlowThreshold(PROF_SLOW_LOOP_US * getCpuFrequencyMhz());
+}
+
+// Per-scope report since the last one: calls, avg/max time, slow loops blamed, and the
+// histogram as "<lower bound in us>:<count>" for each non-empty bucket
+static void profLogReport() {
+    uint32_t mhz = getCpuFrequencyMhz();
+    LOG_OUT("[Prof] %lu MHz, slow loop > %d us", (unsigned long)mhz, PROF_SLOW_LOOP_US);
+    for (int i = 0; i < PROF_SCOPES; i++) {
+        const ProfStats& s = profGetStats((ProfScope)i);
+        if (s.count == 0) continue;
+        char hist[160];
+        int len = 0;
+        for (int b = 0; b < PROF_BUCKETS && len < (int)sizeof(hist) - 16; b++) {
+            if (s.hist[b] == 0) continue;
+            uint32_t floorNs = (uint32_t)((uint64_t)profBucketFloor(b) * 1000 / mhz);
+            if (floorNs < 1000) {
+                len += snprintf(hist + len, sizeof(hist) - len, " %luns:%lu",
+                                (unsigned long)floorNs, (unsigned long)s.hist[b]);
+            } else {
+                len += snprintf(hist + len, sizeof(hist) - len, " %lu:%lu",
+                                (unsigned long)(floorNs / 1000), (unsigned long)s.hist[b]);
+            }
+        }
+        hist[len] = '\0';
+        LOG_OUT("[Prof] %-9s %7lu x, avg %5lu us, max %6lu us, %lu slow |%s",
+                profScopeName((ProfScope)i), (unsigned long)s.count,
+                (unsigned long)(s.sumCycles / s.count / mhz),
+                (unsigned long)(s.maxCycles / mhz), (unsigned long)s.slow, hist);
+    }
+    profResetStats();
+}
+
+void loop() {
+#if PROFILE_ENABLE
+    profLoopBegin();
+    uint32_t idleUs = schedRun();
+    ProfSlowLoop slow;
+    if (profLoopEnd(&slow) && millis() - lastSlowLog >= PROF_SLOW_LOG_MS) {
+        lastSlowLog = millis();
+        uint32_t mhz = getCpuFrequencyMhz();
+        LOG_W("[Prof] Slow loop %lu us: %s %lu us",
+              (unsigned long)(slow.cycles / mhz), profScopeName(slow.culprit),
+              (unsigned long)(slow.culpritCycles / mhz));
+    }
+#else
+    uint32_t idleUs = schedRun();
+#endif
+    stallTick(idleUs);
+
+    // Sleep until the next release; a button edge (inputSetWakeTask) ends it early and
+    // runs the game loop at once. The wait is rounded up to whole ticks: an n-tick block
+    // can end up to a tick early, so rounding down (or skipping sub-tick waits) would come
+    // back to schedRun() before anything is due and spin. Releases run up to a tick late
+    // instead. With automatic light sleep built in, the idle task sleeps the chip through it.
+    if (idleUs > 0) {
+        const uint32_t tickUs = portTICK_PERIOD_MS * 1000;
+        TickType_t ticks = idleUs / tickUs + (idleUs % tickUs != 0);
+        uint32_t sleptFrom = micros();
+        if (ulTaskNotifyTake(pdTRUE, ticks) > 0) {
+            schedArm(appTask, 0);
+        }
+        powerAddSleep(micros() - sleptFrom);
+    }
 }
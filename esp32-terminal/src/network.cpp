@@ -4,6 +4,15 @@
 #include "display.h"
 #include "leds.h"
 #include "heartrate.h"
+#include "timesync.h"
+#include "ledanim.h"
+#include "prof.h"
+#include "latency.h"
+#include "stall.h"
+#include "allochook.h"
+#include "logbuf.h"
+#include "diag.h"
+#include "tunables.h"
 #include <WiFi.h>
 #include <WiFiUdp.h>
 #include <HTTPClient.h>
@@ -15,6 +24,11 @@
 // WebSocket client
 static WebSocketsClient webSocket;
 
+// Outgoing frames are built here behind room for the WebSocket header, so the library
+// frames them in place (handed a plain payload, it copies it into a malloc'd frame)
+static uint8_t txFrame[WEBSOCKETS_MAX_HEADER_SIZE + WS_TX_MAX];
+static char* const txPayload = (char*)txFrame + WEBSOCKETS_MAX_HEADER_SIZE;
+
 // UDP discovery
 static WiFiUDP udp;
 static char serverHost[16] = "";  // Discovered server IP
@@ -31,15 +45,17 @@ static bool operatorReady = false;
 // Operator word list — populated dynamically from server on OPERATOR_JOIN.
 // Server sends vocabulary in the first OPERATOR_STATE message (shared/operatorWords.js).
 static const int MAX_OP_WORDS = 200;
-static String operatorVocab[MAX_OP_WORDS];
+static const int OP_WORD_LEN = 24;   // Longest word in shared/operatorWords.js is 14
+static char operatorVocab[MAX_OP_WORDS][OP_WORD_LEN];
 static int operatorVocabSize = 0;
 
 // Operator selection state (single flat dial position)
 static int operatorFlatIdx = 0;
 
 // Operator built state (from server)
+static const int OP_MSG_RESERVE = 128;
 static String operatorBuiltMsg  = "";
-static String operatorLastWord  = "";  // last committed word, for NO jump
+static char   operatorLastWord[OP_WORD_LEN] = "";  // last committed word, for NO jump
 static int    operatorWordCount = 0;
 
 // Operator "SENT!" feedback timer (0 = inactive)
@@ -51,23 +67,71 @@ static bool wsConnected = false;
 static bool gameJoined = false;
 static unsigned long lastReconnectAttempt = 0;
 static char lastError[128] = "";
+static unsigned long lastTimeSync = 0;
+
+// Low-priority binary uplink budgets (token buckets, in byte-milliseconds so the
+// per-call refill doesn't round away at high loop rates)
+struct TokenBucket {
+    uint32_t rateBps;
+    uint32_t depthBytes;
+    uint32_t tokens;
+    unsigned long lastRefill;
+};
+static TokenBucket streamBucket = { STREAM_BUDGET_BPS, STREAM_BURST_BYTES, STREAM_BURST_BYTES * 1000UL, 0 };
+static uint32_t streamDropped = 0;
+
+// Remote diagnostics: the host picks the log level and metrics per terminal (DIAG_CONFIG);
+// frames wait until no game message went either way for DIAG_QUIET_MS
+static TokenBucket diagBucket = { DIAG_BUDGET_BPS, DIAG_FRAME_MAX, DIAG_FRAME_MAX * 1000UL, 0 };
+static bool diagMetricsOn = false;
+static uint16_t diagSeq = 0;
+static unsigned long lastGameTraffic = 0;
 
 // OTA update flag — set by WebSocket handler, executed from main loop
 static bool otaRequested = false;
 
+// Loop profile report requested by the server — sent from networkUpdate(), outside the
+// WebSocket callback and its 6 KB parse buffer
+static bool profileRequested = false;
+
+// Tunables changed or read by the server — the report goes out from networkUpdate() too.
+// Names the request could not apply are kept for it.
+static const int TUNE_REJECTED_MAX = 4;
+static bool tunablesReportDue = false;
+static bool tunablesSaved = false;
+static char tuneRejected[TUNE_REJECTED_MAX][16];
+static int tuneRejectedCount = 0;
+
 // Kicked flag — set by server KICKED message, causes terminal to return to player select
 static bool wasKicked = false;
 
 // Display state callback
 static DisplayStateCallback displayCallback = nullptr;
 
-// Current display state
+// Current display state, and the one the operator screen is built in (both reserved in
+// networkInit(), so PLAYER_STATE and dial input reuse their buffers)
 static DisplayState currentDisplayState;
+static DisplayState operatorState;
+
+// PLAYER_STATE carrying "at" is held until that server time, so a reveal lands on
+// every terminal at once. Any newer PLAYER_STATE replaces the held one.
+static bool commitPending = false;
+static uint32_t commitAt = 0;   // Local millis()
+
+// micros() when the current WebSocket message arrived, and when the state last handed
+// to displayCallback did (for a scheduled commit: when it fell due)
+static uint32_t messageArrivedUs = 0;
+static uint32_t stateArrivedUs = 0;
 
 // Forward declarations
 static void onWebSocketEvent(WStype_t type, uint8_t* payload, size_t length);
 static void parsePlayerState(JsonObject& payload);
 static void parseOperatorState(JsonObject& payload);
+static void sendProfileReport();
+static void applyTunables(JsonObject& payload);
+static void sendTunablesReport();
+static void startWebSocket();
+static void parseLedAnimation(JsonObject& payload);
 static void sendMessage(const char* type, JsonObject* payload = nullptr);
 static void updateOperatorDisplay();
 
@@ -82,9 +146,13 @@ static const char* getRangeLabel(const char* word) {
 }
 
 static void updateOperatorDisplay() {
+    stateArrivedUs = micros();  // Mostly driven by local dial input
+
+    DisplayState& state = operatorState;
+    state.reset();
+
     // Show "SENT!" briefly after a slide was dispatched (matches React Operator UX)
     if (operatorSentTime > 0 && millis() - operatorSentTime < 2000) {
-        DisplayState state;
         state.line2.text  = "SENT!";
         state.line2.style = DisplayStyle::CRITICAL;
         state.leds.yes    = LedState::OFF;
@@ -94,8 +162,7 @@ static void updateOperatorDisplay() {
         return;
     }
 
-    DisplayState state;
-    const char* currentWord = (operatorVocabSize > 0) ? operatorVocab[operatorFlatIdx].c_str() : "";
+    const char* currentWord = (operatorVocabSize > 0) ? operatorVocab[operatorFlatIdx] : "";
 
     // line1.left = committed sentence, line1.right = alphabetical range label when not ready
     state.line1.left  = operatorBuiltMsg;
@@ -123,14 +190,13 @@ void networkSetPlayerId(uint8_t playerNum) {
     // Use just the number to match the web client format
     snprintf(playerId, sizeof(playerId), "%d", playerNum);
     isOperatorMode = false;
-    Serial.print("Player ID set to: ");
-    Serial.println(playerId);
+    LOG_I("Player ID set to: %s", playerId);
 }
 
 void networkSetOperatorMode() {
     isOperatorMode = true;
     playerId[0] = '\0';
-    Serial.println("Operator mode set");
+    LOG_I("Operator mode set");
 }
 
 bool networkIsOperatorMode() {
@@ -143,15 +209,20 @@ bool networkIsOperatorReady() {
 
 void networkInit() {
     connState = ConnectionState::WIFI_CONNECTING;
+    currentDisplayState.reserve();
+    operatorState.reserve();
+    operatorBuiltMsg.reserve(OP_MSG_RESERVE);
 
     // Start WiFi connection
     WiFi.mode(WIFI_STA);
     WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
 
-    Serial.print("Connecting to WiFi: ");
-    Serial.println(WIFI_SSID);
-    Serial.print("Player ID: ");
-    Serial.println(playerId);
+    LOG_I("Connecting to WiFi: %s", WIFI_SSID);
+    LOG_I("Player ID: %s", playerId);
+}
+
+uint32_t networkStateArrivedUs() {
+    return stateArrivedUs;
 }
 
 void networkSetDisplayCallback(DisplayStateCallback callback) {
@@ -172,20 +243,20 @@ static bool isNewerVersion(const char* remote, const char* local) {
 // Check server for firmware update; download and apply if newer version available.
 // Called once after server discovery, before WebSocket connection.
 static void checkFirmwareUpdate(const char* host, uint16_t port) {
-    Serial.println("[OTA] Checking for firmware update...");
+    LOG_I("[OTA] Checking for firmware update...");
 
     // 1. Fetch version manifest
     HTTPClient http;
     char url[128];
     snprintf(url, sizeof(url), "http://%s:%d/firmware/version", host, port);
-    Serial.printf("[OTA] Fetching %s\n", url);
+    LOG_I("[OTA] Fetching %s", url);
     http.begin(String(url));
     http.setTimeout(5000);
     int httpCode = http.GET();
-    Serial.printf("[OTA] HTTP response: %d\n", httpCode);
+    LOG_I("[OTA] HTTP response: %d", httpCode);
 
     if (httpCode != 200) {
-        Serial.printf("[OTA] Version check failed (HTTP %d), skipping\n", httpCode);
+        LOG_W("[OTA] Version check failed (HTTP %d), skipping", httpCode);
         http.end();
         return;
     }
@@ -195,32 +266,32 @@ static void checkFirmwareUpdate(const char* host, uint16_t port) {
 
     StaticJsonDocument<128> doc;
     if (deserializeJson(doc, body)) {
-        Serial.println("[OTA] Failed to parse version JSON, skipping");
+        LOG_W("[OTA] Failed to parse version JSON, skipping");
         return;
     }
 
     const char* remoteVersion = doc["version"] | "0.0.0";
-    Serial.printf("[OTA] Local: %s, Server: %s\n", FIRMWARE_VERSION, remoteVersion);
+    LOG_I("[OTA] Local: %s, Server: %s", FIRMWARE_VERSION, remoteVersion);
 
     if (!isNewerVersion(remoteVersion, FIRMWARE_VERSION)) {
-        Serial.println("[OTA] Firmware is up to date");
+        LOG_I("[OTA] Firmware is up to date");
         return;
     }
 
     // 2. Log partition info for debugging
     const esp_partition_t* running = esp_ota_get_running_partition();
     const esp_partition_t* target = esp_ota_get_next_update_partition(NULL);
-    Serial.printf("[OTA] Running partition: %s (0x%06x)\n", running ? running->label : "?", running ? running->address : 0);
-    Serial.printf("[OTA] Target partition:  %s (0x%06x, size 0x%06x)\n",
+    LOG_I("[OTA] Running partition: %s (0x%06x)", running ? running->label : "?", running ? running->address : 0);
+    LOG_I("[OTA] Target partition:  %s (0x%06x, size 0x%06x)",
         target ? target->label : "?", target ? target->address : 0, target ? target->size : 0);
 
     // 3. Log heap state for debugging
-    Serial.printf("[OTA] Free heap: %d, largest block: %d\n",
+    LOG_I("[OTA] Free heap: %d, largest block: %d",
         ESP.getFreeHeap(), heap_caps_get_largest_free_block(MALLOC_CAP_DEFAULT));
 
     // 4. Disconnect WebSocket before OTA — frees RAM and prevents WiFi stack
     //    contention between WebSocket frames and HTTP download
-    Serial.println("[OTA] Disconnecting WebSocket for clean OTA...");
+    LOG_I("[OTA] Disconnecting WebSocket for clean OTA...");
     webSocket.disconnect();
     wsConnected = false;
     gameJoined = false;
@@ -228,15 +299,15 @@ static void checkFirmwareUpdate(const char* host, uint16_t port) {
     // 5. Stagger downloads — random delay so multiple terminals don't hit
     //    the server simultaneously (causes corrupt transfers)
     int staggerMs = random(100, 3000);
-    Serial.printf("[OTA] Staggering %d ms...\n", staggerMs);
+    LOG_I("[OTA] Staggering %d ms...", staggerMs);
     delay(staggerMs);
 
     // 6. Download and flash
-    Serial.printf("[OTA] Updating to %s...\n", remoteVersion);
+    LOG_I("[OTA] Updating to %s...", remoteVersion);
     displayMessage("OTA UPDATE", remoteVersion, "Downloading...");
 
     snprintf(url, sizeof(url), "http://%s:%d/firmware/firmware.bin", host, port);
-    Serial.printf("[OTA] Downloading %s\n", url);
+    LOG_I("[OTA] Downloading %s", url);
 
     WiFiClient client;
     httpUpdate.setLedPin(-1);  // No LED
@@ -245,26 +316,43 @@ static void checkFirmwareUpdate(const char* host, uint16_t port) {
 
     switch (ret) {
         case HTTP_UPDATE_OK:
-            Serial.println("[OTA] Update successful! Rebooting...");
+            LOG_I("[OTA] Update successful! Rebooting...");
             displayMessage("OTA UPDATE", "SUCCESS", "Rebooting...");
             ledsSetStatusColor(0, 255, 0); // Green neopixel
             delay(500);
             ESP.restart();
             break;
         case HTTP_UPDATE_FAILED:
-            Serial.printf("[OTA] Failed (err %d): %s\n",
+            LOG_E("[OTA] Failed (err %d): %s",
                 httpUpdate.getLastError(), httpUpdate.getLastErrorString().c_str());
             displayMessage("OTA UPDATE", "FAILED", httpUpdate.getLastErrorString().c_str());
             ledsSetStatusColor(255, 0, 0); // Red neopixel
             delay(3000);
             break;
         case HTTP_UPDATE_NO_UPDATES:
-            Serial.println("[OTA] No update needed");
+            LOG_I("[OTA] No update needed");
             break;
     }
 }
 
+static void startWebSocket() {
+    webSocket.begin(serverHost, serverPort, WS_PATH);
+    webSocket.onEvent(onWebSocketEvent);
+    webSocket.setReconnectInterval(WS_RECONNECT_MS);
+    networkApplyWsPing();
+}
+
+void networkApplyWsPing() {
+    uint32_t ms = tunableGet(Tunable::WS_PING);
+    if (ms > 0) {
+        webSocket.enableHeartbeat(ms, WS_PONG_TIMEOUT_MS, 2);
+    } else {
+        webSocket.disableHeartbeat();
+    }
+}
+
 ConnectionState networkUpdate() {
+    PROF_SCOPE(ProfScope::NETWORK);
     unsigned long now = millis();
 
     switch (connState) {
@@ -275,14 +363,12 @@ ConnectionState networkUpdate() {
 
         case ConnectionState::WIFI_CONNECTING:
             if (WiFi.status() == WL_CONNECTED) {
-                Serial.print("WiFi connected. IP: ");
-                Serial.println(WiFi.localIP());
+                IPAddress ip = WiFi.localIP();
+                LOG_I("WiFi connected. IP: %u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
 
                 if (serverHost[0] != '\0') {
                     // Already discovered server (reconnecting), go straight to WS
-                    webSocket.begin(serverHost, serverPort, WS_PATH);
-                    webSocket.onEvent(onWebSocketEvent);
-                    webSocket.setReconnectInterval(WS_RECONNECT_MS);
+                    startWebSocket();
                     connState = ConnectionState::WS_CONNECTING;
                 } else {
                     // Need to discover server first
@@ -297,7 +383,7 @@ ConnectionState networkUpdate() {
             unsigned long now2 = millis();
             // Send broadcast periodically
             if (now2 - lastDiscoveryBroadcast >= DISCOVERY_TIMEOUT_MS) {
-                Serial.println("Broadcasting discovery...");
+                LOG_I("Broadcasting discovery...");
                 udp.beginPacket(IPAddress(255, 255, 255, 255), DISCOVERY_PORT);
                 udp.print(DISCOVERY_MSG);
                 udp.endPacket();
@@ -322,17 +408,12 @@ ConnectionState networkUpdate() {
                     snprintf(serverHost, sizeof(serverHost), "%d.%d.%d.%d",
                              remoteIP[0], remoteIP[1], remoteIP[2], remoteIP[3]);
 
-                    Serial.print("Server found at ");
-                    Serial.print(serverHost);
-                    Serial.print(":");
-                    Serial.println(serverPort);
+                    LOG_I("Server found at %s:%u", serverHost, serverPort);
 
                     udp.stop();
 
                     // Connect WebSocket
-                    webSocket.begin(serverHost, serverPort, WS_PATH);
-                    webSocket.onEvent(onWebSocketEvent);
-                    webSocket.setReconnectInterval(WS_RECONNECT_MS);
+                    startWebSocket();
                     connState = ConnectionState::WS_CONNECTING;
                 }
             }
@@ -367,9 +448,30 @@ ConnectionState networkUpdate() {
 
         case ConnectionState::CONNECTED:
             webSocket.loop();
+            if (commitPending && (int32_t)(millis() - commitAt) >= 0) {
+                commitPending = false;
+                stateArrivedUs = micros();
+                if (displayCallback != nullptr) displayCallback(currentDisplayState);
+                LOG_I("[Display] Scheduled commit, %ld ms late", (long)(millis() - commitAt));
+            }
             if (!wsConnected) {
                 gameJoined = false;
                 connState = ConnectionState::RECONNECTING;
+            } else if (now - lastTimeSync >= (timesyncIsSettled() ? TIME_SYNC_INTERVAL_MS : 1000)) {
+                // Server echoes t back with its own clock; see timesync.cpp
+                lastTimeSync = now;
+                StaticJsonDocument<64> doc;
+                doc["t"] = (uint32_t)now;
+                JsonObject payload = doc.as<JsonObject>();
+                sendMessage(ClientMsg::TIME_SYNC, &payload);
+            }
+            if (profileRequested && wsConnected) {
+                profileRequested = false;
+                sendProfileReport();
+            }
+            if (tunablesReportDue && wsConnected) {
+                tunablesReportDue = false;
+                sendTunablesReport();
             }
             break;
 
@@ -408,7 +510,7 @@ ConnectionState networkUpdate() {
 
 void networkRetryJoin() {
     if (connState == ConnectionState::ERROR || connState == ConnectionState::RECONNECTING) {
-        Serial.println("Retrying join...");
+        LOG_I("Retrying join...");
         lastError[0] = '\0';  // Clear error message
 
         if (wsConnected) {
@@ -429,10 +531,44 @@ void networkRetryJoin() {
     }
 }
 
+void networkReconnect(bool rediscover) {
+    if (connState == ConnectionState::BOOT) return;   // networkInit() not called yet
+    LOG_I("Reconnecting%s", rediscover ? " with discovery" : "");
+    webSocket.disconnect();
+    wsConnected = false;
+    gameJoined = false;
+    if (rediscover) serverHost[0] = '\0';
+    if (connState == ConnectionState::DISCOVERING) udp.stop();
+    // WiFi normally stays up: the next update goes straight on to discovery or the WebSocket
+    connState = ConnectionState::WIFI_CONNECTING;
+}
+
+void networkLogStatus() {
+    IPAddress ip = WiFi.localIP();
+    LOG_OUT("State %s, WiFi %s, IP %u.%u.%u.%u, RSSI %d dBm",
+            connectionStateName(connState), WiFi.status() == WL_CONNECTED ? "up" : "down",
+            ip[0], ip[1], ip[2], ip[3], (int)WiFi.RSSI());
+    LOG_OUT("Server %s:%u, %s %s, joined %s", serverHost[0] ? serverHost : "(not found)", serverPort,
+            isOperatorMode ? "operator" : "player", isOperatorMode ? "" : playerId,
+            gameJoined ? "yes" : "no");
+    if (lastError[0]) LOG_OUT("Last error: %s", lastError);
+    LOG_OUT("Stream frames over budget %lu, remote log level %u", (unsigned long)streamDropped, diagLevel());
+}
+
 bool networkIsConnected() {
     return connState == ConnectionState::CONNECTED && wsConnected && gameJoined;
 }
 
+// Serialize into txFrame; returns the payload length, 0 if it does not fit
+static size_t serializeFrame(const JsonDocument& doc) {
+    size_t len = serializeJson(doc, txPayload, WS_TX_MAX);
+    if (len >= WS_TX_MAX - 1) {
+        LOG_W("[NET] %s over %u bytes, not sent", doc["type"] | "message", (unsigned)WS_TX_MAX);
+        return 0;
+    }
+    return len;
+}
+
 static void sendMessage(const char* type, JsonObject* payload) {
     StaticJsonDocument<256> doc;
     doc["type"] = type;
@@ -443,13 +579,13 @@ static void sendMessage(const char* type, JsonObject* payload) {
         doc.createNestedObject("payload");
     }
 
-    String json;
-    serializeJson(doc, json);
+    size_t len = serializeFrame(doc);
+    if (len == 0) return;
 
-    Serial.print("Sending: ");
-    Serial.println(json);
+    LOG_D("Sending: %s", txPayload);
 
-    webSocket.sendTXT(json);
+    webSocket.sendTXT(txFrame, len, true);
+    lastGameTraffic = millis();
 }
 
 void networkSendSelectUp() {
@@ -515,15 +651,304 @@ void networkSendUseItem(const char* itemId) {
     }
 }
 
-void networkSendHeartbeat(uint8_t bpm) {
+void networkSendHeartbeat(const HeartbeatReport& report) {
     if (networkIsConnected()) {
+        const HrvStats& stats = report.hrv;
         StaticJsonDocument<128> doc;
-        doc["bpm"] = bpm;
+        doc["bpm"] = stats.bpm;
+        if (report.leadsOff) doc["leadsOff"] = true;
+        doc["quality"] = report.quality;
+        if (stats.bpm > 0) {
+            doc["rmssd"] = stats.rmssd;
+            doc["sdnn"] = stats.sdnn;
+            doc["rejected"] = stats.rejected;
+        }
         JsonObject payload = doc.as<JsonObject>();
         sendMessage(ClientMsg::HEARTBEAT, &payload);
     }
 }
 
+void networkSendDetectorCalibration(bool success, const DetectorParams& params, uint8_t beats) {
+    if (networkIsConnected()) {
+        StaticJsonDocument<192> doc;
+        doc["success"] = success;
+        doc["beats"] = beats;
+        if (success) {
+            doc["thresholdPct"] = params.thresholdPct;
+            doc["minRange"] = params.minRange;
+            doc["refractoryMs"] = params.refractoryMs;
+            doc["baseline"] = params.baseline;
+            doc["range"] = params.typicalRange;
+        }
+        JsonObject payload = doc.as<JsonObject>();
+        sendMessage(ClientMsg::HEARTRATE_CALIBRATED, &payload);
+    }
+}
+
+// Messages too big for sendMessage()'s document are built whole and sent here.
+// Returns the bytes sent (0 on failure). Not echoed to Serial.
+static size_t sendDocument(const JsonDocument& doc) {
+    size_t len = serializeFrame(doc);
+    return len > 0 && webSocket.sendTXT(txFrame, len, true) ? len : 0;
+}
+
+// Loop profile since the last report: per-scope counts, times and the log2 cycle
+// histogram (bucket i = [2^i, 2^(i+1)) cycles, trimmed to the non-empty range from
+// histFrom), plus input latency percentiles per game phase as
+// [count, p50, p90, p99, max] in us.
+static void sendProfileReport() {
+    uint32_t mhz = getCpuFrequencyMhz();
+    StaticJsonDocument<4096> doc;
+    doc["type"] = ClientMsg::PROFILE_REPORT;
+    JsonObject payload = doc.createNestedObject("payload");
+    payload["mhz"] = mhz;
+    payload["slowUs"] = PROF_SLOW_LOOP_US;
+    JsonArray scopes = payload.createNestedArray("scopes");
+
+    for (int i = 0; i < PROF_SCOPES; i++) {
+        const ProfStats& s = profGetStats((ProfScope)i);
+        if (s.count == 0) continue;
+        JsonObject scope = scopes.createNestedObject();
+        scope["name"] = profScopeName((ProfScope)i);
+        scope["count"] = s.count;
+        scope["avgUs"] = (uint32_t)(s.sumCycles / s.count / mhz);
+        scope["maxUs"] = s.maxCycles / mhz;
+        scope["slow"] = s.slow;
+
+        int lo = 0, hi = PROF_BUCKETS - 1;
+        while (s.hist[lo] == 0) lo++;   // count > 0, so some bucket is set
+        while (s.hist[hi] == 0) hi--;
+        scope["histFrom"] = lo;
+        JsonArray hist = scope.createNestedArray("hist");
+        for (int b = lo; b <= hi; b++) hist.add(s.hist[b]);
+    }
+
+    JsonArray latency = payload.createNestedArray("latency");
+    for (int phase = 0; phase < LATENCY_PHASES; phase++) {
+        JsonObject entry;
+        for (int m = 0; m < LATENCY_METRICS; m++) {
+            LatencyPercentiles p = latencyGet((LatencyMetric)m, phase);
+            if (p.count == 0) continue;
+            if (entry.isNull()) {
+                entry = latency.createNestedObject();
+                entry["phase"] = gameLedStateName((GameLedState)phase);
+            }
+            JsonArray values = entry.createNestedArray(m == (int)LatencyMetric::PHOTON ? "photon" : "ack");
+            values.add(p.count);
+            values.add(p.p50Us);
+            values.add(p.p90Us);
+            values.add(p.p99Us);
+            values.add(p.maxUs);
+        }
+    }
+    payload["unanswered"] = latencyTimeouts();
+
+    size_t bytes = sendDocument(doc);
+    LOG_I("[Prof] Report sent (%u bytes)", (unsigned)bytes);
+    profResetStats();
+}
+
+static void applyTunables(JsonObject& payload) {
+    tuneRejectedCount = 0;
+    if (payload["defaults"] | false) tunablesResetDefaults();
+    for (JsonPair kv : payload["set"].as<JsonObject>()) {
+        const char* name = kv.key().c_str();
+        int i = tunableFind(name);
+        if (i >= 0 && kv.value().is<uint32_t>() && tunableSet((Tunable)i, kv.value().as<uint32_t>())) continue;
+        LOG_W("[Tune] Rejected %s", name);
+        if (tuneRejectedCount < TUNE_REJECTED_MAX) {
+            strncpy(tuneRejected[tuneRejectedCount], name, sizeof(tuneRejected[0]) - 1);
+            tuneRejected[tuneRejectedCount][sizeof(tuneRejected[0]) - 1] = '\0';
+            tuneRejectedCount++;
+        }
+    }
+    tunablesSaved = (payload["save"] | false) && tunablesSave();
+    tunablesReportDue = true;
+}
+
+// Every tunable by name: value, unit, bounds and default; whether the request's values
+// were saved to NVS, and the names it could not apply (unknown or out of bounds)
+static void sendTunablesReport() {
+    StaticJsonDocument<1536> doc;
+    doc["type"] = ClientMsg::TUNABLES_REPORT;
+    JsonObject payload = doc.createNestedObject("payload");
+    JsonObject values = payload.createNestedObject("values");
+    for (int i = 0; i < (int)Tunable::COUNT; i++) {
+        const TunableDef& d = tunableDef((Tunable)i);
+        JsonObject v = values.createNestedObject(d.name);
+        v["value"] = tunableGet((Tunable)i);
+        v["unit"] = d.unit;
+        v["min"] = d.min;
+        v["max"] = d.max;
+        v["default"] = d.def;
+    }
+    payload["saved"] = tunablesSaved;
+    JsonArray rejected = payload.createNestedArray("rejected");
+    for (int i = 0; i < tuneRejectedCount; i++) rejected.add((char*)tuneRejected[i]);
+    sendDocument(doc);
+}
+
+bool networkSendHeapReport(const HeapSummary& heap, const TaskStack* stacks, int stackCount,
+                           const HeapSite* sites, int siteCount, uint32_t sitesMissed) {
+    if (!networkIsConnected()) return false;
+
+    StaticJsonDocument<1536> doc;
+    doc["type"] = ClientMsg::HEAP_REPORT;
+    JsonObject payload = doc.createNestedObject("payload");
+    payload["uptimeS"] = millis() / 1000;
+    payload["free"] = heap.last.freeBytes;
+    payload["largest"] = heap.last.largestBlock;
+    payload["fragPct"] = heap.fragPct;
+    payload["minEverFree"] = heap.last.minEverFree;
+    payload["minLargest"] = heap.minLargest;
+    payload["maxFragPct"] = heap.maxFragPct;
+#if HEAP_ALLOC_TRAP
+    payload["allocsAfterSetup"] = allocHookTrapped();
+#endif
+
+    JsonObject stackFree = payload.createNestedObject("stackFree");
+    for (int i = 0; i < stackCount; i++) stackFree[stacks[i].name] = stacks[i].freeBytes;
+
+    if (siteCount > 0 || sitesMissed > 0) {
+        JsonArray top = payload.createNestedArray("allocSites");
+        for (int i = 0; i < siteCount; i++) {
+            JsonObject site = top.createNestedObject();
+            site["site"] = (uint32_t)sites[i].site;
+            site["count"] = sites[i].count;
+            site["bytes"] = sites[i].bytes;
+        }
+        payload["allocSitesMissed"] = sitesMissed;
+    }
+
+    return sendDocument(doc) > 0;
+}
+
+bool networkSendStallReport(const StallRecord* records, int count, const char* resetReason) {
+    if (!networkIsConnected()) return false;
+
+    StaticJsonDocument<2048> doc;
+    doc["type"] = ClientMsg::STALL_REPORT;
+    JsonObject payload = doc.createNestedObject("payload");
+    payload["boot"] = stallBoot();
+    payload["resetReason"] = resetReason;
+    payload["overwritten"] = stallOverwritten();
+    JsonArray stalls = payload.createNestedArray("stalls");
+
+    for (int i = 0; i < count; i++) {
+        const StallRecord& r = records[i];
+        JsonObject stall = stalls.createNestedObject();
+        stall["seq"] = r.seq;
+        stall["boot"] = r.boot;
+        stall["startMs"] = r.startMs;
+        stall["durationMs"] = r.durationMs;
+        if (r.flags & STALL_UNFINISHED) stall["unfinished"] = true;
+        JsonArray scopes = stall.createNestedArray("scopes");
+        JsonArray sites = stall.createNestedArray("sites");
+        for (int d = 0; d < r.depth; d++) {
+            scopes.add(profScopeName((ProfScope)r.scopes[d]));
+            sites.add(r.sites[d]);
+        }
+    }
+
+    return sendDocument(doc) > 0;
+}
+
+bool networkSendBinary(const uint8_t* data, size_t len) {
+    if (!networkIsConnected()) return false;
+    // Not echoed to Serial — telemetry frames arrive several times per second
+    if (len > WS_TX_MAX) return false;
+    memcpy(txPayload, data, len);
+    return webSocket.sendBIN(txFrame, len, true);
+}
+
+static void putU16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static void putU32(uint8_t* p, uint32_t v) {
+    putU16(p, v & 0xFFFF);
+    putU16(p + 2, v >> 16);
+}
+
+// Whole bytes the bucket would allow right now
+static uint32_t bucketAvailable(TokenBucket& bucket) {
+    unsigned long now = millis();
+    unsigned long elapsed = now - bucket.lastRefill;
+    if (elapsed > 1000) elapsed = 1000;  // Bucket is full well within 1 s; avoids overflow
+    bucket.lastRefill = now;
+    bucket.tokens += elapsed * bucket.rateBps;
+    if (bucket.tokens > bucket.depthBytes * 1000UL) bucket.tokens = bucket.depthBytes * 1000UL;
+    return bucket.tokens / 1000;
+}
+
+static bool bucketTake(TokenBucket& bucket, size_t len) {
+    if (bucketAvailable(bucket) < len) return false;
+    bucket.tokens -= len * 1000UL;
+    return true;
+}
+
+bool networkSendStream(const uint8_t* data, size_t len) {
+    if (!networkIsConnected()) return false;
+
+    if (!bucketTake(streamBucket, len)) {
+        if ((++streamDropped % 50) == 1) {
+            LOG_W("[NET] Stream over budget, %u frames dropped", (unsigned)streamDropped);
+        }
+        return false;
+    }
+    return networkSendBinary(data, len);
+}
+
+static bool diagMayDefer() {
+    return !networkIsConnected() || millis() - lastGameTraffic < DIAG_QUIET_MS;
+}
+
+void networkDiagFlush() {
+    if (diagLevel() == 0 || diagMayDefer()) return;
+
+    // Only whole lines that fit the budget leave the ring; the rest wait for the next flush
+    uint32_t room = bucketAvailable(diagBucket);
+    if (room > DIAG_FRAME_MAX) room = DIAG_FRAME_MAX;
+    if (room <= (uint32_t)(BinFrame::DIAG_LOG_HEADER + DIAG_LINE_HEADER)) return;
+    uint8_t* out = (uint8_t*)txPayload;
+    int n = diagPackLines(out + BinFrame::DIAG_LOG_HEADER, room - BinFrame::DIAG_LOG_HEADER);
+    uint32_t dropped = diagTakeDropped();
+    if (n == 0 && dropped == 0) return;
+
+    out[0] = BinFrame::DIAG_LOG;
+    putU16(out + 1, diagSeq++);
+    putU16(out + 3, dropped > 0xFFFF ? 0xFFFF : dropped);
+
+    size_t len = BinFrame::DIAG_LOG_HEADER + n;
+    bucketTake(diagBucket, len);
+    webSocket.sendBIN(txFrame, len, true);
+}
+
+bool networkDiagMetricsEnabled() {
+    return diagMetricsOn;
+}
+
+bool networkSendDiagMetrics(uint32_t* values) {
+    if (!diagMetricsOn || diagMayDefer()) return false;
+
+    values[(int)DiagMetric::WIFI_RSSI] = (uint32_t)(int32_t)WiFi.RSSI();
+    values[(int)DiagMetric::STREAM_DROPPED] = streamDropped;
+    values[(int)DiagMetric::DIAG_DROPPED] = diagDroppedTotal();
+
+    uint8_t frame[BinFrame::DIAG_METRICS_HEADER + DIAG_METRICS * 5];
+    frame[0] = BinFrame::DIAG_METRICS;
+    putU32(frame + 1, millis());
+    frame[5] = DIAG_METRICS;
+    for (int i = 0; i < DIAG_METRICS; i++) {
+        uint8_t* p = frame + BinFrame::DIAG_METRICS_HEADER + i * 5;
+        p[0] = (uint8_t)i;
+        putU32(p + 1, values[i]);
+    }
+    if (!bucketTake(diagBucket, sizeof(frame))) return false;
+    return networkSendBinary(frame, sizeof(frame));
+}
+
 const char* networkGetLastError() {
     return lastError;
 }
@@ -541,6 +966,7 @@ bool networkOtaRequested() {
 }
 
 void networkExecuteOta() {
+    PROF_SCOPE(ProfScope::NETWORK);   // Blocking download: shows up in stall records
     otaRequested = false;
     checkFirmwareUpdate(serverHost, serverPort);
 }
@@ -548,20 +974,22 @@ void networkExecuteOta() {
 static void onWebSocketEvent(WStype_t type, uint8_t* payload, size_t length) {
     switch (type) {
         case WStype_DISCONNECTED:
-            Serial.println("WebSocket disconnected");
+            LOG_I("WebSocket disconnected");
             wsConnected = false;
             gameJoined = false;
             break;
 
         case WStype_CONNECTED:
-            Serial.print("WebSocket connected to: ");
-            Serial.println((char*)payload);
+            LOG_I("WebSocket connected to: %s", (const char*)payload);
             wsConnected = true;
+            commitPending = false;
+            ledAnimClear();  // The server resends its animations after JOIN
             break;
 
         case WStype_TEXT: {
-            Serial.print("Received: ");
-            Serial.println((char*)payload);
+            messageArrivedUs = micros();
+            lastGameTraffic = millis();
+            LOG_D("Received: %s", (const char*)payload);
 
             // Parse JSON message — 6144 bytes to accommodate optional vocabulary array
             // (~142 words × ~16 bytes each) on the initial OPERATOR_STATE message.
@@ -569,8 +997,7 @@ static void onWebSocketEvent(WStype_t type, uint8_t* payload, size_t length) {
             DeserializationError error = deserializeJson(doc, payload, length);
 
             if (error) {
-                Serial.print("JSON parse error: ");
-                Serial.println(error.c_str());
+                LOG_W("JSON parse error: %s", error.c_str());
                 return;
             }
 
@@ -579,21 +1006,20 @@ static void onWebSocketEvent(WStype_t type, uint8_t* payload, size_t length) {
 
             // Validate message type exists
             if (msgType == nullptr) {
-                Serial.println("Message missing type field");
+                LOG_W("Message missing type field");
                 return;
             }
 
             // Handle message types
             if (strcmp(msgType, ServerMsg::WELCOME) == 0) {
-                Serial.println("Received welcome - joined game");
+                LOG_I("Received welcome - joined game");
                 gameJoined = true;
             }
             else if (strcmp(msgType, ServerMsg::ERROR) == 0) {
                 const char* errorMsg = msgPayload["message"] | "Unknown error";
                 strncpy(lastError, errorMsg, sizeof(lastError) - 1);
                 lastError[sizeof(lastError) - 1] = '\0';  // Ensure null termination
-                Serial.print("Server error: ");
-                Serial.println(errorMsg);
+                LOG_W("Server error: %s", errorMsg);
                 if (connState == ConnectionState::JOINING) {
                     connState = ConnectionState::ERROR;
                 }
@@ -606,18 +1032,52 @@ static void onWebSocketEvent(WStype_t type, uint8_t* payload, size_t length) {
             }
             else if (strcmp(msgType, ServerMsg::HEARTRATE_MONITOR) == 0) {
                 bool enabled = msgPayload["enabled"] | false;
+                bool waveform = msgPayload["waveform"] | false;
                 if (enabled) {
                     heartrateEnable();
                 } else {
                     heartrateDisable();
                 }
+                heartrateSetWaveformStreaming(enabled && waveform);
+                heartrateSetReportMode(parseHrReportMode(msgPayload["report"] | "bpm"));
+            }
+            else if (strcmp(msgType, ServerMsg::HEARTRATE_CALIBRATE) == 0) {
+                heartrateStartCalibration(msgPayload["durationMs"] | 0UL);
+            }
+            else if (strcmp(msgType, ServerMsg::LED_ANIMATION) == 0) {
+                parseLedAnimation(msgPayload);
+            }
+            else if (strcmp(msgType, ServerMsg::LED_PLAY) == 0) {
+                const char* id = msgPayload["id"] | "";
+                if (id[0]) {
+                    ledsPlayAnimation(id);
+                } else {
+                    ledsStopAnimation();
+                }
+            }
+            else if (strcmp(msgType, ServerMsg::TIME_SYNC) == 0) {
+                uint32_t sent = msgPayload["t"] | 0UL;
+                uint64_t serverTime = msgPayload["serverTime"].as<uint64_t>();
+                if (serverTime > 0) timesyncAddSample(sent, millis(), serverTime);
+            }
+            else if (strcmp(msgType, ServerMsg::PROFILE_REQUEST) == 0) {
+                profileRequested = true;
+            }
+            else if (strcmp(msgType, ServerMsg::DIAG_CONFIG) == 0) {
+                uint8_t level = msgPayload["logLevel"] | 0;
+                diagSetLevel(level);
+                diagMetricsOn = msgPayload["metrics"] | false;
+                LOG_I("[Diag] Remote log level %u, metrics %s", level, diagMetricsOn ? "on" : "off");
+            }
+            else if (strcmp(msgType, ServerMsg::TUNABLES) == 0) {
+                applyTunables(msgPayload);
             }
             else if (strcmp(msgType, ServerMsg::UPDATE_FIRMWARE) == 0) {
-                Serial.println("[OTA] Server requested firmware update");
+                LOG_I("[OTA] Server requested firmware update");
                 otaRequested = true;
             }
             else if (strcmp(msgType, ServerMsg::KICKED) == 0) {
-                Serial.println("Kicked by server — returning to player select");
+                LOG_I("Kicked by server — returning to player select");
                 wasKicked = true;
             }
             else if (strcmp(msgType, ServerMsg::GAME_STATE) == 0) {
@@ -630,11 +1090,11 @@ static void onWebSocketEvent(WStype_t type, uint8_t* payload, size_t length) {
         }
 
         case WStype_BIN:
-            Serial.println("Received binary data (unexpected)");
+            LOG_W("Received binary data (unexpected)");
             break;
 
         case WStype_ERROR:
-            Serial.println("WebSocket error");
+            LOG_E("WebSocket error");
             break;
 
         case WStype_PING:
@@ -647,10 +1107,37 @@ static void onWebSocketEvent(WStype_t type, uint8_t* payload, size_t length) {
     }
 }
 
+// { id, targets: ["neopixel", "yes", "no"], loops, stops: [[ms, r, g, b, level, ease], ...] }
+static void parseLedAnimation(JsonObject& payload) {
+    LedAnimation anim = {};
+    strncpy(anim.id, payload["id"] | "", sizeof(anim.id) - 1);
+    anim.loops = payload["loops"] | 1;
+    for (JsonVariant target : payload["targets"].as<JsonArray>()) {
+        const char* name = target | "";
+        if (strcmp(name, "neopixel") == 0) anim.targets |= LED_ANIM_NEOPIXEL;
+        else if (strcmp(name, "yes") == 0) anim.targets |= LED_ANIM_YES;
+        else if (strcmp(name, "no") == 0) anim.targets |= LED_ANIM_NO;
+    }
+    for (JsonArray stop : payload["stops"].as<JsonArray>()) {
+        if (anim.count >= LED_ANIM_MAX_STOPS) break;
+        LedKeyframe& k = anim.stops[anim.count++];
+        k.ms = stop[0] | 0;
+        k.r = stop[1] | 0;
+        k.g = stop[2] | 0;
+        k.b = stop[3] | 0;
+        k.level = stop[4] | 0;
+        uint8_t ease = stop[5] | 0;
+        k.ease = ease <= (uint8_t)LedEase::STEP ? (LedEase)ease : LedEase::LINEAR;
+    }
+    if (anim.id[0] == '\0' || anim.count == 0) return;
+    ledAnimStore(anim);
+    LOG_I("[LED] Cached animation '%s' (%u stops)", anim.id, anim.count);
+}
+
 static void parsePlayerState(JsonObject& payload) {
     // Check if display object exists
     if (!payload.containsKey("display")) {
-        Serial.println("No display in player state");
+        LOG_I("No display in player state");
         return;
     }
 
@@ -677,6 +1164,7 @@ static void parsePlayerState(JsonObject& payload) {
     JsonObject leds = display["leds"];
     currentDisplayState.leds.yes = parseLedState(leds["yes"] | "off");
     currentDisplayState.leds.no = parseLedState(leds["no"] | "off");
+    currentDisplayState.leds.power = parseLedState(leds["power"] | "dim");
 
     // Parse status LED (neopixel game state)
     currentDisplayState.statusLed = parseGameLedState(display["statusLed"] | "");
@@ -704,14 +1192,28 @@ static void parsePlayerState(JsonObject& payload) {
         JsonArray namesArr = display["targetNames"];
         JsonArray idsArr   = display["targetIds"];
         for (int i = 0; i < DisplayState::MAX_TARGETS && i < (int)namesArr.size(); i++) {
-            currentDisplayState.targetNames[i] = namesArr[i].as<String>();
+            currentDisplayState.targetNames[i] = namesArr[i] | "";
             if (!idsArr.isNull() && i < (int)idsArr.size()) {
-                currentDisplayState.targetIds[i] = idsArr[i].as<String>();
+                currentDisplayState.targetIds[i] = idsArr[i] | "";
             }
             currentDisplayState.targetCount++;
         }
     }
 
+    // Scheduled commit: hold until the server time in "at" (see networkUpdate)
+    uint64_t at = payload["at"] | (uint64_t)0;
+    if (at > 0 && timesyncIsSynced()) {
+        uint32_t local = timesyncToLocal(at);
+        int32_t wait = (int32_t)(local - millis());
+        if (wait > 0 && wait <= SCHEDULE_MAX_AHEAD_MS) {
+            commitPending = true;
+            commitAt = local;
+            return;
+        }
+    }
+    commitPending = false;
+    stateArrivedUs = messageArrivedUs;
+
     // Notify callback
     if (displayCallback != nullptr) {
         displayCallback(currentDisplayState);
@@ -728,22 +1230,22 @@ static void parseOperatorState(JsonObject& payload) {
         operatorVocabSize = 0;
         for (JsonVariant w : vocab) {
             if (operatorVocabSize >= MAX_OP_WORDS) break;
-            operatorVocab[operatorVocabSize++] = w.as<String>();
+            strncpy(operatorVocab[operatorVocabSize++], w | "", OP_WORD_LEN - 1);
         }
-        Serial.printf("[OP] Vocabulary loaded: %d words\n", operatorVocabSize);
+        LOG_I("[OP] Vocabulary loaded: %d words", operatorVocabSize);
     }
 
     // Update built message from server state
     operatorBuiltMsg  = "";
-    operatorLastWord  = "";
+    operatorLastWord[0] = '\0';
     operatorWordCount = 0;
     JsonArray words = payload["words"];
     if (!words.isNull()) {
         for (JsonVariant word : words) {
             if (operatorWordCount > 0) operatorBuiltMsg += " ";
-            String w = word.as<String>();
+            const char* w = word | "";
             operatorBuiltMsg += w;
-            operatorLastWord  = w;   // keep overwriting to capture last
+            strncpy(operatorLastWord, w, OP_WORD_LEN - 1);   // keep overwriting to capture last
             operatorWordCount++;
         }
     }
@@ -777,7 +1279,7 @@ void networkOperatorScrollUp() {
 
 void networkSendOperatorAdd() {
     if (networkIsConnected() && operatorVocabSize > 0) {
-        const char* word = operatorVocab[operatorFlatIdx].c_str();
+        const char* word = operatorVocab[operatorFlatIdx];
         StaticJsonDocument<64> doc;
         doc["word"] = word;
         JsonObject payload = doc.as<JsonObject>();
@@ -809,7 +1311,7 @@ void networkSendOperatorDelete() {
     // Jump dial to the position of the last committed word before deleting
     if (operatorWordCount > 0) {
         for (int i = 0; i < operatorVocabSize; i++) {
-            if (operatorLastWord == operatorVocab[i]) {
+            if (strcmp(operatorLastWord, operatorVocab[i]) == 0) {
                 operatorFlatIdx = i;
                 break;
             }
@@ -4,6 +4,9 @@
 
 #include <Arduino.h>
 #include "protocol.h"
+#include "heartrate.h"
+#include "stall.h"
+#include "heapmon.h"
 
 // Callback type for receiving display state updates
 typedef void (*DisplayStateCallback)(const DisplayState& state);
@@ -27,6 +30,10 @@ void networkInit();
 // Set the callback for display state updates
 void networkSetDisplayCallback(DisplayStateCallback callback);
 
+// micros() when the state last passed to the display callback arrived over the
+// WebSocket (or, for a scheduled PLAYER_STATE, when its commit time came)
+uint32_t networkStateArrivedUs();
+
 // Update network (call in main loop)
 // Returns the current connection state
 ConnectionState networkUpdate();
@@ -37,6 +44,16 @@ bool networkIsConnected();
 // Retry joining after an error
 void networkRetryJoin();
 
+// Drop the WebSocket and connect again (serial console). `rediscover` also forgets the
+// server address, so a UDP discovery runs first.
+void networkReconnect(bool rediscover);
+
+// Connection details for the serial console (LOG_OUT)
+void networkLogStatus();
+
+// Re-read the WS_PING_MS tunable (0 turns the WebSocket ping off)
+void networkApplyWsPing();
+
 // Send messages to server
 void networkSendSelectUp();
 void networkSendSelectDown();
@@ -47,7 +64,31 @@ void networkSendAbstain();
 void networkSendUseItem(const char* itemId);
 void networkSendIdleScrollUp();
 void networkSendIdleScrollDown();
-void networkSendHeartbeat(uint8_t bpm);
+void networkSendHeartbeat(const HeartbeatReport& report);
+
+// Result of a detector calibration run (heartrateSetCalibrationCallback target)
+void networkSendDetectorCalibration(bool success, const DetectorParams& params, uint8_t beats);
+
+// Binary uplink (telemetry frames, see BinFrame in protocol.h). Returns false if not sent.
+// Push heap health (see heapmon.h): summary since boot, task stack headroom and the
+// busiest allocation sites since the last report
+bool networkSendHeapReport(const HeapSummary& heap, const TaskStack* stacks, int stackCount,
+                           const HeapSite* sites, int siteCount, uint32_t sitesMissed);
+
+// Upload loop-stall records (see stall.h); false if not connected or the send failed
+bool networkSendStallReport(const StallRecord* records, int count, const char* resetReason);
+
+bool networkSendBinary(const uint8_t* data, size_t len);
+
+// Low-priority binary uplink — same as networkSendBinary but capped at STREAM_BUDGET_BPS
+bool networkSendStream(const uint8_t* data, size_t len);
+
+// Remote diagnostics, when the host turned them on (DIAG_CONFIG): send queued log lines
+// (see diag.h) / a metrics frame, within DIAG_BUDGET_BPS and only while game traffic is
+// quiet. `values` is indexed by DiagMetric; the network counters are filled in here.
+void networkDiagFlush();
+bool networkDiagMetricsEnabled();
+bool networkSendDiagMetrics(uint32_t* values);
 
 // Operator terminal messages
 void networkOperatorTick();       // Call each loop; clears SENT! screen after 2s
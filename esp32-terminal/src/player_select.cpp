@@ -4,6 +4,8 @@
 #include "input.h"
 #include "leds.h"
 #include "network.h"
+#include "heartrate.h"
+#include "logbuf.h"
 
 static uint8_t selectedPlayer = 1;  // 1-9 or 0 for OPERATOR
 static bool confirmed = false;
@@ -37,8 +39,8 @@ bool psHandleInput() {
             else if (selectedPlayer == 0) selectedPlayer = 9;
             else selectedPlayer--;
             dirty = true;
-            if (selectedPlayer == 0) Serial.println("Selected: OPERATOR");
-            else { Serial.print("Selected player: "); Serial.println(selectedPlayer); }
+            if (selectedPlayer == 0) LOG_I("Selected: OPERATOR");
+            else LOG_I("Selected player: %u", selectedPlayer);
             break;
 
         case InputEvent::DOWN:
@@ -46,21 +48,22 @@ bool psHandleInput() {
             else if (selectedPlayer == 0) selectedPlayer = 1;
             else selectedPlayer++;
             dirty = true;
-            if (selectedPlayer == 0) Serial.println("Selected: OPERATOR");
-            else { Serial.print("Selected player: "); Serial.println(selectedPlayer); }
+            if (selectedPlayer == 0) LOG_I("Selected: OPERATOR");
+            else LOG_I("Selected player: %u", selectedPlayer);
             break;
 
         case InputEvent::YES:
             confirmed = true;
             ledsSetYes(LedState::OFF);
-            Serial.println("Initializing network...");
+            LOG_I("Initializing network...");
             if (selectedPlayer == 0) {
-                Serial.println("Confirmed: OPERATOR");
+                LOG_I("Confirmed: OPERATOR");
                 networkSetOperatorMode();
+                heartrateSetPlayerSlot(0);
             } else {
-                Serial.print("Confirmed player: ");
-                Serial.println(selectedPlayer);
+                LOG_I("Confirmed player: %u", selectedPlayer);
                 networkSetPlayerId(selectedPlayer);
+                heartrateSetPlayerSlot(selectedPlayer);
             }
             networkInit();
             break;
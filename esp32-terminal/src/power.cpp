@@ -0,0 +1,193 @@
+// Power Manager Implementation
+//
+// Each PowerLevel is a clock range, a WiFi power-save mode and whether automatic light
+// sleep is allowed. With CONFIG_PM_ENABLE the range goes to esp_pm_configure() and the
+// IDF scales the clock itself (DFS), dropping to min_freq whenever no task holds a lock;
+// otherwise the level's max clock is set directly. Automatic light sleep also needs
+// FreeRTOS tickless idle — the stock Arduino-ESP32 build has neither, so there the IDLE
+// level is 80 MHz + modem sleep. The minimum stays at 80 MHz: the LEDC and RMT (button
+// LEDs, neopixel) run from APB, which would drop below 80 MHz with the CPU.
+//
+// Modem sleep wakes the radio at each AP DTIM beacon, so IDLE adds up to one beacon
+// interval (~100-300 ms) to server messages; PERFORMANCE turns it off.
+
+#include "power.h"
+#include "config.h"
+#include "logbuf.h"
+#include <WiFi.h>
+
+#if CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+#endif
+
+#if CONFIG_PM_ENABLE && CONFIG_FREERTOS_USE_TICKLESS_IDLE
+#define POWER_LIGHT_SLEEP 1
+#else
+#define POWER_LIGHT_SLEEP 0
+#endif
+
+struct PowerProfile {
+    const char* name;
+    uint16_t maxMhz;
+    uint16_t minMhz;
+    bool modemSleep;
+    bool lightSleep;
+};
+
+static const PowerProfile profiles[] = {
+    { "PERF", 240, 240, false, false },
+    { "BAL",  240, 80,  true,  false },
+    { "IDLE", 80,  80,  true,  true  },
+};
+
+static PowerLevel level = PowerLevel::PERFORMANCE;
+static bool pmActive = false;          // esp_pm_configure() accepted a config
+
+// Time per level since boot, and how much of it the loop slept
+static uint64_t levelUs[3] = {};
+static uint64_t levelSleepUs[3] = {};
+static uint32_t levelSince = 0;
+static unsigned long lastLog = 0;
+
+#if POWER_LIGHT_SLEEP
+// Light sleep gates the GPIO edge interrupts (input.cpp) — buttons wake by level instead.
+// The encoder rests at either level, so its pins wake on the opposite of where they are.
+static const gpio_num_t BUTTON_PINS[] = {
+    (gpio_num_t)PIN_BTN_YES, (gpio_num_t)PIN_BTN_NO, (gpio_num_t)PIN_ENCODER_SW
+};
+static const gpio_num_t ENCODER_PINS[] = { (gpio_num_t)PIN_ENCODER_A, (gpio_num_t)PIN_ENCODER_B };
+
+static void armEncoderWake() {
+    for (gpio_num_t pin : ENCODER_PINS) {
+        gpio_wakeup_enable(pin, gpio_get_level(pin) ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+    }
+}
+
+static void setWakeSources(bool sleeping) {
+    for (gpio_num_t pin : BUTTON_PINS) {
+        if (sleeping) {
+            gpio_intr_disable(pin);
+            gpio_wakeup_enable(pin, GPIO_INTR_LOW_LEVEL);
+        } else {
+            gpio_wakeup_disable(pin);
+            gpio_set_intr_type(pin, GPIO_INTR_ANYEDGE);
+            gpio_intr_enable(pin);
+        }
+    }
+    for (gpio_num_t pin : ENCODER_PINS) {
+        if (sleeping) {
+            gpio_intr_disable(pin);
+        } else {
+            gpio_wakeup_disable(pin);
+            gpio_set_intr_type(pin, GPIO_INTR_ANYEDGE);
+            gpio_intr_enable(pin);
+        }
+    }
+    if (sleeping) armEncoderWake();
+}
+#endif
+
+static void applyLevel(PowerLevel next) {
+    const PowerProfile& p = profiles[(int)next];
+
+#if CONFIG_PM_ENABLE
+    esp_pm_config_esp32s3_t cfg = {};
+    cfg.max_freq_mhz = p.maxMhz;
+    cfg.min_freq_mhz = p.minMhz;
+    cfg.light_sleep_enable = POWER_LIGHT_SLEEP && p.lightSleep;
+    esp_err_t err = esp_pm_configure(&cfg);
+    pmActive = err == ESP_OK;
+    if (!pmActive) {
+        LOG_E("[Power] esp_pm_configure failed (%s), fixed clock", esp_err_to_name(err));
+    }
+#endif
+    if (!pmActive) setCpuFrequencyMhz(p.maxMhz);
+
+    WiFi.setSleep(p.modemSleep);
+
+#if POWER_LIGHT_SLEEP
+    if (pmActive) setWakeSources(p.lightSleep);
+#endif
+}
+
+void powerInit() {
+    levelSince = micros();
+    applyLevel(PowerLevel::PERFORMANCE);
+    LOG_I("[Power] %s, light sleep %s",
+          pmActive ? "DFS" : "fixed clock",
+          POWER_LIGHT_SLEEP && pmActive ? "available" : "not built in");
+}
+
+static void logStats(uint32_t now) {
+    uint64_t total = 0;
+    for (uint64_t us : levelUs) total += us;
+    total += now - levelSince;
+    if (total == 0) return;
+
+    char line[128];
+    int len = 0;
+    for (int i = 0; i < 3; i++) {
+        uint64_t us = levelUs[i] + ((int)level == i ? now - levelSince : 0);
+        uint32_t sleepPct = us ? (uint32_t)(levelSleepUs[i] * 100 / us) : 0;
+        len += snprintf(line + len, sizeof(line) - len, " %s %lu%% (slept %lu%%)",
+                        profiles[i].name, (unsigned long)(us * 100 / total), (unsigned long)sleepPct);
+    }
+    LOG_I("[Power]%s, %lu MHz, %.1f C", line,
+          (unsigned long)getCpuFrequencyMhz(), temperatureRead());
+}
+
+void powerUpdate(ConnectionState conn, GameLedState game, bool interactive) {
+    PowerLevel next;
+    if (interactive) {
+        next = PowerLevel::PERFORMANCE;
+    } else if (conn != ConnectionState::CONNECTED) {
+        next = PowerLevel::BALANCED;
+    } else {
+        switch (game) {
+            case GameLedState::VOTING:
+            case GameLedState::LOCKED:
+            case GameLedState::ABSTAINED:
+                next = PowerLevel::PERFORMANCE;
+                break;
+            case GameLedState::LOBBY:
+            case GameLedState::DEAD:
+            case GameLedState::GAME_OVER:
+                next = PowerLevel::IDLE;
+                break;
+            default:
+                next = PowerLevel::BALANCED;
+                break;
+        }
+    }
+
+    uint32_t now = micros();
+    if (next != level) {
+        levelUs[(int)level] += now - levelSince;
+        levelSince = now;
+        level = next;
+        applyLevel(next);
+        LOG_I("[Power] -> %s", profiles[(int)next].name);
+    }
+#if POWER_LIGHT_SLEEP
+    else if (pmActive && profiles[(int)level].lightSleep) {
+        armEncoderWake();   // Follow the encoder so the next detent wakes it
+    }
+#endif
+
+#if POWER_PROFILE
+    if (millis() - lastLog >= POWER_LOG_MS) {
+        lastLog = millis();
+        logStats(now);
+    }
+#endif
+}
+
+PowerLevel powerGetLevel() {
+    return level;
+}
+
+void powerAddSleep(uint32_t us) {
+    levelSleepUs[(int)level] += us;
+}
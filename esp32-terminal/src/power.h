@@ -0,0 +1,26 @@
+// Power Manager — CPU clock, WiFi modem sleep and light sleep by game phase
+#ifndef POWER_H
+#define POWER_H
+
+#include <Arduino.h>
+#include "protocol.h"
+
+enum class PowerLevel : uint8_t {
+    PERFORMANCE,    // Voting / target selection / player select: full clock, radio awake
+    BALANCED,       // Day, night, connecting: full clock on demand, radio awake
+    IDLE            // Lobby, dead, game over: low clock, modem sleep, light sleep if built in
+};
+
+// Probe what the build supports (DFS, automatic light sleep) and start at PERFORMANCE
+void powerInit();
+
+// Pick the level for the current state; applied only when it changes, so call freely.
+// interactive = the player is driving the terminal (target selection, player select).
+void powerUpdate(ConnectionState conn, GameLedState game, bool interactive);
+
+PowerLevel powerGetLevel();
+
+// Time the loop spent asleep waiting for the next scheduler deadline
+void powerAddSleep(uint32_t us);
+
+#endif // POWER_H
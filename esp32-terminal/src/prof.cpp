@@ -0,0 +1,143 @@
+// Loop profiler
+//
+// Cycle counts are 32-bit and compared by difference, so a scope survives the counter
+// wrapping (every ~18 s at 240 MHz) but not a single scope longer than that. Under DFS
+// (power.cpp) the CPU clock moves, so cycles rather than microseconds are recorded and
+// converted with the clock at report time.
+
+#include "prof.h"
+
+struct ProfFrame {
+    ProfScope scope;
+    uint32_t start;
+    uint32_t childCycles;   // Time spent in nested scopes
+    uintptr_t site;         // Return address of profEnter(), inside the instrumented function
+};
+
+static ProfClock clockFn = nullptr;
+static ProfStats stats[PROF_SCOPES];
+static ProfFrame stack[PROF_MAX_DEPTH];
+static int depth = 0;
+static int dropped = 0;               // Enters past PROF_MAX_DEPTH, matched by exits
+
+static uint32_t loopStart = 0;
+static bool inLoop = false;
+static uint32_t iterSelf[PROF_SCOPES]; // Self cycles per scope in the current iteration
+static uint32_t slowThreshold = 0;
+
+static int bucketOf(uint32_t cycles) {
+    int b = 0;
+    while (cycles > 1) {
+        cycles >>= 1;
+        b++;
+    }
+    return b;
+}
+
+static void record(ProfScope scope, uint32_t cycles) {
+    ProfStats& s = stats[(int)scope];
+    s.count++;
+    s.sumCycles += cycles;
+    if (cycles > s.maxCycles) s.maxCycles = cycles;
+    s.hist[bucketOf(cycles)]++;
+}
+
+void profInit(ProfClock clock) {
+    clockFn = clock;
+    depth = 0;
+    dropped = 0;
+    inLoop = false;
+    profResetStats();
+}
+
+void profSetSlowThreshold(uint32_t cycles) {
+    slowThreshold = cycles;
+}
+
+void profEnter(ProfScope scope) {
+    if (clockFn == nullptr) return;
+    if (depth >= PROF_MAX_DEPTH) {
+        dropped++;
+        return;
+    }
+    stack[depth++] = { scope, clockFn(), 0, (uintptr_t)__builtin_return_address(0) };
+}
+
+void profExit() {
+    if (clockFn == nullptr) return;
+    if (dropped > 0) {
+        dropped--;
+        return;
+    }
+    if (depth == 0) return;
+
+    const ProfFrame& f = stack[--depth];
+    uint32_t total = clockFn() - f.start;
+    record(f.scope, total);
+    if (inLoop) iterSelf[(int)f.scope] += total - f.childCycles;
+    if (depth > 0) stack[depth - 1].childCycles += total;
+}
+
+void profLoopBegin() {
+    if (clockFn == nullptr) return;
+    for (uint32_t& c : iterSelf) c = 0;
+    loopStart = clockFn();
+    inLoop = true;
+}
+
+bool profLoopEnd(ProfSlowLoop* slow) {
+    if (clockFn == nullptr || !inLoop) return false;
+    inLoop = false;
+
+    uint32_t total = clockFn() - loopStart;
+    uint32_t scoped = 0;
+    for (int i = 0; i < (int)ProfScope::OTHER; i++) scoped += iterSelf[i];
+    iterSelf[(int)ProfScope::OTHER] = total > scoped ? total - scoped : 0;
+    record(ProfScope::OTHER, iterSelf[(int)ProfScope::OTHER]);
+    record(ProfScope::LOOP, total);
+
+    if (slowThreshold == 0 || total <= slowThreshold) return false;
+
+    int culprit = 0;
+    for (int i = 1; i <= (int)ProfScope::OTHER; i++) {
+        if (iterSelf[i] > iterSelf[culprit]) culprit = i;
+    }
+    stats[culprit].slow++;
+    stats[(int)ProfScope::LOOP].slow++;
+    if (slow != nullptr) {
+        slow->cycles = total;
+        slow->culprit = (ProfScope)culprit;
+        slow->culpritCycles = iterSelf[culprit];
+    }
+    return true;
+}
+
+int profActiveScopes(ProfScope* scopes, uintptr_t* sites, int max) {
+    int n = 0;
+    for (int i = depth - 1; i >= 0 && n < max; i--, n++) {
+        scopes[n] = stack[i].scope;
+        sites[n] = stack[i].site;
+    }
+    return n;
+}
+
+const ProfStats& profGetStats(ProfScope scope) {
+    return stats[(int)scope < PROF_SCOPES ? (int)scope : (int)ProfScope::LOOP];
+}
+
+const char* profScopeName(ProfScope scope) {
+    switch (scope) {
+        case ProfScope::LEDS:      return "leds";
+        case ProfScope::HEARTRATE: return "heartrate";
+        case ProfScope::NETWORK:   return "network";
+        case ProfScope::INPUTS:     return "input";
+        case ProfScope::DISPLAY:   return "display";
+        case ProfScope::OTHER:     return "other";
+        case ProfScope::LOOP:      return "loop";
+        default:                   return "";
+    }
+}
+
+void profResetStats() {
+    for (ProfStats& s : stats) s = {};
+}
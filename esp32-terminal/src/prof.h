@@ -0,0 +1,83 @@
+// Loop profiler — CPU-cycle scopes with log2 histograms per subsystem, and attribution
+// of slow loop iterations to the subsystem that used most of them.
+// The cycle counter is injected (profInit), so test_prof drives it with a fake clock.
+#ifndef PROF_H
+#define PROF_H
+
+#include <stdint.h>
+#include "config.h"
+
+enum class ProfScope : uint8_t {
+    LEDS,
+    HEARTRATE,
+    NETWORK,
+    INPUTS,     // (INPUT is an Arduino pin-mode macro)
+    DISPLAY,
+    OTHER,      // Loop time outside every scope (scheduler, game logic)
+    LOOP,       // Whole loop iteration
+    COUNT
+};
+
+static const int PROF_SCOPES = (int)ProfScope::COUNT;
+static const int PROF_BUCKETS = 32;    // Bucket b counts durations of [2^b, 2^(b+1)) cycles
+
+typedef uint32_t (*ProfClock)();       // Free-running CPU cycles, wraps at 2^32
+
+struct ProfStats {
+    uint32_t count;
+    uint64_t sumCycles;
+    uint32_t maxCycles;
+    uint32_t slow;        // Slow loops this scope was blamed for
+    uint32_t hist[PROF_BUCKETS];
+};
+
+// Result of a loop iteration over the slow threshold
+struct ProfSlowLoop {
+    uint32_t cycles;
+    ProfScope culprit;        // Scope with the most (self) cycles in that iteration
+    uint32_t culpritCycles;
+};
+
+// Reset all statistics and use `clock` from now on
+void profInit(ProfClock clock);
+
+// Loop iterations longer than this are attributed (0 = never)
+void profSetSlowThreshold(uint32_t cycles);
+
+// Scopes nest; a scope's histogram gets its full time, its blame only its own (self) time
+void profEnter(ProfScope scope);
+void profExit();
+
+// Bracket one loop iteration. profLoopEnd() returns true (and fills `slow`) when the
+// iteration went over the threshold.
+void profLoopBegin();
+bool profLoopEnd(ProfSlowLoop* slow);
+
+// Scopes open right now, innermost first, each with the code address it was entered
+// from (resolve with addr2line). Read by the stall watchdog from another task: the
+// stack only changes while the loop runs, so it is stable during a stall.
+int profActiveScopes(ProfScope* scopes, uintptr_t* sites, int max);
+
+const ProfStats& profGetStats(ProfScope scope);
+const char* profScopeName(ProfScope scope);
+void profResetStats();
+
+// Lowest cycle count that falls in `bucket`
+static inline uint32_t profBucketFloor(int bucket) {
+    return bucket == 0 ? 0 : 1UL << bucket;
+}
+
+// Instrumentation macros — compile to nothing unless PROFILE_ENABLE
+#if PROFILE_ENABLE
+struct ProfGuard {
+    explicit ProfGuard(ProfScope scope) { profEnter(scope); }
+    ~ProfGuard() { profExit(); }
+};
+#define PROF_CONCAT_(a, b) a##b
+#define PROF_CONCAT(a, b) PROF_CONCAT_(a, b)
+#define PROF_SCOPE(scope) ProfGuard PROF_CONCAT(profGuard_, __LINE__)(scope)
+#else
+#define PROF_SCOPE(scope) do {} while (0)
+#endif
+
+#endif // PROF_H
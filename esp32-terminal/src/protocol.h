@@ -22,6 +22,13 @@ namespace ServerMsg {
     const char* const HEARTRATE_MONITOR = "heartrateMonitor";
     const char* const UPDATE_FIRMWARE = "updateFirmware";
     const char* const KICKED = "kicked";
+    const char* const TIME_SYNC = "timeSync";
+    const char* const HEARTRATE_CALIBRATE = "heartrateCalibrate";
+    const char* const LED_ANIMATION = "ledAnimation";
+    const char* const LED_PLAY = "ledPlay";
+    const char* const PROFILE_REQUEST = "profileRequest";
+    const char* const DIAG_CONFIG = "diagConfig";
+    const char* const TUNABLES = "tunables";
 }
 
 // ============================================================================
@@ -46,6 +53,65 @@ namespace ClientMsg {
     const char* const OPERATOR_READY = "operatorReady";
     const char* const OPERATOR_UNREADY = "operatorUnready";
     const char* const OPERATOR_CLEAR   = "operatorClear";
+    const char* const TIME_SYNC = "timeSync";
+    const char* const HEARTRATE_CALIBRATED = "heartrateCalibrated";
+    const char* const PROFILE_REPORT = "profileReport";
+    const char* const STALL_REPORT = "stallReport";
+    const char* const HEAP_REPORT = "heapReport";
+    const char* const TUNABLES_REPORT = "tunablesReport";
+}
+
+// ============================================================================
+// CLIENT -> SERVER BINARY FRAMES
+// ============================================================================
+// Low-rate telemetry goes up as binary WebSocket frames instead of JSON.
+// Byte 0 is the frame type; multi-byte fields are little-endian.
+// Mirrors BinFrame in shared/constants.js.
+
+namespace BinFrame {
+    // ECG waveform batch:
+    //   [0] type  [1-2] seq  [3-6] t0 (millis of first sample)
+    //   [7] sample interval ms  [8] sample count  [9-10] first sample (uint16)
+    //   then one int8 delta per sample; 0x80 escapes to an absolute uint16.
+    const uint8_t ECG_WAVE = 0x01;
+    const uint8_t ECG_WAVE_HEADER = 11;
+    const uint8_t DELTA_ESCAPE = 0x80;
+
+    // Per-beat events:
+    //   [0] type  [1] flags (bit0 = server clock synced)  [2] beat count
+    //   [3-6] first beat, server epoch ms (low 32 bits; 0 if unsynced)
+    //   [7-8] age of first beat when sent, ms (fallback when unsynced)  [9] signal quality 0-100
+    //   then per beat: [offset from first beat, uint16 ms]
+    //                  [R-R interval, uint16 ms; 0 = unknown or rejected as ectopic]
+    const uint8_t BEATS = 0x02;
+    const uint8_t BEATS_HEADER = 10;
+    const uint8_t BEATS_FLAG_SYNCED = 0x01;
+
+    // Remote log lines (only when the host turned them on, see diag.h):
+    //   [0] type  [1-2] seq  [3-4] lines dropped since the last frame (saturating)
+    //   then per line: [level] [millis, uint32] [length] [text, no terminator]
+    const uint8_t DIAG_LOG = 0x03;
+    const uint8_t DIAG_LOG_HEADER = 5;
+
+    // Metric counters (DiagMetric in diag.h):
+    //   [0] type  [1-4] millis  [5] count  then per counter: [id] [value, uint32]
+    const uint8_t DIAG_METRICS = 0x04;
+    const uint8_t DIAG_METRICS_HEADER = 6;
+}
+
+// ============================================================================
+// HEART RATE REPORT MODES
+// ============================================================================
+
+enum class HrReportMode {
+    BPM,    // JSON heartbeat every 2 s with BPM and HRV (lowest bandwidth)
+    BEATS   // Binary BEATS frames with per-beat timestamps and R-R intervals, no periodic
+            // report (while the monitor is enabled; BPM otherwise)
+};
+
+inline HrReportMode parseHrReportMode(const char* mode) {
+    if (strcmp(mode, "beats") == 0) return HrReportMode::BEATS;
+    return HrReportMode::BPM;
 }
 
 // ============================================================================
@@ -60,10 +126,10 @@ enum class LedState {
 };
 
 // Parse LED state from string
-inline LedState parseLedState(const String& state) {
-    if (state == "dim") return LedState::DIM;
-    if (state == "bright") return LedState::BRIGHT;
-    if (state == "pulse") return LedState::PULSE;
+inline LedState parseLedState(const char* state) {
+    if (strcmp(state, "dim") == 0) return LedState::DIM;
+    if (strcmp(state, "bright") == 0) return LedState::BRIGHT;
+    if (strcmp(state, "pulse") == 0) return LedState::PULSE;
     return LedState::OFF;
 }
 
@@ -77,16 +143,18 @@ enum class DisplayStyle {
     ABSTAINED,
     WAITING,
     CRITICAL,
-    OPERATOR   // Operator sentence mode: full 3-line sentence in FONT_SMALL
+    OPERATOR,  // Operator sentence mode: full 3-line sentence in FONT_SMALL
+    ECG        // Live ECG trace replaces line 2; lines 1 and 3 keep their text
 };
 
 // Parse display style from string
-inline DisplayStyle parseDisplayStyle(const String& style) {
-    if (style == "locked") return DisplayStyle::LOCKED;
-    if (style == "abstained") return DisplayStyle::ABSTAINED;
-    if (style == "waiting") return DisplayStyle::WAITING;
-    if (style == "critical") return DisplayStyle::CRITICAL;
-    if (style == "operator") return DisplayStyle::OPERATOR;
+inline DisplayStyle parseDisplayStyle(const char* style) {
+    if (strcmp(style, "locked") == 0) return DisplayStyle::LOCKED;
+    if (strcmp(style, "abstained") == 0) return DisplayStyle::ABSTAINED;
+    if (strcmp(style, "waiting") == 0) return DisplayStyle::WAITING;
+    if (strcmp(style, "critical") == 0) return DisplayStyle::CRITICAL;
+    if (strcmp(style, "operator") == 0) return DisplayStyle::OPERATOR;
+    if (strcmp(style, "ecg") == 0) return DisplayStyle::ECG;
     return DisplayStyle::NORMAL;
 }
 
@@ -109,20 +177,37 @@ enum class GameLedState {
 };
 
 // Parse game LED state from string
-inline GameLedState parseGameLedState(const String& state) {
-    if (state == "off") return GameLedState::OFF;
-    if (state == "lobby") return GameLedState::LOBBY;
-    if (state == "day") return GameLedState::DAY;
-    if (state == "night") return GameLedState::NIGHT;
-    if (state == "voting") return GameLedState::VOTING;
-    if (state == "locked") return GameLedState::LOCKED;
-    if (state == "abstained") return GameLedState::ABSTAINED;
-    if (state == "dead") return GameLedState::DEAD;
-    if (state == "coward") return GameLedState::COWARD;
-    if (state == "gameOver") return GameLedState::GAME_OVER;
+inline GameLedState parseGameLedState(const char* state) {
+    if (strcmp(state, "off") == 0) return GameLedState::OFF;
+    if (strcmp(state, "lobby") == 0) return GameLedState::LOBBY;
+    if (strcmp(state, "day") == 0) return GameLedState::DAY;
+    if (strcmp(state, "night") == 0) return GameLedState::NIGHT;
+    if (strcmp(state, "voting") == 0) return GameLedState::VOTING;
+    if (strcmp(state, "locked") == 0) return GameLedState::LOCKED;
+    if (strcmp(state, "abstained") == 0) return GameLedState::ABSTAINED;
+    if (strcmp(state, "dead") == 0) return GameLedState::DEAD;
+    if (strcmp(state, "coward") == 0) return GameLedState::COWARD;
+    if (strcmp(state, "gameOver") == 0) return GameLedState::GAME_OVER;
     return GameLedState::NONE;
 }
 
+// Game LED state name as the server spells it (reports)
+inline const char* gameLedStateName(GameLedState state) {
+    switch (state) {
+        case GameLedState::OFF:       return "off";
+        case GameLedState::LOBBY:     return "lobby";
+        case GameLedState::DAY:       return "day";
+        case GameLedState::NIGHT:     return "night";
+        case GameLedState::VOTING:    return "voting";
+        case GameLedState::LOCKED:    return "locked";
+        case GameLedState::ABSTAINED: return "abstained";
+        case GameLedState::DEAD:      return "dead";
+        case GameLedState::COWARD:    return "coward";
+        case GameLedState::GAME_OVER: return "gameOver";
+        default:                      return "none";
+    }
+}
+
 // ============================================================================
 // CONNECTION STATES
 // ============================================================================
@@ -139,6 +224,21 @@ enum class ConnectionState {
     ERROR
 };
 
+inline const char* connectionStateName(ConnectionState state) {
+    switch (state) {
+        case ConnectionState::BOOT:            return "BOOT";
+        case ConnectionState::PLAYER_SELECT:   return "PLAYER_SELECT";
+        case ConnectionState::WIFI_CONNECTING: return "WIFI_CONNECTING";
+        case ConnectionState::DISCOVERING:     return "DISCOVERING";
+        case ConnectionState::WS_CONNECTING:   return "WS_CONNECTING";
+        case ConnectionState::JOINING:         return "JOINING";
+        case ConnectionState::CONNECTED:       return "CONNECTED";
+        case ConnectionState::RECONNECTING:    return "RECONNECTING";
+        case ConnectionState::ERROR:           return "ERROR";
+        default:                               return "?";
+    }
+}
+
 // ============================================================================
 // INPUT EVENTS
 // ============================================================================
@@ -163,9 +263,9 @@ enum class IconState {
     EMPTY
 };
 
-inline IconState parseIconState(const String& state) {
-    if (state == "active") return IconState::ACTIVE;
-    if (state == "inactive") return IconState::INACTIVE;
+inline IconState parseIconState(const char* state) {
+    if (strcmp(state, "active") == 0) return IconState::ACTIVE;
+    if (strcmp(state, "inactive") == 0) return IconState::INACTIVE;
     return IconState::EMPTY;
 }
 
@@ -204,6 +304,7 @@ struct DisplayState {
     struct {
         LedState yes;
         LedState no;
+        LedState power;  // DIM (normal glow) unless the server asks for a pattern
     } leds;
 
     // Status LED (neopixel game state)
@@ -224,20 +325,54 @@ struct DisplayState {
     int    targetCount;
     int    selectionIndex;  // -1 = no selection
 
-    // Default constructor
+    // Longest text reserve() makes room for; longer server text still fits, it just grows
+    // the buffer once
+    static const int TEXT_RESERVE = 40;
+    static const int ID_RESERVE = 16;
+
     DisplayState() {
+        reset();
+    }
+
+    // Back to the defaults, keeping the string buffers
+    void reset() {
         line1.left = "CONNECTING";
         line1.right = "";
         line2.text = "...";
         line2.style = DisplayStyle::NORMAL;
         line3.text = "Please wait";
+        line3.left = "";
+        line3.center = "";
+        line3.right = "";
         leds.yes = LedState::OFF;
         leds.no = LedState::OFF;
+        leds.power = LedState::DIM;
         statusLed = GameLedState::NONE;
         idleScrollIndex = 0;
+        for (IconSlot& icon : icons) {
+            icon.id = "empty";
+            icon.state = IconState::EMPTY;
+        }
         targetCount = 0;
         selectionIndex = -1;
     }
+
+    // Allocate every string up front. A long-lived state then takes new text (and copies
+    // of other states) in place, with no heap traffic per PLAYER_STATE.
+    void reserve() {
+        line1.left.reserve(TEXT_RESERVE);
+        line1.right.reserve(ID_RESERVE);
+        line2.text.reserve(TEXT_RESERVE);
+        line3.text.reserve(TEXT_RESERVE);
+        line3.left.reserve(ID_RESERVE);
+        line3.center.reserve(ID_RESERVE);
+        line3.right.reserve(ID_RESERVE);
+        for (IconSlot& icon : icons) icon.id.reserve(ID_RESERVE);
+        for (int i = 0; i < MAX_TARGETS; i++) {
+            targetIds[i].reserve(ID_RESERVE);
+            targetNames[i].reserve(ID_RESERVE);
+        }
+    }
 };
 
 
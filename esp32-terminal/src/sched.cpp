@@ -0,0 +1,162 @@
+// Cooperative deadline scheduler
+//
+// A fixed table of SCHED_MAX_TASKS. Times are 32-bit microseconds compared by signed
+// difference, so they survive the clock wrapping (every ~71 min). A periodic task is
+// released at fixed steps of its period; if it falls more than a whole period behind,
+// the missed releases are dropped (counted as an overrun) rather than run back to back.
+
+#include "sched.h"
+#include "config.h"
+
+struct SchedTask {
+    const char* name;
+    SchedFn fn;
+    uint32_t periodUs;
+    uint32_t deadlineUs;
+    uint32_t release;     // Next release time
+    uint8_t priority;
+    bool armed;
+    bool ran;             // Already ran in the current schedRun() pass
+    uint32_t runs;
+    uint64_t totalUs;
+    uint32_t maxUs;
+    uint32_t overruns;
+};
+
+static SchedTask tasks[SCHED_MAX_TASKS];
+static int taskCount = 0;
+static SchedClock clockFn = nullptr;
+
+static bool validId(int id) {
+    return id >= 0 && id < taskCount;
+}
+
+void schedInit(SchedClock clock) {
+    clockFn = clock;
+    taskCount = 0;
+}
+
+int schedAdd(const char* name, SchedFn fn, uint32_t periodUs, uint32_t deadlineUs, uint8_t priority) {
+    if (taskCount >= SCHED_MAX_TASKS || fn == nullptr) return -1;
+    SchedTask& t = tasks[taskCount];
+    t = {};
+    t.name = name;
+    t.fn = fn;
+    t.periodUs = periodUs;
+    t.deadlineUs = deadlineUs;
+    t.priority = priority;
+    t.armed = periodUs > 0;
+    t.release = clockFn() + periodUs;
+    return taskCount++;
+}
+
+void schedArm(int id, uint32_t delayUs) {
+    if (!validId(id)) return;
+    tasks[id].release = clockFn() + delayUs;
+    tasks[id].armed = true;
+}
+
+void schedDisarm(int id) {
+    if (!validId(id) || tasks[id].periodUs > 0) return;
+    tasks[id].armed = false;
+}
+
+void schedSetPeriod(int id, uint32_t periodUs) {
+    if (!validId(id)) return;
+    SchedTask& t = tasks[id];
+    t.periodUs = periodUs;
+    if (periodUs > 0 && !t.armed) {
+        t.release = clockFn() + periodUs;
+        t.armed = true;
+    } else if (periodUs == 0) {
+        t.armed = false;
+    }
+}
+
+// Due task with the highest priority (earliest release on a tie), or -1
+static int nextDue(uint32_t now) {
+    int best = -1;
+    for (int i = 0; i < taskCount; i++) {
+        const SchedTask& t = tasks[i];
+        if (!t.armed || t.ran || (int32_t)(now - t.release) < 0) continue;
+        if (best < 0 || t.priority > tasks[best].priority ||
+            (t.priority == tasks[best].priority && (int32_t)(t.release - tasks[best].release) < 0)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+static void runTask(SchedTask& t) {
+    uint32_t release = t.release;
+    if (t.periodUs == 0) t.armed = false;   // Before fn(), so it can re-arm itself
+
+    uint32_t start = clockFn();
+    t.fn();
+    uint32_t end = clockFn();
+
+    uint32_t us = end - start;
+    t.runs++;
+    t.totalUs += us;
+    if (us > t.maxUs) t.maxUs = us;
+
+    uint32_t deadline = t.deadlineUs ? t.deadlineUs : t.periodUs;
+    bool late = deadline > 0 && (end - release) > deadline;
+
+    if (t.periodUs > 0 && t.armed && t.release == release) {
+        t.release += t.periodUs;
+        if ((int32_t)(end - t.release) >= 0) {
+            t.release = end + t.periodUs;   // Fell a whole period behind: drop the backlog
+            late = true;
+        }
+    }
+    if (late) t.overruns++;
+}
+
+uint32_t schedRun() {
+    for (int i = 0; i < taskCount; i++) tasks[i].ran = false;
+
+    int id;
+    while ((id = nextDue(clockFn())) >= 0) {
+        tasks[id].ran = true;
+        runTask(tasks[id]);
+    }
+
+    uint32_t now = clockFn();
+    uint32_t idle = SCHED_IDLE_FOREVER;
+    for (int i = 0; i < taskCount; i++) {
+        if (!tasks[i].armed) continue;
+        int32_t wait = (int32_t)(tasks[i].release - now);
+        if (wait <= 0) return 0;
+        if ((uint32_t)wait < idle) idle = (uint32_t)wait;
+    }
+    return idle;
+}
+
+SchedStats schedGetStats(int id) {
+    SchedStats s = {};
+    if (!validId(id)) return s;
+    const SchedTask& t = tasks[id];
+    s.runs = t.runs;
+    s.avgUs = t.runs ? (uint32_t)(t.totalUs / t.runs) : 0;
+    s.maxUs = t.maxUs;
+    s.overruns = t.overruns;
+    return s;
+}
+
+const char* schedGetName(int id) {
+    return validId(id) ? tasks[id].name : "";
+}
+
+int schedTaskCount() {
+    return taskCount;
+}
+
+void schedResetStats() {
+    for (int i = 0; i < taskCount; i++) {
+        tasks[i].runs = 0;
+        tasks[i].totalUs = 0;
+        tasks[i].maxUs = 0;
+        tasks[i].overruns = 0;
+    }
+}
@@ -0,0 +1,50 @@
+// Cooperative deadline scheduler — periodic and one-shot tasks run from loop().
+// Time comes from the clock passed to schedInit(), so test_sched runs it on a fake one.
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+
+typedef void (*SchedFn)();
+typedef uint32_t (*SchedClock)();   // Free-running microseconds, wraps at 2^32
+
+struct SchedStats {
+    uint32_t runs;
+    uint32_t avgUs;       // Mean runtime
+    uint32_t maxUs;
+    uint32_t overruns;    // Runs that finished after their deadline (or skipped a period)
+};
+
+static const uint32_t SCHED_IDLE_FOREVER = 0xFFFFFFFF;
+
+// Forget all tasks and use `clock` from now on
+void schedInit(SchedClock clock);
+
+// Register a task; returns its id, or -1 when SCHED_MAX_TASKS are in use.
+// periodUs > 0: runs every periodUs from now. periodUs == 0: one-shot, idle until schedArm().
+// deadlineUs: time from release to completion before the run counts as an overrun
+// (0 = the period; no deadline for one-shots). Higher priority runs first when
+// several tasks are due; equal priorities run in release order.
+int schedAdd(const char* name, SchedFn fn, uint32_t periodUs, uint32_t deadlineUs, uint8_t priority);
+
+// (Re)arm a task to run delayUs from now. For a periodic task this moves its next
+// release; the period continues from there.
+void schedArm(int id, uint32_t delayUs);
+
+// Stop a one-shot from firing (a periodic task keeps running; use schedSetPeriod(id, 0))
+void schedDisarm(int id);
+
+// Change a task's period (0 turns it into an idle one-shot)
+void schedSetPeriod(int id, uint32_t periodUs);
+
+// Run every task that is due, each at most once, highest priority first.
+// Returns microseconds until the next release, or SCHED_IDLE_FOREVER if nothing is armed.
+uint32_t schedRun();
+
+// Runtime statistics since the last schedResetStats()
+SchedStats schedGetStats(int id);
+const char* schedGetName(int id);
+int schedTaskCount();
+void schedResetStats();
+
+#endif // SCHED_H
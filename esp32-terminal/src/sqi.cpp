@@ -0,0 +1,124 @@
+// Signal quality index
+//
+// Four components, each 0..1, combined as a weighted sum:
+//   amplitude  — peak-to-peak range; halved if the ADC clipped
+//   noise      — mean |second difference| relative to range (mains hum, EMG, loose contact)
+//   wander     — excursion of a slow baseline EMA relative to the rest of the range
+//   regularity — share of recent beats whose R-R interval hrv.cpp accepted
+// All accumulators are updated per sample; scoring happens once per window.
+
+#include "sqi.h"
+#include "config.h"
+
+static const int ADC_MAX = 4095;
+static const int CLIP_MARGIN = 8;
+static const int BASELINE_SHIFT = 6;   // EMA alpha 1/64 (~0.25 s at 250 Hz)
+
+static int winMin = ADC_MAX;
+static int winMax = 0;
+static uint32_t noiseSum = 0;
+static uint32_t sampleCount = 0;
+static int prev1 = -1;
+static int prev2 = -1;
+
+static int32_t baseline = -1;         // Fixed point, << BASELINE_SHIFT
+static int baseMin = ADC_MAX;
+static int baseMax = 0;
+
+static uint8_t beatBits = 0;          // 1 = accepted, newest in bit 0
+static uint8_t beatCount = 0;
+static bool beatInWindow = false;
+
+static uint8_t quality = 0;
+
+void sqiAddSample(int sample) {
+    if (sample < winMin) winMin = sample;
+    if (sample > winMax) winMax = sample;
+
+    if (prev2 >= 0) {
+        int d2 = sample - 2 * prev1 + prev2;
+        noiseSum += d2 < 0 ? -d2 : d2;
+    }
+    prev2 = prev1;
+    prev1 = sample;
+    sampleCount++;
+
+    if (baseline < 0) baseline = (int32_t)sample << BASELINE_SHIFT;
+    baseline += sample - (baseline >> BASELINE_SHIFT);
+    int b = baseline >> BASELINE_SHIFT;
+    if (b < baseMin) baseMin = b;
+    if (b > baseMax) baseMax = b;
+}
+
+void sqiAddBeat(bool accepted) {
+    beatBits = (beatBits << 1) | (accepted ? 1 : 0);
+    if (beatCount < SQI_BEAT_HISTORY) beatCount++;
+    beatInWindow = true;
+}
+
+// 1.0 at `good`, 0.0 at `bad` (either direction), linear between
+static float score(float value, float good, float bad) {
+    float t = (value - bad) / (good - bad);
+    return t < 0 ? 0 : (t > 1 ? 1 : t);
+}
+
+static int popcount8(uint8_t v) {
+    int n = 0;
+    for (; v; v &= v - 1) n++;
+    return n;
+}
+
+void sqiCloseWindow() {
+    int range = winMax - winMin;
+    if (sampleCount < 3 || range <= 0) {
+        quality = 0;
+    } else {
+        float amplitude = score(range, SQI_RANGE_GOOD, SQI_RANGE_BAD);
+        if (winMax >= ADC_MAX - CLIP_MARGIN || winMin <= CLIP_MARGIN) amplitude *= 0.5f;
+
+        float noisePct = 100.0f * noiseSum / (sampleCount - 2) / range;
+        float noise = score(noisePct, SQI_NOISE_GOOD_PCT, SQI_NOISE_BAD_PCT);
+
+        // Relative to the signal left once the drift is taken out of the range
+        int excursion = baseMax - baseMin;
+        int signal = range - excursion;
+        float wanderPct = signal > 0 ? 100.0f * excursion / signal : SQI_WANDER_BAD_PCT;
+        float wander = score(wanderPct, SQI_WANDER_GOOD_PCT, SQI_WANDER_BAD_PCT);
+
+        // No beat at all this window means no usable rhythm, whatever the waveform looks like
+        uint8_t mask = (uint8_t)((1u << beatCount) - 1);
+        float regularity = (!beatInWindow || beatCount == 0) ? 0
+                         : (float)popcount8(beatBits & mask) / beatCount;
+
+        float q = 0.30f * amplitude + 0.25f * noise + 0.20f * wander + 0.25f * regularity;
+        quality = (uint8_t)(q * 100 + 0.5f);
+    }
+
+    winMin = ADC_MAX;
+    winMax = 0;
+    noiseSum = 0;
+    sampleCount = 0;
+    baseMin = ADC_MAX;
+    baseMax = 0;
+    beatInWindow = false;
+}
+
+uint8_t sqiGet() {
+    return quality;
+}
+
+void sqiReset() {
+    winMin = ADC_MAX;
+    winMax = 0;
+    noiseSum = 0;
+    sampleCount = 0;
+    prev1 = -1;
+    prev2 = -1;
+    baseline = -1;
+    baseMin = ADC_MAX;
+    baseMax = 0;
+    beatBits = 0;
+    beatCount = 0;
+    beatInWindow = false;
+    quality = 0;
+}
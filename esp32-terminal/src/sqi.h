@@ -0,0 +1,22 @@
+// Signal quality index — 0 (unusable) to 100 (clean ECG), one value per detection window.
+#ifndef SQI_H
+#define SQI_H
+
+#include <stdint.h>
+
+// Feed every ADC sample (0..4095)
+void sqiAddSample(int sample);
+
+// Feed every detected beat after the first: whether hrv.cpp accepted its R-R interval
+void sqiAddBeat(bool accepted);
+
+// Score the samples since the previous call (call at each rolling-window boundary)
+void sqiCloseWindow();
+
+// Quality of the last closed window
+uint8_t sqiGet();
+
+// Forget everything (leads off, power down)
+void sqiReset();
+
+#endif // SQI_H
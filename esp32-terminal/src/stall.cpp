@@ -0,0 +1,106 @@
+// Loop-stall records
+//
+// RTC_NOINIT memory holds whatever was there before a reset (garbage after power-up),
+// so the ring is validated by a magic word and its own bounds before it is trusted.
+
+#include "stall.h"
+#include <string.h>
+
+static const uint32_t STALL_MAGIC = 0x5741C401;
+
+static StallRing* ring = nullptr;
+static volatile uint32_t fedMs = 0;      // Last loop tick
+static volatile uint32_t dueMs = 0;      // Planned wake-up + threshold
+static int openIdx = -1;                 // Record of the stall in progress
+static uint32_t openFedMs = 0;           // fedMs when it opened
+
+void stallInit(StallRing* storage) {
+    ring = storage;
+    openIdx = -1;
+    if (ring->magic != STALL_MAGIC || ring->head >= STALL_RING || ring->count > STALL_RING) {
+        memset(ring, 0, sizeof(*ring));
+        ring->magic = STALL_MAGIC;
+    }
+    ring->boot++;
+    fedMs = 0;
+    dueMs = STALL_THRESHOLD_MS;
+}
+
+void stallFeed(uint32_t nowMs, uint32_t idleMs) {
+    fedMs = nowMs;
+    dueMs = nowMs + idleMs + STALL_THRESHOLD_MS;
+}
+
+static int openRecord() {
+    int idx;
+    if (ring->count < STALL_RING) {
+        idx = (ring->head + ring->count) % STALL_RING;
+        ring->count++;
+    } else {
+        idx = ring->head;   // Overwrite the oldest
+        ring->head = (ring->head + 1) % STALL_RING;
+        ring->overwritten++;
+    }
+    return idx;
+}
+
+const StallRecord* stallCheck(uint32_t nowMs, const uint8_t* scopes, const uint32_t* sites, int depth) {
+    if (ring == nullptr) return nullptr;
+    uint32_t fed = fedMs;
+
+    if (openIdx >= 0) {
+        StallRecord& r = ring->records[openIdx];
+        if (fed != openFedMs) {
+            r.durationMs = fed - r.startMs;
+            r.flags &= ~STALL_UNFINISHED;
+            openIdx = -1;
+        } else {
+            r.durationMs = nowMs - r.startMs;
+        }
+        return nullptr;
+    }
+
+    if ((int32_t)(nowMs - dueMs) <= 0) return nullptr;
+
+    openIdx = openRecord();
+    openFedMs = fed;
+    StallRecord& r = ring->records[openIdx];
+    memset(&r, 0, sizeof(r));
+    r.seq = ring->nextSeq++;
+    r.boot = ring->boot;
+    r.startMs = fed;
+    r.durationMs = nowMs - fed;
+    r.flags = STALL_UNFINISHED;
+    if (depth > STALL_DEPTH) depth = STALL_DEPTH;
+    r.depth = depth > 0 ? depth : 0;
+    for (int i = 0; i < r.depth; i++) {
+        r.scopes[i] = scopes[i];
+        r.sites[i] = sites[i];
+    }
+    return &r;
+}
+
+int stallCount() {
+    if (ring == nullptr) return 0;
+    return ring->count - (openIdx >= 0 ? 1 : 0);
+}
+
+const StallRecord* stallGet(int index) {
+    if (index < 0 || index >= stallCount()) return nullptr;
+    return &ring->records[(ring->head + index) % STALL_RING];
+}
+
+void stallAck(int count) {
+    if (count <= 0) return;
+    if (count > stallCount()) count = stallCount();
+    ring->head = (ring->head + count) % STALL_RING;
+    ring->count -= count;
+}
+
+uint32_t stallBoot() {
+    return ring ? ring->boot : 0;
+}
+
+uint32_t stallOverwritten() {
+    return ring ? ring->overwritten : 0;
+}
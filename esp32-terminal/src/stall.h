@@ -0,0 +1,57 @@
+// Loop-stall records — a watchdog task notices when loop() stops ticking and records
+// how long for and which profiler scopes were open. The ring is meant to live in RTC
+// memory, so a stall that ends in a watchdog or panic reset is reported after the reboot.
+// The caller provides the time, the storage and the locking between the loop and the
+// watchdog task.
+#ifndef STALL_H
+#define STALL_H
+
+#include <stdint.h>
+#include "config.h"
+
+static const uint8_t STALL_UNFINISHED = 0x01;   // Still stalled, or a reset cut it short
+
+struct StallRecord {
+    uint32_t seq;                   // Increments across reboots
+    uint32_t boot;                  // Boot count it happened in
+    uint32_t startMs;               // millis() of the last loop tick before the stall
+    uint32_t durationMs;            // From that tick (so includes the planned sleep)
+    uint8_t flags;
+    uint8_t depth;                  // Open scopes when the stall was detected
+    uint8_t scopes[STALL_DEPTH];    // ProfScope ids, innermost first
+    uint32_t sites[STALL_DEPTH];    // Code address each scope was entered from
+};
+
+struct StallRing {
+    uint32_t magic;
+    uint32_t boot;
+    uint32_t nextSeq;
+    uint16_t head;                  // Oldest record
+    uint16_t count;
+    uint32_t overwritten;           // Records lost to a full ring
+    StallRecord records[STALL_RING];
+};
+
+// Adopt `ring`: keep its records if it survived a soft reset, else clear it. Starts a
+// new boot; records left unfinished by the previous one stay flagged as such.
+void stallInit(StallRing* ring);
+
+// Loop side, every iteration: it ran at nowMs and plans to sleep idleMs
+void stallFeed(uint32_t nowMs, uint32_t idleMs);
+
+// Watchdog side, every STALL_CHECK_MS. Opens a record once the loop is STALL_THRESHOLD_MS
+// past its planned wake-up, keeps its duration current, and closes it when the loop
+// ticks again. Returns the record when it was just opened, else nullptr.
+const StallRecord* stallCheck(uint32_t nowMs, const uint8_t* scopes, const uint32_t* sites, int depth);
+
+// Finished records, oldest first (the one still open is not included)
+int stallCount();
+const StallRecord* stallGet(int index);
+
+// Drop the oldest `count` finished records (uploaded)
+void stallAck(int count);
+
+uint32_t stallBoot();
+uint32_t stallOverwritten();
+
+#endif // STALL_H
@@ -0,0 +1,62 @@
+// Server clock offset estimation
+//
+// Each exchange yields offset = serverTime - (localSend + rtt/2); the error is bounded
+// by half the path asymmetry, which grows with RTT. Keeping the lowest-RTT sample from
+// a window rejects exchanges that were queued behind WiFi retries. Eight samples (80 s
+// at the steady probe rate) keeps crystal drift inside the window under 2 ms.
+
+#include "timesync.h"
+
+static const int WINDOW = 8;
+
+static int64_t sampleOffset[WINDOW];
+static uint32_t sampleRtt[WINDOW];
+static int sampleCount = 0;
+static int sampleNext = 0;
+
+static int64_t bestOffset = 0;
+static uint32_t bestRtt = 0;
+
+void timesyncAddSample(uint32_t localSend, uint32_t localRecv, uint64_t serverTime) {
+    uint32_t rtt = localRecv - localSend;
+    int64_t offset = (int64_t)serverTime - (int64_t)(localSend + rtt / 2);
+
+    sampleOffset[sampleNext] = offset;
+    sampleRtt[sampleNext] = rtt;
+    sampleNext = (sampleNext + 1) % WINDOW;
+    if (sampleCount < WINDOW) sampleCount++;
+
+    int best = 0;
+    for (int i = 1; i < sampleCount; i++) {
+        if (sampleRtt[i] < sampleRtt[best]) best = i;
+    }
+    bestOffset = sampleOffset[best];
+    bestRtt = sampleRtt[best];
+}
+
+bool timesyncIsSynced() {
+    return sampleCount > 0;
+}
+
+bool timesyncIsSettled() {
+    return sampleCount == WINDOW;
+}
+
+uint64_t timesyncToServer(uint32_t localMs) {
+    return (uint64_t)((int64_t)localMs + bestOffset);
+}
+
+uint32_t timesyncToLocal(uint64_t serverMs) {
+    return (uint32_t)((int64_t)serverMs - bestOffset);
+}
+
+uint32_t timesyncRoundTrip() {
+    return bestRtt;
+}
+
+void timesyncReset() {
+    sampleCount = 0;
+    sampleNext = 0;
+    bestOffset = 0;
+    bestRtt = 0;
+}
@@ -0,0 +1,30 @@
+// Server clock offset estimation — NTP-style request/response over the WebSocket.
+// Send/receive times are passed in by the network layer; nothing here reads millis().
+#ifndef TIMESYNC_H
+#define TIMESYNC_H
+
+#include <stdint.h>
+
+// Feed one completed exchange: local millis() when the request left and when the
+// reply arrived, plus the server's Date.now() stamped into the reply.
+void timesyncAddSample(uint32_t localSend, uint32_t localRecv, uint64_t serverTime);
+
+// True once at least one exchange has completed
+bool timesyncIsSynced();
+
+// True once the sample window is full (probe fast until then)
+bool timesyncIsSettled();
+
+// Convert a local millis() timestamp to server epoch ms
+uint64_t timesyncToServer(uint32_t localMs);
+
+// Convert server epoch ms to the local millis() at which that instant occurs
+uint32_t timesyncToLocal(uint64_t serverMs);
+
+// Round-trip time of the sample the offset is currently derived from
+uint32_t timesyncRoundTrip();
+
+// Forget all samples (e.g. when switching servers)
+void timesyncReset();
+
+#endif // TIMESYNC_H
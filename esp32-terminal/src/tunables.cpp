@@ -0,0 +1,90 @@
+// Runtime tunables
+
+#include "tunables.h"
+#include <string.h>
+#ifdef ARDUINO
+#include <Preferences.h>
+#endif
+
+static const int TUNABLE_COUNT = (int)Tunable::COUNT;
+
+// Same order as enum Tunable
+static const TunableDef defs[TUNABLE_COUNT] = {
+    { "encoderPollMs",  "ms", 1,   100,   ENCODER_POLL_MS },
+    { "debounceMs",     "ms", 1,   200,   DEBOUNCE_MS },
+    { "longPressMs",    "ms", 200, 3000,  LONG_PRESS_MS },
+    { "scrollSettleMs", "ms", 0,   2000,  SCROLL_SETTLE_MS },
+    { "wsPingMs",       "ms", 0,   60000, WS_PING_MS },
+    { "bpmSendMs",      "ms", 500, 10000, AD8232_BPM_SEND_MS },
+    { "hrThresholdPct", "%",  10,  95,    AD8232_THRESHOLD_PCT },
+    { "hrMinRange",     "",   50,  4095,  AD8232_MIN_RANGE },
+    { "hrRefractoryMs", "ms", 150, 1000,  AD8232_REFRACTORY_MS },
+};
+
+static uint32_t values[TUNABLE_COUNT];
+
+static void (*changeListener)(Tunable t) = nullptr;
+
+void tunablesInit() {
+    for (int i = 0; i < TUNABLE_COUNT; i++) values[i] = defs[i].def;
+}
+
+const TunableDef& tunableDef(Tunable t) {
+    return defs[(int)t];
+}
+
+uint32_t tunableGet(Tunable t) {
+    return values[(int)t];
+}
+
+bool tunableSet(Tunable t, uint32_t value) {
+    const TunableDef& d = defs[(int)t];
+    if (value < d.min || value > d.max) return false;
+    if (values[(int)t] == value) return true;
+    values[(int)t] = value;
+    if (changeListener) changeListener(t);
+    return true;
+}
+
+int tunableFind(const char* name) {
+    for (int i = 0; i < TUNABLE_COUNT; i++) {
+        if (strcmp(defs[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+void tunablesSetListener(void (*listener)(Tunable t)) {
+    changeListener = listener;
+}
+
+void tunablesResetDefaults() {
+    for (int i = 0; i < TUNABLE_COUNT; i++) tunableSet((Tunable)i, defs[i].def);
+}
+
+#ifdef ARDUINO
+static Preferences prefs;
+
+void tunablesLoad() {
+    if (!prefs.begin(TUNABLES_NVS_NAMESPACE, true)) return;   // Nothing saved yet
+    for (int i = 0; i < TUNABLE_COUNT; i++) {
+        if (!prefs.isKey(defs[i].name)) continue;
+        uint32_t v = prefs.getUInt(defs[i].name, defs[i].def);
+        // Bounds may have tightened since it was saved: keep the default then
+        if (v >= defs[i].min && v <= defs[i].max) values[i] = v;
+    }
+    prefs.end();
+}
+
+bool tunablesSave() {
+    if (!prefs.begin(TUNABLES_NVS_NAMESPACE, false)) return false;
+    for (int i = 0; i < TUNABLE_COUNT; i++) {
+        if (values[i] != defs[i].def) {
+            prefs.putUInt(defs[i].name, values[i]);
+        } else if (prefs.isKey(defs[i].name)) {
+            prefs.remove(defs[i].name);
+        }
+    }
+    prefs.end();
+    return true;
+}
+#endif
@@ -0,0 +1,60 @@
+// Runtime tunables — timing and detector values that can be changed without reflashing,
+// from the serial console (set / save) or by the host for the whole fleet (tunables
+// message). Each has a default (config.h), bounds and a unit; values saved to NVS are
+// loaded at boot. Consumers read them where they use them, so a change applies at once.
+// Only load/save touch NVS (Preferences) and are built for the device alone; bounds,
+// parsing and host updates are plain code.
+#ifndef TUNABLES_H
+#define TUNABLES_H
+
+#include <stdint.h>
+#include "config.h"
+
+enum class Tunable : uint8_t {
+    ENCODER_POLL,
+    DEBOUNCE,
+    LONG_PRESS,
+    SCROLL_SETTLE,
+    WS_PING,
+    BPM_SEND,
+    HR_THRESHOLD,    // Detector defaults (slots without a stored calibration)
+    HR_MIN_RANGE,
+    HR_REFRACTORY,
+    COUNT
+};
+
+struct TunableDef {
+    const char* name;       // Wire, console and NVS key (max 15 characters)
+    const char* unit;       // "ms", "%", "" (ADC counts)
+    uint32_t min;
+    uint32_t max;
+    uint32_t def;
+};
+
+// Every value to its default, without telling the listener (first thing at boot)
+void tunablesInit();
+
+const TunableDef& tunableDef(Tunable t);
+uint32_t tunableGet(Tunable t);
+
+// Out-of-bounds values are refused (false). A change is passed to the listener.
+bool tunableSet(Tunable t, uint32_t value);
+
+// Index by name, -1 if there is no such tunable
+int tunableFind(const char* name);
+
+// Called after a value changed, for consumers that cache it (ISR copies, live detector)
+void tunablesSetListener(void (*listener)(Tunable t));
+
+// Everything back to the defaults (the listener hears each change)
+void tunablesResetDefaults();
+
+#ifdef ARDUINO
+// NVS: load at boot after tunablesInit(), before the consumers initialize (no listener
+// calls). Saving stores the values that differ from their default and clears the rest,
+// so a firmware update that changes a default reaches every terminal that was not tuned.
+void tunablesLoad();
+bool tunablesSave();
+#endif
+
+#endif // TUNABLES_H
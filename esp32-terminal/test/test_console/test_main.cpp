@@ -0,0 +1,138 @@
+// Native unit tests for console.cpp
+// Run with: pio test -e native
+
+#include <unity.h>
+#include <string.h>
+#include "console.h"
+#include "logbuf.h"
+
+static int calls = 0;
+static int lastArgc = 0;
+static char lastArgs[CONSOLE_MAX_ARGS][CONSOLE_LINE_MAX];
+
+static void record(int argc, char** argv) {
+    calls++;
+    lastArgc = argc;
+    for (int i = 0; i < argc; i++) strcpy(lastArgs[i], argv[i]);
+}
+
+static const ConsoleCommand commands[] = {
+    { "net", "", "Connection state", record },
+    { "set", "[name value]", "Change a value", record },
+};
+
+static uint8_t rec[LOG_RECORD_MAX];
+static char text[256];
+
+void setUp() {
+    logReset();
+    consoleInit(commands, 2);
+    calls = 0;
+    lastArgc = 0;
+}
+
+void tearDown() {}
+
+static bool type(const char* s) {
+    bool ran = false;
+    while (*s) ran = consoleFeed(*s++);
+    return ran;
+}
+
+// Next line the console printed
+static const char* reply() {
+    int len = logPop(rec);
+    if (len == 0) return nullptr;
+    logFormat(rec, len, text, sizeof(text));
+    return text;
+}
+
+void test_line_runs_matching_command_with_words() {
+    TEST_ASSERT_FALSE(type("  set\tsettle   200"));
+    TEST_ASSERT_EQUAL_INT(0, calls);
+    TEST_ASSERT_TRUE(consoleFeed('\r'));
+    TEST_ASSERT_FALSE(consoleFeed('\n'));    // CRLF: the LF is an empty line
+    TEST_ASSERT_EQUAL_INT(1, calls);
+    TEST_ASSERT_EQUAL_INT(3, lastArgc);
+    TEST_ASSERT_EQUAL_STRING("set", lastArgs[0]);
+    TEST_ASSERT_EQUAL_STRING("settle", lastArgs[1]);
+    TEST_ASSERT_EQUAL_STRING("200", lastArgs[2]);
+    TEST_ASSERT_NULL(reply());
+}
+
+void test_empty_line_does_nothing() {
+    TEST_ASSERT_FALSE(type("   \n"));
+    TEST_ASSERT_EQUAL_INT(0, calls);
+    TEST_ASSERT_NULL(reply());
+}
+
+void test_unknown_command_says_so() {
+    TEST_ASSERT_FALSE(type("reboot\n"));
+    TEST_ASSERT_EQUAL_STRING("Unknown command 'reboot' (help lists them)", reply());
+}
+
+void test_help_lists_every_command() {
+    TEST_ASSERT_TRUE(type("help\n"));
+    TEST_ASSERT_EQUAL_STRING("Commands:", reply());
+    TEST_ASSERT_EQUAL_STRING("  net                         Connection state", reply());
+    TEST_ASSERT_EQUAL_STRING("  set        [name value]     Change a value", reply());
+    TEST_ASSERT_NULL(reply());
+    TEST_ASSERT_EQUAL_INT(0, calls);
+}
+
+void test_backspace_edits_the_line() {
+    type("nex\bt\x7f");
+    type("t\n");
+    TEST_ASSERT_EQUAL_INT(1, calls);
+    TEST_ASSERT_EQUAL_STRING("net", lastArgs[0]);
+}
+
+void test_over_long_line_is_discarded() {
+    for (int i = 0; i < CONSOLE_LINE_MAX + 10; i++) consoleFeed('a');
+    TEST_ASSERT_FALSE(consoleFeed('\n'));
+    TEST_ASSERT_NOT_NULL(strstr(reply(), "Line too long"));
+
+    // The next line starts clean
+    TEST_ASSERT_TRUE(type("net\n"));
+}
+
+void test_extra_words_are_ignored() {
+    type("set a b c d e f g h\n");
+    TEST_ASSERT_EQUAL_INT(CONSOLE_MAX_ARGS, lastArgc);
+}
+
+void test_parse_uint_checks_range() {
+    uint32_t v = 0;
+    TEST_ASSERT_TRUE(consoleParseUint("150", 100, 200, &v));
+    TEST_ASSERT_EQUAL_UINT32(150, v);
+    TEST_ASSERT_NULL(reply());
+
+    TEST_ASSERT_FALSE(consoleParseUint("250", 100, 200, &v));
+    TEST_ASSERT_EQUAL_STRING("Expected a number from 100 to 200", reply());
+    TEST_ASSERT_FALSE(consoleParseUint("12x", 0, 200, &v));
+    TEST_ASSERT_FALSE(consoleParseUint("", 0, 200, &v));
+    TEST_ASSERT_FALSE(consoleParseUint(nullptr, 0, 200, &v));
+    TEST_ASSERT_EQUAL_UINT32(150, v);
+}
+
+void test_replies_pass_any_log_level() {
+    logSetLevel(0);
+    LOG_E("hidden");
+    type("reboot\n");
+    TEST_ASSERT_EQUAL_STRING("Unknown command 'reboot' (help lists them)", reply());
+    TEST_ASSERT_NULL(reply());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_line_runs_matching_command_with_words);
+    RUN_TEST(test_empty_line_does_nothing);
+    RUN_TEST(test_unknown_command_says_so);
+    RUN_TEST(test_help_lists_every_command);
+    RUN_TEST(test_backspace_edits_the_line);
+    RUN_TEST(test_over_long_line_is_discarded);
+    RUN_TEST(test_extra_words_are_ignored);
+    RUN_TEST(test_parse_uint_checks_range);
+    RUN_TEST(test_replies_pass_any_log_level);
+    return UNITY_END();
+}
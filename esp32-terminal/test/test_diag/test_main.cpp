@@ -0,0 +1,113 @@
+// Native unit tests for diag.cpp
+// Run with: pio test -e native
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "diag.h"
+
+static uint8_t frame[DIAG_RING_BYTES];
+
+void setUp() {
+    diagReset();
+}
+
+void tearDown() {}
+
+static void push(uint8_t level, uint32_t ms, const char* text) {
+    diagPushLine(level, ms, text, strlen(text));
+}
+
+void test_lines_pack_in_wire_layout() {
+    push(3, 0x01020304, "WiFi connected");
+    push(2, 5, "[NET] Stream over budget");
+
+    int n = diagPackLines(frame, sizeof(frame));
+    TEST_ASSERT_EQUAL_INT(2 * DIAG_LINE_HEADER + 14 + 24, n);
+    TEST_ASSERT_EQUAL_UINT8(3, frame[0]);
+    TEST_ASSERT_EQUAL_UINT8(0x04, frame[1]);
+    TEST_ASSERT_EQUAL_UINT8(0x01, frame[4]);
+    TEST_ASSERT_EQUAL_UINT8(14, frame[5]);
+    TEST_ASSERT_EQUAL_MEMORY("WiFi connected", frame + 6, 14);
+    TEST_ASSERT_EQUAL_UINT8(2, frame[20]);
+    TEST_ASSERT_EQUAL_UINT8(5, frame[21]);
+    TEST_ASSERT_EQUAL_INT(0, diagPackLines(frame, sizeof(frame)));
+}
+
+void test_only_whole_lines_leave_the_ring() {
+    push(3, 1, "first line");
+    push(3, 2, "second line");
+
+    // Room for the first line and part of the second
+    int n = diagPackLines(frame, DIAG_LINE_HEADER + 10 + 4);
+    TEST_ASSERT_EQUAL_INT(DIAG_LINE_HEADER + 10, n);
+
+    // Too small for the next line: nothing moves
+    TEST_ASSERT_EQUAL_INT(0, diagPackLines(frame, 8));
+
+    n = diagPackLines(frame, sizeof(frame));
+    TEST_ASSERT_EQUAL_INT(DIAG_LINE_HEADER + 11, n);
+    TEST_ASSERT_EQUAL_MEMORY("second line", frame + DIAG_LINE_HEADER, 11);
+}
+
+void test_full_ring_drops_and_counts() {
+    char text[100];
+    memset(text, 'x', sizeof(text));
+    int pushed = 0;
+    while (diagPushLine(3, 0, text, sizeof(text))) pushed++;
+    TEST_ASSERT_EQUAL_INT(DIAG_RING_BYTES / (DIAG_LINE_HEADER + 100), pushed);
+
+    diagPushLine(3, 0, text, sizeof(text));
+    TEST_ASSERT_EQUAL_UINT32(2, diagTakeDropped());
+    TEST_ASSERT_EQUAL_UINT32(0, diagTakeDropped());
+    TEST_ASSERT_EQUAL_UINT32(2, diagDroppedTotal());
+
+    // Draining makes room again
+    diagPackLines(frame, DIAG_LINE_HEADER + 100);
+    TEST_ASSERT_TRUE(diagPushLine(3, 0, text, sizeof(text)));
+}
+
+void test_lines_survive_the_wrap() {
+    char text[32];
+    int popped = 0;
+    for (int i = 0; i < 500; i++) {
+        int len = snprintf(text, sizeof(text), "line %d", i);
+        TEST_ASSERT_TRUE(diagPushLine(4, i, text, len));
+        if (i % 7 == 6) {
+            int n = diagPackLines(frame, sizeof(frame));
+            for (int at = 0; at < n; at += DIAG_LINE_HEADER + frame[at + 5]) {
+                len = snprintf(text, sizeof(text), "line %d", popped);
+                TEST_ASSERT_EQUAL_UINT8(popped & 0xFF, frame[at + 1]);
+                TEST_ASSERT_EQUAL_UINT8(len, frame[at + 5]);
+                TEST_ASSERT_EQUAL_MEMORY(text, frame + at + DIAG_LINE_HEADER, len);
+                popped++;
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(497, popped);
+}
+
+void test_long_lines_are_truncated() {
+    static char text[400];
+    memset(text, 'y', sizeof(text));
+    diagPushLine(1, 0, text, sizeof(text));
+    TEST_ASSERT_EQUAL_INT(DIAG_LINE_HEADER + DIAG_TEXT_MAX, diagPackLines(frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL_UINT8(DIAG_TEXT_MAX, frame[5]);
+}
+
+void test_level_starts_off() {
+    TEST_ASSERT_EQUAL_UINT8(0, diagLevel());
+    diagSetLevel(4);
+    TEST_ASSERT_EQUAL_UINT8(4, diagLevel());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_lines_pack_in_wire_layout);
+    RUN_TEST(test_only_whole_lines_leave_the_ring);
+    RUN_TEST(test_full_ring_drops_and_counts);
+    RUN_TEST(test_lines_survive_the_wrap);
+    RUN_TEST(test_long_lines_are_truncated);
+    RUN_TEST(test_level_starts_off);
+    return UNITY_END();
+}
@@ -0,0 +1,112 @@
+// Native unit tests for dsp.cpp — optimized kernels must match the *Ref versions bit for bit.
+// Also prints a cycles-per-block benchmark. Run with: pio test -e native -v
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dsp.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static uint64_t cycles() { return __rdtsc(); }
+#elif defined(ESP_PLATFORM)
+#include <esp_cpu.h>
+static uint64_t cycles() { return esp_cpu_get_cycle_count(); }
+#else
+#include <time.h>
+static uint64_t cycles() {   // Nanoseconds where no cycle counter is available
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+#endif
+
+static const int BLOCK = 64;
+static const int BLOCKS = 40;
+
+// Same 15-tap 35 Hz low-pass as heartrate.cpp (Q15, unity DC gain)
+static const int16_t LOWPASS[15] = {
+    -15, -184, -500, -418, 1072, 4219, 7641, 9138, 7641, 4219, 1072, -418, -500, -184, -15
+};
+
+static int16_t input[BLOCK * BLOCKS];
+
+static void fillEcgLike(int16_t* buf, int n, int lo, int hi) {
+    for (int i = 0; i < n; i++) {
+        int r = (i % 200) < 8 ? hi : lo;           // Spiky, like R waves
+        buf[i] = (int16_t)(r + (rand() % 301) - 150);
+    }
+}
+
+void setUp() { srand(7); }
+void tearDown() {}
+
+// Feed the same data through both versions in uneven block sizes
+static void runFir(const int16_t* h, uint16_t taps, const int16_t* in, int n) {
+    int16_t delayA[64], delayB[64];
+    DspFirQ15 a, b;
+    dspFirInit(&a, h, taps, delayA);
+    dspFirInit(&b, h, taps, delayB);
+    int16_t outA[BLOCK], outB[BLOCK];
+    for (int off = 0, len = 1; off < n; off += len, len = (len + 7) % BLOCK + 1) {
+        if (off + len > n) len = n - off;
+        dspFirQ15(&a, in + off, outA, len);
+        dspFirQ15Ref(&b, in + off, outB, len);
+        TEST_ASSERT_EQUAL_MEMORY(outB, outA, len * sizeof(int16_t));
+    }
+}
+
+void test_fir_matches_reference() {
+    fillEcgLike(input, BLOCK * BLOCKS, 1500, 3500);
+    runFir(LOWPASS, 15, input, BLOCK * BLOCKS);
+}
+
+void test_fir_odd_tap_counts_and_saturation() {
+    int16_t h[32];
+    for (int taps = 1; taps <= 32; taps += 3) {
+        for (int k = 0; k < taps; k++) h[k] = (int16_t)((rand() % 6001) - 3000);
+        for (int i = 0; i < BLOCK * 4; i++) input[i] = (int16_t)((rand() % 32769) - 16384);
+        runFir(h, taps, input, BLOCK * 4);
+    }
+}
+
+void test_fir_unity_dc_gain() {
+    int16_t delay[30];
+    DspFirQ15 f;
+    dspFirInit(&f, LOWPASS, 15, delay);
+    dspFirPrime(&f, 2048);
+    int16_t in[BLOCK], out[BLOCK];
+    for (int i = 0; i < BLOCK; i++) in[i] = 2048;
+    dspFirQ15(&f, in, out, BLOCK);
+    TEST_ASSERT_EQUAL_INT(2048, out[0]);
+    TEST_ASSERT_EQUAL_INT(2048, out[BLOCK - 1]);
+}
+
+// Not an assertion — reports cycles (or ns) per 64-sample block
+void test_benchmark() {
+    fillEcgLike(input, BLOCK * BLOCKS, 1500, 3500);
+    int16_t out[BLOCK];
+    int16_t delay[30];
+    DspFirQ15 fir;
+
+    dspFirInit(&fir, LOWPASS, 15, delay);
+    uint64_t t0 = cycles();
+    for (int b = 0; b < BLOCKS; b++) dspFirQ15(&fir, input + b * BLOCK, out, BLOCK);
+    uint64_t t1 = cycles();
+    for (int b = 0; b < BLOCKS; b++) dspFirQ15Ref(&fir, input + b * BLOCK, out, BLOCK);
+    uint64_t t2 = cycles();
+
+    printf("\n[DSP] cycles per %d-sample block (optimized / reference)\n", BLOCK);
+    printf("[DSP]   %-9s %7llu / %7llu\n", "fir15", (unsigned long long)((t1 - t0) / BLOCKS),
+           (unsigned long long)((t2 - t1) / BLOCKS));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fir_matches_reference);
+    RUN_TEST(test_fir_odd_tap_counts_and_saturation);
+    RUN_TEST(test_fir_unity_dc_gain);
+    RUN_TEST(test_benchmark);
+    return UNITY_END();
+}
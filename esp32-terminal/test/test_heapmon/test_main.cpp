@@ -0,0 +1,71 @@
+// Native unit tests for heapmon.cpp
+// Run with: pio test -e native
+
+#include <unity.h>
+#include "heapmon.h"
+
+void setUp() {
+    heapmonReset();
+    heapmonResetSites();
+}
+
+void tearDown() {}
+
+void test_fragmentation() {
+    TEST_ASSERT_EQUAL_UINT8(0, heapmonFragPct(100000, 100000));
+    TEST_ASSERT_EQUAL_UINT8(75, heapmonFragPct(100000, 25000));
+    TEST_ASSERT_EQUAL_UINT8(0, heapmonFragPct(0, 0));
+    TEST_ASSERT_EQUAL_UINT8(100, heapmonFragPct(4000000000u, 0));
+}
+
+void test_summary_tracks_lows_and_worst_fragmentation() {
+    heapmonSample({ 200000, 110000, 190000 });
+    heapmonSample({ 150000, 30000, 140000 });   // Fragmented
+    heapmonSample({ 180000, 100000, 140000 });  // Partly recovered
+    HeapSummary s = heapmonSummary();
+    TEST_ASSERT_EQUAL_UINT32(3, s.samples);
+    TEST_ASSERT_EQUAL_UINT32(180000, s.last.freeBytes);
+    TEST_ASSERT_EQUAL_UINT32(150000, s.minFree);
+    TEST_ASSERT_EQUAL_UINT32(30000, s.minLargest);
+    TEST_ASSERT_EQUAL_UINT8(45, s.fragPct);
+    TEST_ASSERT_EQUAL_UINT8(80, s.maxFragPct);
+}
+
+void test_sites_counted_and_ranked() {
+    for (int i = 0; i < 5; i++) heapmonCountAlloc(0x42001000, 32);
+    for (int i = 0; i < 9; i++) heapmonCountAlloc(0x42002000, 100);
+    heapmonCountAlloc(0x42003000, 4000);
+    heapmonCountAlloc(0, 10);   // Unknown caller: ignored
+
+    HeapSite top[2];
+    TEST_ASSERT_EQUAL_INT(2, heapmonTopSites(top, 2));
+    TEST_ASSERT_EQUAL_UINT32(0x42002000, (uint32_t)top[0].site);
+    TEST_ASSERT_EQUAL_UINT32(9, top[0].count);
+    TEST_ASSERT_EQUAL_UINT32(900, top[0].bytes);
+    TEST_ASSERT_EQUAL_UINT32(0x42001000, (uint32_t)top[1].site);
+
+    HeapSite all[8];
+    TEST_ASSERT_EQUAL_INT(3, heapmonTopSites(all, 8));
+    TEST_ASSERT_EQUAL_UINT32(1, all[2].count);
+}
+
+void test_full_table_counts_misses() {
+    for (uint32_t i = 0; i < HEAP_SITE_SLOTS + 5; i++) heapmonCountAlloc(0x42000000 + i * 4, 8);
+    TEST_ASSERT_EQUAL_UINT32(5, heapmonSitesMissed());
+    heapmonCountAlloc(0x42000000, 8);           // Known site still counts
+    TEST_ASSERT_EQUAL_UINT32(5, heapmonSitesMissed());
+
+    heapmonResetSites();
+    HeapSite top[1];
+    TEST_ASSERT_EQUAL_INT(0, heapmonTopSites(top, 1));
+    TEST_ASSERT_EQUAL_UINT32(0, heapmonSitesMissed());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fragmentation);
+    RUN_TEST(test_summary_tracks_lows_and_worst_fragmentation);
+    RUN_TEST(test_sites_counted_and_ranked);
+    RUN_TEST(test_full_table_counts_misses);
+    return UNITY_END();
+}
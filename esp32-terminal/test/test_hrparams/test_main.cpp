@@ -0,0 +1,75 @@
+// Native unit tests for hrparams.cpp — detector defaults against a calibrated slot
+// Run with: pio test -e native
+
+#include <unity.h>
+#include "hrparams.h"
+#include "tunables.h"
+
+static DetectorParams calibrated() {
+    DetectorParams p = { 62, 310, 280, 1850, 900, true };
+    return p;
+}
+
+void setUp() {
+    tunablesSetListener(nullptr);
+    tunablesInit();
+}
+void tearDown() {}
+
+void test_defaults_come_from_the_tunables() {
+    DetectorParams p = hrParamsDefaults();
+    TEST_ASSERT_EQUAL_UINT8(AD8232_THRESHOLD_PCT, p.thresholdPct);
+    TEST_ASSERT_EQUAL_UINT16(AD8232_MIN_RANGE, p.minRange);
+    TEST_ASSERT_EQUAL_UINT16(AD8232_REFRACTORY_MS, p.refractoryMs);
+    TEST_ASSERT_FALSE(p.learned);
+
+    tunableSet(Tunable::HR_MIN_RANGE, 420);
+    TEST_ASSERT_EQUAL_UINT16(420, hrParamsDefaults().minRange);
+}
+
+void test_uncalibrated_slot_follows_a_default_change() {
+    DetectorParams p = hrParamsDefaults();
+    tunableSet(Tunable::HR_THRESHOLD, 70);
+    TEST_ASSERT_TRUE(hrParamsDefaultsChanged(&p));
+    TEST_ASSERT_EQUAL_UINT8(70, p.thresholdPct);
+    TEST_ASSERT_EQUAL_UINT16(AD8232_MIN_RANGE, p.minRange);
+    TEST_ASSERT_FALSE(p.learned);
+
+    // Nothing new to take
+    TEST_ASSERT_FALSE(hrParamsDefaultsChanged(&p));
+}
+
+void test_calibrated_slot_keeps_its_params() {
+    DetectorParams p = calibrated();
+    tunableSet(Tunable::HR_THRESHOLD, 80);
+    tunableSet(Tunable::HR_MIN_RANGE, 600);
+    tunableSet(Tunable::HR_REFRACTORY, 500);
+    TEST_ASSERT_FALSE(hrParamsDefaultsChanged(&p));
+
+    DetectorParams want = calibrated();
+    TEST_ASSERT_EQUAL_UINT8(want.thresholdPct, p.thresholdPct);
+    TEST_ASSERT_EQUAL_UINT16(want.minRange, p.minRange);
+    TEST_ASSERT_EQUAL_UINT16(want.refractoryMs, p.refractoryMs);
+    TEST_ASSERT_EQUAL_UINT16(want.baseline, p.baseline);
+    TEST_ASSERT_EQUAL_UINT16(want.typicalRange, p.typicalRange);
+    TEST_ASSERT_TRUE(p.learned);
+}
+
+void test_only_a_calibration_is_storable() {
+    TEST_ASSERT_TRUE(hrParamsStorable(calibrated()));
+
+    // Defaults have no baseline/range to pre-warm the window with
+    TEST_ASSERT_FALSE(hrParamsStorable(hrParamsDefaults()));
+    DetectorParams p = calibrated();
+    p.typicalRange = 0;
+    TEST_ASSERT_FALSE(hrParamsStorable(p));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_defaults_come_from_the_tunables);
+    RUN_TEST(test_uncalibrated_slot_follows_a_default_change);
+    RUN_TEST(test_calibrated_slot_keeps_its_params);
+    RUN_TEST(test_only_a_calibration_is_storable);
+    return UNITY_END();
+}
@@ -0,0 +1,91 @@
+// Native unit tests for hrv.cpp — synthetic R-R sequences.
+// Run with: pio test -e native
+
+#include <unity.h>
+#include "hrv.h"
+
+static void feed(const uint32_t* rr, int n) {
+    for (int i = 0; i < n; i++) hrvAddInterval(rr[i]);
+}
+
+void setUp() { hrvReset(); }
+void tearDown() {}
+
+void test_steady_rhythm() {
+    for (int i = 0; i < 20; i++) hrvAddInterval(750);
+    HrvStats s = hrvGetStats();
+    TEST_ASSERT_EQUAL_UINT8(80, s.bpm);
+    TEST_ASSERT_EQUAL_UINT8(80, s.medianBpm);
+    TEST_ASSERT_EQUAL_UINT16(0, s.rmssd);
+    TEST_ASSERT_EQUAL_UINT16(0, s.sdnn);
+    TEST_ASSERT_EQUAL_UINT8(16, s.count);
+}
+
+void test_needs_minimum_intervals() {
+    hrvAddInterval(800);
+    hrvAddInterval(800);
+    TEST_ASSERT_EQUAL_UINT8(0, hrvGetStats().bpm);
+    hrvAddInterval(800);
+    TEST_ASSERT_EQUAL_UINT8(75, hrvGetStats().bpm);
+}
+
+void test_alternating_intervals() {
+    // 800/840 alternating: successive differences are all 40 ms, SD is 20 ms
+    for (int i = 0; i < 16; i++) hrvAddInterval(i & 1 ? 840 : 800);
+    HrvStats s = hrvGetStats();
+    TEST_ASSERT_EQUAL_UINT16(40, s.rmssd);
+    TEST_ASSERT_EQUAL_UINT16(20, s.sdnn);
+    TEST_ASSERT_EQUAL_UINT8(73, s.bpm);   // 60000 / 820
+}
+
+void test_missed_beat_rejected() {
+    const uint32_t rr[] = {750, 760, 740, 750, 1500, 750, 755, 745};
+    feed(rr, 8);
+    HrvStats s = hrvGetStats();
+    TEST_ASSERT_EQUAL_UINT16(1, s.rejected);
+    TEST_ASSERT_EQUAL_UINT8(80, s.bpm);
+    TEST_ASSERT_UINT16_WITHIN(2, 10, s.rmssd);   // chain broken across the gap, no 750 ms jump
+}
+
+void test_doubled_beat_rejected() {
+    const uint32_t rr[] = {900, 905, 895, 900, 450, 450, 900, 900};
+    feed(rr, 8);
+    HrvStats s = hrvGetStats();
+    TEST_ASSERT_EQUAL_UINT16(2, s.rejected);
+    TEST_ASSERT_EQUAL_UINT8(67, s.bpm);
+}
+
+void test_out_of_range() {
+    TEST_ASSERT_EQUAL(HrvVerdict::OUT_OF_RANGE, hrvAddInterval(150));
+    TEST_ASSERT_EQUAL(HrvVerdict::OUT_OF_RANGE, hrvAddInterval(4000));
+    TEST_ASSERT_EQUAL_UINT8(0, hrvGetStats().count);
+}
+
+void test_sustained_rate_change_accepted() {
+    // Resting 1000 ms, then a sudden sustained jump to 600 ms (exercise/startle)
+    for (int i = 0; i < 10; i++) hrvAddInterval(1000);
+    for (int i = 0; i < 8; i++) hrvAddInterval(600);
+    HrvStats s = hrvGetStats();
+    TEST_ASSERT_EQUAL_UINT8(100, s.bpm);
+    TEST_ASSERT_EQUAL_UINT8(100, s.medianBpm);
+}
+
+void test_trimmed_mean_ignores_edges() {
+    // 12 beats at 700 and a few borderline-accepted outliers within 20% of the median
+    const uint32_t rr[] = {700, 700, 700, 700, 700, 700, 830, 700, 700, 580, 700, 700};
+    feed(rr, 12);
+    TEST_ASSERT_EQUAL_UINT8(86, hrvGetStats().bpm);   // 60000 / 700
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_steady_rhythm);
+    RUN_TEST(test_needs_minimum_intervals);
+    RUN_TEST(test_alternating_intervals);
+    RUN_TEST(test_missed_beat_rejected);
+    RUN_TEST(test_doubled_beat_rejected);
+    RUN_TEST(test_out_of_range);
+    RUN_TEST(test_sustained_rate_change_accepted);
+    RUN_TEST(test_trimmed_mean_ignores_edges);
+    return UNITY_END();
+}
@@ -0,0 +1,100 @@
+// Native unit tests for latency.cpp
+// Run with: pio test -e native
+
+#include <unity.h>
+#include "latency.h"
+
+static const uint8_t VOTING = 5;
+static const uint8_t DAY = 3;
+
+void setUp() {
+    latencyReset();
+}
+
+void tearDown() {}
+
+void test_photon_from_capture_to_present() {
+    latencyInput(1000, false);
+    latencyPresented(9000, VOTING);
+    LatencyPercentiles p = latencyGet(LatencyMetric::PHOTON, VOTING);
+    TEST_ASSERT_EQUAL_UINT16(1, p.count);
+    TEST_ASSERT_EQUAL_UINT32(8000, p.p50Us);
+    TEST_ASSERT_EQUAL_UINT16(0, latencyGet(LatencyMetric::ACK, VOTING).count);
+    TEST_ASSERT_EQUAL_UINT16(0, latencyGet(LatencyMetric::PHOTON, DAY).count);
+}
+
+void test_earliest_unanswered_input_wins() {
+    latencyInput(1000, false);
+    latencyInput(4000, false);   // Second detent before the frame went out
+    latencyPresented(10000, VOTING);
+    latencyPresented(20000, VOTING);   // No input pending: not a sample
+    LatencyPercentiles p = latencyGet(LatencyMetric::PHOTON, VOTING);
+    TEST_ASSERT_EQUAL_UINT16(1, p.count);
+    TEST_ASSERT_EQUAL_UINT32(9000, p.maxUs);
+}
+
+void test_ack_only_for_inputs_sent_to_the_server() {
+    latencyInput(1000, false);
+    latencyStateArrived(5000, VOTING);
+    TEST_ASSERT_EQUAL_UINT16(0, latencyGet(LatencyMetric::ACK, VOTING).count);
+
+    latencyInput(10000, true);
+    latencyPresented(12000, VOTING);
+    latencyStateArrived(60000, VOTING);
+    TEST_ASSERT_EQUAL_UINT32(50000, latencyGet(LatencyMetric::ACK, VOTING).p50Us);
+}
+
+void test_state_sent_before_the_input_does_not_count() {
+    latencyInput(10000, true);
+    latencyStateArrived(9000, DAY);      // Was already in flight
+    latencyStateArrived(30000, DAY);
+    TEST_ASSERT_EQUAL_UINT16(1, latencyGet(LatencyMetric::ACK, DAY).count);
+    TEST_ASSERT_EQUAL_UINT32(20000, latencyGet(LatencyMetric::ACK, DAY).p50Us);
+}
+
+void test_unanswered_inputs_time_out() {
+    latencyInput(0, true);
+    latencyStateArrived(LATENCY_TIMEOUT_MS * 1000UL + 1, DAY);
+    TEST_ASSERT_EQUAL_UINT16(0, latencyGet(LatencyMetric::ACK, DAY).count);
+    TEST_ASSERT_EQUAL_UINT32(1, latencyTimeouts());
+
+    // A stale open measurement is replaced by the next input
+    latencyInput(5000000, false);
+    latencyInput(5000000 + LATENCY_TIMEOUT_MS * 1000UL + 10, false);
+    latencyPresented(5000000 + LATENCY_TIMEOUT_MS * 1000UL + 1010, DAY);
+    TEST_ASSERT_EQUAL_UINT32(1000, latencyGet(LatencyMetric::PHOTON, DAY).p50Us);
+}
+
+void test_percentiles_over_the_window() {
+    for (uint32_t i = 1; i <= 100; i++) {
+        latencyInput(i * 1000000, false);
+        latencyPresented(i * 1000000 + i * 100, VOTING);
+    }
+    // Only the last LATENCY_SAMPLES survive: 69..100 x 100 us
+    LatencyPercentiles p = latencyGet(LatencyMetric::PHOTON, VOTING);
+    TEST_ASSERT_EQUAL_UINT16(LATENCY_SAMPLES, p.count);
+    TEST_ASSERT_EQUAL_UINT32(8400, p.p50Us);
+    TEST_ASSERT_EQUAL_UINT32(9700, p.p90Us);
+    TEST_ASSERT_EQUAL_UINT32(10000, p.p99Us);
+    TEST_ASSERT_EQUAL_UINT32(10000, p.maxUs);
+}
+
+void test_survives_clock_wrap() {
+    latencyInput(0xFFFFF000u, true);
+    latencyPresented(0x00000800u, DAY);
+    latencyStateArrived(0x00001000u, DAY);
+    TEST_ASSERT_EQUAL_UINT32(0x1800, latencyGet(LatencyMetric::PHOTON, DAY).p50Us);
+    TEST_ASSERT_EQUAL_UINT32(0x2000, latencyGet(LatencyMetric::ACK, DAY).p50Us);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_photon_from_capture_to_present);
+    RUN_TEST(test_earliest_unanswered_input_wins);
+    RUN_TEST(test_ack_only_for_inputs_sent_to_the_server);
+    RUN_TEST(test_state_sent_before_the_input_does_not_count);
+    RUN_TEST(test_unanswered_inputs_time_out);
+    RUN_TEST(test_percentiles_over_the_window);
+    RUN_TEST(test_survives_clock_wrap);
+    return UNITY_END();
+}
@@ -0,0 +1,121 @@
+// Native unit tests for ledanim.cpp — keyframe sampling and the animation cache.
+// Run with: pio test -e native
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "ledanim.h"
+
+// Black -> red over 100 ms -> black over 100 ms, button level following the red channel
+static LedAnimation flash(const char* id, uint8_t loops, LedEase curve = LedEase::LINEAR) {
+    LedAnimation anim = {};
+    strncpy(anim.id, id, sizeof(anim.id) - 1);
+    anim.targets = LED_ANIM_NEOPIXEL | LED_ANIM_YES;
+    anim.loops = loops;
+    anim.count = 3;
+    anim.stops[0] = {0, 0, 0, 0, 0, LedEase::LINEAR};
+    anim.stops[1] = {100, 200, 0, 0, 200, curve};
+    anim.stops[2] = {100, 0, 0, 0, 0, curve};
+    return anim;
+}
+
+void setUp() {
+    ledAnimClear();
+}
+void tearDown() {}
+
+void test_linear_interpolation() {
+    LedAnimation anim = flash("a", 1);
+    LedAnimFrame f;
+    TEST_ASSERT_TRUE(ledAnimSample(anim, 0, &f));
+    TEST_ASSERT_EQUAL_UINT8(0, f.r);
+    TEST_ASSERT_TRUE(ledAnimSample(anim, 50, &f));
+    TEST_ASSERT_EQUAL_UINT8(100, f.r);
+    TEST_ASSERT_EQUAL_UINT8(100, f.level);
+    TEST_ASSERT_TRUE(ledAnimSample(anim, 150, &f));
+    TEST_ASSERT_EQUAL_UINT8(100, f.r);
+    TEST_ASSERT_EQUAL_UINT8(0, f.g);
+}
+
+void test_easing_curves() {
+    LedAnimFrame in, out, inOut, step;
+    LedAnimation a = flash("in", 1, LedEase::IN);
+    ledAnimSample(a, 25, &in);
+    a = flash("out", 1, LedEase::OUT);
+    ledAnimSample(a, 25, &out);
+    a = flash("io", 1, LedEase::IN_OUT);
+    ledAnimSample(a, 50, &inOut);
+    a = flash("step", 1, LedEase::STEP);
+    ledAnimSample(a, 99, &step);
+
+    TEST_ASSERT_LESS_THAN(50, in.r);          // Linear would be 50
+    TEST_ASSERT_GREATER_THAN(50, out.r);
+    TEST_ASSERT_INT_WITHIN(2, 100, inOut.r);  // Symmetric about the midpoint
+    TEST_ASSERT_EQUAL_UINT8(0, step.r);       // Holds until the segment ends
+}
+
+void test_loops_then_ends_on_last_stop() {
+    LedAnimation anim = flash("a", 2);
+    LedAnimFrame f;
+    TEST_ASSERT_TRUE(ledAnimSample(anim, 250, &f));
+    TEST_ASSERT_EQUAL_UINT8(100, f.r);        // Second loop, halfway up
+    TEST_ASSERT_FALSE(ledAnimSample(anim, 400, &f));
+    TEST_ASSERT_EQUAL_UINT8(0, f.r);
+}
+
+void test_zero_loops_repeats_forever() {
+    LedAnimation anim = flash("a", 0);
+    LedAnimFrame f;
+    TEST_ASSERT_TRUE(ledAnimSample(anim, 200000 + 50, &f));
+    TEST_ASSERT_EQUAL_UINT8(100, f.r);
+}
+
+void test_degenerate_animations_end_immediately() {
+    LedAnimation anim = {};
+    LedAnimFrame f;
+    TEST_ASSERT_FALSE(ledAnimSample(anim, 0, &f));
+    anim = flash("a", 0);
+    anim.stops[1].ms = 0;
+    anim.stops[2].ms = 0;
+    TEST_ASSERT_FALSE(ledAnimSample(anim, 0, &f));
+}
+
+void test_store_replaces_same_id() {
+    ledAnimStore(flash("a", 1));
+    ledAnimStore(flash("a", 3));
+    const LedAnimation* found = ledAnimFind("a");
+    TEST_ASSERT_NOT_NULL(found);
+    TEST_ASSERT_EQUAL_UINT8(3, found->loops);
+    TEST_ASSERT_NULL(ledAnimFind("b"));
+}
+
+void test_store_evicts_oldest_when_full() {
+    char id[LED_ANIM_ID_LEN];
+    for (int i = 0; i <= LED_ANIM_SLOTS; i++) {
+        snprintf(id, sizeof(id), "anim%d", i);
+        ledAnimStore(flash(id, 1));
+    }
+    TEST_ASSERT_NULL(ledAnimFind("anim0"));
+    TEST_ASSERT_NOT_NULL(ledAnimFind("anim1"));
+    snprintf(id, sizeof(id), "anim%d", LED_ANIM_SLOTS);
+    TEST_ASSERT_NOT_NULL(ledAnimFind(id));
+}
+
+void test_clear_forgets_everything() {
+    ledAnimStore(flash("a", 1));
+    ledAnimClear();
+    TEST_ASSERT_NULL(ledAnimFind("a"));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_linear_interpolation);
+    RUN_TEST(test_easing_curves);
+    RUN_TEST(test_loops_then_ends_on_last_stop);
+    RUN_TEST(test_zero_loops_repeats_forever);
+    RUN_TEST(test_degenerate_animations_end_immediately);
+    RUN_TEST(test_store_replaces_same_id);
+    RUN_TEST(test_store_evicts_oldest_when_full);
+    RUN_TEST(test_clear_forgets_everything);
+    return UNITY_END();
+}
@@ -0,0 +1,118 @@
+// Native unit tests for logbuf.cpp
+// Run with: pio test -e native
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "logbuf.h"
+
+static uint32_t fakeMs = 0;
+static uint32_t clockFn() { return fakeMs; }
+
+static uint8_t rec[LOG_RECORD_MAX];
+static char text[256];
+
+void setUp() {
+    logReset();
+    logSetClock(clockFn);
+    fakeMs = 1234;
+}
+
+void tearDown() {}
+
+// Pop the next record and format it
+static const char* next() {
+    int len = logPop(rec);
+    if (len == 0) return nullptr;
+    logFormat(rec, len, text, sizeof(text));
+    return text;
+}
+
+void test_formats_like_printf() {
+    char expected[256];
+    const char* name = "player-3";
+    unsigned long big = 4000000000UL;
+    snprintf(expected, sizeof(expected), "[HR] %s: %d bpm, %lu, 0x%04x, %5.1f C, %-4s|, %c 100%%",
+             name, -72, big, 0xBEEF, 41.25, "ab", 'z');
+
+    LOG_I("[HR] %s: %d bpm, %lu, 0x%04x, %5.1f C, %-4s|, %c 100%%", name, -72, big, 0xBEEF, 41.25, "ab", 'z');
+    TEST_ASSERT_EQUAL_STRING(expected, next());
+    TEST_ASSERT_EQUAL_UINT32(1234, logRecordMs(rec));
+    TEST_ASSERT_EQUAL_INT((int)LogLevel::INFO, (int)logRecordLevel(rec));
+}
+
+void test_strings_are_copied_at_log_time() {
+    char buf[16] = "before";
+    LOG_I("state %s", buf);
+    strcpy(buf, "after");
+    TEST_ASSERT_EQUAL_STRING("state before", next());
+}
+
+void test_long_strings_are_truncated() {
+    char longText[400];
+    memset(longText, 'x', sizeof(longText) - 1);
+    longText[sizeof(longText) - 1] = '\0';
+    LOG_I("Received: %s", longText);
+    const char* out = next();
+    TEST_ASSERT_EQUAL_INT(10 + LOG_STR_MAX, (int)strlen(out));
+}
+
+void test_missing_arguments_show_the_specifier() {
+    LOG_W("only %d of %d", 1);
+    TEST_ASSERT_EQUAL_STRING("only 1 of %d", next());
+}
+
+void test_records_come_out_in_order_across_the_wrap() {
+    char expected[32];
+    int popped = 0;
+    for (int i = 0; i < 1000; i++) {
+        LOG_I("record %d", i);
+        if (i % 3 == 2) {
+            // Consumer falls behind a little, then catches up
+            while (next() != nullptr) {
+                snprintf(expected, sizeof(expected), "record %d", popped++);
+                TEST_ASSERT_EQUAL_STRING(expected, text);
+            }
+        }
+    }
+    while (next() != nullptr) popped++;
+    TEST_ASSERT_EQUAL_INT(1000, popped);
+    TEST_ASSERT_EQUAL_UINT32(0, logTakeDropped());
+}
+
+void test_full_ring_drops_new_records() {
+    int written = 0;
+    while (written < LOG_RING_BYTES) {
+        LOG_I("filler %d", written);
+        written++;
+    }
+    TEST_ASSERT_TRUE(logTakeDropped() > 0);
+    TEST_ASSERT_EQUAL_UINT32(0, logTakeDropped());
+    TEST_ASSERT_EQUAL_STRING("filler 0", next());
+}
+
+void test_runtime_level_skips_records() {
+    logSetLevel(2);
+    LOG_I("info %d", 1);
+    LOG_W("warn %d", 2);
+    LOG_OUT("out %d", 3);
+    TEST_ASSERT_EQUAL_STRING("warn 2", next());
+    TEST_ASSERT_EQUAL_STRING("out 3", next());
+    TEST_ASSERT_NULL(next());
+
+    // Never above what was compiled in
+    logSetLevel(LOG_LEVEL + 1);
+    TEST_ASSERT_EQUAL_UINT8(LOG_LEVEL, logLevel());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_formats_like_printf);
+    RUN_TEST(test_strings_are_copied_at_log_time);
+    RUN_TEST(test_long_strings_are_truncated);
+    RUN_TEST(test_missing_arguments_show_the_specifier);
+    RUN_TEST(test_records_come_out_in_order_across_the_wrap);
+    RUN_TEST(test_full_ring_drops_new_records);
+    RUN_TEST(test_runtime_level_skips_records);
+    return UNITY_END();
+}
@@ -0,0 +1,158 @@
+// Native unit tests for prof.cpp — run under a fake cycle counter.
+// Run with: pio test -e native
+
+#include <unity.h>
+#include "prof.h"
+
+static uint32_t fakeCycles = 0;
+static uint32_t fakeClock() { return fakeCycles; }
+
+void setUp() {
+    fakeCycles = 1000;
+    profInit(fakeClock);
+    profSetSlowThreshold(0);
+}
+
+void tearDown() {}
+
+// A scope that takes `cycles`
+static void spend(ProfScope scope, uint32_t cycles) {
+    profEnter(scope);
+    fakeCycles += cycles;
+    profExit();
+}
+
+void test_scope_counts_and_extremes() {
+    spend(ProfScope::NETWORK, 100);
+    spend(ProfScope::NETWORK, 300);
+    const ProfStats& s = profGetStats(ProfScope::NETWORK);
+    TEST_ASSERT_EQUAL_UINT32(2, s.count);
+    TEST_ASSERT_EQUAL_UINT32(400, (uint32_t)s.sumCycles);
+    TEST_ASSERT_EQUAL_UINT32(300, s.maxCycles);
+    TEST_ASSERT_EQUAL_UINT32(0, profGetStats(ProfScope::LEDS).count);
+}
+
+void test_histogram_is_log2() {
+    spend(ProfScope::LEDS, 0);
+    spend(ProfScope::LEDS, 1);
+    spend(ProfScope::LEDS, 1023);
+    spend(ProfScope::LEDS, 1024);
+    spend(ProfScope::LEDS, 0x80000000u);
+    const ProfStats& s = profGetStats(ProfScope::LEDS);
+    TEST_ASSERT_EQUAL_UINT32(2, s.hist[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, s.hist[9]);
+    TEST_ASSERT_EQUAL_UINT32(1, s.hist[10]);
+    TEST_ASSERT_EQUAL_UINT32(1, s.hist[31]);
+    TEST_ASSERT_EQUAL_UINT32(1024, profBucketFloor(10));
+}
+
+void test_nested_scope_blames_self_time() {
+    profSetSlowThreshold(1000);
+    profLoopBegin();
+    profEnter(ProfScope::NETWORK);
+    fakeCycles += 200;
+    spend(ProfScope::DISPLAY, 1500);   // Called from inside the network scope
+    profExit();
+    ProfSlowLoop slow = {};
+    TEST_ASSERT_TRUE(profLoopEnd(&slow));
+
+    TEST_ASSERT_EQUAL_UINT32(1700, profGetStats(ProfScope::NETWORK).maxCycles);
+    TEST_ASSERT_EQUAL_INT((int)ProfScope::DISPLAY, (int)slow.culprit);
+    TEST_ASSERT_EQUAL_UINT32(1500, slow.culpritCycles);
+    TEST_ASSERT_EQUAL_UINT32(1700, slow.cycles);
+    TEST_ASSERT_EQUAL_UINT32(1, profGetStats(ProfScope::DISPLAY).slow);
+    TEST_ASSERT_EQUAL_UINT32(0, profGetStats(ProfScope::NETWORK).slow);
+}
+
+void test_unscoped_time_is_other() {
+    profSetSlowThreshold(500);
+    profLoopBegin();
+    spend(ProfScope::INPUTS, 100);
+    fakeCycles += 900;
+    ProfSlowLoop slow = {};
+    TEST_ASSERT_TRUE(profLoopEnd(&slow));
+    TEST_ASSERT_EQUAL_INT((int)ProfScope::OTHER, (int)slow.culprit);
+    TEST_ASSERT_EQUAL_UINT32(900, profGetStats(ProfScope::OTHER).maxCycles);
+    TEST_ASSERT_EQUAL_UINT32(1000, profGetStats(ProfScope::LOOP).maxCycles);
+    TEST_ASSERT_EQUAL_UINT32(1, profGetStats(ProfScope::LOOP).slow);
+}
+
+void test_fast_loop_is_not_slow() {
+    profSetSlowThreshold(500);
+    profLoopBegin();
+    spend(ProfScope::HEARTRATE, 400);
+    ProfSlowLoop slow = {};
+    TEST_ASSERT_FALSE(profLoopEnd(&slow));
+    TEST_ASSERT_EQUAL_UINT32(1, profGetStats(ProfScope::LOOP).count);
+    TEST_ASSERT_EQUAL_UINT32(0, profGetStats(ProfScope::HEARTRATE).slow);
+}
+
+void test_blame_resets_each_iteration() {
+    profSetSlowThreshold(500);
+    profLoopBegin();
+    spend(ProfScope::LEDS, 400);
+    profLoopEnd(nullptr);
+
+    profLoopBegin();
+    spend(ProfScope::LEDS, 300);
+    spend(ProfScope::NETWORK, 350);
+    ProfSlowLoop slow = {};
+    TEST_ASSERT_TRUE(profLoopEnd(&slow));
+    TEST_ASSERT_EQUAL_INT((int)ProfScope::NETWORK, (int)slow.culprit);
+}
+
+void test_survives_counter_wrap() {
+    fakeCycles = 0xFFFFFF00u;
+    spend(ProfScope::NETWORK, 0x200);
+    TEST_ASSERT_EQUAL_UINT32(0x200, profGetStats(ProfScope::NETWORK).maxCycles);
+}
+
+void test_too_deep_nesting_stays_balanced() {
+    for (int i = 0; i < PROF_MAX_DEPTH + 2; i++) profEnter(ProfScope::INPUTS);
+    fakeCycles += 10;
+    for (int i = 0; i < PROF_MAX_DEPTH + 2; i++) profExit();
+    TEST_ASSERT_EQUAL_UINT32(PROF_MAX_DEPTH, profGetStats(ProfScope::INPUTS).count);
+
+    spend(ProfScope::LEDS, 50);
+    TEST_ASSERT_EQUAL_UINT32(50, profGetStats(ProfScope::LEDS).maxCycles);
+}
+
+void test_active_scopes_innermost_first() {
+    ProfScope scopes[4];
+    uintptr_t sites[4];
+    TEST_ASSERT_EQUAL_INT(0, profActiveScopes(scopes, sites, 4));
+
+    profEnter(ProfScope::NETWORK);
+    profEnter(ProfScope::DISPLAY);
+    TEST_ASSERT_EQUAL_INT(1, profActiveScopes(scopes, sites, 1));
+    TEST_ASSERT_EQUAL_INT((int)ProfScope::DISPLAY, (int)scopes[0]);
+    TEST_ASSERT_EQUAL_INT(2, profActiveScopes(scopes, sites, 4));
+    TEST_ASSERT_EQUAL_INT((int)ProfScope::NETWORK, (int)scopes[1]);
+    TEST_ASSERT_TRUE(sites[0] != 0 && sites[1] != 0);
+    profExit();
+    profExit();
+    TEST_ASSERT_EQUAL_INT(0, profActiveScopes(scopes, sites, 4));
+}
+
+void test_reset_clears_stats() {
+    spend(ProfScope::NETWORK, 100);
+    profResetStats();
+    TEST_ASSERT_EQUAL_UINT32(0, profGetStats(ProfScope::NETWORK).count);
+    TEST_ASSERT_EQUAL_UINT32(0, profGetStats(ProfScope::NETWORK).hist[6]);
+    TEST_ASSERT_EQUAL_STRING("network", profScopeName(ProfScope::NETWORK));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_scope_counts_and_extremes);
+    RUN_TEST(test_histogram_is_log2);
+    RUN_TEST(test_nested_scope_blames_self_time);
+    RUN_TEST(test_unscoped_time_is_other);
+    RUN_TEST(test_fast_loop_is_not_slow);
+    RUN_TEST(test_blame_resets_each_iteration);
+    RUN_TEST(test_survives_counter_wrap);
+    RUN_TEST(test_too_deep_nesting_stays_balanced);
+    RUN_TEST(test_active_scopes_innermost_first);
+    RUN_TEST(test_reset_clears_stats);
+    return UNITY_END();
+}
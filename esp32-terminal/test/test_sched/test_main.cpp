@@ -0,0 +1,184 @@
+// Native unit tests for sched.cpp — run under a fake microsecond clock.
+// Run with: pio test -e native
+
+#include <unity.h>
+#include "sched.h"
+
+static uint32_t fakeNow = 0;
+static uint32_t fakeClock() { return fakeNow; }
+
+// Task bodies record their order and can take simulated time
+static char order[32];
+static int orderLen = 0;
+static uint32_t workUs = 0;
+static int rearmId = -1;
+
+static void record(char c) {
+    if (orderLen < (int)sizeof(order) - 1) order[orderLen++] = c;
+    order[orderLen] = '\0';
+    fakeNow += workUs;
+}
+static void taskA() { record('a'); }
+static void taskB() { record('b'); }
+static void taskC() { record('c'); }
+static void taskRearm() {
+    record('r');
+    schedArm(rearmId, 500);
+}
+
+// Advance the fake clock in steps, calling schedRun() the way loop() does: sleep for the
+// returned time (capped at `step` so the test also sees early wakes), then run again.
+// Releases falling exactly at the end are run.
+static void runFor(uint32_t us, uint32_t step = 1000000) {
+    uint32_t end = fakeNow + us;
+    while ((int32_t)(end - fakeNow) > 0) {
+        uint32_t idle = schedRun();
+        uint32_t sleep = idle < step ? idle : step;
+        if (sleep == 0) sleep = 1;
+        if ((int32_t)(end - fakeNow) < (int32_t)sleep) sleep = end - fakeNow;
+        fakeNow += sleep;
+    }
+    schedRun();
+}
+
+void setUp() {
+    fakeNow = 1000;
+    orderLen = 0;
+    order[0] = '\0';
+    workUs = 0;
+    schedInit(fakeClock);
+}
+void tearDown() {}
+
+void test_periodic_runs_at_its_period() {
+    int a = schedAdd("a", taskA, 4000, 0, 1);
+    runFor(40000);
+    TEST_ASSERT_EQUAL_INT(10, schedGetStats(a).runs);
+    TEST_ASSERT_EQUAL_INT(0, schedGetStats(a).overruns);
+}
+
+void test_returns_time_to_next_release() {
+    schedAdd("a", taskA, 16000, 0, 1);
+    schedAdd("b", taskB, 4000, 0, 1);
+    TEST_ASSERT_EQUAL_INT(4000, schedRun());
+    fakeNow += 4000;
+    TEST_ASSERT_EQUAL_INT(4000, schedRun());
+    TEST_ASSERT_EQUAL_STRING("b", order);
+}
+
+void test_idle_forever_with_nothing_armed() {
+    schedAdd("oneshot", taskA, 0, 0, 1);
+    TEST_ASSERT_EQUAL_INT(SCHED_IDLE_FOREVER, schedRun());
+}
+
+void test_priority_then_release_order() {
+    schedAdd("low", taskA, 0, 0, 1);
+    schedAdd("high", taskB, 0, 0, 5);
+    schedAdd("low2", taskC, 0, 0, 1);
+    schedArm(2, 0);
+    fakeNow += 10;
+    schedArm(0, 0);
+    schedArm(1, 0);
+    schedRun();
+    TEST_ASSERT_EQUAL_STRING("bca", order);
+}
+
+void test_one_shot_fires_once_and_can_be_cancelled() {
+    int a = schedAdd("a", taskA, 0, 0, 1);
+    int b = schedAdd("b", taskB, 0, 0, 1);
+    schedArm(a, 150000);
+    schedArm(b, 150000);
+    runFor(100000);
+    schedArm(a, 150000);    // Re-armed before it fired: pushed back
+    schedDisarm(b);
+    runFor(500000);
+    TEST_ASSERT_EQUAL_STRING("a", order);
+    TEST_ASSERT_EQUAL_INT(1, schedGetStats(a).runs);
+    TEST_ASSERT_EQUAL_INT(0, schedGetStats(b).runs);
+}
+
+void test_task_can_rearm_itself() {
+    rearmId = schedAdd("r", taskRearm, 0, 0, 1);
+    schedArm(rearmId, 0);
+    runFor(2200);
+    TEST_ASSERT_EQUAL_STRING("rrrrr", order);
+}
+
+void test_each_task_runs_at_most_once_per_pass() {
+    schedAdd("a", taskA, 100, 0, 1);
+    fakeNow += 1000;            // Ten periods late
+    schedRun();
+    TEST_ASSERT_EQUAL_STRING("a", order);
+}
+
+void test_overruns_and_runtime_stats() {
+    int a = schedAdd("a", taskA, 10000, 2000, 1);
+    workUs = 1000;
+    runFor(50000);
+    SchedStats s = schedGetStats(a);
+    TEST_ASSERT_EQUAL_INT(5, s.runs);
+    TEST_ASSERT_EQUAL_INT(1000, s.avgUs);
+    TEST_ASSERT_EQUAL_INT(0, s.overruns);
+
+    workUs = 3000;              // Past the 2 ms deadline
+    runFor(20000);
+    s = schedGetStats(a);
+    TEST_ASSERT_EQUAL_INT(2, s.overruns);
+    TEST_ASSERT_EQUAL_INT(3000, s.maxUs);
+
+    schedResetStats();
+    TEST_ASSERT_EQUAL_INT(0, schedGetStats(a).runs);
+}
+
+void test_falling_a_period_behind_drops_the_backlog() {
+    int a = schedAdd("a", taskA, 4000, 0, 1);
+    fakeNow += 4000;
+    schedRun();
+    fakeNow += 20000;           // Loop stalled for five periods
+    schedRun();
+    TEST_ASSERT_EQUAL_INT(4000, schedRun());
+    TEST_ASSERT_EQUAL_INT(2, schedGetStats(a).runs);
+    TEST_ASSERT_EQUAL_INT(1, schedGetStats(a).overruns);
+}
+
+void test_higher_priority_keeps_its_cadence_under_load() {
+    int hr = schedAdd("hr", taskA, 4000, 0, 3);
+    int slow = schedAdd("slow", taskB, 2000, 0, 1);
+    workUs = 500;
+    runFor(400000, 250);
+    TEST_ASSERT_EQUAL_INT(100, schedGetStats(hr).runs);
+    TEST_ASSERT_EQUAL_INT(0, schedGetStats(hr).overruns);
+    TEST_ASSERT_GREATER_OR_EQUAL(190, schedGetStats(slow).runs);
+}
+
+void test_survives_clock_wrap() {
+    fakeNow = 0xFFFFF000u;
+    int a = schedAdd("a", taskA, 1000, 0, 1);
+    runFor(10000);
+    TEST_ASSERT_EQUAL_INT(10, schedGetStats(a).runs);
+    TEST_ASSERT_EQUAL_INT(0, schedGetStats(a).overruns);
+}
+
+void test_table_full() {
+    for (int i = 0; i < schedTaskCount() + 64; i++) schedAdd("x", taskA, 1000, 0, 1);
+    TEST_ASSERT_EQUAL_INT(-1, schedAdd("x", taskA, 1000, 0, 1));
+    TEST_ASSERT_EQUAL_STRING("x", schedGetName(0));
+    TEST_ASSERT_EQUAL_STRING("", schedGetName(-1));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_periodic_runs_at_its_period);
+    RUN_TEST(test_returns_time_to_next_release);
+    RUN_TEST(test_idle_forever_with_nothing_armed);
+    RUN_TEST(test_priority_then_release_order);
+    RUN_TEST(test_one_shot_fires_once_and_can_be_cancelled);
+    RUN_TEST(test_task_can_rearm_itself);
+    RUN_TEST(test_each_task_runs_at_most_once_per_pass);
+    RUN_TEST(test_overruns_and_runtime_stats);
+    RUN_TEST(test_falling_a_period_behind_drops_the_backlog);
+    RUN_TEST(test_higher_priority_keeps_its_cadence_under_load);
+    RUN_TEST(test_survives_clock_wrap);
+    RUN_TEST(test_table_full);
+    return UNITY_END();
+}
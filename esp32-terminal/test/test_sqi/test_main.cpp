@@ -0,0 +1,76 @@
+// Native unit tests for sqi.cpp — synthetic ECG windows.
+// Run with: pio test -e native
+
+#include <unity.h>
+#include <stdlib.h>
+#include "sqi.h"
+
+// One 2 s window at 250 Hz: baseline plus a triangular R-wave every `period` samples.
+// `noise` adds uniform jitter, `wander` a slow ramp across the window.
+static void window(int amplitude, int period, int noise, int wander, int beatsAccepted = -1) {
+    for (int i = 0; i < 500; i++) {
+        int phase = i % period;
+        int r = phase < 5 ? phase * amplitude / 5 : (phase < 10 ? (10 - phase) * amplitude / 5 : 0);
+        int jitter = noise ? (rand() % (2 * noise + 1)) - noise : 0;
+        sqiAddSample(1500 + r + jitter + wander * i / 500);
+        if (phase == 5 && beatsAccepted != 0) {
+            sqiAddBeat(beatsAccepted < 0 || (i / period) % 2 == 0);
+        }
+    }
+    sqiCloseWindow();
+}
+
+void setUp() {
+    sqiReset();
+    srand(1);
+}
+void tearDown() {}
+
+void test_clean_signal_scores_high() {
+    window(1200, 200, 0, 0);
+    TEST_ASSERT_GREATER_OR_EQUAL(90, sqiGet());
+}
+
+void test_flat_line_scores_low() {
+    for (int i = 0; i < 500; i++) sqiAddSample(2048 + (i & 1));
+    sqiCloseWindow();
+    TEST_ASSERT_LESS_THAN(30, sqiGet());
+}
+
+void test_noise_lowers_quality() {
+    window(1200, 200, 0, 0);
+    uint8_t clean = sqiGet();
+    window(1200, 200, 150, 0);
+    TEST_ASSERT_LESS_THAN(clean - 15, sqiGet());
+}
+
+void test_baseline_wander_lowers_quality() {
+    window(1200, 200, 0, 0);
+    uint8_t clean = sqiGet();
+    window(1200, 200, 0, 1500);
+    TEST_ASSERT_LESS_THAN(clean - 15, sqiGet());
+}
+
+void test_irregular_beats_lower_quality() {
+    window(1200, 200, 0, 0);
+    uint8_t clean = sqiGet();
+    sqiReset();
+    window(1200, 200, 0, 0, 1);   // every other R-R rejected
+    TEST_ASSERT_LESS_THAN(clean, sqiGet());
+}
+
+void test_no_beats_in_window() {
+    window(1200, 200, 0, 0, 0);
+    TEST_ASSERT_LESS_OR_EQUAL(75, sqiGet());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_clean_signal_scores_high);
+    RUN_TEST(test_flat_line_scores_low);
+    RUN_TEST(test_noise_lowers_quality);
+    RUN_TEST(test_baseline_wander_lowers_quality);
+    RUN_TEST(test_irregular_beats_lower_quality);
+    RUN_TEST(test_no_beats_in_window);
+    return UNITY_END();
+}
@@ -0,0 +1,128 @@
+// Native unit tests for stall.cpp
+// Run with: pio test -e native
+
+#include <unity.h>
+#include <string.h>
+#include "stall.h"
+
+static StallRing storage;
+static const uint8_t SCOPES[] = { 2, 4 };        // network inside display, say
+static const uint32_t SITES[] = { 0x42001000, 0x42002000 };
+
+void setUp() {
+    memset(&storage, 0xA5, sizeof(storage));     // RTC memory after power-up
+    stallInit(&storage);
+}
+
+void tearDown() {}
+
+// Run the watchdog every STALL_CHECK_MS from `from` to `to` with the loop silent
+static const StallRecord* watch(uint32_t from, uint32_t to) {
+    const StallRecord* opened = nullptr;
+    for (uint32_t t = from; t <= to; t += STALL_CHECK_MS) {
+        const StallRecord* r = stallCheck(t, SCOPES, SITES, 2);
+        if (r) opened = r;
+    }
+    return opened;
+}
+
+void test_garbage_ring_is_cleared() {
+    TEST_ASSERT_EQUAL_INT(0, stallCount());
+    TEST_ASSERT_EQUAL_UINT32(1, stallBoot());
+    TEST_ASSERT_EQUAL_UINT32(0, stallOverwritten());
+}
+
+void test_ticking_loop_never_stalls() {
+    for (uint32_t t = 0; t < 2000; t += 5) {
+        stallFeed(t, 4);
+        TEST_ASSERT_NULL(stallCheck(t + 3, SCOPES, SITES, 2));
+    }
+    TEST_ASSERT_EQUAL_INT(0, stallCount());
+}
+
+void test_long_planned_sleep_is_not_a_stall() {
+    stallFeed(1000, 500);
+    TEST_ASSERT_NULL(watch(1000, 1000 + 500 + STALL_THRESHOLD_MS));
+}
+
+void test_stall_is_recorded_with_scopes_and_duration() {
+    stallFeed(1000, 2);
+    const StallRecord* opened = watch(1000, 1300);
+    TEST_ASSERT_NOT_NULL(opened);
+    TEST_ASSERT_EQUAL_INT(0, stallCount());       // Still open
+    TEST_ASSERT_EQUAL_UINT8(2, opened->depth);
+    TEST_ASSERT_EQUAL_UINT8(2, opened->scopes[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x42002000, opened->sites[1]);
+    TEST_ASSERT_EQUAL_UINT32(300, opened->durationMs);
+
+    stallFeed(1640, 2);                           // Loop is back
+    stallCheck(1650, nullptr, nullptr, 0);
+    TEST_ASSERT_EQUAL_INT(1, stallCount());
+    const StallRecord* r = stallGet(0);
+    TEST_ASSERT_EQUAL_UINT32(1000, r->startMs);
+    TEST_ASSERT_EQUAL_UINT32(640, r->durationMs);
+    TEST_ASSERT_EQUAL_UINT8(0, r->flags & STALL_UNFINISHED);
+}
+
+void test_stall_cut_short_by_reset_survives_it() {
+    stallFeed(1000, 2);
+    watch(1000, 5000);                            // Task watchdog fires here
+    stallInit(&storage);                          // Soft reboot, same RTC memory
+    TEST_ASSERT_EQUAL_UINT32(2, stallBoot());
+    TEST_ASSERT_EQUAL_INT(1, stallCount());
+    const StallRecord* r = stallGet(0);
+    TEST_ASSERT_EQUAL_UINT32(1, r->boot);
+    TEST_ASSERT_EQUAL_UINT32(4000, r->durationMs);
+    TEST_ASSERT_EQUAL_UINT8(STALL_UNFINISHED, r->flags & STALL_UNFINISHED);
+}
+
+void test_full_ring_keeps_the_newest() {
+    uint32_t t = 0;
+    for (int i = 0; i < STALL_RING + 3; i++) {
+        stallFeed(t, 0);
+        watch(t, t + 200);
+        t += 300;
+        stallFeed(t, 0);
+        stallCheck(t, nullptr, nullptr, 0);
+    }
+    TEST_ASSERT_EQUAL_INT(STALL_RING, stallCount());
+    TEST_ASSERT_EQUAL_UINT32(3, stallOverwritten());
+    TEST_ASSERT_EQUAL_UINT32(3, stallGet(0)->seq);
+    TEST_ASSERT_EQUAL_UINT32(STALL_RING + 2, stallGet(STALL_RING - 1)->seq);
+}
+
+void test_ack_drops_uploaded_records() {
+    for (int i = 0; i < 3; i++) {
+        uint32_t t = i * 1000;
+        stallFeed(t, 0);
+        watch(t, t + 200);
+        stallFeed(t + 300, 0);
+        stallCheck(t + 300, nullptr, nullptr, 0);
+    }
+    stallFeed(5000, 0);
+    watch(5000, 5200);                            // A fourth one, still open
+    TEST_ASSERT_EQUAL_INT(3, stallCount());
+
+    stallAck(2);
+    TEST_ASSERT_EQUAL_INT(1, stallCount());
+    TEST_ASSERT_EQUAL_UINT32(2, stallGet(0)->seq);
+    stallAck(5);                                  // Never drops the open one
+    TEST_ASSERT_EQUAL_INT(0, stallCount());
+
+    stallFeed(5400, 0);
+    stallCheck(5400, nullptr, nullptr, 0);
+    TEST_ASSERT_EQUAL_INT(1, stallCount());
+    TEST_ASSERT_EQUAL_UINT32(3, stallGet(0)->seq);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_garbage_ring_is_cleared);
+    RUN_TEST(test_ticking_loop_never_stalls);
+    RUN_TEST(test_long_planned_sleep_is_not_a_stall);
+    RUN_TEST(test_stall_is_recorded_with_scopes_and_duration);
+    RUN_TEST(test_stall_cut_short_by_reset_survives_it);
+    RUN_TEST(test_full_ring_keeps_the_newest);
+    RUN_TEST(test_ack_drops_uploaded_records);
+    return UNITY_END();
+}
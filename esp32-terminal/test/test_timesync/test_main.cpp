@@ -0,0 +1,99 @@
+// Native unit tests for timesync.cpp — offset estimation and scheduled-commit skew.
+// Run with: pio test -e native
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "timesync.h"
+
+// Stand-in server: true time t (ms since the room powered up) reads as SERVER_EPOCH + t
+// on the server and as t - boot on a terminal that booted at `boot`.
+static const uint64_t SERVER_EPOCH = 1760000000000ULL;
+static const int TERMINALS = 9;
+
+// One-way WiFi delay: a few ms of air time, and now and then a queued retry
+static uint32_t pathDelay() {
+    uint32_t d = 2 + rand() % 4;
+    if (rand() % 5 == 0) d += rand() % 80;
+    return d;
+}
+
+// Run `probes` TIME_SYNC exchanges from a terminal that booted at `boot`, starting at true time `t`
+static uint32_t syncTerminal(uint32_t boot, uint32_t t, int probes) {
+    timesyncReset();
+    for (int i = 0; i < probes; i++) {
+        uint32_t up = pathDelay();
+        uint32_t down = pathDelay();
+        uint64_t serverTime = SERVER_EPOCH + t + up;
+        timesyncAddSample(t - boot, t + up + down - boot, serverTime);
+        t += 1000;
+    }
+    return t;
+}
+
+void setUp() {
+    timesyncReset();
+    srand(7);
+}
+void tearDown() {}
+
+void test_unsynced_until_first_sample() {
+    TEST_ASSERT_FALSE(timesyncIsSynced());
+    timesyncAddSample(100, 110, SERVER_EPOCH + 105);
+    TEST_ASSERT_TRUE(timesyncIsSynced());
+    TEST_ASSERT_FALSE(timesyncIsSettled());
+    syncTerminal(0, 1000, 8);
+    TEST_ASSERT_TRUE(timesyncIsSettled());
+}
+
+void test_symmetric_path_is_exact() {
+    timesyncAddSample(1000, 1020, SERVER_EPOCH + 5010);
+    TEST_ASSERT_EQUAL_INT(20, timesyncRoundTrip());
+    TEST_ASSERT_TRUE(timesyncToServer(1010) == SERVER_EPOCH + 5010);
+    TEST_ASSERT_EQUAL_INT(1010, timesyncToLocal(SERVER_EPOCH + 5010));
+}
+
+void test_lowest_round_trip_wins() {
+    timesyncAddSample(1000, 1200, SERVER_EPOCH + 9000);   // Queued: 180 ms up, 20 down
+    timesyncAddSample(2000, 2010, SERVER_EPOCH + 6005);
+    TEST_ASSERT_EQUAL_INT(10, timesyncRoundTrip());
+    TEST_ASSERT_EQUAL_INT(3000, timesyncToLocal(SERVER_EPOCH + 7000));
+}
+
+void test_to_local_survives_millis_wrap() {
+    timesyncAddSample(0xFFFFFFF0u, 0xFFFFFFF0u + 10, SERVER_EPOCH + 5);
+    TEST_ASSERT_EQUAL_INT(89, timesyncToLocal(SERVER_EPOCH + 105));
+    TEST_ASSERT_EQUAL_INT(29, timesyncToLocal(SERVER_EPOCH + 45));
+}
+
+// The server stamps one "at" on a reveal; each terminal commits when its own millis()
+// reaches timesyncToLocal(at). Skew is the spread of those instants in true time, after
+// the 1 s probe burst that fills each terminal's sample window on connect.
+void test_cross_terminal_commit_skew() {
+    int worst = 0;
+    for (int trial = 0; trial < 50; trial++) {
+        uint32_t t = 60000 + rand() % 10000;
+        uint64_t at = SERVER_EPOCH + t + 10000 + 250;
+        int32_t first = INT32_MAX, last = INT32_MIN;
+        for (int i = 0; i < TERMINALS; i++) {
+            uint32_t boot = rand() % 30000;
+            syncTerminal(boot, t, 8);
+            int32_t commit = (int32_t)(timesyncToLocal(at) + boot);
+            if (commit < first) first = commit;
+            if (commit > last) last = commit;
+        }
+        if (last - first > worst) worst = last - first;
+    }
+    printf("cross-terminal commit skew: worst %d ms over 50 reveals x %d terminals\n", worst, TERMINALS);
+    TEST_ASSERT_LESS_OR_EQUAL(8, worst);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_unsynced_until_first_sample);
+    RUN_TEST(test_symmetric_path_is_exact);
+    RUN_TEST(test_lowest_round_trip_wins);
+    RUN_TEST(test_to_local_survives_millis_wrap);
+    RUN_TEST(test_cross_terminal_commit_skew);
+    return UNITY_END();
+}
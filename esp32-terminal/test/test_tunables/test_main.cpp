@@ -0,0 +1,83 @@
+// Native unit tests for tunables.cpp
+// Run with: pio test -e native
+
+#include <unity.h>
+#include <string.h>
+#include "tunables.h"
+
+static int changes = 0;
+static Tunable lastChanged = Tunable::COUNT;
+
+static void onChange(Tunable t) {
+    changes++;
+    lastChanged = t;
+}
+
+void setUp() {
+    tunablesSetListener(nullptr);
+    tunablesInit();
+    tunablesSetListener(onChange);
+    changes = 0;
+    lastChanged = Tunable::COUNT;
+}
+
+void tearDown() {}
+
+void test_starts_at_config_defaults() {
+    TEST_ASSERT_EQUAL_UINT32(DEBOUNCE_MS, tunableGet(Tunable::DEBOUNCE));
+    TEST_ASSERT_EQUAL_UINT32(SCROLL_SETTLE_MS, tunableGet(Tunable::SCROLL_SETTLE));
+    TEST_ASSERT_EQUAL_UINT32(AD8232_REFRACTORY_MS, tunableGet(Tunable::HR_REFRACTORY));
+    for (int i = 0; i < (int)Tunable::COUNT; i++) {
+        const TunableDef& d = tunableDef((Tunable)i);
+        TEST_ASSERT_EQUAL_UINT32(d.def, tunableGet((Tunable)i));
+        TEST_ASSERT_TRUE(d.min <= d.def && d.def <= d.max);
+        TEST_ASSERT_TRUE(strlen(d.name) <= 15);   // NVS key limit
+    }
+}
+
+void test_set_within_bounds_notifies() {
+    TEST_ASSERT_TRUE(tunableSet(Tunable::SCROLL_SETTLE, 220));
+    TEST_ASSERT_EQUAL_UINT32(220, tunableGet(Tunable::SCROLL_SETTLE));
+    TEST_ASSERT_EQUAL_INT(1, changes);
+    TEST_ASSERT_EQUAL_INT((int)Tunable::SCROLL_SETTLE, (int)lastChanged);
+
+    // Same value again: accepted, nothing to tell
+    TEST_ASSERT_TRUE(tunableSet(Tunable::SCROLL_SETTLE, 220));
+    TEST_ASSERT_EQUAL_INT(1, changes);
+}
+
+void test_out_of_bounds_is_refused() {
+    const TunableDef& d = tunableDef(Tunable::DEBOUNCE);
+    TEST_ASSERT_FALSE(tunableSet(Tunable::DEBOUNCE, d.max + 1));
+    TEST_ASSERT_FALSE(tunableSet(Tunable::DEBOUNCE, d.min - 1));
+    TEST_ASSERT_EQUAL_UINT32(DEBOUNCE_MS, tunableGet(Tunable::DEBOUNCE));
+    TEST_ASSERT_EQUAL_INT(0, changes);
+    TEST_ASSERT_TRUE(tunableSet(Tunable::DEBOUNCE, d.max));
+}
+
+void test_find_by_name() {
+    TEST_ASSERT_EQUAL_INT((int)Tunable::DEBOUNCE, tunableFind("debounceMs"));
+    TEST_ASSERT_EQUAL_INT((int)Tunable::HR_THRESHOLD, tunableFind("hrThresholdPct"));
+    TEST_ASSERT_EQUAL_INT(-1, tunableFind("debounce"));
+    TEST_ASSERT_EQUAL_INT(-1, tunableFind(""));
+}
+
+void test_reset_restores_defaults_and_notifies_changes_only() {
+    tunableSet(Tunable::LONG_PRESS, 900);
+    tunableSet(Tunable::WS_PING, 15000);
+    changes = 0;
+    tunablesResetDefaults();
+    TEST_ASSERT_EQUAL_INT(2, changes);
+    TEST_ASSERT_EQUAL_UINT32(LONG_PRESS_MS, tunableGet(Tunable::LONG_PRESS));
+    TEST_ASSERT_EQUAL_UINT32(WS_PING_MS, tunableGet(Tunable::WS_PING));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_starts_at_config_defaults);
+    RUN_TEST(test_set_within_bounds_notifies);
+    RUN_TEST(test_out_of_bounds_is_refused);
+    RUN_TEST(test_find_by_name);
+    RUN_TEST(test_reset_restores_defaults_and_notifies_changes_only);
+    return UNITY_END();
+}
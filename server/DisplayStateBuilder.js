@@ -156,7 +156,7 @@ export class DisplayStateBuilder {
     }
 
     // Priority-ordered state dispatch
-    if (phase === GamePhase.LOBBY) return this._displayLobby(getLine1)
+    if (phase === GamePhase.LOBBY) return this._displayLobby(getLine1, game)
     if (phase === GamePhase.GAME_OVER) return this._displayGameOver(getLine1)
     if (!p.isAlive && !hasActiveEvent) return this._displayDead(getLine1, ctx.dayCount, phase)
 
@@ -275,15 +275,18 @@ export class DisplayStateBuilder {
       { left: 'CALIBRATION', right: '' },
       { text: line2Text, style: DisplayStyle.NORMAL },
       { text: line3Text },
-      { yes: LedState.OFF, no: LedState.OFF },
+      // Power LED (optional, default dim) breathes while the terminal is measuring
+      { yes: LedState.OFF, no: LedState.OFF, power: LedState.PULSE },
       StatusLed.LOBBY
     )
   }
 
-  _displayLobby(getLine1) {
+  _displayLobby(getLine1, game) {
+    // Heartbeat mode: terminals show their own live ECG while waiting
+    const style = game?.heartbeatMode ? DisplayStyle.ECG : DisplayStyle.NORMAL
     return this._display(
       { left: getLine1(), right: '' },
-      { text: 'WAITING', style: DisplayStyle.NORMAL },
+      { text: 'WAITING', style },
       { text: 'Game will begin soon' },
       { yes: LedState.OFF, no: LedState.OFF },
       StatusLed.LOBBY
@@ -461,6 +461,7 @@ export class EventResolver {
     })
 
     this.game.broadcast(ServerMsg.EVENT_TIMER, { eventId, duration })
+    this.game.playLedAnimation(instance.participants, 'timerStarted')
     return { success: true }
   }
 
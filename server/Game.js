@@ -7,6 +7,17 @@ const WIN_CACHE_EMPTY = Symbol('WIN_CACHE_EMPTY');
 // Named constants for magic numbers
 const BROADCAST_DEBOUNCE_MS = 120;  // Coalesce rapid dial input broadcasts
 const LOG_MAX_ENTRIES = 500;        // Server-side log trim threshold
+const BEAT_RR_WINDOW = 16;          // R-R intervals kept for BPM/HRV in beats mode (terminal's HRV_WINDOW)
+const BEAT_BPM_REPORT_MS = 2000;    // Min spacing of derived BPM updates (matches terminal BPM mode)
+const STRESS_LN_RMSSD_CALM = 4.2;   // ln(RMSSD ms) mapped to stress 0 (~67 ms)
+const STRESS_LN_RMSSD_TENSE = 2.3;  // ln(RMSSD ms) mapped to stress 100 (~10 ms)
+const SIGNAL_QUALITY_MIN = 40;      // Terminal signal quality index below this counts as poor
+const SIGNAL_POOR_REPORTS = 3;      // Consecutive poor reports (~6 s) before auto-simulating
+const DETECTOR_CALIBRATION_MS = 25000; // Terminal detector learning, inside the 30 s resting phase
+const SYNCED_COMMIT_LEAD_MS = 300;  // Terminals hold a death reveal this long, then commit together
+const SYNCED_COMMIT_MIN_LEAD_MS = 150; // Least lead an update is stamped with (else the instant moves out)
+const TERMINAL_FRAG_WARN_PCT = 50; // Heap reports this fragmented are logged
+const TERMINAL_LOG_KEEP = 200;     // Remote log lines kept per terminal for the host
 
 import {
   GamePhase,
@@ -35,6 +46,7 @@ import { str } from './strings.js';
 import { PersistenceManager } from './PersistenceManager.js';
 import { SlideManager } from './SlideManager.js';
 import { EventResolver } from './EventResolver.js';
+import { seqGap } from './terminalFrames.js';
 import fs from 'fs';
 import { fileURLToPath } from 'url';
 import path from 'path';
@@ -49,6 +61,9 @@ export class Game {
     this.host = null; // Legacy reference (kept for handler compat)
     this.screen = null; // Legacy reference (kept for handler compat)
     this.playerCustomizations = new Map(); // Persist player names/portraits across resets
+    this._terminalHealth = new Map(); // Latest heap report per terminal (survives resets)
+    this._terminalDiag = new Map(); // Remote log level / metrics per terminal, and what came back
+    this._terminalTunables = new Map(); // Tunables the host assigned per terminal, and what they report
 
     // Sub-object managers (created before reset() since reset() calls their reset())
     this.persistence = new PersistenceManager(this);
@@ -72,6 +87,9 @@ export class Game {
     // synchronous tick schedule a single actual send on the next microtask.
     this._broadcastScheduled = false;
 
+    // Server time at which terminals commit held PLAYER_STATEs (see scheduleSyncedCommit)
+    this._commitAt = 0;
+
     this.presetRolePool = null;
 
     this.reset();
@@ -193,6 +211,7 @@ export class Game {
     // Simulated heartbeat (secret per-player fake, survives reset)
     // Don't clear _simHeartbeatState or timer on reset — these persist like calibration config
     if (!this._simHeartbeatState) this._simHeartbeatState = {};
+    this._poorSignalReports = {};
     if (this._hostSettings) this._ensureSimTimer();
 
     // Noise injection state per player (tracks recent normalized values)
@@ -1007,6 +1026,7 @@ export class Game {
     }
 
     player.kill(cause);
+    this.scheduleSyncedCommit();
     player.deathDay = this.dayCount;
     player.deathPhase = this.phase;
     this._invalidateWinCache();
@@ -1207,13 +1227,164 @@ export class Game {
     return false;
   }
 
+  // Raw waveform is only streamed for the heartbeat slide subject (the trace on screen)
+  _isWaveformNeeded(playerId) {
+    return !!playerId && this._heartrateSlidePlayerId === playerId;
+  }
+
+  // Enabled monitors use the host's report mode (per-beat by default). The rest stay on the
+  // periodic BPM report, which is what a heartbeat slide snapshots when it is pushed.
+  _heartrateMonitorPayload(playerId) {
+    const enabled = this._isHeartrateNeeded(playerId);
+    return {
+      enabled,
+      waveform: this._isWaveformNeeded(playerId),
+      report: enabled ? this._hostSettings?.heartbeatReportMode || 'beats' : 'bpm',
+    };
+  }
+
   // Tell all terminal-connected players to enable/disable their AD8232
   _broadcastHeartrateMonitor() {
     for (const player of this.players.values()) {
       if (player.terminalConnected) {
-        player.send(ServerMsg.HEARTRATE_MONITOR, { enabled: this._isHeartrateNeeded(player.id) });
+        player.send(ServerMsg.HEARTRATE_MONITOR, this._heartrateMonitorPayload(player.id));
+      }
+    }
+  }
+
+  // Binary ECG_WAVE frame from a terminal: track sequence gaps, relay to screen + host
+  ingestEcgFrame(player, frame) {
+    const ecg = player.ecg;
+    ecg.lost += seqGap(ecg.lastSeq, frame.seq);
+    ecg.lastSeq = frame.seq;
+    ecg.frames++;
+    ecg.lastUpdate = Date.now();
+
+    const trace = {
+      playerId: player.id,
+      seq: frame.seq,
+      t0: frame.t0,
+      intervalMs: frame.intervalMs,
+      samples: frame.samples,
+      lost: ecg.lost,
+    };
+    this.sendToScreen(ServerMsg.HEARTBEAT_TRACE, trace);
+    this.sendToHost(ServerMsg.HEARTBEAT_TRACE, trace);
+    return { success: true };
+  }
+
+  // Binary BEATS frame: relay R-peaks, derive BPM and HRV from recent R-R intervals.
+  // Beats mode has no periodic HEARTBEAT, so this feeds reportHeartbeat() instead.
+  ingestBeats(player, { quality, beats }) {
+    const state = player.beats;
+    // Drop beats already seen (frames may be resent after a reconnect)
+    const fresh = beats.filter((b) => b.time > state.lastTime);
+    if (fresh.length === 0) return { success: true };
+    state.lastTime = fresh[fresh.length - 1].time;
+
+    for (const b of fresh) {
+      // rr 0: unknown, or rejected as ectopic by the terminal; it also breaks the RMSSD chain
+      if (b.rr < 300 || b.rr > 2000) {
+        state.prevRr = 0;
+        continue;
+      }
+      state.rr.push(b.rr);
+      if (state.prevRr) state.diffs.push(b.rr - state.prevRr);
+      state.prevRr = b.rr;
+    }
+    if (state.rr.length > BEAT_RR_WINDOW) state.rr.splice(0, state.rr.length - BEAT_RR_WINDOW);
+    if (state.diffs.length > BEAT_RR_WINDOW) state.diffs.splice(0, state.diffs.length - BEAT_RR_WINDOW);
+
+    const relay = { playerId: player.id, beats: fresh };
+    this.sendToScreen(ServerMsg.HEARTBEAT_BEATS, relay);
+    this.sendToHost(ServerMsg.HEARTBEAT_BEATS, relay);
+
+    // Game logic still runs on BPM; throttle to the terminal's BPM-mode cadence
+    const now = Date.now();
+    if (state.rr.length === 0 || now - state.lastBpmReport < BEAT_BPM_REPORT_MS) return { success: true };
+    state.lastBpmReport = now;
+    return this.reportHeartbeat(player, { ...this._rrStats(state.rr, state.diffs), quality });
+  }
+
+  // Opt-in fallback: a persistently poor signal switches the player to a simulated heartbeat.
+  // Returns true if it did (the real report is then discarded).
+  _checkSignalQuality(player) {
+    const { quality, leadsOff } = player.heartbeat;
+    if (quality === null || leadsOff) {
+      delete this._poorSignalReports[player.id];
+      return false;
+    }
+    if (quality >= SIGNAL_QUALITY_MIN) {
+      delete this._poorSignalReports[player.id];
+      return false;
+    }
+    const count = (this._poorSignalReports[player.id] || 0) + 1;
+    this._poorSignalReports[player.id] = count;
+    if (count < SIGNAL_POOR_REPORTS || !this._hostSettings.heartbeatAutoSimulate) return false;
+    if (!this._isHeartrateNeeded(player.id)) return false;
+
+    delete this._poorSignalReports[player.id];
+    this.togglePlayerSimulated(player.id);
+    this.addLog(str('log', 'heartbeatAutoSimulated', { name: player.name }));
+    return true;
+  }
+
+  // BPM from the median interval (robust to a missed beat the terminal let through),
+  // SDNN over the window, RMSSD over successive differences of adjacent accepted beats
+  _rrStats(rr, diffs) {
+    const sorted = [...rr].sort((a, b) => a - b);
+    const mid = sorted.length >> 1;
+    const median = sorted.length % 2 ? sorted[mid] : (sorted[mid - 1] + sorted[mid]) / 2;
+    const mean = rr.reduce((a, b) => a + b, 0) / rr.length;
+    const sdnn = Math.sqrt(rr.reduce((a, b) => a + (b - mean) ** 2, 0) / rr.length);
+    const rmssd = diffs.length ? Math.sqrt(diffs.reduce((a, d) => a + d * d, 0) / diffs.length) : 0;
+    return { bpm: Math.round(60000 / median), rmssd: Math.round(rmssd), sdnn: Math.round(sdnn) };
+  }
+
+  // 0 (relaxed) - 100 (stressed) from RMSSD; vagal tone drops under acute stress
+  _stressIndex(rmssd) {
+    if (!rmssd) return null;
+    const t = (STRESS_LN_RMSSD_CALM - Math.log(rmssd)) / (STRESS_LN_RMSSD_CALM - STRESS_LN_RMSSD_TENSE);
+    return Math.round(Math.min(1, Math.max(0, t)) * 100);
+  }
+
+  // Latest BPM/HRV report from a terminal's HEARTBEAT message
+  reportHeartbeat(player, { bpm, fake, rmssd, sdnn, leadsOff, quality }) {
+    bpm = bpm || 0;
+    // Signal lost: beats-mode statistics start over with the next beats
+    if (!bpm) Object.assign(player.beats, { rr: [], diffs: [], prevRr: 0 });
+    // Don't let real sensor overwrite simulated heartbeat
+    const cal = this._hostSettings?.heartbeatCalibration?.[player.id];
+    if (cal?.simulated) {
+      // Still collect calibration samples from real sensor if calibrating
+      if (this._calibration) {
+        const tmpHeartbeat = player.heartbeat;
+        player.heartbeat = { ...tmpHeartbeat, bpm };
+        this.collectCalibrationSample(player);
+        player.heartbeat = tmpHeartbeat;
       }
+      return { success: true };
+    }
+
+    player.heartbeat = {
+      bpm,
+      active: bpm > 0,
+      fake: fake === true,
+      rmssd: rmssd || 0,
+      sdnn: sdnn || 0,
+      leadsOff: leadsOff === true,
+      quality: typeof quality === 'number' ? quality : null, // null: firmware predates the index
+      lastUpdate: Date.now(),
+    };
+    if (this._checkSignalQuality(player)) return { success: true };
+    // Collect calibration sample if calibration is active
+    if (this._calibration) {
+      this.collectCalibrationSample(player);
+      this._broadcastCalibrationState();
     }
+    this._checkHeartbeatModeSpike(player);
+    this.broadcastGameState();
+    return { success: true };
   }
 
   toggleHeartbeatMode() {
@@ -1335,6 +1506,7 @@ export class Game {
       phase: 'resting',
       playerIds: playerIds.map(String),
       samples: {},  // { playerId: { resting: [], elevated: [] } }
+      detector: {}, // { playerId: learned terminal detector params } (see recordDetectorCalibration)
       duration: 30000,
       startTime: Date.now(),
     };
@@ -1344,6 +1516,7 @@ export class Game {
     this._calibrationTimer = setTimeout(() => this._advanceCalibration(), 30000);
     this._broadcastCalibrationState();
     this._broadcastHeartrateMonitor();
+    this._sendDetectorCalibration(DETECTOR_CALIBRATION_MS);
     this.broadcastGameState();
     return { success: true };
   }
@@ -1354,6 +1527,7 @@ export class Game {
 
   stopCalibration() {
     if (this._calibrationTimer) clearTimeout(this._calibrationTimer);
+    if (this._calibration?.phase === 'resting') this._sendDetectorCalibration(0);
     this._calibration = null;
     this._calibrationTimer = null;
     this._broadcastCalibrationState();
@@ -1375,6 +1549,217 @@ export class Game {
     this.broadcastGameState();
   }
 
+  // Play a cached LED animation on the given players' terminals (sent on join, see
+  // definitions/ledAnimations.js)
+  playLedAnimation(playerIds, id) {
+    for (const playerId of playerIds) {
+      const player = this.getPlayer(playerId);
+      if (player?.terminalConnected) {
+        player.send(ServerMsg.LED_PLAY, { id });
+      }
+    }
+  }
+
+  // Ask calibrating terminals to learn their beat detector params (0 cancels a run)
+  _sendDetectorCalibration(durationMs) {
+    for (const id of this._calibration.playerIds) {
+      const player = this.getPlayer(id);
+      if (player?.terminalConnected) {
+        player.send(ServerMsg.HEARTRATE_CALIBRATE, { durationMs });
+      }
+    }
+  }
+
+  // Terminal finished a detector calibration run (params are stored on the terminal)
+  recordDetectorCalibration(player, result) {
+    const detector = result.success ? {
+      thresholdPct: result.thresholdPct,
+      minRange: result.minRange,
+      refractoryMs: result.refractoryMs,
+      beats: result.beats,
+    } : { failed: true, beats: result.beats || 0 };
+    player.detector = detector;
+    if (this._calibration?.playerIds.includes(String(player.id))) {
+      this._calibration.detector[player.id] = detector;
+      this._broadcastCalibrationState();
+    }
+    return { success: true };
+  }
+
+  // Ask terminals for a loop profile report (all connected terminals when playerId is
+  // omitted); each reply is relayed to the host as TERMINAL_PROFILE
+  requestTerminalProfile(playerId = null) {
+    let requested = 0;
+    for (const player of this.players.values()) {
+      if (playerId != null && String(player.id) !== String(playerId)) continue;
+      if (player.terminalConnected) {
+        player.send(ServerMsg.PROFILE_REQUEST, {});
+        requested++;
+      }
+    }
+    return { success: true, terminalsRequested: requested };
+  }
+
+  recordTerminalProfile(player, report) {
+    const loop = report.scopes?.find((s) => s.name === 'loop');
+    console.log(`[Profile] ${player.id}: ${report.mhz} MHz, loop avg ${loop?.avgUs ?? '?'} us, ` +
+      `max ${loop?.maxUs ?? '?'} us, ${loop?.slow ?? 0} slow`);
+    this.sendToHost(ServerMsg.TERMINAL_PROFILE, { playerId: player.id, ...report });
+    return { success: true };
+  }
+
+  // Loop stalls a terminal recorded (kept across its reboots until uploaded). Sites are
+  // code addresses for addr2line against the matching firmware build.
+  recordTerminalStalls(player, report) {
+    for (const stall of report.stalls || []) {
+      const where = stall.scopes?.length ? stall.scopes.join(' < ') : 'other';
+      const sites = (stall.sites || []).map((a) => '0x' + a.toString(16)).join(' ');
+      console.log(`[Stall] ${player.id} boot ${stall.boot}: ${stall.durationMs} ms in ${where}` +
+        (sites ? ` (${sites})` : '') + (stall.unfinished ? `, cut short by reset${stall.boot === report.boot - 1 ? ` (${report.resetReason})` : ''}` : ''));
+    }
+    this.sendToHost(ServerMsg.TERMINAL_STALLS, { playerId: player.id, ...report });
+    return { success: true };
+  }
+
+  // Periodic heap / stack report from a terminal. The latest one per terminal is kept for
+  // the fleet view; a largest free block far below free heap means fragmentation.
+  recordTerminalHealth(player, report) {
+    const health = { ...report, receivedAt: Date.now() };
+    this._terminalHealth.set(String(player.id), health);
+    if (report.maxFragPct >= TERMINAL_FRAG_WARN_PCT) {
+      console.log(`[Heap] ${player.id}: ${report.free} B free, largest block ${report.largest} B ` +
+        `(${report.fragPct}% fragmented, worst ${report.maxFragPct}%), min ever ${report.minEverFree} B`);
+    }
+    this.sendToHost(ServerMsg.TERMINAL_HEALTH, { playerId: player.id, ...health });
+    return { success: true };
+  }
+
+  getTerminalHealth() {
+    return [...this._terminalHealth].map(([playerId, health]) => ({ playerId, ...health }));
+  }
+
+  // === Remote Terminal Diagnostics ===
+
+  _terminalDiagState(playerId) {
+    const key = String(playerId);
+    if (!this._terminalDiag.has(key)) {
+      this._terminalDiag.set(key, { logLevel: 0, metrics: false, lastSeq: null, lost: 0, dropped: 0, lines: [], latest: null });
+    }
+    return this._terminalDiag.get(key);
+  }
+
+  // Sent to a terminal on every join, so a kicked or rebooted terminal picks up the
+  // setting of the player it now is (off unless the host turned it on)
+  _terminalDiagPayload(playerId) {
+    const diag = this._terminalDiag.get(String(playerId));
+    return { logLevel: diag?.logLevel || 0, metrics: !!diag?.metrics };
+  }
+
+  // Host toggles log streaming (level 1 error .. 4 debug, 0 off) and metrics for one terminal.
+  // Log lines arrive in DIAG_LOG frames, counters in DIAG_METRICS frames.
+  setTerminalDiag(playerId, { logLevel = 0, metrics = false } = {}) {
+    const player = this.getPlayer(playerId);
+    if (!player) return { success: false, error: 'Player not found' };
+    const diag = this._terminalDiagState(playerId);
+    diag.logLevel = Math.max(0, Math.min(4, Number(logLevel) || 0));
+    diag.metrics = !!metrics;
+    if (player.terminalConnected) {
+      player.send(ServerMsg.DIAG_CONFIG, this._terminalDiagPayload(playerId));
+    }
+    return { success: true };
+  }
+
+  ingestTerminalLog(player, frame) {
+    const diag = this._terminalDiagState(player.id);
+    diag.lost += seqGap(diag.lastSeq, frame.seq);
+    diag.lastSeq = frame.seq;
+    diag.dropped += frame.dropped;
+    diag.lines.push(...frame.lines);
+    if (diag.lines.length > TERMINAL_LOG_KEEP) diag.lines.splice(0, diag.lines.length - TERMINAL_LOG_KEEP);
+
+    this.sendToHost(ServerMsg.TERMINAL_LOG, {
+      playerId: player.id,
+      lines: frame.lines,
+      dropped: diag.dropped,
+      lost: diag.lost,
+    });
+    return { success: true };
+  }
+
+  ingestTerminalMetrics(player, frame) {
+    const diag = this._terminalDiagState(player.id);
+    diag.latest = { ...frame.metrics, ms: frame.ms, receivedAt: Date.now() };
+    this.sendToHost(ServerMsg.TERMINAL_METRICS, { playerId: player.id, ...diag.latest });
+    return { success: true };
+  }
+
+  // Recent lines and the latest counters, for a host that opens the view mid-game
+  getTerminalDiag(playerId) {
+    const diag = this._terminalDiag.get(String(playerId));
+    if (!diag) return null;
+    const { logLevel, metrics, lines, latest, dropped, lost } = diag;
+    return { playerId: String(playerId), logLevel, metrics, lines: [...lines], latest, dropped, lost };
+  }
+
+  // === Terminal Tunables ===
+
+  _terminalTunablesState(playerId) {
+    const key = String(playerId);
+    if (!this._terminalTunables.has(key)) {
+      this._terminalTunables.set(key, { assigned: {}, values: null, receivedAt: null });
+    }
+    return this._terminalTunables.get(key);
+  }
+
+  // Sent to a terminal on every join: what the host assigned this session (a rebooted
+  // terminal gets it back even if it was not saved). An empty set just asks for a report.
+  _terminalTunablesPayload(playerId) {
+    const tune = this._terminalTunables.get(String(playerId));
+    return { set: { ...tune?.assigned } };
+  }
+
+  // Host sets runtime tunables (esp32-terminal/src/tunables.h) on some or all terminals,
+  // e.g. to A/B a settle time across the fleet. Terminals check names and bounds and
+  // answer with tunablesReport; `save` keeps the values across reboots, `defaults` first
+  // puts everything back. No values at all reads the current ones.
+  setTerminalTunables({ playerIds = null, values = {}, save = false, defaults = false } = {}) {
+    const set = {};
+    for (const [name, value] of Object.entries(values || {})) {
+      if (typeof value === 'number') set[name] = value;
+    }
+    const ids = playerIds == null ? null : [].concat(playerIds).map(String);
+    let sent = 0;
+    for (const player of this.players.values()) {
+      if (ids && !ids.includes(String(player.id))) continue;
+      const tune = this._terminalTunablesState(player.id);
+      tune.assigned = defaults ? { ...set } : { ...tune.assigned, ...set };
+      if (player.terminalConnected) {
+        player.send(ServerMsg.TUNABLES, { set, save: !!save, defaults: !!defaults });
+        sent++;
+      }
+    }
+    return { success: true, terminalsSent: sent };
+  }
+
+  recordTerminalTunables(player, report) {
+    const tune = this._terminalTunablesState(player.id);
+    tune.values = report.values || {};
+    tune.receivedAt = Date.now();
+    // A refused value is not sent again on the next join
+    const rejected = report.rejected || [];
+    for (const name of rejected) delete tune.assigned[name];
+    if (rejected.length) console.log(`[Tune] ${player.id} rejected ${rejected.join(', ')}`);
+
+    this.sendToHost(ServerMsg.TERMINAL_TUNABLES, { playerId: player.id, ...report });
+    return { success: true };
+  }
+
+  // Last report and the host's assignment per terminal
+  getTerminalTunables() {
+    return [...this._terminalTunables].map(([playerId, { assigned, values, receivedAt }]) =>
+      ({ playerId, assigned: { ...assigned }, values, receivedAt }));
+  }
+
   collectCalibrationSample(player) {
     if (!this._calibration) return;
     if (!this._calibration.playerIds.includes(String(player.id))) return;
@@ -1523,6 +1908,7 @@ export class Game {
       startTime: this._calibration.startTime,
       duration: this._calibration.duration,
       samples: this._calibration.samples,
+      detector: this._calibration.detector,
     } : null;
     this.sendToHost(ServerMsg.CALIBRATION_STATE, state);
   }
@@ -1549,6 +1935,26 @@ export class Game {
     });
   }
 
+  // Stamp terminal PLAYER_STATEs for the next SYNCED_COMMIT_LEAD_MS with one server time,
+  // so every terminal shows the change at the same instant instead of as each message lands.
+  // Updates sent inside the window share the instant (a death cascade reveals together).
+  scheduleSyncedCommit() {
+    if (this._commitAt > Date.now()) return;
+    this._commitAt = Date.now() + SYNCED_COMMIT_LEAD_MS;
+  }
+
+  // Pending commit time for terminal PLAYER_STATEs, or undefined outside the window.
+  // An update sent late in the window could land after the instant, so with less than
+  // SYNCED_COMMIT_MIN_LEAD_MS left the instant moves out for it and what follows.
+  syncedCommitAt() {
+    const now = Date.now();
+    if (this._commitAt <= now) return undefined;
+    if (this._commitAt - now < SYNCED_COMMIT_MIN_LEAD_MS) {
+      this._commitAt = now + SYNCED_COMMIT_MIN_LEAD_MS;
+    }
+    return this._commitAt;
+  }
+
   _executeBroadcast() {
     // Send public state to each player (not host - they get host state below)
     const publicState = this.getGameState({ audience: 'public' });
@@ -1646,6 +2052,10 @@ export class Game {
         active: calEnabled ? (calEnabled && p.heartbeat.active && !stale) : (p.heartbeat.active && !stale),
         fake: isSimulated ? false : (p.heartbeat.fake ?? false),
         simulated: audience === 'host' ? isSimulated : undefined,
+        stress: audience === 'host' ? this._stressIndex(p.heartbeat.rmssd) : undefined,
+        // Reported once per contact change, so not subject to the staleness timeout
+        leadsOff: audience === 'host' ? !!(p.heartbeat.leadsOff && p.terminalConnected) : undefined,
+        quality: audience === 'host' && !stale ? p.heartbeat.quality ?? null : undefined,
       };
 
       return base;
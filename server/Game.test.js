@@ -1,9 +1,11 @@
 // server/Game.test.js
-// Integration tests for the Game state machine.
+// Integration tests for the Game state machine and its handling of terminal (ESP32) reports.
 
 import { describe, it, expect, beforeEach, vi } from 'vitest'
-import { GamePhase, Team } from '../shared/constants.js'
-import { createTestGame, startGameWithRoles } from './test/helpers.js'
+import { ClientMsg, GamePhase, LedEase, ServerMsg, SlideType, Team } from '../shared/constants.js'
+import { getAllLedAnimations } from './definitions/ledAnimations.js'
+import { createHostHandlers } from './handlers/host.js'
+import { createTestGame, mockWs, startGameWithRoles } from './test/helpers.js'
 
 vi.mock('fs', () => ({
   default: {
@@ -275,3 +277,468 @@ describe('win conditions', () => {
     expect(game.checkWinCondition()).toBeNull()
   })
 })
+
+// ─── Game.ingestEcgFrame ──────────────────────────────────────────────────────
+
+describe('Game.ingestEcgFrame', () => {
+  it('relays decoded samples to screen and host with loss count', () => {
+    const { game, spies } = createTestGame(4)
+    const player = game.getPlayer('1')
+
+    game.ingestEcgFrame(player, { seq: 0, t0: 0, intervalMs: 8, samples: [1, 2] })
+    game.ingestEcgFrame(player, { seq: 3, t0: 300, intervalMs: 8, samples: [3] })
+
+    expect(player.ecg.frames).toBe(2)
+    expect(player.ecg.lost).toBe(2)
+    expect(spies.sendToScreen).toHaveBeenLastCalledWith(ServerMsg.HEARTBEAT_TRACE,
+      expect.objectContaining({ playerId: '1', seq: 3, samples: [3], lost: 2 }))
+    expect(spies.sendToHost).toHaveBeenLastCalledWith(ServerMsg.HEARTBEAT_TRACE,
+      expect.objectContaining({ playerId: '1' }))
+  })
+
+  it('requests the waveform only for the heartbeat slide subject', () => {
+    const { game } = createTestGame(4)
+    game._heartrateSlidePlayerId = '2'
+    expect(game._heartrateMonitorPayload('2')).toMatchObject({ enabled: true, waveform: true })
+    expect(game._heartrateMonitorPayload('1')).toMatchObject({ enabled: false, waveform: false })
+  })
+})
+
+// ─── Game.ingestBeats ─────────────────────────────────────────────────────────
+
+describe('Game.ingestBeats', () => {
+  it('relays beats and derives BPM from R-R intervals', () => {
+    const { game, spies } = createTestGame(4)
+    game._hostSettings.heartbeatCalibration = {}
+    const player = game.getPlayer('1')
+    const beats = [{ time: 1000, rr: 0 }, { time: 1750, rr: 750 }, { time: 2500, rr: 750 }]
+
+    game.ingestBeats(player, { quality: 85, beats })
+
+    expect(spies.sendToScreen).toHaveBeenCalledWith(ServerMsg.HEARTBEAT_BEATS, { playerId: '1', beats })
+    expect(spies.sendToHost).toHaveBeenCalledWith(ServerMsg.HEARTBEAT_BEATS, { playerId: '1', beats })
+    expect(player.heartbeat).toMatchObject({ bpm: 80, active: true, rmssd: 0, sdnn: 0, quality: 85 })
+  })
+
+  it('computes RMSSD and SDNN, skipping rejected intervals', () => {
+    const { game } = createTestGame(4)
+    game._hostSettings.heartbeatCalibration = {}
+    const player = game.getPlayer('1')
+    // 800/840 alternate (RMSSD 40, SDNN 20); the rr 0 beat was rejected on the terminal
+    const rr = [800, 840, 800, 0, 840, 800, 840]
+    game.ingestBeats(player, { quality: 90, beats: rr.map((r, i) => ({ time: 1000 + i * 800, rr: r })) })
+
+    expect(player.beats.rr).toEqual([800, 840, 800, 840, 800, 840])
+    expect(player.beats.diffs).toEqual([40, -40, -40, 40])
+    expect(player.heartbeat).toMatchObject({ bpm: 73, rmssd: 40, sdnn: 20 })
+  })
+
+  it('ignores resent beats and implausible intervals', () => {
+    const { game, spies } = createTestGame(4)
+    const player = game.getPlayer('1')
+    game.ingestBeats(player, { quality: 90, beats: [{ time: 1000, rr: 100 }, { time: 2000, rr: 1000 }] })
+    spies.sendToScreen.mockClear()
+
+    game.ingestBeats(player, { quality: 90, beats: [{ time: 2000, rr: 1000 }] })
+
+    expect(spies.sendToScreen).not.toHaveBeenCalled()
+    expect(player.beats.rr).toEqual([1000])
+  })
+
+  it('starts the statistics over when the terminal reports the signal lost', () => {
+    const { game } = createTestGame(4)
+    game._hostSettings.heartbeatCalibration = {}
+    const player = game.getPlayer('1')
+    game.ingestBeats(player, { quality: 90, beats: [{ time: 1000, rr: 800 }, { time: 1800, rr: 800 }] })
+
+    game.reportHeartbeat(player, { bpm: 0, leadsOff: true })
+
+    expect(player.beats.rr).toEqual([])
+    expect(player.beats.prevRr).toBe(0)
+  })
+
+  it('tells terminals which report mode to use', () => {
+    const { game } = createTestGame(4)
+    game.heartbeatMode = true
+    expect(game._heartrateMonitorPayload('1').report).toBe('beats')
+    game._hostSettings.heartbeatReportMode = 'bpm'
+    expect(game._heartrateMonitorPayload('1').report).toBe('bpm')
+  })
+
+  it('keeps terminals without the monitor on BPM reports for the heartbeat slide', () => {
+    const { game } = createTestGame(4)
+    game._hostSettings.heartbeatCalibration = {}
+    const player = game.getPlayer('1')
+    player.addConnection(mockWs('terminal'))
+    expect(game._heartrateMonitorPayload('1')).toMatchObject({ enabled: false, report: 'bpm' })
+
+    game.reportHeartbeat(player, { bpm: 74 })
+    const host = createHostHandlers(game, new Set())
+    host[ClientMsg.PUSH_HEARTBEAT_SLIDE]({ clientType: 'host' }, { playerId: '1' })
+
+    expect(game.getCurrentSlide()).toMatchObject({ type: SlideType.HEARTBEAT, playerId: '1', bpm: 74 })
+    expect(game._heartrateMonitorPayload('1')).toMatchObject({ enabled: true, report: 'beats' })
+  })
+})
+
+// ─── Game.reportHeartbeat ─────────────────────────────────────────────────────
+
+describe('Game.reportHeartbeat', () => {
+  it('stores HRV and exposes a stress index to the host only', () => {
+    const { game } = createTestGame(4)
+    game._hostSettings.heartbeatCalibration = {}
+    const player = game.getPlayer('1')
+
+    game.reportHeartbeat(player, { bpm: 72, rmssd: 45, sdnn: 50 })
+
+    expect(player.heartbeat).toMatchObject({ bpm: 72, active: true, rmssd: 45, sdnn: 50 })
+    const hostView = game.getGameState({ audience: 'host' }).players.find((p) => p.id === '1')
+    const publicView = game.getGameState().players.find((p) => p.id === '1')
+    expect(hostView.heartbeat.stress).toBe(21)
+    expect(publicView.heartbeat.stress).toBeUndefined()
+  })
+
+  it('flags leads-off for the host while the terminal is connected', () => {
+    const { game } = createTestGame(2)
+    game._hostSettings.heartbeatCalibration = {}
+    const player = game.getPlayer('1')
+    const terminal = mockWs('terminal')
+    player.addConnection(terminal)
+
+    game.reportHeartbeat(player, { bpm: 0, leadsOff: true })
+    const hostView = () => game.getGameState({ audience: 'host' }).players.find((p) => p.id === '1')
+    expect(hostView().heartbeat).toMatchObject({ active: false, leadsOff: true })
+
+    terminal.readyState = 3
+    expect(hostView().heartbeat.leadsOff).toBe(false)
+  })
+
+  it('auto-simulates a player after sustained poor signal quality (opt-in)', () => {
+    const { game } = createTestGame(2)
+    game._hostSettings.heartbeatCalibration = {}
+    game._hostSettings.heartbeatAutoSimulate = true
+    game.heartbeatMode = true
+    const player = game.getPlayer('1')
+
+    game.reportHeartbeat(player, { bpm: 70, quality: 20 })
+    game.reportHeartbeat(player, { bpm: 70, quality: 90 })
+    game.reportHeartbeat(player, { bpm: 70, quality: 20 })
+    game.reportHeartbeat(player, { bpm: 70, quality: 20 })
+    expect(game._hostSettings.heartbeatCalibration['1']?.simulated).toBeFalsy()
+
+    game.reportHeartbeat(player, { bpm: 70, quality: 20 })
+    expect(game._hostSettings.heartbeatCalibration['1'].simulated).toBe(true)
+  })
+
+  it('maps low HRV to high stress and clamps the range', () => {
+    const { game } = createTestGame(1)
+    expect(game._stressIndex(120)).toBe(0)
+    expect(game._stressIndex(12)).toBe(90)
+    expect(game._stressIndex(5)).toBe(100)
+    expect(game._stressIndex(0)).toBeNull()
+  })
+})
+
+// ─── Detector calibration ─────────────────────────────────────────────────────
+
+describe('terminal detector calibration', () => {
+  it('asks calibrating terminals to learn, and cancels on early stop', () => {
+    const { game } = createTestGame(2)
+    const terminal = mockWs('terminal')
+    game.getPlayer('1').addConnection(terminal)
+
+    game.startCalibration(['1', '2'])
+    expect(terminal.send).toHaveBeenCalledWith(JSON.stringify({
+      type: ServerMsg.HEARTRATE_CALIBRATE, payload: { durationMs: 25000 },
+    }))
+
+    game.stopCalibration()
+    expect(terminal.send).toHaveBeenCalledWith(JSON.stringify({
+      type: ServerMsg.HEARTRATE_CALIBRATE, payload: { durationMs: 0 },
+    }))
+  })
+
+  it('records the learned params in the calibration state', () => {
+    const { game, spies } = createTestGame(2)
+    const player = game.getPlayer('1')
+    game.startCalibration(['1'])
+
+    game.recordDetectorCalibration(player, { success: true, thresholdPct: 70, minRange: 320, refractoryMs: 380, beats: 24 })
+
+    expect(player.detector).toEqual({ thresholdPct: 70, minRange: 320, refractoryMs: 380, beats: 24 })
+    expect(spies.sendToHost).toHaveBeenLastCalledWith(ServerMsg.CALIBRATION_STATE,
+      expect.objectContaining({ detector: { 1: player.detector } }))
+    game.stopCalibration()
+  })
+})
+
+// ─── OLED ECG scope ───────────────────────────────────────────────────────────
+
+describe('terminal ECG scope', () => {
+  it('switches the lobby display to the live trace in heartbeat mode', () => {
+    const { game } = createTestGame(2)
+    const player = game.getPlayer('1')
+    expect(player.getDisplayState(game).line2.style).toBe('normal')
+
+    game.toggleHeartbeatMode()
+    expect(player.getDisplayState(game).line2).toEqual({ text: 'WAITING', style: 'ecg' })
+  })
+})
+
+describe('terminal power LED', () => {
+  it('breathes the power LED during calibration only', () => {
+    const { game } = createTestGame(2)
+    const player = game.getPlayer('1')
+    expect(player.getDisplayState(game).leds.power).toBeUndefined()
+
+    game.startCalibration(['1'])
+    expect(player.getDisplayState(game).leds).toEqual({ yes: 'off', no: 'off', power: 'pulse' })
+    game.stopCalibration()
+  })
+})
+
+// ─── LED keyframe animations ──────────────────────────────────────────────────
+
+describe('terminal LED animations', () => {
+  it('plays an animation on terminal connections only', () => {
+    const { game } = createTestGame(2)
+    const terminal = mockWs('terminal')
+    const web = mockWs('web')
+    game.getPlayer('1').addConnection(terminal)
+    game.getPlayer('2').addConnection(web)
+
+    game.playLedAnimation(['1', '2'], 'timerStarted')
+    expect(terminal.send).toHaveBeenCalledWith(JSON.stringify({
+      type: ServerMsg.LED_PLAY, payload: { id: 'timerStarted' },
+    }))
+    expect(web.send.mock.calls.some(([msg]) => msg.includes(ServerMsg.LED_PLAY))).toBe(false)
+  })
+
+  it('defines animations that fit the terminal cache', () => {
+    for (const anim of getAllLedAnimations()) {
+      expect(anim.id.length).toBeLessThanOrEqual(15)
+      expect(anim.stops.length).toBeGreaterThan(1)
+      expect(anim.stops.length).toBeLessThanOrEqual(12)
+      for (const stop of anim.stops) {
+        expect(stop).toHaveLength(6)
+        expect(Object.values(LedEase)).toContain(stop[5])
+      }
+    }
+  })
+})
+
+// ─── Synchronized reveals ─────────────────────────────────────────────────────
+
+describe('scheduled terminal commits', () => {
+  const lastPayload = (ws) => JSON.parse(ws.send.mock.calls.at(-1)[0]).payload
+
+  it('stamps every terminal with the same commit time inside the window', () => {
+    const { game } = createTestGame(3)
+    const terminals = ['1', '2'].map((id) => {
+      const ws = mockWs('terminal')
+      game.getPlayer(id).addConnection(ws)
+      return ws
+    })
+    const web = mockWs('web')
+    game.getPlayer('3').addConnection(web)
+
+    const before = Date.now()
+    game.scheduleSyncedCommit()
+    const at = game.syncedCommitAt()
+    expect(at).toBeGreaterThanOrEqual(before + 300)
+
+    game.scheduleSyncedCommit() // A second death in the cascade keeps the first instant
+    expect(game.syncedCommitAt()).toBe(at)
+
+    for (const id of ['1', '2', '3']) game.getPlayer(id).syncState(game)
+    expect(terminals.map((ws) => lastPayload(ws).at)).toEqual([at, at])
+    expect(lastPayload(web).at).toBeUndefined()
+  })
+
+  it('gives an update sent late in the window enough lead', () => {
+    const { game } = createTestGame(2)
+    const terminal = mockWs('terminal')
+    game.getPlayer('1').addConnection(terminal)
+
+    game.scheduleSyncedCommit()
+    game._commitAt = Date.now() + 20 // Near the end of the window
+    const before = Date.now()
+    game.getPlayer('1').syncState(game)
+    const at = lastPayload(terminal).at
+    expect(at).toBeGreaterThanOrEqual(before + 150)
+    expect(game.syncedCommitAt()).toBe(at) // Later updates share the new instant
+  })
+
+  it('sends unscheduled updates once the window has passed', () => {
+    const { game } = createTestGame(2)
+    const terminal = mockWs('terminal')
+    game.getPlayer('1').addConnection(terminal)
+
+    game.scheduleSyncedCommit()
+    game._commitAt = Date.now() - 1
+    game.getPlayer('1').syncState(game)
+    expect('at' in lastPayload(terminal)).toBe(false)
+  })
+})
+
+// ─── Loop profiler ────────────────────────────────────────────────────────────
+
+describe('terminal loop profile', () => {
+  it('asks only the requested terminal for a report', () => {
+    const { game } = createTestGame(2)
+    const t1 = mockWs('terminal')
+    const t2 = mockWs('terminal')
+    game.getPlayer('1').addConnection(t1)
+    game.getPlayer('2').addConnection(t2)
+
+    expect(game.requestTerminalProfile('2')).toEqual({ success: true, terminalsRequested: 1 })
+    expect(t2.send).toHaveBeenCalledWith(JSON.stringify({ type: ServerMsg.PROFILE_REQUEST, payload: {} }))
+    expect(t1.send).not.toHaveBeenCalled()
+
+    expect(game.requestTerminalProfile().terminalsRequested).toBe(2)
+  })
+
+  it('relays reports to the host', () => {
+    const { game, spies } = createTestGame(1)
+    const report = { mhz: 240, slowUs: 4000, scopes: [{ name: 'loop', count: 10, avgUs: 90, maxUs: 5000, slow: 1, histFrom: 12, hist: [9, 1] }] }
+
+    game.recordTerminalProfile(game.getPlayer('1'), report)
+    expect(spies.sendToHost).toHaveBeenCalledWith(ServerMsg.TERMINAL_PROFILE, { playerId: '1', ...report })
+  })
+})
+
+// ─── Loop stalls ──────────────────────────────────────────────────────────────
+
+describe('terminal stall reports', () => {
+  it('relays stall records to the host', () => {
+    const { game, spies } = createTestGame(1)
+    const report = {
+      boot: 3,
+      resetReason: 'task watchdog',
+      overwritten: 0,
+      stalls: [
+        { seq: 4, boot: 2, startMs: 81234, durationMs: 5012, unfinished: true, scopes: ['network'], sites: [0x42012345] },
+        { seq: 5, boot: 3, startMs: 900, durationMs: 140, scopes: [], sites: [] },
+      ],
+    }
+
+    expect(game.recordTerminalStalls(game.getPlayer('1'), report)).toEqual({ success: true })
+    expect(spies.sendToHost).toHaveBeenCalledWith(ServerMsg.TERMINAL_STALLS, { playerId: '1', ...report })
+  })
+})
+
+// ─── Heap health ──────────────────────────────────────────────────────────────
+
+describe('terminal heap reports', () => {
+  it('relays reports to the host and keeps the latest per terminal', () => {
+    const { game, spies } = createTestGame(2)
+    const report = {
+      uptimeS: 600, free: 180000, largest: 90000, fragPct: 50,
+      minEverFree: 150000, minLargest: 80000, maxFragPct: 55,
+      stackFree: { loop: 2100, stallwd: 1800 },
+    }
+
+    expect(game.recordTerminalHealth(game.getPlayer('1'), report)).toEqual({ success: true })
+    expect(spies.sendToHost).toHaveBeenCalledWith(ServerMsg.TERMINAL_HEALTH,
+      expect.objectContaining({ playerId: '1', ...report, receivedAt: expect.any(Number) }))
+
+    game.recordTerminalHealth(game.getPlayer('1'), { ...report, free: 170000 })
+    game.recordTerminalHealth(game.getPlayer('2'), report)
+    const fleet = game.getTerminalHealth()
+    expect(fleet.map((h) => h.playerId)).toEqual(['1', '2'])
+    expect(fleet[0].free).toBe(170000)
+  })
+})
+
+// ─── Remote diagnostics ───────────────────────────────────────────────────────
+
+describe('terminal remote diagnostics', () => {
+  it('sends the setting to the terminal and on every join', () => {
+    const { game } = createTestGame(2)
+    const t1 = mockWs('terminal')
+    game.getPlayer('1').addConnection(t1)
+
+    expect(game._terminalDiagPayload('1')).toEqual({ logLevel: 0, metrics: false })
+    expect(game.setTerminalDiag('1', { logLevel: 9, metrics: true })).toEqual({ success: true })
+    expect(t1.send).toHaveBeenCalledWith(JSON.stringify({
+      type: ServerMsg.DIAG_CONFIG, payload: { logLevel: 4, metrics: true },
+    }))
+    expect(game._terminalDiagPayload('1')).toEqual({ logLevel: 4, metrics: true })
+    expect(game.setTerminalDiag('99', { logLevel: 3 }).success).toBe(false)
+  })
+
+  it('relays log lines to the host with loss counts and keeps recent ones', () => {
+    const { game, spies } = createTestGame(1)
+    const player = game.getPlayer('1')
+    const line = (i) => ({ level: 3, ms: i, text: `line ${i}` })
+
+    game.ingestTerminalLog(player, { seq: 0, dropped: 0, lines: [line(0)] })
+    game.ingestTerminalLog(player, { seq: 3, dropped: 5, lines: [line(1), line(2)] })
+    expect(spies.sendToHost).toHaveBeenLastCalledWith(ServerMsg.TERMINAL_LOG, {
+      playerId: '1', lines: [line(1), line(2)], dropped: 5, lost: 2,
+    })
+
+    for (let i = 0; i < 300; i++) game.ingestTerminalLog(player, { seq: 4 + i, dropped: 0, lines: [line(i + 3)] })
+    const diag = game.getTerminalDiag('1')
+    expect(diag.lines).toHaveLength(200)
+    expect(diag.lines[199]).toEqual(line(302))
+  })
+
+  it('relays metrics to the host and keeps the latest', () => {
+    const { game, spies } = createTestGame(1)
+    game.ingestTerminalMetrics(game.getPlayer('1'), { ms: 5000, metrics: { heapFree: 180000, wifiRssi: -60 } })
+    expect(spies.sendToHost).toHaveBeenCalledWith(ServerMsg.TERMINAL_METRICS,
+      expect.objectContaining({ playerId: '1', heapFree: 180000, wifiRssi: -60, ms: 5000 }))
+    expect(game.getTerminalDiag('1').latest.heapFree).toBe(180000)
+  })
+})
+
+// ─── Runtime tunables ─────────────────────────────────────────────────────────
+
+describe('terminal tunables', () => {
+  it('sends values to every terminal, or the ones asked for', () => {
+    const { game } = createTestGame(3)
+    const t1 = mockWs('terminal')
+    const t2 = mockWs('terminal')
+    game.getPlayer('1').addConnection(t1)
+    game.getPlayer('2').addConnection(t2)
+
+    const all = game.setTerminalTunables({ values: { debounceMs: 30, bogus: 'x' }, save: true })
+    expect(all).toEqual({ success: true, terminalsSent: 2 })
+    expect(t1.send).toHaveBeenCalledWith(JSON.stringify({
+      type: ServerMsg.TUNABLES, payload: { set: { debounceMs: 30 }, save: true, defaults: false },
+    }))
+
+    // A/B: a different settle time on terminal 2 only
+    expect(game.setTerminalTunables({ playerIds: ['2'], values: { scrollSettleMs: 250 } }).terminalsSent).toBe(1)
+    expect(game._terminalTunablesPayload('1')).toEqual({ set: { debounceMs: 30 } })
+    expect(game._terminalTunablesPayload('2')).toEqual({ set: { debounceMs: 30, scrollSettleMs: 250 } })
+    // Not connected now, but gets it on join
+    expect(game._terminalTunablesPayload('3')).toEqual({ set: { debounceMs: 30 } })
+  })
+
+  it('defaults clears what was assigned; an empty set only reads', () => {
+    const { game } = createTestGame(1)
+    game.setTerminalTunables({ values: { debounceMs: 30 } })
+    game.setTerminalTunables({ defaults: true })
+    expect(game._terminalTunablesPayload('1')).toEqual({ set: {} })
+    expect(game._terminalTunablesPayload('9')).toEqual({ set: {} })
+  })
+
+  it('relays reports to the host and stops resending rejected values', () => {
+    const { game, spies } = createTestGame(1)
+    game.setTerminalTunables({ values: { debounceMs: 30, longPressMs: 50 } })
+    const report = {
+      values: { debounceMs: { value: 30, unit: 'ms', min: 1, max: 200, default: 50 } },
+      saved: false,
+      rejected: ['longPressMs'],
+    }
+    expect(game.recordTerminalTunables(game.getPlayer('1'), report)).toEqual({ success: true })
+    expect(spies.sendToHost).toHaveBeenCalledWith(ServerMsg.TERMINAL_TUNABLES, { playerId: '1', ...report })
+    expect(game._terminalTunablesPayload('1')).toEqual({ set: { debounceMs: 30 } })
+
+    const [fleet] = game.getTerminalTunables()
+    expect(fleet.playerId).toBe('1')
+    expect(fleet.values.debounceMs.value).toBe(30)
+  })
+})
@@ -46,6 +46,8 @@ export class PersistenceManager {
       heartbeatDisplayElevated: 110,
       simsCanLose: false,
       heartbeatAddNoise: false,
+      heartbeatAutoSimulate: false, // Simulate a player's heartbeat once their signal quality stays low
+      heartbeatReportMode: 'beats', // Enabled monitors: 'beats' (per-beat R-R frames) or 'bpm' (2 s averages)
       poisonKillsGeneric: false,
       elderRecruitRole: 'child',
       elderRecruitThreshold: 2,
@@ -73,6 +73,10 @@ export class Player {
 
     // Heartbeat (from ESP32 AD8232)
     this.heartbeat = { bpm: 0, active: false, lastUpdate: 0 };
+    // Raw waveform stream bookkeeping (binary ECG_WAVE frames)
+    this.ecg = { lastSeq: null, lost: 0, frames: 0, lastUpdate: 0 };
+    this.beats = { lastTime: 0, rr: [], diffs: [], prevRr: 0, lastBpmReport: 0 };
+    this.detector = null; // Last terminal detector calibration result
 
     // Connection
     this.lastSeen = Date.now();
@@ -474,11 +478,13 @@ export class Player {
   // Terminal connections (ESP32) only receive { display } — the full private state
   // can exceed the terminal's JSON parse buffer and is not needed for rendering.
   // Web connections receive the full state as usual.
+  // `at` (server ms) asks the terminal to hold the update until then — see Game.scheduleSyncedCommit.
   syncState(game, { skipTerminalIfSelecting = false } = {}) {
     if (this.connections.length === 0) return false
 
     const fullState = this.getPrivateState(game, { forSelf: true })
     const hasTargets = fullState.display?.targetNames?.length > 0
+    const at = game.syncedCommitAt?.()
 
     let sent = false
     for (const ws of this.connections) {
@@ -487,7 +493,7 @@ export class Player {
       // player is in target selection — the terminal is completely deaf anyway.
       if (skipTerminalIfSelecting && hasTargets && ws.source === 'terminal') continue
       try {
-        const payload = ws.source === 'terminal' ? { display: fullState.display } : fullState
+        const payload = ws.source === 'terminal' ? { display: fullState.display, at } : fullState
         ws.send(JSON.stringify({ type: ServerMsg.PLAYER_STATE, payload }))
         sent = true
       } catch (err) {
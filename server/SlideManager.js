@@ -231,21 +231,16 @@ export class SlideManager {
       ? currentSlide.playerId : null
 
     if (newSlidePlayerId !== this._heartrateSlidePlayerId) {
-      // Disable previous slide subject (unless still needed by HB mode/calibration)
-      if (this._heartrateSlidePlayerId) {
-        const prev = this.game.getPlayer(this._heartrateSlidePlayerId)
-        if (prev?.terminalConnected && !this.game.heartbeatMode && !this.game._calibration) {
-          prev.send(ServerMsg.HEARTRATE_MONITOR, { enabled: false })
-        }
-      }
-      // Enable new slide subject
-      if (newSlidePlayerId) {
-        const player = this.game.getPlayer(newSlidePlayerId)
+      const prevPlayerId = this._heartrateSlidePlayerId
+      this._heartrateSlidePlayerId = newSlidePlayerId
+      // Previous subject drops its waveform stream (and the monitor, unless HB mode/calibration
+      // still needs it); new subject gets monitor + waveform for the on-screen trace
+      for (const id of [prevPlayerId, newSlidePlayerId]) {
+        const player = id && this.game.getPlayer(id)
         if (player?.terminalConnected) {
-          player.send(ServerMsg.HEARTRATE_MONITOR, { enabled: true })
+          player.send(ServerMsg.HEARTRATE_MONITOR, this.game._heartrateMonitorPayload(id))
         }
       }
-      this._heartrateSlidePlayerId = newSlidePlayerId
     }
   }
 
@@ -0,0 +1,50 @@
+// server/definitions/ledAnimations.js
+// Keyframe LED animations for terminals.
+// Sent once when a terminal joins and cached there by id; afterwards a play
+// command is just { id }, and the terminal renders every frame locally.
+
+import { LedEase } from '../../shared/constants.js';
+
+/**
+ * LED Animation Schema:
+ * {
+ *   id: string,          // Cache key on the terminal (max 15 chars)
+ *   targets: string[],   // Any of 'neopixel', 'yes', 'no'
+ *   loops: number,       // Times to play, 0 = until stopped
+ *   stops: [             // Max 12. First stop is the start value; each later stop
+ *     [ms, r, g, b, level, ease],  // is reached ms after the previous one.
+ *   ],                   // r/g/b drive the neopixel, level (0-255) the button LEDs,
+ * }                      // ease (LedEase) curves the segment ending at that stop.
+ *
+ * When an animation ends the LEDs return to their normal state.
+ */
+
+const ledAnimations = {
+  // Event timer started: three amber flashes on every LED
+  timerStarted: {
+    id: 'timerStarted',
+    targets: ['neopixel', 'yes', 'no'],
+    loops: 3,
+    stops: [
+      [0, 0, 0, 0, 0, LedEase.LINEAR],
+      [120, 255, 120, 0, 255, LedEase.OUT],
+      [280, 0, 0, 0, 0, LedEase.IN],
+    ],
+  },
+};
+
+/**
+ * Get LED animation definition by ID
+ */
+export function getLedAnimation(animationId) {
+  return ledAnimations[animationId] || null;
+}
+
+/**
+ * Get all LED animation definitions
+ */
+export function getAllLedAnimations() {
+  return Object.values(ledAnimations);
+}
+
+export { ledAnimations };
@@ -2,6 +2,7 @@
 // Handlers for initial client connections (players, host, screen).
 
 import { ClientMsg, ServerMsg } from '../../shared/constants.js'
+import { getAllLedAnimations } from '../definitions/ledAnimations.js'
 import { send } from './utils.js'
 
 export function createConnectionHandlers(game) {
@@ -26,7 +27,10 @@ export function createConnectionHandlers(game) {
           send(ws, ServerMsg.GAME_STATE, game.getGameState())
           send(ws, ServerMsg.PLAYER_STATE, existing.getPrivateState(game, { forSelf: true }))
           if (ws.source === 'terminal') {
-            send(ws, ServerMsg.HEARTRATE_MONITOR, { enabled: game._isHeartrateNeeded(playerId) })
+            send(ws, ServerMsg.HEARTRATE_MONITOR, game._heartrateMonitorPayload(playerId))
+            send(ws, ServerMsg.DIAG_CONFIG, game._terminalDiagPayload(playerId))
+            send(ws, ServerMsg.TUNABLES, game._terminalTunablesPayload(playerId))
+            for (const anim of getAllLedAnimations()) send(ws, ServerMsg.LED_ANIMATION, anim)
           }
           // Notify others of reconnection - broadcastGameState after broadcastPlayerList
           // ensures host gets role info (PLAYER_LIST only has public state)
@@ -48,7 +52,10 @@ export function createConnectionHandlers(game) {
         send(ws, ServerMsg.GAME_STATE, game.getGameState())
         send(ws, ServerMsg.PLAYER_STATE, result.player.getPrivateState(game))
         if (ws.source === 'terminal') {
-          send(ws, ServerMsg.HEARTRATE_MONITOR, { enabled: game._isHeartrateNeeded(playerId) })
+          send(ws, ServerMsg.HEARTRATE_MONITOR, game._heartrateMonitorPayload(playerId))
+          send(ws, ServerMsg.DIAG_CONFIG, game._terminalDiagPayload(playerId))
+          send(ws, ServerMsg.TUNABLES, game._terminalTunablesPayload(playerId))
+          for (const anim of getAllLedAnimations()) send(ws, ServerMsg.LED_ANIMATION, anim)
         }
       }
       // Don't send error here — handleMessage sends it from the returned result.
@@ -72,7 +79,10 @@ export function createConnectionHandlers(game) {
         send(ws, ServerMsg.GAME_STATE, game.getGameState())
         send(ws, ServerMsg.PLAYER_STATE, result.player.getPrivateState(game))
         if (ws.source === 'terminal') {
-          send(ws, ServerMsg.HEARTRATE_MONITOR, { enabled: game._isHeartrateNeeded(playerId) })
+          send(ws, ServerMsg.HEARTRATE_MONITOR, game._heartrateMonitorPayload(playerId))
+          send(ws, ServerMsg.DIAG_CONFIG, game._terminalDiagPayload(playerId))
+          send(ws, ServerMsg.TUNABLES, game._terminalTunablesPayload(playerId))
+          for (const anim of getAllLedAnimations()) send(ws, ServerMsg.LED_ANIMATION, anim)
         }
         // Notify others of reconnection - broadcastGameState after broadcastPlayerList
         // ensures host gets role info (PLAYER_LIST only has public state)
@@ -85,6 +95,12 @@ export function createConnectionHandlers(game) {
       return result
     },
 
+    // Terminal clock probe — echo its timestamp with ours (see esp32-terminal/src/timesync.cpp)
+    [ClientMsg.TIME_SYNC]: (ws, payload) => {
+      send(ws, ServerMsg.TIME_SYNC, { t: payload.t, serverTime: Date.now() })
+      return { success: true }
+    },
+
     [ClientMsg.HOST_CONNECT]: (ws) => {
       game.host = ws
       ws.clientType = 'host'
@@ -40,9 +40,9 @@ export function createHostHandlers(game, clients) {
         })
         send(client, ServerMsg.PLAYER_STATE, player.getPrivateState(game))
         if (client.source === 'terminal') {
-          send(client, ServerMsg.HEARTRATE_MONITOR, {
-            enabled: game._isHeartrateNeeded(client.playerId),
-          })
+          send(client, ServerMsg.HEARTRATE_MONITOR, game._heartrateMonitorPayload(client.playerId))
+          send(client, ServerMsg.DIAG_CONFIG, game._terminalDiagPayload(client.playerId))
+          send(client, ServerMsg.TUNABLES, game._terminalTunablesPayload(client.playerId))
         }
       }
 
@@ -237,6 +237,7 @@ export function createHostHandlers(game, clients) {
 
     [ClientMsg.SAVE_HOST_SETTINGS]: requireHost((ws, payload) => {
       game.saveHostSettings(payload)
+      if ('heartbeatReportMode' in payload) game._broadcastHeartrateMonitor()
       return { success: true }
     }),
 
@@ -339,5 +340,14 @@ export function createHostHandlers(game, clients) {
       console.log(`[Firmware] Triggered OTA update on ${updated} terminal(s)`)
       return { success: true, terminalsUpdated: updated }
     }),
+
+    [ClientMsg.REQUEST_TERMINAL_PROFILE]: requireHost((ws, payload) =>
+      game.requestTerminalProfile(payload?.playerId ?? null)),
+
+    [ClientMsg.SET_TERMINAL_DIAG]: requireHost((ws, payload) =>
+      game.setTerminalDiag(payload?.playerId, payload)),
+
+    [ClientMsg.SET_TERMINAL_TUNABLES]: requireHost((ws, payload) =>
+      game.setTerminalTunables(payload ?? {})),
   }
 }
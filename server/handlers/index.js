@@ -7,6 +7,7 @@ import { createConnectionHandlers } from './connection.js'
 import { createPlayerHandlers } from './player.js'
 import { createHostHandlers } from './host.js'
 import { createDebugHandlers } from './debug.js'
+import { createTelemetryHandlers } from './telemetry.js'
 
 export function createHandlers(game, clients) {
   return {
@@ -17,6 +18,26 @@ export function createHandlers(game, clients) {
   }
 }
 
+// Binary frames are keyed by their first byte (BinFrame type) rather than a JSON type field.
+export function createBinaryHandlers(game) {
+  return createTelemetryHandlers(game)
+}
+
+export function handleBinaryMessage(binaryHandlers, ws, data) {
+  if (data.length === 0) return
+  const handler = binaryHandlers[data[0]]
+
+  // Binary frames are fire-and-forget telemetry — never answer with an error frame,
+  // a misbehaving terminal would otherwise get a reply for every 100 ms batch.
+  if (!handler) return
+
+  try {
+    handler(ws, data)
+  } catch (e) {
+    console.error(`[Server] Error handling binary frame 0x${data[0].toString(16)}:`, e)
+  }
+}
+
 export function handleMessage(handlers, ws, message) {
   let data
   try {
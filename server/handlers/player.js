@@ -203,33 +203,42 @@ export function createPlayerHandlers(game) {
       const player = game.getPlayer(ws.playerId)
       if (!player) return { success: false, error: 'Not a player' }
 
-      // Don't let real sensor overwrite simulated heartbeat
-      const cal = game._hostSettings?.heartbeatCalibration?.[ws.playerId]
-      if (cal?.simulated) {
-        // Still collect calibration samples from real sensor if calibrating
-        if (game._calibration) {
-          const tmpHeartbeat = player.heartbeat
-          player.heartbeat = { ...tmpHeartbeat, bpm: payload.bpm || 0 }
-          game.collectCalibrationSample(player)
-          player.heartbeat = tmpHeartbeat
-        }
-        return { success: true }
-      }
+      return game.reportHeartbeat(player, payload)
+    },
 
-      player.heartbeat = {
-        bpm: payload.bpm || 0,
-        active: (payload.bpm || 0) > 0,
-        fake: payload.fake === true,
-        lastUpdate: Date.now(),
-      }
-      // Collect calibration sample if calibration is active
-      if (game._calibration) {
-        game.collectCalibrationSample(player)
-        game._broadcastCalibrationState()
-      }
-      game._checkHeartbeatModeSpike(player)
-      game.broadcastGameState()
-      return { success: true }
+    [ClientMsg.HEARTRATE_CALIBRATED]: (ws, payload) => {
+      const player = game.getPlayer(ws.playerId)
+      if (!player) return { success: false, error: 'Not a player' }
+
+      return game.recordDetectorCalibration(player, payload)
+    },
+
+    [ClientMsg.PROFILE_REPORT]: (ws, payload) => {
+      const player = game.getPlayer(ws.playerId)
+      if (!player) return { success: false, error: 'Not a player' }
+
+      return game.recordTerminalProfile(player, payload)
+    },
+
+    [ClientMsg.STALL_REPORT]: (ws, payload) => {
+      const player = game.getPlayer(ws.playerId)
+      if (!player) return { success: false, error: 'Not a player' }
+
+      return game.recordTerminalStalls(player, payload)
+    },
+
+    [ClientMsg.HEAP_REPORT]: (ws, payload) => {
+      const player = game.getPlayer(ws.playerId)
+      if (!player) return { success: false, error: 'Not a player' }
+
+      return game.recordTerminalHealth(player, payload)
+    },
+
+    [ClientMsg.TUNABLES_REPORT]: (ws, payload) => {
+      const player = game.getPlayer(ws.playerId)
+      if (!player) return { success: false, error: 'Not a player' }
+
+      return game.recordTerminalTunables(player, payload)
     },
 
     // === Operator Terminal ===
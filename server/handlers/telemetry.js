@@ -0,0 +1,49 @@
+// server/handlers/telemetry.js
+// Handlers for binary telemetry frames from ESP32 terminals, keyed by BinFrame type.
+
+import { BinFrame } from '../../shared/constants.js'
+import { decodeEcgWave, decodeBeats, decodeDiagLog, decodeDiagMetrics } from '../terminalFrames.js'
+
+export function createTelemetryHandlers(game) {
+  return {
+    [BinFrame.ECG_WAVE]: (ws, buf) => {
+      const player = game.getPlayer(ws.playerId)
+      if (!player) return { success: false, error: 'Not a player' }
+
+      const frame = decodeEcgWave(buf)
+      if (!frame) return { success: false, error: 'Malformed waveform frame' }
+
+      return game.ingestEcgFrame(player, frame)
+    },
+
+    [BinFrame.BEATS]: (ws, buf) => {
+      const player = game.getPlayer(ws.playerId)
+      if (!player) return { success: false, error: 'Not a player' }
+
+      const frame = decodeBeats(buf, Date.now())
+      if (!frame) return { success: false, error: 'Malformed beats frame' }
+
+      return game.ingestBeats(player, frame)
+    },
+
+    [BinFrame.DIAG_LOG]: (ws, buf) => {
+      const player = game.getPlayer(ws.playerId)
+      if (!player) return { success: false, error: 'Not a player' }
+
+      const frame = decodeDiagLog(buf)
+      if (!frame) return { success: false, error: 'Malformed log frame' }
+
+      return game.ingestTerminalLog(player, frame)
+    },
+
+    [BinFrame.DIAG_METRICS]: (ws, buf) => {
+      const player = game.getPlayer(ws.playerId)
+      if (!player) return { success: false, error: 'Not a player' }
+
+      const frame = decodeDiagMetrics(buf)
+      if (!frame) return { success: false, error: 'Malformed metrics frame' }
+
+      return game.ingestTerminalMetrics(player, frame)
+    },
+  }
+}
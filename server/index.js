@@ -5,7 +5,7 @@ import { createServer } from 'http';
 import { WebSocketServer } from 'ws';
 import dgram from 'dgram';
 import { Game } from './Game.js';
-import { createHandlers, handleMessage } from './handlers/index.js';
+import { createHandlers, createBinaryHandlers, handleMessage, handleBinaryMessage } from './handlers/index.js';
 import { handleFirmwareRequest } from './firmware.js';
 
 const PORT = process.env.PORT || 8080;
@@ -58,6 +58,7 @@ const game = new Game(broadcast, sendToHost, sendToScreen);
 
 // Create handlers
 const handlers = createHandlers(game, clients);
+const binaryHandlers = createBinaryHandlers(game);
 
 server.listen(PORT, () => {
   console.log(`[Server] Running on http://localhost:${PORT} (WebSocket + firmware)`);
@@ -96,7 +97,11 @@ wss.on('connection', (ws) => {
   ws.on('pong', () => { ws.isAlive = true; });
   clients.add(ws);
 
-  ws.on('message', (message) => {
+  ws.on('message', (message, isBinary) => {
+    if (isBinary) {
+      handleBinaryMessage(binaryHandlers, ws, message);
+      return;
+    }
     handleMessage(handlers, ws, message.toString());
   });
 
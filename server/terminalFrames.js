@@ -0,0 +1,144 @@
+// server/terminalFrames.js
+// Decoders for binary telemetry frames sent by ESP32 terminals.
+// Layouts are defined in esp32-terminal/src/protocol.h (BinFrame); all fields little-endian.
+
+import { BinFrame, DiagMetric } from '../shared/constants.js'
+
+const ECG_WAVE_HEADER = 11
+const DELTA_ESCAPE = -128 // 0x80 as int8
+const BEATS_HEADER = 10
+const BEATS_FLAG_SYNCED = 0x01
+const DIAG_LOG_HEADER = 5
+const DIAG_LINE_HEADER = 6
+const DIAG_METRICS_HEADER = 6
+const U32 = 0x100000000
+
+/**
+ * Decode an ECG waveform batch.
+ * [0] type [1-2] seq [3-6] t0 [7] intervalMs [8] count [9-10] first sample,
+ * then one int8 delta per sample (0x80 escapes to an absolute uint16).
+ * @param {Buffer} buf
+ * @returns {{ seq: number, t0: number, intervalMs: number, samples: number[] } | null}
+ */
+export function decodeEcgWave(buf) {
+  if (buf.length < ECG_WAVE_HEADER || buf[0] !== BinFrame.ECG_WAVE) return null
+
+  const seq = buf.readUInt16LE(1)
+  const t0 = buf.readUInt32LE(3)
+  const intervalMs = buf[7]
+  const count = buf[8]
+  if (count === 0 || intervalMs === 0) return null
+
+  const samples = new Array(count)
+  let value = buf.readUInt16LE(9)
+  samples[0] = value
+  let off = ECG_WAVE_HEADER
+  for (let i = 1; i < count; i++) {
+    if (off >= buf.length) return null
+    const delta = buf.readInt8(off++)
+    if (delta === DELTA_ESCAPE) {
+      if (off + 2 > buf.length) return null
+      value = buf.readUInt16LE(off)
+      off += 2
+    } else {
+      value += delta
+    }
+    samples[i] = value
+  }
+
+  return { seq, t0, intervalMs, samples }
+}
+
+/**
+ * Decode a batch of R-peaks.
+ * [0] type [1] flags [2] count [3-6] server time of first beat (low 32 bits)
+ * [7-8] age of first beat at send [9] signal quality 0-100, then per beat:
+ * u16 offset from first, u16 R-R (0 = unknown or rejected as ectopic by the terminal).
+ * When the terminal is not clock-synced, beat times are estimated from arrival time minus age.
+ * @param {Buffer} buf
+ * @param {number} arrivalMs - server Date.now() when the frame arrived
+ * @returns {{ quality: number, beats: { time: number, rr: number }[] } | null}
+ */
+export function decodeBeats(buf, arrivalMs) {
+  if (buf.length < BEATS_HEADER || buf[0] !== BinFrame.BEATS) return null
+
+  const flags = buf[1]
+  const count = buf[2]
+  if (count === 0 || buf.length < BEATS_HEADER + count * 4) return null
+
+  let first
+  if (flags & BEATS_FLAG_SYNCED) {
+    // Restore the high bits: pick the epoch-ms value nearest arrival with matching low 32 bits
+    const low = buf.readUInt32LE(3)
+    first = arrivalMs - (((arrivalMs % U32) - low + U32 * 1.5) % U32 - U32 / 2)
+  } else {
+    first = arrivalMs - buf.readUInt16LE(7)
+  }
+  const quality = buf[9]
+
+  const beats = new Array(count)
+  for (let i = 0; i < count; i++) {
+    const off = BEATS_HEADER + i * 4
+    beats[i] = { time: first + buf.readUInt16LE(off), rr: buf.readUInt16LE(off + 2) }
+  }
+  return { quality, beats }
+}
+
+/**
+ * Decode a batch of remote log lines.
+ * [0] type [1-2] seq [3-4] lines dropped on the terminal since the last frame,
+ * then per line: [level] [u32 terminal millis] [length] [text].
+ * @param {Buffer} buf
+ * @returns {{ seq: number, dropped: number, lines: { level: number, ms: number, text: string }[] } | null}
+ */
+export function decodeDiagLog(buf) {
+  if (buf.length < DIAG_LOG_HEADER || buf[0] !== BinFrame.DIAG_LOG) return null
+
+  const lines = []
+  let off = DIAG_LOG_HEADER
+  while (off < buf.length) {
+    if (off + DIAG_LINE_HEADER > buf.length) return null
+    const len = buf[off + 5]
+    if (off + DIAG_LINE_HEADER + len > buf.length) return null
+    lines.push({
+      level: buf[off],
+      ms: buf.readUInt32LE(off + 1),
+      text: buf.toString('utf8', off + DIAG_LINE_HEADER, off + DIAG_LINE_HEADER + len),
+    })
+    off += DIAG_LINE_HEADER + len
+  }
+  return { seq: buf.readUInt16LE(1), dropped: buf.readUInt16LE(3), lines }
+}
+
+/**
+ * Decode a terminal's diagnostic counters.
+ * [0] type [1-4] terminal millis [5] count, then per counter: [id] [u32 value].
+ * Counters are keyed by their DiagMetric name; ids this server doesn't know are skipped.
+ * @param {Buffer} buf
+ * @returns {{ ms: number, metrics: Object<string, number> } | null}
+ */
+export function decodeDiagMetrics(buf) {
+  if (buf.length < DIAG_METRICS_HEADER || buf[0] !== BinFrame.DIAG_METRICS) return null
+
+  const count = buf[5]
+  if (buf.length < DIAG_METRICS_HEADER + count * 5) return null
+
+  const metrics = {}
+  for (let i = 0; i < count; i++) {
+    const off = DIAG_METRICS_HEADER + i * 5
+    const name = DiagMetric[buf[off]]
+    if (!name) continue
+    metrics[name] = name === 'wifiRssi' ? buf.readInt32LE(off + 1) : buf.readUInt32LE(off + 1)
+  }
+  return { ms: buf.readUInt32LE(1), metrics }
+}
+
+/**
+ * Number of frames missing between two 16-bit sequence numbers.
+ * A jump larger than `maxGap` is treated as a terminal restart rather than loss.
+ */
+export function seqGap(lastSeq, seq, maxGap = 1000) {
+  if (lastSeq === null || lastSeq === undefined) return 0
+  const gap = (seq - lastSeq - 1) & 0xffff
+  return gap > maxGap ? 0 : gap
+}
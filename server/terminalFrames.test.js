@@ -0,0 +1,186 @@
+// server/terminalFrames.test.js
+// Unit tests for ESP32 binary telemetry frame decoding. Game-side handling of the
+// decoded frames and other terminal messages is covered in Game.test.js.
+
+import { describe, it, expect } from 'vitest'
+import { BinFrame, DiagMetric } from '../shared/constants.js'
+import { decodeEcgWave, decodeBeats, decodeDiagLog, decodeDiagMetrics, seqGap } from './terminalFrames.js'
+
+// Mirrors waveformPush() in esp32-terminal/src/heartrate.cpp
+function encodeEcgWave(seq, t0, intervalMs, samples) {
+  const bytes = [BinFrame.ECG_WAVE, seq & 0xff, seq >> 8,
+    t0 & 0xff, (t0 >> 8) & 0xff, (t0 >> 16) & 0xff, (t0 >>> 24) & 0xff,
+    intervalMs, samples.length, samples[0] & 0xff, samples[0] >> 8]
+  for (let i = 1; i < samples.length; i++) {
+    const delta = samples[i] - samples[i - 1]
+    if (delta > -128 && delta <= 127) bytes.push(delta & 0xff)
+    else bytes.push(0x80, samples[i] & 0xff, samples[i] >> 8)
+  }
+  return Buffer.from(bytes)
+}
+
+// Mirrors beatsFlush() in esp32-terminal/src/heartrate.cpp
+function encodeBeats(serverTime, age, beats, synced = true, quality = 90) {
+  const buf = Buffer.alloc(10 + beats.length * 4)
+  buf[0] = BinFrame.BEATS
+  buf[1] = synced ? 1 : 0
+  buf[2] = beats.length
+  buf.writeUInt32LE(synced ? serverTime % 0x100000000 : 0, 3)
+  buf.writeUInt16LE(age, 7)
+  buf[9] = quality
+  beats.forEach(([offset, rr], i) => {
+    buf.writeUInt16LE(offset, 10 + i * 4)
+    buf.writeUInt16LE(rr, 12 + i * 4)
+  })
+  return buf
+}
+
+// ─── decodeEcgWave ────────────────────────────────────────────────────────────
+
+describe('decodeEcgWave', () => {
+  it('round-trips small deltas', () => {
+    const samples = [2048, 2050, 2047, 2047, 2100, 2010]
+    const frame = decodeEcgWave(encodeEcgWave(7, 123456, 8, samples))
+    expect(frame).toEqual({ seq: 7, t0: 123456, intervalMs: 8, samples })
+  })
+
+  it('round-trips escaped jumps (R-wave upstroke)', () => {
+    const samples = [1800, 3900, 3950, 1500, 0, 4095]
+    const frame = decodeEcgWave(encodeEcgWave(65535, 0xfffffff0, 8, samples))
+    expect(frame.samples).toEqual(samples)
+    expect(frame.seq).toBe(65535)
+    expect(frame.t0).toBe(0xfffffff0)
+  })
+
+  it('accepts a single-sample frame', () => {
+    expect(decodeEcgWave(encodeEcgWave(0, 0, 8, [1234])).samples).toEqual([1234])
+  })
+
+  it('rejects truncated frames', () => {
+    const buf = encodeEcgWave(1, 0, 8, [100, 400, 401])
+    expect(decodeEcgWave(buf.subarray(0, buf.length - 1))).toBeNull()
+    expect(decodeEcgWave(buf.subarray(0, 5))).toBeNull()
+  })
+
+  it('rejects other frame types and empty batches', () => {
+    const buf = encodeEcgWave(1, 0, 8, [100])
+    buf[0] = 0x7f
+    expect(decodeEcgWave(buf)).toBeNull()
+    const empty = encodeEcgWave(1, 0, 8, [100])
+    empty[8] = 0
+    expect(decodeEcgWave(empty)).toBeNull()
+  })
+})
+
+// ─── seqGap ───────────────────────────────────────────────────────────────────
+
+describe('seqGap', () => {
+  it('is zero for the first frame and consecutive frames', () => {
+    expect(seqGap(null, 5)).toBe(0)
+    expect(seqGap(5, 6)).toBe(0)
+  })
+
+  it('counts missing frames across the 16-bit wrap', () => {
+    expect(seqGap(10, 13)).toBe(2)
+    expect(seqGap(65534, 1)).toBe(2)
+  })
+
+  it('treats a huge jump as a terminal restart', () => {
+    expect(seqGap(40000, 0)).toBe(0)
+  })
+})
+
+// ─── decodeBeats ──────────────────────────────────────────────────────────────
+
+describe('decodeBeats', () => {
+  const NOW = 1760000000000
+
+  it('restores full server timestamps from the low 32 bits', () => {
+    const first = NOW - 900
+    const frame = decodeBeats(encodeBeats(first, 900, [[0, 0], [820, 820]], true, 77), NOW)
+    expect(frame).toEqual({ quality: 77, beats: [{ time: first, rr: 0 }, { time: first + 820, rr: 820 }] })
+  })
+
+  it('handles a first beat slightly ahead of arrival (clock skew)', () => {
+    const first = NOW + 15
+    expect(decodeBeats(encodeBeats(first, 0, [[0, 700]]), NOW).beats[0].time).toBe(first)
+  })
+
+  it('falls back to arrival minus age when unsynced', () => {
+    const { beats } = decodeBeats(encodeBeats(0, 1200, [[0, 750], [750, 750]], false), NOW)
+    expect(beats.map((b) => b.time)).toEqual([NOW - 1200, NOW - 450])
+  })
+
+  it('rejects truncated and empty frames', () => {
+    const buf = encodeBeats(NOW, 0, [[0, 800], [800, 800]])
+    expect(decodeBeats(buf.subarray(0, buf.length - 2), NOW)).toBeNull()
+    expect(decodeBeats(encodeBeats(NOW, 0, []), NOW)).toBeNull()
+  })
+})
+
+// ─── Remote diagnostics ───────────────────────────────────────────────────────
+
+// Mirrors networkDiagFlush() and diagPushLine() in esp32-terminal/src
+function encodeDiagLog(seq, dropped, lines) {
+  const parts = [Buffer.from([BinFrame.DIAG_LOG, seq & 0xff, seq >> 8, dropped & 0xff, dropped >> 8])]
+  for (const { level, ms, text } of lines) {
+    const header = Buffer.alloc(6)
+    header[0] = level
+    header.writeUInt32LE(ms, 1)
+    header[5] = Buffer.byteLength(text)
+    parts.push(header, Buffer.from(text))
+  }
+  return Buffer.concat(parts)
+}
+
+// Mirrors networkSendDiagMetrics() in esp32-terminal/src/network.cpp
+function encodeDiagMetrics(ms, values) {
+  const buf = Buffer.alloc(6 + values.length * 5)
+  buf[0] = BinFrame.DIAG_METRICS
+  buf.writeUInt32LE(ms, 1)
+  buf[5] = values.length
+  values.forEach((v, id) => {
+    buf[6 + id * 5] = id
+    if (v < 0) buf.writeInt32LE(v, 7 + id * 5)
+    else buf.writeUInt32LE(v, 7 + id * 5)
+  })
+  return buf
+}
+
+describe('decodeDiagLog', () => {
+  it('round-trips a batch of lines', () => {
+    const lines = [
+      { level: 3, ms: 81234, text: 'WiFi connected. IP: 10.0.0.12' },
+      { level: 2, ms: 81300, text: '[NET] Stream over budget, 1 frames dropped' },
+    ]
+    expect(decodeDiagLog(encodeDiagLog(7, 2, lines))).toEqual({ seq: 7, dropped: 2, lines })
+  })
+
+  it('accepts a frame that only reports dropped lines', () => {
+    expect(decodeDiagLog(encodeDiagLog(1, 40, []))).toEqual({ seq: 1, dropped: 40, lines: [] })
+  })
+
+  it('rejects truncated lines and other frame types', () => {
+    const buf = encodeDiagLog(0, 0, [{ level: 3, ms: 1, text: 'hello' }])
+    expect(decodeDiagLog(buf.subarray(0, buf.length - 1))).toBeNull()
+    expect(decodeDiagLog(buf.subarray(0, 8))).toBeNull()
+    expect(decodeDiagLog(Buffer.from([BinFrame.BEATS, 0, 0, 0, 0]))).toBeNull()
+  })
+})
+
+describe('decodeDiagMetrics', () => {
+  it('names counters and keeps RSSI signed', () => {
+    const values = [180000, 90000, 150000, -67, 3, 0, 1, 0]
+    const frame = decodeDiagMetrics(encodeDiagMetrics(5000, values))
+    expect(frame.ms).toBe(5000)
+    expect(Object.keys(frame.metrics)).toEqual(DiagMetric)
+    expect(frame.metrics.heapFree).toBe(180000)
+    expect(frame.metrics.wifiRssi).toBe(-67)
+  })
+
+  it('skips counter ids from newer firmware and rejects truncated frames', () => {
+    const buf = encodeDiagMetrics(1, new Array(DiagMetric.length + 1).fill(5))
+    expect(Object.keys(decodeDiagMetrics(buf).metrics)).toHaveLength(DiagMetric.length)
+    expect(decodeDiagMetrics(buf.subarray(0, buf.length - 2))).toBeNull()
+  })
+})
@@ -9,7 +9,7 @@ import { WebSocketServer } from 'ws'
 import path from 'path'
 import { fileURLToPath } from 'url'
 import { Game } from './Game.js'
-import { createHandlers, handleMessage } from './handlers/index.js'
+import { createHandlers, createBinaryHandlers, handleMessage, handleBinaryMessage } from './handlers/index.js'
 import { firmwareRoutes } from './firmware.js'
 
 const PORT = process.env.PORT || 8080
@@ -64,11 +64,16 @@ const game = new Game(broadcast, sendToHost, sendToScreen)
 
 // Create handlers
 const handlers = createHandlers(game)
+const binaryHandlers = createBinaryHandlers(game)
 
 wss.on('connection', (ws) => {
   clients.add(ws)
 
-  ws.on('message', (message) => {
+  ws.on('message', (message, isBinary) => {
+    if (isBinary) {
+      handleBinaryMessage(binaryHandlers, ws, message)
+      return
+    }
     handleMessage(handlers, ws, message.toString())
   })
 
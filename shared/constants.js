@@ -44,6 +44,21 @@ export const ServerMsg = {
   SCORES: 'scores',
   CALIBRATION_STATE: 'calibrationState',
   HEARTRATE_MONITOR: 'heartrateMonitor',
+  HEARTBEAT_TRACE: 'heartbeatTrace', // Decoded ECG waveform batch from a terminal
+  HEARTBEAT_BEATS: 'heartbeatBeats', // Individual R-peaks (server-clock timestamps) from a terminal
+  TIME_SYNC: 'timeSync', // Reply to a terminal clock probe
+  HEARTRATE_CALIBRATE: 'heartrateCalibrate', // Terminal: learn detector params for durationMs (0 = cancel)
+  LED_ANIMATION: 'ledAnimation', // Terminal: cache a keyframe LED animation by id
+  LED_PLAY: 'ledPlay', // Terminal: play a cached LED animation ({ id: '' } stops)
+  PROFILE_REQUEST: 'profileRequest', // Terminal: send a loop profile report
+  TERMINAL_PROFILE: 'terminalProfile', // Host: a terminal's loop profile report
+  TERMINAL_STALLS: 'terminalStalls', // Host: loop stalls a terminal recorded (uploaded on connect)
+  TERMINAL_HEALTH: 'terminalHealth', // Host: a terminal's periodic heap / stack report
+  DIAG_CONFIG: 'diagConfig', // Terminal: remote log level (0 = off) and metrics on/off
+  TERMINAL_LOG: 'terminalLog', // Host: log lines streamed from a terminal
+  TERMINAL_METRICS: 'terminalMetrics', // Host: a terminal's diagnostic counters
+  TUNABLES: 'tunables', // Terminal: { set: { name: value }, save, defaults } - replies with tunablesReport
+  TERMINAL_TUNABLES: 'terminalTunables', // Host: a terminal's tunables (values, bounds, what it rejected)
   UPDATE_FIRMWARE: 'updateFirmware',
   KICKED: 'kicked',
 };
@@ -119,6 +134,12 @@ export const ClientMsg = {
 
   // Heartbeat
   HEARTBEAT: 'heartbeat',
+  TIME_SYNC: 'timeSync',
+  HEARTRATE_CALIBRATED: 'heartrateCalibrated',
+  PROFILE_REPORT: 'profileReport', // Terminal loop profiler (reply to PROFILE_REQUEST)
+  STALL_REPORT: 'stallReport', // Terminal loop-stall records
+  HEAP_REPORT: 'heapReport', // Terminal heap and stack health (every minute)
+  TUNABLES_REPORT: 'tunablesReport', // Terminal runtime tunables (reply to TUNABLES)
   PUSH_HEARTBEAT_SLIDE: 'pushHeartbeatSlide',
   TOGGLE_HEARTBEAT_MODE: 'toggleHeartbeatMode',
   TOGGLE_FAKE_HEARTBEATS: 'toggleFakeHeartbeats',
@@ -147,12 +168,36 @@ export const ClientMsg = {
 
   // Firmware
   TRIGGER_FIRMWARE_UPDATE: 'triggerFirmwareUpdate',
+  REQUEST_TERMINAL_PROFILE: 'requestTerminalProfile',
+  SET_TERMINAL_DIAG: 'setTerminalDiag', // { playerId, logLevel, metrics }
+  SET_TERMINAL_TUNABLES: 'setTerminalTunables', // { playerIds (default all), values, save, defaults }
 
   // Debug actions (only when DEBUG_MODE enabled)
   DEBUG_AUTO_SELECT: 'debugAutoSelect',
   DEBUG_AUTO_SELECT_ALL: 'debugAutoSelectAll',
 };
 
+// Binary frame types - ESP32 terminal -> Server (byte 0 of a binary WebSocket frame)
+// Mirrors BinFrame in esp32-terminal/src/protocol.h
+export const BinFrame = {
+  ECG_WAVE: 0x01,
+  BEATS: 0x02,
+  DIAG_LOG: 0x03,
+  DIAG_METRICS: 0x04,
+};
+
+// Counter ids in a DIAG_METRICS frame - mirrors DiagMetric in esp32-terminal/src/diag.h
+export const DiagMetric = [
+  'heapFree',
+  'heapLargest',
+  'heapMinEver',
+  'wifiRssi',
+  'streamDropped',
+  'diagDropped',
+  'latencyTimeouts',
+  'stalls',
+];
+
 export const SlideType = {
   TITLE: 'title',
   PLAYER_REVEAL: 'playerReveal',
@@ -322,6 +367,16 @@ export const LedState = {
   OFF: 'off',
   DIM: 'dim',
   BRIGHT: 'bright',
+  PULSE: 'pulse', // Terminal breathes the LED on its hardware fader
+};
+
+// Keyframe easing for LED animations (matches LedEase in esp32-terminal/src/ledanim.h)
+export const LedEase = {
+  LINEAR: 0,
+  IN: 1,
+  OUT: 2,
+  IN_OUT: 3,
+  STEP: 4,
 };
 
 // Status LED states for neopixel (game state indicator)
@@ -352,6 +407,7 @@ export const DisplayStyle = {
   ABSTAINED: 'abstained',
   WAITING: 'waiting',
   CRITICAL: 'critical',
+  ECG: 'ecg', // Terminal OLED draws a live trace in place of line 2 (web shows the text)
 };
 
 // Operator terminal word library
@@ -342,7 +342,11 @@ export const STRING_CATALOG = [
   { cat: "host", key: "calibration.recommend", default: "Recommend", tags: ["heartbeat","calibration"], desc: "Button to auto-set recommended display range values" },
   { cat: "host", key: "calibration.simsCanLose", default: "Sims lose?", tags: ["heartbeat","calibration"], desc: "Toggle whether simulated heartbeats can spike over threshold and lose votes" },
   { cat: "host", key: "calibration.addNoise", default: "Add noise?", tags: ["heartbeat","calibration"], desc: "Toggle jitter on stable heartbeat values so the number dances instead of sitting flat" },
+  { cat: "host", key: "calibration.autoSimulate", default: "Simulate on bad signal?", tags: ["heartbeat","calibration"], desc: "Toggle automatically simulating a player's heartbeat when their sensor signal quality stays low" },
+  { cat: "host", key: "calibration.detectorFailed", default: "Terminal could not tune its beat detector (too few beats) — check electrodes", tags: ["heartbeat","calibration"], desc: "Tooltip when a terminal's on-device detector calibration failed" },
+  { cat: "host", key: "calibration.qualityHint", default: "Live BPM · signal quality (0-100%)", tags: ["heartbeat","calibration"], desc: "Tooltip on the live BPM column explaining the signal quality figure" },
   { cat: "log", key: "calibrationSaved", default: "Heartbeat calibration saved for {count} player(s)", tokens: ["{count}"], tags: ["heartbeat","calibration"], desc: "Log when calibration is saved" },
+  { cat: "log", key: "heartbeatAutoSimulated", default: "{name}'s sensor signal is poor — heartbeat now simulated", tokens: ["{name}"], tags: ["heartbeat"], desc: "Log when a player is switched to a simulated heartbeat because of low signal quality" },
   { cat: "landing", key: "title", default: "BIG TIME MURDER", desc: "Main title on the landing page" },
   { cat: "landing", key: "tagline", default: "A social deduction game", desc: "Subtitle tagline on landing page" },
   { cat: "landing", key: "connected", default: "● Connected", desc: "Server connection status — connected" },
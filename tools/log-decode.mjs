@@ -0,0 +1,153 @@
+// tools/log-decode.mjs
+// Decodes a terminal's binary log stream (firmware built with LOG_BINARY=1, see logbuf.h)
+// Records carry the format string's flash address; the firmware ELF turns it back into text.
+// Plain text on the stream (boot ROM output, "[Log] N records dropped") passes through.
+// Usage: node tools/log-decode.mjs <firmware.elf> [capture.bin] [--ms]
+//        (reads stdin when no capture is given, e.g. piped from a serial reader)
+
+import { readFileSync, createReadStream } from 'fs'
+
+const RECORD_MARK = 0x1E
+const HEADER = 10                 // length, level, format address (4), ms (4)
+const LEVELS = { 0: '', 1: 'E', 2: 'W', 3: '', 4: 'D' }   // Output and info unmarked
+
+const args = process.argv.slice(2)
+const showMs = args.includes('--ms')
+const [elfPath, inputPath] = args.filter(a => !a.startsWith('--'))
+if (!elfPath) {
+  console.error('Usage: node tools/log-decode.mjs <firmware.elf> [capture.bin] [--ms]')
+  process.exit(1)
+}
+
+// ── ELF: loaded sections, to map an address to the bytes behind it ─────────
+
+function loadSections(path) {
+  const elf = readFileSync(path)
+  if (elf.readUInt32BE(0) !== 0x7F454C46 || elf[4] !== 1 || elf[5] !== 1) {
+    throw new Error(`${path}: not a little-endian ELF32 file`)
+  }
+  const shoff = elf.readUInt32LE(32)
+  const shentsize = elf.readUInt16LE(46)
+  const shnum = elf.readUInt16LE(48)
+  const sections = []
+  for (let i = 0; i < shnum; i++) {
+    const at = shoff + i * shentsize
+    const type = elf.readUInt32LE(at + 4)
+    const flags = elf.readUInt32LE(at + 8)
+    const addr = elf.readUInt32LE(at + 12)
+    const offset = elf.readUInt32LE(at + 16)
+    const size = elf.readUInt32LE(at + 20)
+    const SHT_NOBITS = 8, SHF_ALLOC = 2
+    if (type === SHT_NOBITS || !(flags & SHF_ALLOC) || addr === 0) continue
+    sections.push({ addr, offset, size })
+  }
+  return { elf, sections }
+}
+
+function stringAt({ elf, sections }, addr) {
+  const s = sections.find(s => addr >= s.addr && addr < s.addr + s.size)
+  if (!s) return null
+  const start = s.offset + (addr - s.addr)
+  const end = elf.indexOf(0, start)
+  return elf.toString('latin1', start, end < 0 ? s.offset + s.size : end)
+}
+
+// ── Record arguments and printf ─────────────────────────────────────────────
+
+function readArgs(rec) {
+  const out = []
+  let at = HEADER
+  while (at < rec.length) {
+    const tag = String.fromCharCode(rec[at++])
+    if (tag === 'i') { out.push(rec.readInt32LE(at)); at += 4 }
+    else if (tag === 'u') { out.push(rec.readUInt32LE(at)); at += 4 }
+    else if (tag === 'I') { out.push(rec.readBigInt64LE(at)); at += 8 }
+    else if (tag === 'U') { out.push(rec.readBigUInt64LE(at)); at += 8 }
+    else if (tag === 'f') { out.push(rec.readFloatLE(at)); at += 4 }
+    else if (tag === 's') { const n = rec[at++]; out.push(rec.toString('latin1', at, at + n)); at += n }
+    else break
+  }
+  return out
+}
+
+function pad(text, flags, width) {
+  if (text.length >= width) return text
+  if (flags.includes('-')) return text.padEnd(width)
+  if (flags.includes('0') && /^[-+]?[0-9a-fA-F.]/.test(text)) {
+    const sign = /^[-+]/.test(text) ? text[0] : ''
+    return sign + text.slice(sign.length).padStart(width - sign.length, '0')
+  }
+  return text.padStart(width)
+}
+
+function format(fmt, values) {
+  let next = 0
+  return fmt.replace(/%([-+ #0]*)(\d*)(?:\.(\d+))?[hlLqjzt]*([diouxXcpfFeEgGs%])/g,
+    (spec, flags, width, prec, conv) => {
+      if (conv === '%') return '%'
+      if (next >= values.length) return spec
+      let v = values[next++]
+      let text
+      switch (conv) {
+        case 'd': case 'i': text = String(typeof v === 'number' ? Math.trunc(v) : v); break
+        case 'u': text = String(typeof v === 'bigint' || v >= 0 ? v : v >>> 0); break
+        case 'x': case 'X': case 'o': case 'p':
+          if (typeof v === 'number' && v < 0) v = v >>> 0
+          if (typeof v === 'bigint' && v < 0n) v = BigInt.asUintN(64, v)
+          text = v.toString(conv === 'o' ? 8 : 16)
+          if (conv === 'X') text = text.toUpperCase()
+          if (conv === 'p') text = '0x' + text.padStart(8, '0')
+          break
+        case 'c': text = String.fromCharCode(Number(v)); break
+        case 'f': case 'F': text = Number(v).toFixed(prec === undefined ? 6 : +prec); break
+        case 'e': case 'E': text = Number(v).toExponential(prec === undefined ? 6 : +prec); break
+        case 'g': case 'G': text = String(Number(Number(v).toPrecision(prec ? +prec : 6))); break
+        default: text = typeof v === 'string' ? (prec === undefined ? v : v.slice(0, +prec)) : String(v)
+      }
+      if (flags.includes('+') && /^[0-9]/.test(text) && 'dif'.includes(conv)) text = '+' + text
+      return pad(text, flags, width ? +width : 0)
+    })
+}
+
+function decodeRecord(image, rec) {
+  const level = LEVELS[rec[1]] ?? '?'
+  const addr = rec.readUInt32LE(2)
+  const ms = rec.readUInt32LE(6)
+  const fmt = stringAt(image, addr)
+  const text = fmt === null
+    ? `<unknown format 0x${addr.toString(16).padStart(8, '0')}> ${readArgs(rec).join(' ')}`
+    : format(fmt, readArgs(rec))
+  const stamp = showMs ? `${(ms / 1000).toFixed(3).padStart(10)} ` : ''
+  return `${stamp}${level && level + ' '}${text}`
+}
+
+// ── Stream ──────────────────────────────────────────────────────────────────
+
+const image = loadSections(elfPath)
+let pending = Buffer.alloc(0)
+let textLine = ''
+
+function feed(chunk) {
+  pending = Buffer.concat([pending, chunk])
+  let at = 0
+  while (at < pending.length) {
+    if (pending[at] === RECORD_MARK) {
+      if (at + 1 >= pending.length) break
+      const len = pending[at + 1]
+      if (len < HEADER) { at++; continue }      // Not a record after all
+      if (at + 1 + len > pending.length) break
+      if (textLine) { process.stdout.write(textLine + '\n'); textLine = '' }
+      process.stdout.write(decodeRecord(image, pending.subarray(at + 1, at + 1 + len)) + '\n')
+      at += 1 + len
+      continue
+    }
+    const ch = pending[at++]
+    if (ch === 0x0A) { process.stdout.write(textLine + '\n'); textLine = '' }
+    else if (ch !== 0x0D) textLine += String.fromCharCode(ch)
+  }
+  pending = pending.subarray(at)
+}
+
+const input = inputPath ? createReadStream(inputPath) : process.stdin
+input.on('data', feed)
+input.on('end', () => { if (textLine) process.stdout.write(textLine + '\n') })